@@ -14,6 +14,10 @@
 #include <thread>
 
 #include "interfaces/interfaces_callback.grpc.pb.h"
+#include "robot/client/flow_control.h"
+#include "robot/client/notification_dispatcher.h"
+#include "robot/client/notification_pool.h"
+#include "robot/client/notification_router.h"
 #include "robot/common/status.h"
 #include <grpcpp/grpcpp.h>
 
@@ -22,9 +26,41 @@ using humanoid_robot::konka_sdk::common::Status;
 namespace humanoid_robot {
 namespace konka_sdk {
 namespace robot {
-// 回调函数类型定义
-using SubscriptionMessageCallback =
-    std::function<void(const humanoid_robot::PB::interfaces::Notification &)>;
+
+/**
+ * 回调服务实现方式
+ */
+enum class CallbackServerMode {
+  kSync, // gRPC 同步服务，线程由 gRPC 按需创建
+  kAsync // 完成队列异步服务，线程数固定
+};
+
+/**
+ * 回调服务器配置
+ */
+struct CallbackServerOptions {
+  // 订阅消息分发：默认4个工作线程，按 event_type 保序
+  NotificationDispatchOptions dispatch;
+  // 消息对象池：请求解码到可复用的 arena 消息中
+  NotificationPoolOptions pool;
+  // 通过 NotificationAck 向推送方反馈队列压力
+  FlowControlOptions flow_control;
+
+  CallbackServerMode mode = CallbackServerMode::kSync;
+  // 以下仅 kAsync 模式有效
+  size_t completion_queues = 1; // 完成队列数
+  size_t threads_per_queue = 1; // 每个完成队列的轮询线程数
+  size_t calls_per_queue = 32;  // 每个完成队列预先挂起的调用数（并发上限）
+};
+
+/**
+ * 回调服务器运行统计
+ */
+struct CallbackServerStats {
+  NotificationDispatchStats dispatch;
+  NotificationPoolStats pool;
+  FlowControlStats flow_control;
+};
 
 /**
  * ClientCallbackServer - 客户端回调服务器
@@ -88,6 +124,35 @@ public:
    */
   void SetSubscriptionMessageCallback(SubscriptionMessageCallback callback);
 
+  /**
+   * 按主题注册处理器，服务器运行期间也可调用
+   * @param event_type 事件类型，为空表示接收所有消息
+   * @param object_id 对象ID，为空表示该事件类型的所有对象
+   * @param handler 处理器，以共享只读指针接收消息
+   * @return 处理器句柄，用于注销
+   */
+  SubscriptionHandlerId AddSubscriptionHandler(const std::string &event_type,
+                                               NotificationHandler handler);
+  SubscriptionHandlerId AddSubscriptionHandler(const std::string &event_type,
+                                               const std::string &object_id,
+                                               NotificationHandler handler);
+
+  /**
+   * 注销处理器，服务器运行期间也可调用
+   */
+  bool RemoveSubscriptionHandler(SubscriptionHandlerId id);
+
+  /**
+   * 设置服务器配置（需在启动前调用）
+   * @param options 服务器配置
+   */
+  void SetServerOptions(const CallbackServerOptions &options);
+
+  /**
+   * 获取运行统计（队列深度、回调耗时等）
+   */
+  CallbackServerStats GetStats() const;
+
   // =================================================================
   // 便捷方法
   // =================================================================
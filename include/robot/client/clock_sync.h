@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Client/server clock offset and drift estimation
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_CLOCK_SYNC_H
+#define HUMANOID_ROBOT_CLIENT_CLOCK_SYNC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "robot/client/interfaces_client.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+// 对时请求：Query 的 input 中 clock_sync=true，t1 为客户端发送时刻；
+// 网关在 output 中返回 t2(收到请求) 和 t3(发出响应)，均为 Unix 纳秒
+constexpr const char *kClockSyncKey = "clock_sync";
+constexpr const char *kClockSyncT1Key = "t1";
+constexpr const char *kClockSyncT2Key = "t2";
+constexpr const char *kClockSyncT3Key = "t3";
+
+/**
+ * 对时配置
+ */
+struct ClockSyncOptions {
+  // 对时周期(ms)
+  int64_t interval_ms = 1000;
+  // 每轮发送的探测次数，取往返时延最小的一次
+  int samples_per_round = 8;
+  // 用于估计漂移的轮数
+  size_t drift_window = 30;
+  // 单次探测超时(ms)
+  int64_t request_timeout_ms = 500;
+};
+
+/**
+ * 对时统计
+ */
+struct ClockSyncStats {
+  bool synced = false;
+  int64_t offset_ns = 0;     // 当前偏移：服务端时间 - 本地时间
+  double drift_ppm = 0.0;    // 本地时钟相对服务端的漂移
+  int64_t round_trip_ns = 0; // 最近一轮的最小往返时延
+  uint64_t rounds = 0;
+  uint64_t failures = 0;
+};
+
+/**
+ * ClockSync - 基于现有通道的 NTP 式对时
+ *
+ * 每轮发送若干次 Query 探测，按最小往返时延的样本计算偏移
+ * offset = ((t2 - t1) + (t3 - t4)) / 2，并对最近若干轮的偏移做线性拟合
+ * 估计漂移。换算接口无锁，可在订阅回调等热路径上调用。
+ */
+class ClockSync {
+public:
+  explicit ClockSync(std::shared_ptr<InterfacesClient> client,
+                     ClockSyncOptions options = ClockSyncOptions());
+  ~ClockSync();
+
+  /**
+   * 启动后台对时线程（先同步完成一轮）
+   */
+  Status Start();
+
+  void Stop();
+
+  /**
+   * 执行一轮对时
+   */
+  Status SyncOnce();
+
+  bool IsSynced() const;
+
+  /**
+   * 本地时刻对应的偏移(ns)，未同步时为 0
+   */
+  int64_t OffsetNs(int64_t local_ns) const;
+
+  /**
+   * 把本地 Unix 纳秒时间换算为服务端时间
+   */
+  int64_t ToServerTimeNs(int64_t local_ns) const;
+
+  /**
+   * 当前的服务端时间(Unix 纳秒)
+   */
+  int64_t ServerTimeNs() const;
+
+  /**
+   * 本地 Unix 纳秒时间
+   */
+  static int64_t LocalTimeNs();
+
+  ClockSyncStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  ClockSync(const ClockSync &) = delete;
+  ClockSync &operator=(const ClockSync &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_CLOCK_SYNC_H
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Flow-control feedback carried in NotificationAck
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_FLOW_CONTROL_H
+#define HUMANOID_ROBOT_CLIENT_FLOW_CONTROL_H
+
+#include <cstdint>
+#include <memory>
+
+#include "interfaces/interfaces_callback.pb.h"
+#include <grpcpp/grpcpp.h>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+class NotificationDispatcher;
+
+// NotificationAck.ret 取值：0 正常；正数为流控信号；负数为处理失败
+constexpr int32_t kAckOk = 0;
+constexpr int32_t kAckSlowDown = 1; // 请降低推送频率，建议频率见尾部元数据
+constexpr int32_t kAckDrop = 2;     // 客户端积压，请丢弃非关键消息
+
+// 建议推送频率(Hz)，以十进制字符串放在响应尾部元数据中
+constexpr const char *kSuggestedRateMetadataKey = "x-suggested-rate-hz";
+
+/**
+ * 流控信号
+ */
+enum class FlowSignal { kNone, kSlowDown, kDrop };
+
+/**
+ * 一次确认携带的流控反馈
+ */
+struct FlowFeedback {
+  FlowSignal signal = FlowSignal::kNone;
+  double suggested_rate_hz = 0.0; // 0 表示未给出建议
+};
+
+/**
+ * 流控配置：按消息所在队列的占用率判定
+ */
+struct FlowControlOptions {
+  // 默认关闭：未按上述约定解读正数 ret 的网关会把非零确认当作推送失败，
+  // 需确认网关支持后再开启
+  bool enabled = false;
+  // 占用率达到该值时返回 kAckSlowDown
+  double slow_down_watermark = 0.5;
+  // 占用率达到该值时返回 kAckDrop
+  double drop_watermark = 0.9;
+  // 建议频率 = 实测消费速率 × rate_margin
+  double rate_margin = 0.8;
+  // 消费速率的采样周期(ms)
+  int64_t rate_window_ms = 200;
+};
+
+/**
+ * 流控统计
+ */
+struct FlowControlStats {
+  uint64_t slow_down = 0;    // 发出 kAckSlowDown 的次数
+  uint64_t drop = 0;         // 发出 kAckDrop 的次数
+  double drain_rate_hz = 0.0; // 当前估计的消费速率
+};
+
+/**
+ * FlowController - 根据队列水位生成 NotificationAck 流控反馈
+ *
+ * 队列占用率取自消息实际进入的分片队列，消费速率由分发器的完成计数
+ * 按固定周期采样并做指数平滑得到。Evaluate() 无锁，可在 gRPC 线程上
+ * 直接调用。
+ */
+class FlowController {
+public:
+  FlowController(FlowControlOptions options,
+                 const NotificationDispatcher *dispatcher);
+  ~FlowController();
+
+  FlowFeedback Evaluate(double queue_fill);
+
+  /**
+   * 当前估计的消费速率(Hz)
+   */
+  double DrainRateHz() const;
+
+  FlowControlStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  FlowController(const FlowController &) = delete;
+  FlowController &operator=(const FlowController &) = delete;
+};
+
+/**
+ * 把反馈写入确认消息和尾部元数据（服务端）
+ */
+void ApplyFlowFeedback(const FlowFeedback &feedback,
+                       humanoid_robot::PB::interfaces::NotificationAck *ack,
+                       grpc::ServerContext *context);
+
+/**
+ * 从确认消息和尾部元数据中解析反馈（推送方/网关使用）
+ */
+FlowFeedback
+ParseFlowFeedback(const humanoid_robot::PB::interfaces::NotificationAck &ack,
+                  const grpc::ClientContext &context);
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_FLOW_CONTROL_H
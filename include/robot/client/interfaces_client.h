@@ -154,6 +154,25 @@ public:
             humanoid_robot::PB::interfaces::SubscribeResponse &response,
             int64_t timeout_ms = 0);
 
+  /**
+   * Open a long-lived subscription stream
+   * Notifications flow down the stream instead of being pushed to a
+   * ClientCallbackServer, so no inbound port is needed (works behind NAT).
+   * Carried over the server-streaming Action RPC with the Subscribe() input
+   * plus a "subscribe_stream" flag; the gateway must accept the
+   * "subscribe.stream.v1" capability.
+   * @param request The subscription request (same fields as Subscribe())
+   * @param reader The client reader for notifications (output)
+   * @param context The client context (must remain valid during stream
+   * lifetime, TryCancel() ends the subscription)
+   * @return Status of the operation
+   */
+  Status SubscribeStream(
+      const humanoid_robot::PB::interfaces::SubscribeRequest &request,
+      std::unique_ptr<::grpc::ClientReader<
+          ::humanoid_robot::PB::interfaces::ActionResponse>> &reader,
+      grpc::ClientContext &context);
+
   // =================================================================
   // Utility Methods
   // =================================================================
@@ -170,6 +189,31 @@ public:
    */
   bool WaitForChannelReady(int64_t timeout_ms = 5000);
 
+  // =================================================================
+  // Capability Negotiation
+  // =================================================================
+
+  /**
+   * Negotiate optional protocol capabilities with the server
+   * @param offered Capabilities supported by this client (e.g. "codec.compact.v1")
+   * @param timeout_ms Timeout in milliseconds (default: 5000)
+   * @return Status of the handshake. On failure no capability is enabled and
+   *         callers fall back to the default protobuf encoding.
+   */
+  Status NegotiateCapabilities(const std::vector<std::string> &offered,
+                               int64_t timeout_ms = 5000);
+
+  /**
+   * Check whether a capability was accepted by the server
+   */
+  bool HasCapability(const std::string &capability) const;
+
+  /**
+   * Convert a gRPC status into an SDK Status
+   * (also used for the status returned by Finish() on a Send stream)
+   */
+  static Status ConvertGrpcStatus(const grpc::Status &grpc_status);
+
 private:
   // Private implementation details
   class InterfacesClientImpl;
@@ -180,7 +224,6 @@ private:
   InterfacesClient &operator=(const InterfacesClient &) = delete;
 
   // Helper methods
-  Status ConvertGrpcStatus(const grpc::Status &grpc_status);
   std::chrono::system_clock::time_point GetDeadline(int64_t timeout_ms);
   std::unique_ptr<humanoid_robot::framework::common::ConfigManager> config_manager_;
   humanoid_robot::framework::common::ConfigNode loaded_config_;
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Latest-value conflation for high-rate subscription topics
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_NOTIFICATION_CONFLATOR_H
+#define HUMANOID_ROBOT_CLIENT_NOTIFICATION_CONFLATOR_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "robot/client/notification_dispatcher.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+/**
+ * 合并统计
+ */
+struct NotificationConflationStats {
+  uint64_t offered = 0;   // 进入合并槽的消息数
+  uint64_t conflated = 0; // 投递前被新值覆盖而丢弃的消息数
+  uint64_t delivered = 0; // 实际投递的消息数
+  uint64_t slots = 0;     // 当前槽位数（event_type + object_id）
+};
+
+/**
+ * NotificationConflator - 高频主题的最新值合并
+ *
+ * 每个 (event_type, object_id) 对应一个最新值槽位：新消息直接覆盖槽位，
+ * 由单个投递线程按配置频率取出最新值交给下游，同一键两次投递的间隔
+ * 不小于 1/rate。生产快于消费时丢弃的是过期值，队列长度与键数成正比，
+ * 不会无限增长。
+ */
+class NotificationConflator {
+public:
+  /**
+   * @param topics 需要合并的事件类型及每个键的最大投递频率(Hz)，
+   *               频率不大于0表示不限速（仍合并投递前到达的消息）
+   * @param deliver 下游投递函数，在投递线程上调用
+   */
+  NotificationConflator(std::unordered_map<std::string, double> topics,
+                        NotificationHandler deliver);
+  ~NotificationConflator();
+
+  /**
+   * 提交一条消息
+   * @return 消息所属主题不需要合并（或已停止）时返回 false，由调用方正常分发
+   */
+  bool Offer(const NotificationPtr &message);
+
+  /**
+   * 投递所有未投递的最新值后停止投递线程
+   */
+  void Stop();
+
+  NotificationConflationStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  NotificationConflator(const NotificationConflator &) = delete;
+  NotificationConflator &operator=(const NotificationConflator &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_NOTIFICATION_CONFLATOR_H
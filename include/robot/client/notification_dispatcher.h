@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Sharded worker pool for subscription notifications
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_NOTIFICATION_DISPATCHER_H
+#define HUMANOID_ROBOT_CLIENT_NOTIFICATION_DISPATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "interfaces/interfaces_callback.pb.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+class ClockSync;
+
+// 回调函数类型定义
+using SubscriptionMessageCallback =
+    std::function<void(const humanoid_robot::PB::interfaces::Notification &)>;
+
+// 只读共享的订阅消息
+using NotificationPtr =
+    std::shared_ptr<const humanoid_robot::PB::interfaces::Notification>;
+
+// 以共享指针接收消息的处理器，可在回调返回后继续持有消息
+using NotificationHandler = std::function<void(const NotificationPtr &)>;
+
+/**
+ * 保序键：键相同的消息落在同一分片，按到达顺序串行处理
+ */
+enum class NotificationOrderKey {
+  kEventType,           // 按 event_type 保序
+  kObjectId,            // 按 object_id 保序
+  kEventTypeAndObjectId // 按 (event_type, object_id) 保序，并行度最高
+};
+
+/**
+ * 优先级：按事件类型划分
+ */
+enum class NotificationPriority {
+  kCritical, // 独立队列和线程，有单独的容量，不会被其他流量阻塞
+  kNormal,   // 分片队列，满时阻塞 gRPC 线程形成背压
+  kBulk      // 大流量传感器数据，排在普通消息之后，积压时最先丢弃
+};
+
+/**
+ * 分发配置
+ */
+struct NotificationDispatchOptions {
+  // 工作线程数（即分片数），0 表示在 gRPC 线程上直接执行回调
+  size_t worker_threads = 4;
+  // 每个分片的队列容量，队列满时阻塞 gRPC 线程形成背压；0 表示不限
+  size_t queue_capacity = 1024;
+  NotificationOrderKey order_key = NotificationOrderKey::kEventType;
+  // 只保留最新值的事件类型及每个 (event_type, object_id) 的最大投递频率(Hz)，
+  // 如 {{"sensor.imu", 30.0}, {"navigation.pose", 20.0}}；频率不大于0表示不限速
+  std::unordered_map<std::string, double> conflated_topics;
+  // 事件类型的优先级，未列出的为 kNormal；仅线程池模式有效
+  std::unordered_map<std::string, NotificationPriority> priorities = {
+      {"error.critical", NotificationPriority::kCritical},
+      {"sensor.camera", NotificationPriority::kBulk},
+      {"sensor.lidar", NotificationPriority::kBulk}};
+  // 每个分片的 kBulk 队列容量，满时丢弃最旧的消息，不阻塞 gRPC 线程
+  size_t bulk_queue_capacity = 64;
+  // kCritical 队列容量，满时阻塞 gRPC 线程；0 表示不限。
+  // 与 queue_capacity 分开，关键消息不会因普通流量的背压配置而排队等待
+  size_t critical_queue_capacity = 0;
+  // 按 event_type 统计推送延迟、排队时间和回调耗时
+  bool track_topics = true;
+  // 消息中服务端时间戳(Unix 毫秒)的字段名，用于计算推送延迟
+  std::string timestamp_key = "timestamp";
+  // 对时模块，设置后推送延迟按服务端时间计算，否则直接使用本地时间
+  std::shared_ptr<ClockSync> clock_sync;
+};
+
+/**
+ * 单个事件类型的延迟统计，时间单位为微秒
+ */
+struct TopicLatencyStats {
+  uint64_t count = 0;
+  uint64_t push_p50_us = 0; // 服务端时间戳到到达客户端
+  uint64_t push_p99_us = 0;
+  uint64_t push_max_us = 0;
+  uint64_t queue_wait_p50_us = 0;
+  uint64_t queue_wait_p99_us = 0;
+  uint64_t handler_p50_us = 0;
+  uint64_t handler_p99_us = 0;
+  uint64_t handler_max_us = 0;
+};
+
+/**
+ * 分发统计，时间单位为微秒
+ */
+struct NotificationDispatchStats {
+  uint64_t received = 0;       // 收到的消息数
+  uint64_t dispatched = 0;     // 回调执行完成的消息数
+  uint64_t handler_errors = 0; // 回调抛出异常的次数
+  uint64_t queue_depth = 0;    // 当前排队消息总数
+  uint64_t max_queue_depth = 0; // 单个分片出现过的最大排队数
+  std::vector<uint64_t> shard_depths;
+
+  uint64_t critical_dispatched = 0; // kCritical 消息处理数
+  uint64_t bulk_shed = 0;           // kBulk 积压时丢弃的消息数
+  uint64_t critical_wait_p99_us = 0;
+
+  uint64_t conflated = 0;           // 合并主题中被新值覆盖的消息数
+  uint64_t conflation_delivered = 0; // 合并主题实际投递的消息数
+
+  uint64_t queue_wait_p50_us = 0;
+  uint64_t queue_wait_p99_us = 0;
+  uint64_t handler_p50_us = 0;
+  uint64_t handler_p99_us = 0;
+  uint64_t handler_max_us = 0;
+
+  // 按 event_type 的延迟统计
+  std::map<std::string, TopicLatencyStats> topics;
+};
+
+/**
+ * 当前消息的时间戳(Unix 纳秒)，配置 clock_sync 时已换算为服务端时间
+ */
+struct NotificationTiming {
+  int64_t server_timestamp_ns = 0; // 消息自带的服务端时间戳，没有时为 0
+  int64_t arrival_ns = 0;          // 到达客户端
+  int64_t dispatch_ns = 0;         // 开始执行回调
+  int64_t push_latency_ns = 0;     // arrival_ns - server_timestamp_ns
+  int64_t queue_wait_ns = 0;       // 在分发队列中的等待时间
+};
+
+/**
+ * 在订阅回调内获取当前消息的时间戳，回调之外调用结果无意义
+ */
+const NotificationTiming &CurrentNotificationTiming();
+
+/**
+ * NotificationDispatcher - 订阅消息分片工作线程池
+ *
+ * 每个工作线程独占一个分片队列，消息按保序键哈希到分片：
+ * 同一键的消息严格按到达顺序处理，不同键的消息在不同线程上并行，
+ * 单个慢回调只阻塞其所在分片。
+ *
+ * kCritical 事件走独立队列和线程；kBulk 事件在每个分片上单独排队，
+ * 只在普通队列为空时处理，积压超过容量时丢弃最旧的消息。
+ * 同一事件类型总属于同一优先级，因此按 event_type 保序不受影响。
+ */
+class NotificationDispatcher {
+public:
+  NotificationDispatcher(NotificationDispatchOptions options,
+                         NotificationHandler handler);
+  ~NotificationDispatcher();
+
+  /**
+   * 投递一条消息
+   * 线程池模式下入队即返回（队列满时阻塞等待），内联模式下直接执行回调。
+   * @param queue_fill 输出消息所在队列的占用率 [0, 1]，用于流控反馈；
+   *                   关键消息、合并消息和内联模式下为 0
+   * @return 已停止或内联回调抛出异常时返回 false
+   */
+  bool Dispatch(const humanoid_robot::PB::interfaces::Notification &message);
+  bool Dispatch(NotificationPtr message, double *queue_fill = nullptr);
+
+  /**
+   * 已执行完成的消息数（无锁读取，用于估算消费速率）
+   */
+  uint64_t DispatchedCount() const;
+
+  /**
+   * 停止接收新消息，处理完已排队的消息后退出工作线程
+   */
+  void Stop();
+
+  NotificationDispatchStats GetStats() const;
+
+  /**
+   * 计算消息的保序键哈希
+   */
+  static size_t OrderHash(
+      const humanoid_robot::PB::interfaces::Notification &message,
+      NotificationOrderKey order_key);
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  NotificationDispatcher(const NotificationDispatcher &) = delete;
+  NotificationDispatcher &operator=(const NotificationDispatcher &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_NOTIFICATION_DISPATCHER_H
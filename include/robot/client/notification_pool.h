@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Arena-backed Notification pool for the callback path
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_NOTIFICATION_POOL_H
+#define HUMANOID_ROBOT_CLIENT_NOTIFICATION_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "interfaces/interfaces_callback.pb.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+/**
+ * 对象池配置
+ */
+struct NotificationPoolOptions {
+  // 空闲对象上限，超出后归还的对象直接释放；0 表示不使用对象池
+  size_t max_idle = 256;
+  // 每个对象独占的 arena 初始块大小，常见消息应能完整放入
+  size_t arena_block_bytes = 16 * 1024;
+};
+
+/**
+ * 对象池统计
+ */
+struct NotificationPoolStats {
+  uint64_t acquired = 0; // 获取次数
+  uint64_t created = 0;  // 新建对象数（未命中空闲列表）
+  uint64_t released = 0; // 归还次数
+  uint64_t dropped = 0;  // 因空闲列表已满而释放的对象数
+  uint64_t idle = 0;     // 当前空闲对象数
+};
+
+/**
+ * NotificationPool - 基于 arena 的订阅消息对象池
+ *
+ * 每个池对象拥有一个带初始块的 protobuf Arena，Notification 及其嵌套的
+ * Variant 字典、字符串都分配在该 arena 上。Acquire() 返回的共享指针的
+ * 控制块也放在池对象内部，因此稳态下获取、解码、分发、归还全程不调用
+ * 全局分配器。最后一个引用释放时 arena 被重置，对象回到空闲列表。
+ *
+ * 池本身可以先于取出的对象销毁，未归还的对象在释放时自行删除。
+ */
+class NotificationPool {
+public:
+  static std::shared_ptr<NotificationPool>
+  Create(NotificationPoolOptions options = NotificationPoolOptions());
+
+  ~NotificationPool();
+
+  /**
+   * 获取一个空消息，可直接作为解码目标；所有引用释放后自动回收
+   */
+  std::shared_ptr<humanoid_robot::PB::interfaces::Notification> Acquire();
+
+  NotificationPoolStats GetStats() const;
+
+  class State;
+
+private:
+  explicit NotificationPool(NotificationPoolOptions options);
+
+  std::shared_ptr<State> state_;
+
+  NotificationPool(const NotificationPool &) = delete;
+  NotificationPool &operator=(const NotificationPool &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_NOTIFICATION_POOL_H
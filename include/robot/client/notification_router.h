@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Topic-routed handler registry for subscription notifications
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_NOTIFICATION_ROUTER_H
+#define HUMANOID_ROBOT_CLIENT_NOTIFICATION_ROUTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "robot/client/notification_dispatcher.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+// 处理器句柄，用于注销；0 为无效句柄
+using SubscriptionHandlerId = uint64_t;
+
+/**
+ * NotificationRouter - 按主题路由的订阅消息处理器注册表
+ *
+ * 处理器按 (event_type, object_id) 注册：
+ * - event_type + object_id：只接收该对象的该类消息
+ * - 仅 event_type（object_id 为空）：接收该类消息的所有对象
+ * - event_type 为空：接收所有消息
+ *
+ * 路由表采用写时复制：注册/注销时复制整张表后原子替换，
+ * Route() 只做一次原子加载和两次哈希查找，不加锁，
+ * 可在服务器运行期间随时增删处理器。
+ * 同一条消息以共享只读指针分发给所有匹配的处理器，不做拷贝。
+ */
+class NotificationRouter {
+public:
+  NotificationRouter();
+  ~NotificationRouter();
+
+  /**
+   * 注册处理器
+   * @return 处理器句柄，handler 为空时返回 0
+   */
+  SubscriptionHandlerId Add(const std::string &event_type,
+                            const std::string &object_id,
+                            NotificationHandler handler);
+
+  SubscriptionHandlerId Add(const std::string &event_type,
+                            NotificationHandler handler) {
+    return Add(event_type, std::string(), std::move(handler));
+  }
+
+  /**
+   * 注销处理器，已在执行中的调用不受影响
+   * @return 句柄不存在时返回 false
+   */
+  bool Remove(SubscriptionHandlerId id);
+
+  void Clear();
+
+  /**
+   * 将消息分发给所有匹配的处理器
+   * 单个处理器抛出的异常会被捕获并计数，不影响其他处理器。
+   * @param failed 输出抛出异常的处理器个数，可为空
+   * @return 调用的处理器个数
+   */
+  size_t Route(const NotificationPtr &message, size_t *failed = nullptr) const;
+
+  size_t HandlerCount() const;
+
+  /**
+   * 组合全局回调与本路由表：先执行 callback，再按主题路由，
+   * 有处理器失败时抛出异常以便分发器计数。路由表须比返回值存活更久。
+   */
+  NotificationHandler BindHandler(SubscriptionMessageCallback callback);
+
+  /**
+   * 提取消息的 event_type / object_id（整数 object_id 转为十进制字符串）
+   */
+  static std::string EventTypeOf(
+      const humanoid_robot::PB::interfaces::Notification &message);
+  static std::string ObjectIdOf(
+      const humanoid_robot::PB::interfaces::Notification &message);
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  NotificationRouter(const NotificationRouter &) = delete;
+  NotificationRouter &operator=(const NotificationRouter &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_NOTIFICATION_ROUTER_H
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Shared-memory fan-out of subscription notifications to local processes
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_SHM_RING_H
+#define HUMANOID_ROBOT_CLIENT_SHM_RING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "interfaces/interfaces_callback.pb.h"
+#include "robot/client/notification_dispatcher.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+// 可同时登记游标的读者进程数上限，超出的读者仍可读取，只是不计入统计
+constexpr size_t kShmRingMaxReaders = 16;
+
+/**
+ * 共享内存环形缓冲配置
+ */
+struct ShmRingOptions {
+  // 槽位数，读者落后超过该数量时丢失最旧的消息
+  size_t slot_count = 1024;
+  // 单个槽位可容纳的序列化消息字节数，超出的消息不发布
+  size_t slot_bytes = 4096;
+  // 写者销毁时删除 /dev/shm 下的共享内存对象
+  bool unlink_on_close = true;
+};
+
+/**
+ * 写者统计
+ */
+struct ShmRingStats {
+  uint64_t published = 0;      // 已发布消息数
+  uint64_t oversize = 0;       // 因超过槽位大小而未发布的消息数
+  uint64_t readers = 0;        // 当前登记的读者数
+  uint64_t max_reader_lag = 0; // 最慢读者落后的消息数
+};
+
+/**
+ * ShmRingWriter - 把订阅消息发布到 /dev/shm 中的环形缓冲
+ *
+ * 每个槽位由序列锁保护：写入期间序号为奇数，写完后为偶数且与消息序号
+ * 一一对应。写者从不等待读者，读者也不加锁，同一主机上的多个进程只需
+ * 由一个 SDK 进程订阅网关，其他进程通过 ShmRingReader 读取。
+ *
+ * 通常配合 ClientCallbackServer 使用：
+ *   server.AddSubscriptionHandler("navigation.pose", writer->AsHandler());
+ */
+class ShmRingWriter {
+public:
+  /**
+   * 创建共享内存对象，同名的残留对象会被替换
+   * @param name 共享内存名称，如 "/konka_pose"
+   */
+  static common::Status Create(const std::string &name, ShmRingOptions options,
+                               std::unique_ptr<ShmRingWriter> &writer);
+
+  ~ShmRingWriter();
+
+  /**
+   * 发布一条消息，可从多个线程调用
+   */
+  common::Status
+  Publish(const humanoid_robot::PB::interfaces::Notification &message);
+
+  /**
+   * 返回可注册到 ClientCallbackServer / StreamSubscription 的处理器
+   *
+   * 处理器只持有写者的弱引用，写者销毁后再收到的消息直接丢弃
+   */
+  NotificationHandler AsHandler();
+
+  const std::string &Name() const;
+
+  ShmRingStats GetStats() const;
+
+  class Impl;
+
+private:
+  explicit ShmRingWriter(std::unique_ptr<Impl> impl);
+
+  // 共享所有权只为 AsHandler() 的弱引用，写者仍是唯一的强引用持有者
+  std::shared_ptr<Impl> pImpl_;
+
+  ShmRingWriter(const ShmRingWriter &) = delete;
+  ShmRingWriter &operator=(const ShmRingWriter &) = delete;
+};
+
+/**
+ * 共享内存中一条消息的只读视图
+ *
+ * data 直接指向共享内存槽位，使用完毕后须调用 ShmRingReader::Validate()
+ * 确认期间未被写者覆盖，否则读到的内容无效。
+ */
+struct ShmMessageView {
+  const char *data = nullptr;
+  size_t size = 0;
+  uint64_t sequence = 0;
+};
+
+/**
+ * ShmRingReader - 在其他进程中读取 ShmRingWriter 发布的消息
+ *
+ * 每个读者维护独立游标，打开时从最新位置开始；落后超过一圈时跳到最旧的
+ * 可用消息，并计入 Lost()。单个读者对象不可跨线程并发使用。
+ */
+class ShmRingReader {
+public:
+  static common::Status Open(const std::string &name,
+                             std::unique_ptr<ShmRingReader> &reader);
+
+  ~ShmRingReader();
+
+  /**
+   * 零拷贝读取下一条消息
+   * @return 没有新消息时返回 false
+   */
+  bool TryRead(ShmMessageView *view);
+
+  /**
+   * 检查视图指向的槽位在读取期间是否被覆盖
+   */
+  bool Validate(const ShmMessageView &view) const;
+
+  /**
+   * 读取并解析下一条消息，被覆盖的消息自动跳过
+   */
+  bool TryRead(humanoid_robot::PB::interfaces::Notification *message);
+
+  /**
+   * 等待并读取下一条消息
+   * @param timeout_ms 超时时间(毫秒)
+   * @return 超时返回 false
+   */
+  bool Read(humanoid_robot::PB::interfaces::Notification *message,
+            int64_t timeout_ms);
+
+  /**
+   * 因落后或读取期间被覆盖而丢失的消息数
+   */
+  uint64_t Lost() const;
+
+  class Impl;
+
+private:
+  explicit ShmRingReader(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> pImpl_;
+
+  ShmRingReader(const ShmRingReader &) = delete;
+  ShmRingReader &operator=(const ShmRingReader &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_SHM_RING_H
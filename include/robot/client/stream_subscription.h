@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Client-initiated streaming subscription
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_STREAM_SUBSCRIPTION_H
+#define HUMANOID_ROBOT_CLIENT_STREAM_SUBSCRIPTION_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "robot/client/interfaces_client.h"
+#include "robot/client/notification_dispatcher.h"
+#include "robot/client/notification_router.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+// 流式订阅能力名，需通过 InterfacesClient::NegotiateCapabilities 协商
+constexpr const char *kStreamSubscribeCapability = "subscribe.stream.v1";
+
+/**
+ * 流式订阅配置
+ */
+struct StreamSubscriptionOptions {
+  // 与 ClientCallbackServer 相同的分发配置（工作线程、保序键、合并主题）
+  NotificationDispatchOptions dispatch;
+  // 流异常断开后的重连间隔，不大于0表示不重连；服务端正常结束流时不重连
+  int64_t reconnect_delay_ms = 1000;
+};
+
+/**
+ * 流式订阅统计
+ */
+struct StreamSubscriptionStats {
+  uint64_t messages = 0;   // 收到的通知数
+  uint64_t reconnects = 0; // 重连次数
+  std::string subscription_id;
+  NotificationDispatchStats dispatch;
+};
+
+/**
+ * StreamSubscription - 客户端发起的流式订阅
+ *
+ * 与 ClientCallbackServer 的反向推送不同，订阅由客户端通过
+ * InterfacesClient::SubscribeStream 打开一条长连接服务端流，通知沿该流
+ * 下发：每条消息省去一次 RPC 的建立、头部和确认，也不需要客户端开放
+ * 监听端口（可穿越 NAT）。
+ *
+ * 回调接口与 ClientCallbackServer 一致：全局回调 + 按主题注册的处理器，
+ * 分发同样经过分片工作线程池。
+ */
+class StreamSubscription {
+public:
+  explicit StreamSubscription(
+      std::shared_ptr<InterfacesClient> client,
+      StreamSubscriptionOptions options = StreamSubscriptionOptions());
+  ~StreamSubscription();
+
+  /**
+   * 注册订阅消息回调（需在 Start 之前调用）
+   */
+  void SetSubscriptionMessageCallback(SubscriptionMessageCallback callback);
+
+  /**
+   * 按主题注册/注销处理器，运行期间也可调用
+   */
+  SubscriptionHandlerId AddSubscriptionHandler(const std::string &event_type,
+                                               NotificationHandler handler);
+  SubscriptionHandlerId AddSubscriptionHandler(const std::string &event_type,
+                                               const std::string &object_id,
+                                               NotificationHandler handler);
+  bool RemoveSubscriptionHandler(SubscriptionHandlerId id);
+
+  /**
+   * 打开订阅流并在后台线程中接收通知
+   * @param request 订阅请求（与 InterfacesClient::Subscribe 相同，
+   *                不需要 client_endpoint）
+   * @return 服务端未接受 kStreamSubscribeCapability 时返回 not_supported
+   *         （需先调用 InterfacesClient::NegotiateCapabilities），
+   *         流建立失败时返回错误
+   */
+  Status Start(const humanoid_robot::PB::interfaces::SubscribeRequest &request);
+
+  /**
+   * 取消订阅流，并处理完已收到的通知
+   */
+  void Stop();
+
+  bool IsRunning() const;
+
+  StreamSubscriptionStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  StreamSubscription(const StreamSubscription &) = delete;
+  StreamSubscription &operator=(const StreamSubscription &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_STREAM_SUBSCRIPTION_H
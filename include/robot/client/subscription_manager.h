@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Lease tracking and automatic restore for persistent subscriptions
+ */
+
+#ifndef HUMANOID_ROBOT_CLIENT_SUBSCRIPTION_MANAGER_H
+#define HUMANOID_ROBOT_CLIENT_SUBSCRIPTION_MANAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "robot/client/interfaces_client.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+
+// 订阅请求 input/params 中的心跳间隔(秒)
+constexpr const char *kHeartbeatIntervalKey = "heartbeatInterval";
+// 订阅响应 output 中的订阅ID
+constexpr const char *kSubscriptionIdKey = "subscriptionId";
+// 批量续租请求 input：字典，订阅ID -> 心跳间隔(秒)
+constexpr const char *kRenewSubscriptionsKey = "renewSubscriptions";
+// 批量续租响应 output：字典，网关已不认识的订阅ID -> true
+constexpr const char *kExpiredSubscriptionsKey = "expiredSubscriptions";
+// 批量续租能力名，需通过 InterfacesClient::NegotiateCapabilities 协商
+constexpr const char *kSubscriptionRenewCapability = "subscribe.renew.v1";
+
+/**
+ * 订阅管理器配置
+ */
+struct SubscriptionManagerOptions {
+  // 时间轮刻度(ms)
+  int64_t tick_ms = 100;
+  // 请求中未指定心跳间隔时使用的默认值(秒)
+  int32_t default_heartbeat_s = 5;
+  // 在心跳间隔的该比例处续租，留出重试余量
+  double renew_fraction = 0.5;
+  // 单次续租请求携带的订阅数
+  size_t renew_batch_size = 64;
+  // 重连后并行恢复订阅的线程数
+  size_t restore_threads = 8;
+  // 单个订阅恢复失败后的重试间隔(ms)，每次失败翻倍，不超过上限；
+  // 连接重新建立时清零
+  int64_t restore_backoff_ms = 200;
+  int64_t restore_backoff_max_ms = 30000;
+  // 单次订阅/续租/退订请求超时(ms)
+  int64_t request_timeout_ms = 3000;
+};
+
+/**
+ * 订阅管理器统计
+ */
+struct SubscriptionManagerStats {
+  uint64_t active = 0;           // 当前有效订阅数
+  uint64_t pending = 0;          // 等待恢复的订阅数
+  uint64_t renew_requests = 0;   // 已发送的批量续租请求数
+  uint64_t renewed = 0;          // 续租成功的订阅数
+  uint64_t renew_failures = 0;   // 续租失败的请求数
+  uint64_t renew_skipped = 0;    // 未协商续租能力而未发送的续租数
+  uint64_t restored = 0;         // 重新订阅成功数
+  uint64_t restore_failures = 0; // 重新订阅失败数
+  uint64_t restores = 0;         // 恢复轮次
+  int64_t last_restore_ms = 0;   // 最近一轮恢复耗时
+};
+
+using ManagedSubscriptionId = uint64_t;
+
+/**
+ * SubscriptionManager - 持久订阅的统一管理
+ *
+ * 管理器持有所有订阅请求，按各自的心跳间隔批量续租，并在网关重启或
+ * 连接恢复后并行重新订阅。续租时刻由一个分层时间轮调度（4 层 × 64 槽），
+ * 每个刻度的开销与订阅总数无关，只与到期的订阅数有关。
+ *
+ * 以下情况会触发重新订阅：
+ * - 续租因连接故障失败，连接恢复后恢复全部订阅
+ * - 通道从故障状态回到 READY
+ * - 续租响应中列出的已失效订阅
+ *
+ * 只有网关接受 kSubscriptionRenewCapability 时才发送批量续租，否则订阅
+ * 由网关原有的心跳机制维持，管理器只负责连接恢复后的重新订阅。
+ * 能力在每个刻度检查，Start() 之后再协商也会生效。
+ */
+class SubscriptionManager {
+public:
+  explicit SubscriptionManager(
+      std::shared_ptr<InterfacesClient> client,
+      SubscriptionManagerOptions options = SubscriptionManagerOptions());
+  ~SubscriptionManager();
+
+  /**
+   * 启动续租线程
+   */
+  Status Start();
+
+  /**
+   * 停止续租线程，已有订阅保持不变
+   */
+  void Stop();
+
+  bool IsRunning() const;
+
+  /**
+   * 订阅并纳入管理
+   * @param request 订阅请求，心跳间隔取 kHeartbeatIntervalKey
+   * @param id 管理器内的句柄(输出)，重新订阅后保持不变
+   */
+  Status Add(const humanoid_robot::PB::interfaces::SubscribeRequest &request,
+             ManagedSubscriptionId *id);
+
+  /**
+   * 退订并移出管理
+   */
+  Status Remove(ManagedSubscriptionId id);
+
+  /**
+   * 网关分配的当前订阅ID，重新订阅后会变化
+   */
+  std::string SubscriptionIdOf(ManagedSubscriptionId id) const;
+
+  size_t Size() const;
+
+  /**
+   * 立即并行重新订阅全部订阅
+   */
+  Status RestoreAll();
+
+  SubscriptionManagerStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  SubscriptionManager(const SubscriptionManager &) = delete;
+  SubscriptionManager &operator=(const SubscriptionManager &) = delete;
+};
+
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_CLIENT_SUBSCRIPTION_MANAGER_H
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Bounded broadcast ring with per-consumer cursors and drop-oldest policy
+ */
+
+#ifndef HUMANOID_ROBOT_COMMON_BROADCAST_RING_H
+#define HUMANOID_ROBOT_COMMON_BROADCAST_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+/**
+ * BroadcastRing - 有界广播环形队列
+ *
+ * - 生产者通过 fetch_add 领取序号后写入槽位，写满时直接覆盖最旧元素，
+ *   生产者之间、生产者与消费者之间都不会互相等待；
+ * - 读者按序号读取，遇到已领取但尚未写完的槽位时返回（保持顺序），
+ *   Published() 包含正在写入的元素；
+ * - 每个消费者持有独立的 Cursor，读取互不影响；落后超过容量时游标
+ *   跳到最旧的有效元素并累计丢弃数；
+ * - 元素以 shared_ptr<const T> 形式共享，多个消费者读取同一元素无拷贝。
+ *
+ * 整个队列没有锁：槽位保存指向 Holder（序号 + 元素）的原子指针，
+ * 生产者用 CAS 安装，只会替换序号更小的 Holder，被抢先一圈的生产者
+ * 直接丢弃自己的元素；读者（以及比较序号的生产者）在槽位 readers
+ * 计数的保护下访问 Holder、复制 shared_ptr，
+ * 并按 Holder 中的序号判断未写入/已覆盖。被替换的 Holder 压入槽位的
+ * 回收栈，生产者取走整栈后看到 readers 为 0 才释放，否则放回。
+ */
+template <typename T> class BroadcastRing {
+public:
+  using ValuePtr = std::shared_ptr<const T>;
+
+  struct Cursor {
+    uint64_t next = 0;    // 下一个待读取的序号
+    uint64_t dropped = 0; // 因落后被覆盖而丢弃的元素数
+    uint64_t delivered = 0;
+  };
+
+  explicit BroadcastRing(size_t capacity)
+      : capacity_(RoundUpPowerOfTwo(capacity)), mask_(capacity_ - 1),
+        slots_(capacity_) {}
+
+  ~BroadcastRing() {
+    for (auto &slot : slots_) {
+      FreeList(slot.holder.load(std::memory_order_relaxed));
+      FreeList(slot.retired.load(std::memory_order_relaxed));
+    }
+  }
+
+  BroadcastRing(const BroadcastRing &) = delete;
+  BroadcastRing &operator=(const BroadcastRing &) = delete;
+
+  /**
+   * 发布一个元素
+   * @return 元素序号
+   */
+  uint64_t Publish(ValuePtr value) {
+    uint64_t seq = claim_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[seq & mask_];
+    Holder *holder = new Holder{seq, std::move(value), nullptr};
+    // 读取 old->seq 期间同样占用 readers，防止 old 被其它生产者释放
+    slot.readers.fetch_add(1, std::memory_order_seq_cst);
+    Holder *old = slot.holder.load(std::memory_order_seq_cst);
+    do {
+      if (old != nullptr && old->seq > seq) {
+        // 被领先一圈的生产者抢先写入，本元素从未可见
+        slot.readers.fetch_sub(1, std::memory_order_release);
+        delete holder;
+        return seq;
+      }
+    } while (!slot.holder.compare_exchange_weak(old, holder,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_seq_cst));
+    slot.readers.fetch_sub(1, std::memory_order_release);
+    if (old != nullptr) {
+      Retire(slot, old, old);
+    }
+    Reclaim(slot);
+    return seq;
+  }
+
+  /**
+   * 创建从当前最新位置开始读取的游标
+   */
+  Cursor NewCursor() const {
+    Cursor cursor;
+    cursor.next = claim_.load(std::memory_order_acquire);
+    return cursor;
+  }
+
+  /**
+   * 非阻塞读取
+   * @return 读取到元素返回true
+   */
+  bool TryRead(Cursor &cursor, ValuePtr &out) const {
+    for (;;) {
+      uint64_t head = claim_.load(std::memory_order_acquire);
+      if (cursor.next >= head) {
+        return false;
+      }
+      if (head - cursor.next > capacity_) {
+        uint64_t oldest = head - capacity_;
+        cursor.dropped += oldest - cursor.next;
+        cursor.next = oldest;
+      }
+
+      const Slot &slot = slots_[cursor.next & mask_];
+      slot.readers.fetch_add(1, std::memory_order_seq_cst);
+      const Holder *holder = slot.holder.load(std::memory_order_seq_cst);
+      if (holder == nullptr || holder->seq < cursor.next) {
+        slot.readers.fetch_sub(1, std::memory_order_release);
+        return false; // 尚未写完
+      }
+      if (holder->seq != cursor.next) {
+        slot.readers.fetch_sub(1, std::memory_order_release);
+        // 已被更新的元素覆盖
+        ++cursor.dropped;
+        ++cursor.next;
+        continue;
+      }
+      out = holder->value;
+      slot.readers.fetch_sub(1, std::memory_order_release);
+      ++cursor.next;
+      ++cursor.delivered;
+      return true;
+    }
+  }
+
+  /**
+   * 游标当前积压深度（不超过容量）
+   */
+  uint64_t Depth(const Cursor &cursor) const {
+    uint64_t head = claim_.load(std::memory_order_acquire);
+    if (cursor.next >= head) {
+      return 0;
+    }
+    uint64_t depth = head - cursor.next;
+    return depth > capacity_ ? capacity_ : depth;
+  }
+
+  uint64_t Published() const { return claim_.load(std::memory_order_acquire); }
+  size_t Capacity() const { return capacity_; }
+
+private:
+  struct Holder {
+    uint64_t seq;
+    ValuePtr value;
+    Holder *next; // 回收栈链接，入栈后才使用
+  };
+
+  struct Slot {
+    std::atomic<Holder *> holder{nullptr};
+    std::atomic<Holder *> retired{nullptr};
+    mutable std::atomic<uint32_t> readers{0};
+  };
+
+  // 把 [first, last] 这一段压入回收栈
+  static void Retire(Slot &slot, Holder *first, Holder *last) {
+    Holder *top = slot.retired.load(std::memory_order_relaxed);
+    do {
+      last->next = top;
+    } while (!slot.retired.compare_exchange_weak(top, first,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed));
+  }
+
+  // 取走整个回收栈：栈中的 Holder 都已被换出，此后没有读者时，
+  // 之后进入的读者只能读到槽位当前的 Holder，可以安全释放
+  static void Reclaim(Slot &slot) {
+    Holder *list = slot.retired.exchange(nullptr, std::memory_order_seq_cst);
+    if (list == nullptr) {
+      return;
+    }
+    if (slot.readers.load(std::memory_order_seq_cst) == 0) {
+      FreeList(list);
+      return;
+    }
+    Holder *last = list;
+    while (last->next != nullptr) {
+      last = last->next;
+    }
+    Retire(slot, list, last);
+  }
+
+  static void FreeList(Holder *list) {
+    while (list != nullptr) {
+      Holder *next = list->next;
+      delete list;
+      list = next;
+    }
+  }
+
+  static size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::vector<Slot> slots_;
+  alignas(64) std::atomic<uint64_t> claim_{0};
+};
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_COMMON_BROADCAST_RING_H
@@ -0,0 +1,189 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Lock-free log-linear latency histogram
+ */
+
+#ifndef HUMANOID_ROBOT_COMMON_LATENCY_HISTOGRAM_H
+#define HUMANOID_ROBOT_COMMON_LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+/**
+ * LatencyHistogram - 无锁对数线性直方图
+ *
+ * 每个2的幂区间再切分为8个子桶，相对误差不超过12.5%。
+ * Record() 只有几次 relaxed 原子操作，可在热路径上多线程并发调用；
+ * 读取侧得到的是近似一致的快照。
+ */
+class LatencyHistogram {
+public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr size_t kSubBucketCount = size_t{1} << kSubBucketBits;
+  static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) *
+                                         kSubBucketCount;
+
+  LatencyHistogram() { Reset(); }
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  /**
+   * 记录一个样本（单位由调用方决定，SDK内部统一使用纳秒）
+   */
+  void Record(uint64_t value) noexcept {
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (value > prev &&
+           !max_.compare_exchange_weak(prev, value,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * 单写者版本：只有一个线程写入时使用（如按线程分片），不使用读-改-写
+   * 原子操作；其他线程仍可并发读取和 Merge
+   */
+  void RecordSingleWriter(uint64_t value) noexcept {
+    auto &bucket = buckets_[BucketIndex(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    count_.store(count_.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_relaxed);
+    sum_.store(sum_.load(std::memory_order_relaxed) + value,
+               std::memory_order_relaxed);
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * 合并另一个直方图（用于分片汇总）
+   */
+  void Merge(const LatencyHistogram &other) noexcept {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      uint64_t n = other.buckets_[i].load(std::memory_order_relaxed);
+      if (n != 0) {
+        buckets_[i].fetch_add(n, std::memory_order_relaxed);
+      }
+    }
+    count_.fetch_add(other.Count(), std::memory_order_relaxed);
+    sum_.fetch_add(other.Sum(), std::memory_order_relaxed);
+    uint64_t other_max = other.Max();
+    uint64_t prev = max_.load(std::memory_order_relaxed);
+    while (other_max > prev &&
+           !max_.compare_exchange_weak(prev, other_max,
+                                       std::memory_order_relaxed)) {
+    }
+  }
+
+  void Reset() noexcept {
+    for (auto &bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t Count() const noexcept {
+    return count_.load(std::memory_order_relaxed);
+  }
+  uint64_t Sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+  uint64_t Max() const noexcept { return max_.load(std::memory_order_relaxed); }
+
+  double Mean() const noexcept {
+    uint64_t n = Count();
+    return n == 0 ? 0.0 : static_cast<double>(Sum()) / static_cast<double>(n);
+  }
+
+  /**
+   * 计算分位数
+   * @param quantile 取值 [0, 1]，例如 0.99
+   * @return 对应桶的上界（不超过记录到的最大值）
+   */
+  uint64_t Percentile(double quantile) const noexcept {
+    uint64_t total = 0;
+    for (const auto &bucket : buckets_) {
+      total += bucket.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+      return 0;
+    }
+    if (quantile < 0.0) {
+      quantile = 0.0;
+    } else if (quantile > 1.0) {
+      quantile = 1.0;
+    }
+    uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(total));
+    if (rank == 0) {
+      rank = 1;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; ++i) {
+      seen += buckets_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        uint64_t upper = BucketUpperBound(i);
+        uint64_t max = Max();
+        return upper < max ? upper : max;
+      }
+    }
+    return Max();
+  }
+
+  /**
+   * 桶计数（用于导出）
+   */
+  uint64_t BucketCountAt(size_t index) const noexcept {
+    return buckets_[index].load(std::memory_order_relaxed);
+  }
+
+  static size_t BucketIndex(uint64_t value) noexcept {
+    if (value < kSubBucketCount) {
+      return static_cast<size_t>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - kSubBucketBits;
+    return (static_cast<size_t>(msb - kSubBucketBits + 1) << kSubBucketBits) +
+           static_cast<size_t>((value >> shift) & (kSubBucketCount - 1));
+  }
+
+  static uint64_t BucketLowerBound(size_t index) noexcept {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+    int msb = static_cast<int>(index >> kSubBucketBits) + kSubBucketBits - 1;
+    uint64_t sub = index & (kSubBucketCount - 1);
+    return (kSubBucketCount + sub) << (msb - kSubBucketBits);
+  }
+
+  static uint64_t BucketUpperBound(size_t index) noexcept {
+    if (index < kSubBucketCount) {
+      return index;
+    }
+    int msb = static_cast<int>(index >> kSubBucketBits) + kSubBucketBits - 1;
+    return BucketLowerBound(index) + (uint64_t{1} << (msb - kSubBucketBits)) -
+           1;
+  }
+
+private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_;
+  std::atomic<uint64_t> max_;
+};
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_COMMON_LATENCY_HISTOGRAM_H
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Asynchronous structured logger
+ */
+
+#ifndef HUMANOID_ROBOT_COMMON_LOGGER_H
+#define HUMANOID_ROBOT_COMMON_LOGGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// 编译期日志级别：低于该级别的日志语句被整体消除
+// 0=trace 1=debug 2=info 3=warn 4=error 5=off
+#ifndef KONKA_SDK_LOG_COMPILE_LEVEL
+#define KONKA_SDK_LOG_COMPILE_LEVEL 1
+#endif
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+enum class LogLevel : int {
+  kTrace = 0,
+  kDebug = 1,
+  kInfo = 2,
+  kWarn = 3,
+  kError = 4,
+  kOff = 5
+};
+
+// 单条日志（消息 + 结构化字段）的最大长度，超出部分截断
+constexpr size_t kMaxLogText = 480;
+
+/**
+ * 一条日志记录
+ * text 前 message_length 字节为消息，其后为 " key=value" 形式的字段
+ */
+struct LogRecord {
+  int64_t time_ns = 0; // Unix 纳秒
+  LogLevel level = LogLevel::kInfo;
+  uint32_t thread_id = 0;
+  const char *module = "";
+  const char *file = "";
+  int line = 0;
+  uint16_t message_length = 0;
+  uint16_t length = 0;
+  char text[kMaxLogText];
+};
+
+using LogSink = std::function<void(const LogRecord &record)>;
+
+/**
+ * 日志统计
+ */
+struct LoggerStats {
+  uint64_t written = 0; // 已输出的记录数
+  uint64_t dropped = 0; // 线程缓冲区满而丢弃的记录数
+  uint64_t threads = 0; // 当前持有缓冲区的线程数
+};
+
+/**
+ * Logger - 异步结构化日志
+ *
+ * 每个线程拥有一个单生产者/单消费者无锁环形缓冲区，记录日志只做格式化和
+ * 一次拷贝，不加锁也不做系统调用；后台线程定期汇总各线程的缓冲区，
+ * 按批写出（默认 stderr，一批一次 write）。缓冲区满时丢弃新记录并计数，
+ * 不会阻塞调用线程。
+ *
+ * 默认运行期级别为 kWarn，可通过 SetLevel() 或环境变量
+ * KONKA_SDK_LOG_LEVEL(trace/debug/info/warn/error/off) 调整。
+ */
+class Logger {
+public:
+  static Logger &Instance();
+
+  void SetLevel(LogLevel level) {
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
+  }
+
+  LogLevel Level() const {
+    return static_cast<LogLevel>(level_.load(std::memory_order_relaxed));
+  }
+
+  bool ShouldLog(LogLevel level) const {
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * 替换输出目标，在后台线程上逐条调用；传入空函数恢复默认 stderr 输出
+   */
+  void SetSink(LogSink sink);
+
+  /**
+   * 提交一条记录（由 LogLine 调用）
+   */
+  void Submit(const LogRecord &record);
+
+  /**
+   * 同步输出所有线程中已提交的记录
+   */
+  void Flush();
+
+  LoggerStats GetStats() const;
+
+private:
+  class Impl;
+
+  Logger();
+  ~Logger() = delete;
+
+  std::atomic<int> level_;
+  Impl *impl_;
+
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+};
+
+/**
+ * LogLine - 单条日志的构造器，析构时提交
+ *
+ * 用法：
+ *   KONKA_LOG_WARN("control").Field("command", command_id)
+ *       << "Write request failed";
+ * 消息用 << 追加，结构化字段用 Field() 追加，输出时字段排在消息之后。
+ */
+class LogLine {
+public:
+  LogLine(LogLevel level, const char *module, const char *file, int line);
+  ~LogLine();
+
+  LogLine &operator<<(std::string_view value) {
+    Append(message_, message_length_, kMaxLogText, value);
+    return *this;
+  }
+  LogLine &operator<<(const char *value) {
+    return *this << std::string_view(value != nullptr ? value : "(null)");
+  }
+  LogLine &operator<<(const std::string &value) {
+    return *this << std::string_view(value);
+  }
+  LogLine &operator<<(char value) { return *this << std::string_view(&value, 1); }
+  LogLine &operator<<(bool value) {
+    return *this << std::string_view(value ? "true" : "false");
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value ||
+                              std::is_enum<T>::value,
+                          LogLine &>::type
+  operator<<(T value) {
+    char buffer[32];
+    return *this << std::string_view(buffer, FormatNumber(buffer, value));
+  }
+
+  LogLine &Field(std::string_view key, std::string_view value);
+  LogLine &Field(std::string_view key, const char *value) {
+    return Field(key, std::string_view(value != nullptr ? value : "(null)"));
+  }
+  LogLine &Field(std::string_view key, const std::string &value) {
+    return Field(key, std::string_view(value));
+  }
+  LogLine &Field(std::string_view key, bool value) {
+    return Field(key, std::string_view(value ? "true" : "false"));
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_arithmetic<T>::value ||
+                              std::is_enum<T>::value,
+                          LogLine &>::type
+  Field(std::string_view key, T value) {
+    char buffer[32];
+    return Field(key, std::string_view(buffer, FormatNumber(buffer, value)));
+  }
+
+private:
+  template <typename T> static size_t FormatNumber(char *buffer, T value) {
+    if constexpr (std::is_enum<T>::value) {
+      return FormatInteger(
+          buffer, static_cast<int64_t>(
+                      static_cast<typename std::underlying_type<T>::type>(
+                          value)));
+    } else if constexpr (std::is_floating_point<T>::value) {
+      return FormatDouble(buffer, static_cast<double>(value));
+    } else if constexpr (std::is_signed<T>::value) {
+      return FormatInteger(buffer, static_cast<int64_t>(value));
+    } else {
+      return FormatUnsigned(buffer, static_cast<uint64_t>(value));
+    }
+  }
+
+  static size_t FormatInteger(char *buffer, int64_t value);
+  static size_t FormatUnsigned(char *buffer, uint64_t value);
+  static size_t FormatDouble(char *buffer, double value);
+  static void Append(char *target, size_t &length, size_t capacity,
+                     std::string_view value);
+
+  LogLevel level_;
+  const char *module_;
+  const char *file_;
+  int line_;
+  size_t message_length_ = 0;
+  size_t fields_length_ = 0;
+  char message_[kMaxLogText];
+  char fields_[kMaxLogText];
+};
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+// 第一个条件为编译期常量，低于编译期级别的语句连同参数求值一起被消除；
+// if/else 结构保证宏可以安全地用在不带花括号的 if 语句中
+#define KONKA_LOG(level, module)                                               \
+  if (static_cast<int>(level) < KONKA_SDK_LOG_COMPILE_LEVEL ||                 \
+      !::humanoid_robot::konka_sdk::common::Logger::Instance().ShouldLog(      \
+          level)) {                                                            \
+  } else                                                                       \
+    ::humanoid_robot::konka_sdk::common::LogLine(level, module, __FILE__,      \
+                                                 __LINE__)
+
+#define KONKA_LOG_TRACE(module)                                                \
+  KONKA_LOG(::humanoid_robot::konka_sdk::common::LogLevel::kTrace, module)
+#define KONKA_LOG_DEBUG(module)                                                \
+  KONKA_LOG(::humanoid_robot::konka_sdk::common::LogLevel::kDebug, module)
+#define KONKA_LOG_INFO(module)                                                 \
+  KONKA_LOG(::humanoid_robot::konka_sdk::common::LogLevel::kInfo, module)
+#define KONKA_LOG_WARN(module)                                                 \
+  KONKA_LOG(::humanoid_robot::konka_sdk::common::LogLevel::kWarn, module)
+#define KONKA_LOG_ERROR(module)                                                \
+  KONKA_LOG(::humanoid_robot::konka_sdk::common::LogLevel::kError, module)
+
+#endif // HUMANOID_ROBOT_COMMON_LOGGER_H
@@ -0,0 +1,284 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * In-process metrics registry with Prometheus text export
+ */
+
+#ifndef HUMANOID_ROBOT_COMMON_METRICS_H
+#define HUMANOID_ROBOT_COMMON_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "robot/common/status.h"
+#include "robot/common/tracing.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+/**
+ * 请求阶段
+ */
+enum class MetricPhase : int {
+  kTotal = 0,        // 整个请求
+  kEnvelopeBuild,    // 构建 SendRequest 信封（含业务数据序列化）
+  kStreamOpen,       // 打开 gRPC 流
+  kWrite,            // 写出请求
+  kServerWait,       // 等待服务端响应
+  kParse,            // 解析响应
+  kCount
+};
+
+/**
+ * 错误类别，与 InterfacesClient::ConvertGrpcStatus 的映射一致，
+ * 另加 SDK 自身的未连接和解析失败
+ */
+enum class MetricErrorCategory : int {
+  kNotConnected = 0,
+  kCancelled,
+  kTimedOut,
+  kNotFound,
+  kAlreadyExists,
+  kPermissionDenied,
+  kUnavailable,
+  kUnimplemented,
+  kIoError,
+  kParse,
+  kCount
+};
+
+const char *MetricPhaseName(MetricPhase phase);
+const char *MetricErrorCategoryName(MetricErrorCategory category);
+
+/**
+ * 把 Status 的错误码归类
+ */
+MetricErrorCategory ErrorCategoryOf(const std::error_code &code);
+
+// 常用的方法名，作为指标的 method 标签
+constexpr const char *kMetricMethodSend = "Send";
+constexpr const char *kMetricMethodQuery = "Query";
+constexpr const char *kMetricMethodSubscribe = "Subscribe";
+constexpr const char *kMetricMethodUnsubscribe = "Unsubscribe";
+// 一个信封打包多帧的批量请求
+constexpr const char *kMetricMethodSendBatch = "SendBatch";
+
+/**
+ * 指标键：方法名（须为静态字符串）+ 命令码（无命令码的 RPC 为 0）
+ */
+struct MetricKey {
+  const char *method;
+  int32_t command;
+
+  bool operator<(const MetricKey &other) const;
+};
+
+/**
+ * 单个阶段的汇总
+ */
+struct PhaseMetrics {
+  uint64_t count = 0;
+  uint64_t sum_ns = 0;
+  uint64_t max_ns = 0;
+  uint64_t p50_ns = 0;
+  uint64_t p99_ns = 0;
+  uint64_t p999_ns = 0;
+};
+
+/**
+ * 批量请求每批条数的汇总
+ */
+struct BatchSizeMetrics {
+  uint64_t count = 0; // 批次数
+  uint64_t sum = 0;   // 条数之和
+  uint64_t max = 0;
+  uint64_t p50 = 0;
+  uint64_t p99 = 0;
+};
+
+/**
+ * 单个命令的汇总
+ */
+struct CommandMetrics {
+  std::array<PhaseMetrics, static_cast<size_t>(MetricPhase::kCount)> phases;
+  std::array<uint64_t, static_cast<size_t>(MetricErrorCategory::kCount)>
+      errors{};
+  BatchSizeMetrics batch_size; // 只有批量请求有数据
+
+  const PhaseMetrics &Phase(MetricPhase phase) const {
+    return phases[static_cast<size_t>(phase)];
+  }
+  uint64_t Errors(MetricErrorCategory category) const {
+    return errors[static_cast<size_t>(category)];
+  }
+};
+
+using MetricsSnapshot = std::map<MetricKey, CommandMetrics>;
+
+/**
+ * MetricsRegistry - 进程内指标注册表
+ *
+ * 每个线程写自己的分片（按命令懒创建对数线性直方图），记录时只有一次
+ * 线程局部查找和几次无竞争的 relaxed 原子操作；读取时合并所有分片。
+ * 线程退出时其分片并入注册表，数据不会丢失。
+ *
+ * 导出为 Prometheus 文本格式：拉取方式调用 ExportPrometheus()，
+ * 或用 StartFileDump() 周期性写文件（配合 node_exporter textfile collector）。
+ */
+class MetricsRegistry {
+public:
+  static MetricsRegistry &Instance();
+
+  /**
+   * 关闭后记录接口直接返回
+   */
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void RecordLatency(const MetricKey &key, MetricPhase phase,
+                     uint64_t latency_ns);
+  void RecordError(const MetricKey &key, MetricErrorCategory category);
+  /**
+   * 记录一个批量请求打包的条数
+   */
+  void RecordBatchSize(const MetricKey &key, uint64_t items);
+
+  /**
+   * 合并所有分片得到当前快照
+   */
+  MetricsSnapshot Snapshot() const;
+
+  /**
+   * 清空所有指标
+   */
+  void Reset();
+
+  /**
+   * Prometheus 文本格式（histogram 单位为秒）
+   */
+  std::string ExportPrometheus() const;
+
+  /**
+   * 以 Prometheus 文本格式写文件（先写临时文件再重命名）
+   */
+  Status WriteToFile(const std::string &path) const;
+
+  /**
+   * 启动后台线程，每 interval_ms 写一次文件
+   */
+  Status StartFileDump(const std::string &path, int64_t interval_ms = 10000);
+  void StopFileDump();
+
+private:
+  class Impl;
+
+  MetricsRegistry();
+  ~MetricsRegistry() = delete;
+
+  std::atomic<bool> enabled_{true};
+  Impl *impl_;
+
+  MetricsRegistry(const MetricsRegistry &) = delete;
+  MetricsRegistry &operator=(const MetricsRegistry &) = delete;
+};
+
+/**
+ * RequestTimer - 按阶段计时一次请求
+ *
+ * 用法：
+ *   RequestTimer timer(kMetricMethodSend, command_id);
+ *   ... 构建请求 ...
+ *   timer.Mark(MetricPhase::kEnvelopeBuild);
+ *   ... 打开流 ...
+ *   timer.Mark(MetricPhase::kStreamOpen);
+ * Mark() 把距上一次标记的耗时记到给定阶段；析构时记录整个请求的耗时。
+ *
+ * 同时为请求开启一个 span，每个阶段记录为它的子 span；
+ * 请求期间该 span 是当前线程的当前 span，InterfacesClient 据此在 gRPC
+ * 元数据中传递追踪上下文。
+ */
+class RequestTimer {
+public:
+  /**
+   * @param span_name span 名称（静态字符串），为空时使用方法名
+   * @param category span 类别（静态字符串）
+   */
+  RequestTimer(const char *method, int32_t command,
+               const char *span_name = nullptr,
+               const char *category = "request")
+      : key_{method, command},
+        enabled_(MetricsRegistry::Instance().IsEnabled()),
+        span_(span_name != nullptr ? span_name : method, category, command) {
+    if (enabled_ || span_.IsActive()) {
+      start_ = last_ = Clock::now();
+    }
+  }
+
+  ~RequestTimer() {
+    if (enabled_) {
+      MetricsRegistry::Instance().RecordLatency(
+          key_, MetricPhase::kTotal, ElapsedNs(start_, Clock::now()));
+    }
+  }
+
+  void Mark(MetricPhase phase) {
+    if (!enabled_ && !span_.IsActive()) {
+      return;
+    }
+    auto now = Clock::now();
+    if (enabled_) {
+      MetricsRegistry::Instance().RecordLatency(key_, phase,
+                                                ElapsedNs(last_, now));
+    }
+    if (span_.IsActive()) {
+      span_.RecordChild(
+          MetricPhaseName(phase),
+          span_.StartNs() + static_cast<int64_t>(ElapsedNs(start_, last_)),
+          span_.StartNs() + static_cast<int64_t>(ElapsedNs(start_, now)));
+    }
+    last_ = now;
+  }
+
+  void Fail(MetricErrorCategory category) {
+    span_.SetError();
+    if (enabled_) {
+      MetricsRegistry::Instance().RecordError(key_, category);
+    }
+  }
+
+  void Fail(const Status &status) { Fail(ErrorCategoryOf(status.code())); }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  static uint64_t ElapsedNs(Clock::time_point from, Clock::time_point to) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(to - from)
+            .count());
+  }
+
+  MetricKey key_;
+  bool enabled_;
+  TraceSpan span_;
+  Clock::time_point start_;
+  Clock::time_point last_;
+
+  RequestTimer(const RequestTimer &) = delete;
+  RequestTimer &operator=(const RequestTimer &) = delete;
+};
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_COMMON_METRICS_H
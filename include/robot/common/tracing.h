@@ -0,0 +1,184 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Request tracing with an in-memory span ring
+ */
+
+#ifndef HUMANOID_ROBOT_COMMON_TRACING_H
+#define HUMANOID_ROBOT_COMMON_TRACING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+// gRPC 元数据中传递追踪上下文的键（W3C Trace Context 格式）
+constexpr const char *kTraceparentKey = "traceparent";
+
+/**
+ * 追踪上下文：128 位 trace id + 当前 span id
+ */
+struct TraceContext {
+  uint64_t trace_id_high = 0;
+  uint64_t trace_id_low = 0;
+  uint64_t span_id = 0;
+
+  bool IsValid() const {
+    return (trace_id_high != 0 || trace_id_low != 0) && span_id != 0;
+  }
+
+  /**
+   * 00-<trace id 32 位十六进制>-<span id 16 位十六进制>-01
+   */
+  std::string ToTraceparent() const;
+
+  static bool FromTraceparent(const std::string &value, TraceContext *context);
+};
+
+/**
+ * 一个已结束的 span
+ */
+struct SpanRecord {
+  uint64_t trace_id_high = 0;
+  uint64_t trace_id_low = 0;
+  uint64_t span_id = 0;
+  uint64_t parent_span_id = 0;
+  const char *name = "";     // 须为静态字符串
+  const char *category = ""; // 须为静态字符串
+  int32_t command = 0;
+  uint32_t thread_id = 0;
+  int64_t start_ns = 0; // Unix 纳秒
+  int64_t end_ns = 0;
+  bool error = false;
+};
+
+/**
+ * 追踪统计
+ */
+struct TracerStats {
+  uint64_t recorded = 0;    // 累计写入的 span 数
+  uint64_t overwritten = 0; // 因环形缓冲回绕被覆盖的 span 数
+};
+
+/**
+ * Tracer - span 收集器
+ *
+ * 已结束的 span 写入固定大小的无锁环形缓冲（多写者，每个槽位由序列锁保护），
+ * 写满后覆盖最旧的记录，相当于常驻的“飞行记录仪”。需要时调用
+ * ExportChromeTrace() 导出为 Chrome trace-event JSON，可在
+ * chrome://tracing 或 Perfetto 中查看。
+ *
+ * 默认开启，可通过 SetEnabled() 或环境变量 KONKA_SDK_TRACE=0 关闭。
+ */
+class Tracer {
+public:
+  static constexpr size_t kCapacity = 8192;
+
+  static Tracer &Instance();
+
+  void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  void Record(const SpanRecord &record);
+
+  /**
+   * 按开始时间排序的 span 快照
+   */
+  std::vector<SpanRecord> Collect() const;
+
+  /**
+   * 丢弃调用时刻之前领取序号的全部 span（含正在写入的），之后记录的
+   * span 不受影响；只移动水位线、不改写槽位，可与 Record() 并发调用
+   */
+  void Clear();
+
+  std::string ExportChromeTrace() const;
+
+  Status WriteChromeTrace(const std::string &path) const;
+
+  TracerStats GetStats() const;
+
+  /**
+   * 当前线程上正在进行的 span 的上下文（没有时无效）
+   */
+  static TraceContext Current();
+
+  static int64_t NowNs();
+
+private:
+  class Impl;
+
+  Tracer();
+  ~Tracer() = delete;
+
+  std::atomic<bool> enabled_;
+  Impl *impl_;
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+};
+
+/**
+ * TraceSpan - RAII span
+ *
+ * 构造时成为当前线程的当前 span，其父 span 为构造前的当前 span
+ * （没有时开启新的 trace）；析构时结束并写入 Tracer。
+ * 同一线程上的 span 须按后进先出的顺序结束。
+ */
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name, const char *category = "sdk",
+                     int32_t command = 0);
+
+  /**
+   * 以远端上下文为父 span（例如从 gRPC 元数据中取出的 traceparent）
+   */
+  TraceSpan(const char *name, const TraceContext &parent,
+            const char *category = "sdk", int32_t command = 0);
+
+  ~TraceSpan();
+
+  bool IsActive() const { return active_; }
+  const TraceContext &Context() const { return context_; }
+  int64_t StartNs() const { return start_ns_; }
+
+  void SetError() { error_ = true; }
+
+  /**
+   * 记录一个已结束的子 span（时间由调用方给出）
+   */
+  void RecordChild(const char *name, int64_t start_ns, int64_t end_ns,
+                   bool error = false) const;
+
+private:
+  void Begin(const char *name, const char *category, int32_t command,
+             const TraceContext *parent);
+
+  bool active_ = false;
+  bool error_ = false;
+  const char *name_ = "";
+  const char *category_ = "";
+  int32_t command_ = 0;
+  TraceContext context_;
+  uint64_t parent_span_id_ = 0;
+  int64_t start_ns_ = 0;
+  const TraceContext *previous_ = nullptr;
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+};
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_COMMON_TRACING_H
@@ -0,0 +1,94 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_COMPACT_CODEC
+#define HUMANOID_ROBOT_INTERFACES_COMPACT_CODEC
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ros2/geometry_msgs/Pose.pb.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace compact_codec {
+
+/**
+ * 紧凑定长编码（小端）
+ *
+ * 仅用于白名单中的小型高频消息，编码结果仍放在 Variant 的 bytevalue 中：
+ *   byte 0      版本号 kCompactCodecVersion
+ *   byte 1      类型ID CompactTraits<T>::kTypeId
+ *   byte 2..    按字段顺序排列的小端定长数据
+ * 是否启用通过 InterfacesClient::NegotiateCapabilities 握手决定，
+ * 未协商成功时一律回退为 protobuf 编码。
+ */
+constexpr uint8_t kCompactCodecVersion = 1;
+constexpr size_t kCompactHeaderSize = 2;
+
+// 握手时使用的能力名称
+constexpr const char* kCompactCodecCapability = "codec.compact.v1";
+// 请求/响应字典中标记本条数据编码方式的key与取值
+constexpr const char* kCodecKey = "codec";
+constexpr const char* kCompactCodecName = "compact.v1";
+// 请求字典中声明响应可使用紧凑编码的key，取值同 kCompactCodecName
+constexpr const char* kAcceptCodecKey = "accept_codec";
+
+using Pose = humanoid_robot::PB::ros2::geometry_msgs::Pose;
+
+/**
+ * 白名单类型特征，未特化的类型不支持紧凑编码
+ */
+template <typename T>
+struct CompactTraits {
+  static constexpr bool kSupported = false;
+};
+
+template <>
+struct CompactTraits<Pose> {
+  static constexpr bool kSupported = true;
+  static constexpr uint8_t kTypeId = 1;
+  // position(x,y,z) + orientation(x,y,z,w)
+  static constexpr size_t kPayloadSize = 7 * sizeof(double);
+
+  static void Encode(const Pose& pose, uint8_t* out);
+  static void Decode(const uint8_t* in, Pose* pose);
+};
+
+/**
+ * 编码为紧凑格式，out 会被覆盖
+ */
+template <typename T>
+bool EncodeCompact(const T& message, std::string* out) {
+  static_assert(CompactTraits<T>::kSupported,
+                "Type is not whitelisted for the compact codec");
+  out->resize(kCompactHeaderSize + CompactTraits<T>::kPayloadSize);
+  auto* data = reinterpret_cast<uint8_t*>(&(*out)[0]);
+  data[0] = kCompactCodecVersion;
+  data[1] = CompactTraits<T>::kTypeId;
+  CompactTraits<T>::Encode(message, data + kCompactHeaderSize);
+  return true;
+}
+
+/**
+ * 从紧凑格式解码，版本号、类型ID或长度不匹配时返回false
+ */
+template <typename T>
+bool DecodeCompact(const std::string& in, T* message) {
+  static_assert(CompactTraits<T>::kSupported,
+                "Type is not whitelisted for the compact codec");
+  if (in.size() != kCompactHeaderSize + CompactTraits<T>::kPayloadSize) {
+    return false;
+  }
+  const auto* data = reinterpret_cast<const uint8_t*>(in.data());
+  if (data[0] != kCompactCodecVersion || data[1] != CompactTraits<T>::kTypeId) {
+    return false;
+  }
+  CompactTraits<T>::Decode(data + kCompactHeaderSize, message);
+  return true;
+}
+
+}  // namespace compact_codec
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_COMPACT_CODEC
@@ -0,0 +1,127 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_CONTROL_DEADMAN
+#define HUMANOID_ROBOT_INTERFACES_CONTROL_DEADMAN
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "robot/common/status.h"
+#include "robot/modules/control_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace control_api {
+
+using Status = humanoid_robot::konka_sdk::common::Status;
+
+// 心跳请求使用的命令码，网关需原样回显 heartbeat_seq
+constexpr int32_t kDeadmanHeartbeatCommandId = 0x7F01;
+// 网关支持心跳回显时在能力握手中接受该能力
+constexpr const char* kDeadmanHeartbeatCapability = "control.deadman.v1";
+
+/**
+ * @brief 死人开关配置
+ */
+struct DeadmanOptions {
+  // 心跳发送频率(Hz)
+  double heartbeat_hz = 100.0;
+  // 单次心跳往返时间上限(ms)，超过即触发
+  int64_t max_rtt_ms = 50;
+  // 连续未收到心跳回执的最长时间(ms)，超过即触发
+  int64_t max_gap_ms = 100;
+  // 应用未调用 Feed() 的最长时间(ms)，超过视为应用卡死；<=0 表示不检测
+  int64_t app_stall_timeout_ms = 100;
+  // 触发时是否在本地下发 EmergencyStop
+  bool trigger_emergency_stop = true;
+  // 心跳流的 gRPC 截止时间(ms)
+  int64_t stream_timeout_ms = 24LL * 3600 * 1000;
+};
+
+enum class DeadmanTripReason {
+  kNone = 0,
+  kAppStalled,     // 应用超时未喂狗
+  kRttExceeded,    // 往返时间超限
+  kHeartbeatGap,   // 心跳回执中断
+  kStreamBroken,   // 心跳流异常结束
+};
+
+/**
+ * @brief 死人开关运行统计
+ *
+ * 时间单位均为微秒。detection_latency_us 为从最后一次有效信号
+ * （喂狗或心跳回执）到判定触发的时间，上界约为对应阈值加一个心跳周期。
+ */
+struct DeadmanStats {
+  uint64_t heartbeats_sent = 0;
+  uint64_t heartbeats_acked = 0;
+  uint64_t rtt_p50_us = 0;
+  uint64_t rtt_p99_us = 0;
+  uint64_t rtt_max_us = 0;
+  DeadmanTripReason trip_reason = DeadmanTripReason::kNone;
+  int64_t detection_latency_us = 0;
+  int64_t stop_request_latency_us = 0;
+  ControlResStatus stop_status = ControlResStatus::ERROR_DATA_GET_FAILED;
+  bool heartbeat_echo = false; // 是否使用心跳回显（否则按写入成功判定）
+};
+
+using DeadmanTripCallback =
+    std::function<void(DeadmanTripReason, const DeadmanStats &)>;
+
+/**
+ * DeadmanSession - 控制通道死人开关
+ *
+ * 通过常驻 Send 流按固定频率发送心跳并统计往返时间；应用需周期性调用
+ * Feed()。当应用卡死、往返时间超限或心跳回执中断时，会在本地立即下发
+ * EmergencyStop，而不必等待运动指令流的截止时间到期。
+ * 触发后会话停止发送心跳，需 Stop() 后重新 Start()。
+ *
+ * 网关接受 kDeadmanHeartbeatCapability 时按 heartbeat_seq 回执判定存活并
+ * 统计往返时间；否则退化为按心跳写入成功判定，max_gap_ms 约束的是连续
+ * 写入失败或阻塞的时间，max_rtt_ms 不生效。
+ */
+class DeadmanSession {
+public:
+  explicit DeadmanSession(std::unique_ptr<InterfacesClient> &client,
+                          DeadmanOptions options = DeadmanOptions());
+  ~DeadmanSession();
+
+  /**
+   * 建立心跳流并启动心跳/回执线程
+   * 需先用 NegotiateCapabilities 协商 kDeadmanHeartbeatCapability 才启用回显
+   */
+  Status Start();
+
+  /**
+   * 停止心跳并关闭心跳流
+   */
+  void Stop();
+
+  /**
+   * 应用侧喂狗，需以高于 app_stall_timeout_ms 的频率调用
+   */
+  void Feed();
+
+  bool IsRunning() const;
+  bool IsTripped() const;
+
+  /**
+   * 注册触发回调（在监控线程中执行，需在 Start() 之前设置）
+   */
+  void SetTripCallback(DeadmanTripCallback callback);
+
+  DeadmanStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  DeadmanSession(const DeadmanSession &) = delete;
+  DeadmanSession &operator=(const DeadmanSession &) = delete;
+};
+
+}  // namespace control_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_CONTROL_DEADMAN
@@ -0,0 +1,129 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_DETECTION_STORE
+#define HUMANOID_ROBOT_INTERFACES_DETECTION_STORE
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+/**
+ * @brief 三维坐标(m)
+ */
+struct Vec3 {
+  double x = 0.0;
+  double y = 0.0;
+  double z = 0.0;
+};
+
+/**
+ * @brief 图像坐标系下的二维框(像素)
+ */
+struct Box2D {
+  float x_min = 0.0f;
+  float y_min = 0.0f;
+  float x_max = 0.0f;
+  float y_max = 0.0f;
+
+  bool Empty() const { return x_max <= x_min || y_max <= y_min; }
+  float Area() const { return Empty() ? 0.0f : (x_max - x_min) * (y_max - y_min); }
+};
+
+/**
+ * @brief 存储中的一条检测结果
+ */
+struct TrackedDetection {
+  uint64_t track_id = 0;     // 跟踪ID，0 表示无跟踪ID
+  int32_t class_id = 0;
+  float score = 0.0f;
+  uint32_t camera = 0;       // 二维框所属相机
+  Box2D box;                 // 为空或含 NaN 表示没有二维框
+  bool has_position = false;
+  Vec3 position;             // 机器人坐标系下的三维位置，非有限值不参与查询
+  int64_t timestamp_ns = 0;  // 检测时间(steady_clock)
+};
+
+/**
+ * @brief 检测存储配置
+ */
+struct DetectionStoreOptions {
+  // 超过该时长的检测在下一次写入时过期
+  int64_t max_age_ms = 2000;
+  // 三维网格边长(m)，建议取常用查询半径的量级
+  double cell_size_m = 1.0;
+  // 二维网格边长(像素)
+  float cell_size_px = 64.0f;
+  // 相同 track_id 的新检测替换旧检测
+  bool replace_by_track_id = true;
+};
+
+/**
+ * DetectionStore - 带时间窗口的检测结果空间索引
+ *
+ * 三维位置与二维框各维护一张均匀网格，网格以 CSR 形式紧凑存放
+ * （每个桶的条目连续排列并内联坐标），查询只访问相关桶，
+ * 数千个目标时区域、最近邻和框重叠查询均在微秒级完成。
+ *
+ * 写入按帧批量进行：InsertFrame 一次完成插入、过期淘汰和索引重建。
+ * 查询之间可并发执行，写入与查询互斥。
+ */
+class DetectionStore {
+public:
+  explicit DetectionStore(DetectionStoreOptions options = DetectionStoreOptions());
+  ~DetectionStore();
+
+  /**
+   * 批量写入一帧检测结果并淘汰早于 now_ns - max_age 的检测
+   */
+  void InsertFrame(const std::vector<TrackedDetection>& detections, int64_t now_ns);
+
+  /**
+   * 仅执行过期淘汰
+   */
+  void Expire(int64_t now_ns);
+
+  void Clear();
+  size_t Size() const;
+
+  /**
+   * 三维位置与 center 距离不超过 radius 的检测
+   */
+  size_t QueryRadius(const Vec3& center, double radius,
+                     std::vector<TrackedDetection>& out) const;
+
+  /**
+   * 三维位置落在轴对齐包围盒 [min_corner, max_corner] 内的检测
+   */
+  size_t QueryRegion(const Vec3& min_corner, const Vec3& max_corner,
+                     std::vector<TrackedDetection>& out) const;
+
+  /**
+   * 距离 point 最近的 k 个检测，按距离升序
+   */
+  size_t QueryNearest(const Vec3& point, size_t k,
+                      std::vector<TrackedDetection>& out) const;
+
+  /**
+   * 二维框与 box 重叠且 IoU 不低于 min_iou 的检测
+   * @param camera 相机编号，负数表示不限相机
+   */
+  size_t QueryBoxOverlap(const Box2D& box, std::vector<TrackedDetection>& out,
+                         float min_iou = 0.0f, int64_t camera = -1) const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  DetectionStore(const DetectionStore&) = delete;
+  DetectionStore& operator=(const DetectionStore&) = delete;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_DETECTION_STORE
@@ -0,0 +1,144 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_DETECTION_STREAM
+#define HUMANOID_ROBOT_INTERFACES_DETECTION_STREAM
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "interfaces/interfaces_callback.pb.h"
+#include "robot/common/broadcast_ring.h"
+#include "robot/common/status.h"
+#include "robot/modules/perception_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+using Status = humanoid_robot::konka_sdk::common::Status;
+using Notification = humanoid_robot::PB::interfaces::Notification;
+
+// 检测结果推送的事件类型
+constexpr const char* kDetectionEventType = "perception.detection";
+
+/**
+ * @brief 检测结果帧
+ */
+struct DetectionFrame {
+  uint64_t sequence = 0;    // 流内序号
+  int64_t receive_ns = 0;   // 客户端接收时间(steady_clock)
+  ResponseDetection detection;
+};
+
+using DetectionFramePtr = std::shared_ptr<const DetectionFrame>;
+using DetectionRing = humanoid_robot::konka_sdk::common::BroadcastRing<DetectionFrame>;
+
+/**
+ * @brief 检测流统计
+ */
+struct DetectionStreamStats {
+  uint64_t published = 0;       // 已发布帧数
+  uint64_t parse_failures = 0;  // 解析失败帧数
+  uint64_t consumers = 0;       // 当前消费者数
+  uint64_t max_depth = 0;       // 所有消费者中最大积压
+  uint64_t dropped = 0;         // 所有消费者累计丢帧
+};
+
+class DetectionStream;
+
+/**
+ * DetectionConsumer - 检测流消费者
+ *
+ * 每个消费者拥有独立游标，慢消费者只会丢弃最旧的帧，
+ * 不会阻塞生产者或其他消费者。同一消费者对象不可多线程并发读取。
+ */
+class DetectionConsumer {
+public:
+  ~DetectionConsumer();
+
+  /**
+   * 非阻塞读取下一帧
+   */
+  bool TryNext(DetectionFramePtr& frame);
+
+  /**
+   * 阻塞读取下一帧，超时返回false
+   */
+  bool Next(DetectionFramePtr& frame, std::chrono::milliseconds timeout);
+
+  uint64_t Dropped() const { return dropped_.load(std::memory_order_relaxed); }
+  uint64_t Delivered() const {
+    return delivered_.load(std::memory_order_relaxed);
+  }
+  uint64_t Depth() const;
+
+private:
+  friend class DetectionStream;
+  explicit DetectionConsumer(std::shared_ptr<DetectionStream> stream);
+  void SyncCounters();
+
+  std::shared_ptr<DetectionStream> stream_;
+  DetectionRing::Cursor cursor_;
+  // 供统计线程读取的游标镜像
+  std::atomic<uint64_t> position_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> delivered_{0};
+};
+
+/**
+ * DetectionStream - 连续检测结果流
+ *
+ * 数据来源可以是 Action 流式请求，也可以是 "perception.detection"
+ * 订阅推送（将 OnNotification 接入 ClientCallbackServer 回调）。
+ * 结果写入有界广播队列，满时丢弃最旧帧，保证感知延迟有界。
+ */
+class DetectionStream : public std::enable_shared_from_this<DetectionStream> {
+public:
+  static std::shared_ptr<DetectionStream> Create(size_t capacity = 64);
+  ~DetectionStream();
+
+  /**
+   * 通过 Action 流式请求持续获取检测结果（后台线程读取）
+   */
+  Status StartFromAction(std::unique_ptr<InterfacesClient>& client,
+                         const RequestDetection& request_detection);
+
+  /**
+   * 停止 Action 读取线程
+   */
+  void Stop();
+
+  /**
+   * 订阅推送入口，缺少 event_type 或非检测事件会被忽略
+   */
+  void OnNotification(const Notification& notification);
+
+  /**
+   * 直接发布一帧检测结果
+   */
+  uint64_t Publish(ResponseDetection detection);
+
+  /**
+   * 创建消费者，从当前最新位置开始读取
+   */
+  std::unique_ptr<DetectionConsumer> Subscribe();
+
+  DetectionStreamStats GetStats() const;
+
+private:
+  friend class DetectionConsumer;
+  explicit DetectionStream(size_t capacity);
+
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  DetectionStream(const DetectionStream&) = delete;
+  DetectionStream& operator=(const DetectionStream&) = delete;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_DETECTION_STREAM
@@ -0,0 +1,156 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_IMAGE_PREPROCESS
+#define HUMANOID_ROBOT_INTERFACES_IMAGE_PREPROCESS
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+using Status = humanoid_robot::konka_sdk::common::Status;
+
+/**
+ * @brief 像素格式（8位交错存储）
+ */
+enum class PixelFormat : uint8_t {
+  kBGR8 = 0,
+  kRGB8 = 1,
+  kGray8 = 2,
+};
+
+inline int PixelChannels(PixelFormat format) {
+  return format == PixelFormat::kGray8 ? 1 : 3;
+}
+
+/**
+ * @brief 图像视图（不持有数据）
+ */
+struct ImageView {
+  const uint8_t* data = nullptr;
+  int width = 0;
+  int height = 0;
+  size_t stride = 0;  // 行字节数，0 表示紧密排列
+  PixelFormat format = PixelFormat::kBGR8;
+
+  size_t RowBytes() const {
+    return static_cast<size_t>(width) * PixelChannels(format);
+  }
+  size_t Stride() const { return stride != 0 ? stride : RowBytes(); }
+  // 紧密排列时的总字节数
+  size_t ByteSize() const { return RowBytes() * static_cast<size_t>(height); }
+};
+
+/**
+ * @brief 感兴趣区域，宽或高为 0 表示整幅图像
+ */
+struct ImageRoi {
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+
+  bool Empty() const { return width <= 0 || height <= 0; }
+};
+
+/**
+ * @brief 预处理配置，执行顺序为 裁剪 -> 缩放 -> 颜色转换
+ */
+struct PreprocessOptions {
+  ImageRoi roi;
+  // 输出尺寸，0 表示与 ROI 相同（不缩放）
+  int out_width = 0;
+  int out_height = 0;
+  PixelFormat out_format = PixelFormat::kBGR8;
+};
+
+/**
+ * @brief 向量化指令级别
+ */
+enum class SimdLevel : uint8_t {
+  kScalar = 0,
+  kSSSE3 = 1,
+  kAVX2 = 2,
+};
+
+/**
+ * 检测当前 CPU 支持的最高指令级别（非 x86 平台返回 kScalar）
+ */
+SimdLevel DetectSimdLevel();
+
+const char* SimdLevelName(SimdLevel level);
+
+/**
+ * AlignedBuffer - 64字节对齐、只增不减的可复用缓冲
+ */
+class AlignedBuffer {
+public:
+  static constexpr size_t kAlignment = 64;
+
+  AlignedBuffer() = default;
+  ~AlignedBuffer();
+
+  /**
+   * 保证容量不少于 size 字节，原有内容不保留
+   */
+  uint8_t* Reserve(size_t size);
+
+  uint8_t* data() const { return data_; }
+  size_t capacity() const { return capacity_; }
+
+private:
+  uint8_t* data_ = nullptr;
+  size_t capacity_ = 0;
+
+  AlignedBuffer(const AlignedBuffer&) = delete;
+  AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+};
+
+/**
+ * ImagePreprocessor - 感知请求上传前的客户端图像预处理
+ *
+ * 将 1080p 原始帧裁剪/缩放到感知后端的输入分辨率并转换颜色空间后
+ * 再放入 perception_api 请求，上传字节数与服务端负载按缩放比例下降。
+ *
+ * - 缩放为双线性插值（7位定点权重），颜色转换支持 BGR/RGB 互换及灰度；
+ * - 运行时按 CPU 选择 AVX2 / SSSE3 / 标量实现，各实现结果逐字节一致；
+ * - 输出写入内部对齐缓冲并在调用间复用，稳态下不再分配内存。
+ *
+ * 输出视图在下一次 Process 调用前有效。同一对象不可多线程并发使用。
+ */
+class ImagePreprocessor {
+public:
+  /**
+   * @param max_level 允许使用的最高指令级别，实际级别不超过 CPU 支持
+   */
+  explicit ImagePreprocessor(SimdLevel max_level = SimdLevel::kAVX2);
+  ~ImagePreprocessor();
+
+  /**
+   * 执行预处理
+   * @param input   输入图像
+   * @param options 裁剪/缩放/颜色转换配置
+   * @param output  输出视图（紧密排列，指向内部缓冲）
+   */
+  Status Process(const ImageView& input, const PreprocessOptions& options,
+                 ImageView& output);
+
+  SimdLevel simd_level() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  ImagePreprocessor(const ImagePreprocessor&) = delete;
+  ImagePreprocessor& operator=(const ImagePreprocessor&) = delete;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_IMAGE_PREPROCESS
@@ -0,0 +1,144 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_MASK_UTIL
+#define HUMANOID_ROBOT_INTERFACES_MASK_UTIL
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+/**
+ * @brief 掩码外接框（包含端点），空掩码时 Empty() 为 true
+ */
+struct MaskBox {
+  int x_min = 0;
+  int y_min = 0;
+  int x_max = -1;
+  int y_max = -1;
+
+  bool Empty() const { return x_max < x_min || y_max < y_min; }
+  int Width() const { return Empty() ? 0 : x_max - x_min + 1; }
+  int Height() const { return Empty() ? 0 : y_max - y_min + 1; }
+};
+
+/**
+ * @brief 掩码质心，空掩码时 valid 为 false
+ */
+struct MaskCentroid {
+  double x = 0.0;
+  double y = 0.0;
+  bool valid = false;
+};
+
+class RleMask;
+
+/**
+ * BitMask - 按位压缩的分割掩码
+ *
+ * 每行按64位对齐存储，内存为逐字节掩码的 1/8。面积、外接框、质心和
+ * IoU 都直接在64位字上用 popcount 计算，不展开为逐像素字节。
+ * 字节掩码打包在 x86 上使用 SSE2/AVX2 movemask，popcount 在支持
+ * POPCNT 的 CPU 上使用硬件指令。
+ */
+class BitMask {
+public:
+  BitMask() = default;
+  BitMask(int width, int height);
+
+  /**
+   * 从逐字节掩码（如 ResponseDivision 中的原始掩码）打包，
+   * 大于 threshold 的像素视为前景
+   * @param stride 行字节数，0 表示紧密排列
+   */
+  static BitMask FromBytes(const uint8_t* data, int width, int height,
+                           size_t stride = 0, uint8_t threshold = 0);
+
+  static BitMask FromBytes(const std::string& data, int width, int height,
+                           uint8_t threshold = 0);
+
+  /**
+   * 展开为逐字节掩码（前景为 1），仅用于兼容旧代码
+   */
+  std::vector<uint8_t> ToBytes() const;
+
+  bool Get(int x, int y) const {
+    return (Row(y)[x >> 6] >> (x & 63)) & 1u;
+  }
+  void Set(int x, int y, bool value);
+
+  uint64_t Area() const;
+  MaskBox BoundingBox() const;
+  MaskCentroid Centroid() const;
+
+  /**
+   * 交集像素数，尺寸不一致时返回0
+   */
+  static uint64_t IntersectionArea(const BitMask& a, const BitMask& b);
+
+  /**
+   * 交并比，尺寸不一致或并集为空时返回0
+   */
+  static double IoU(const BitMask& a, const BitMask& b);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  size_t words_per_row() const { return words_per_row_; }
+  const uint64_t* Row(int y) const {
+    return words_.data() + static_cast<size_t>(y) * words_per_row_;
+  }
+  uint64_t* MutableRow(int y) {
+    return words_.data() + static_cast<size_t>(y) * words_per_row_;
+  }
+  size_t MemoryBytes() const { return words_.size() * sizeof(uint64_t); }
+
+private:
+  int width_ = 0;
+  int height_ = 0;
+  size_t words_per_row_ = 0;
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * RleMask - 行优先游程编码掩码
+ *
+ * runs 依次为背景、前景、背景……的长度（首段背景可以为0），
+ * 按整幅图像行优先展开（不按行截断）。内存与掩码边界复杂度成正比，
+ * 适合长期保存大量掩码；面积与 IoU 直接在游程上归并计算。
+ */
+class RleMask {
+public:
+  RleMask() = default;
+
+  static RleMask FromBitMask(const BitMask& mask);
+  static RleMask FromBytes(const uint8_t* data, int width, int height,
+                           size_t stride = 0, uint8_t threshold = 0);
+
+  BitMask ToBitMask() const;
+
+  uint64_t Area() const;
+  MaskBox BoundingBox() const;
+  MaskCentroid Centroid() const;
+
+  static uint64_t IntersectionArea(const RleMask& a, const RleMask& b);
+  static double IoU(const RleMask& a, const RleMask& b);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  const std::vector<uint32_t>& runs() const { return runs_; }
+  size_t MemoryBytes() const { return runs_.size() * sizeof(uint32_t); }
+
+private:
+  int width_ = 0;
+  int height_ = 0;
+  std::vector<uint32_t> runs_;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_MASK_UTIL
@@ -13,7 +13,7 @@
 #include "sdk_service/perception/response_status.pb.h"
 
 namespace humanoid_robot {
-namespace clientSDK {
+namespace konka_sdk {
 namespace robot {
 namespace perception_api {
 using RequestDetection = humanoid_robot::PB::sdk_service::perception::RequestDetection;
@@ -25,7 +25,7 @@ using ResponsePerception = humanoid_robot::PB::sdk_service::perception::Response
 
 
 using PerceptionResStatus = humanoid_robot::PB::sdk_service::perception::ResponseStatus;
-using InterfacesClient = humanoid_robot::clientSDK::robot::InterfacesClient;
+using InterfacesClient = humanoid_robot::konka_sdk::robot::InterfacesClient;
 
 using SendRequest = humanoid_robot::PB::interfaces::SendRequest;
 using SendResponse = humanoid_robot::PB::interfaces::SendResponse;
@@ -46,6 +46,6 @@ PerceptionResStatus Perception(std::unique_ptr<InterfacesClient>& client,
 
 }  // namespace perception_api
 }  // namespace robot
-}  // namespace clientSDK
+}  // namespace konka_sdk
 }  // namespace humanoid_robot
 #endif  // HUMANOID_ROBOT_INTERFACES_PERCEPTIONAPI
\ No newline at end of file
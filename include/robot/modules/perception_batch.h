@@ -0,0 +1,131 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_PERCEPTION_BATCH
+#define HUMANOID_ROBOT_INTERFACES_PERCEPTION_BATCH
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "robot/common/status.h"
+#include "robot/modules/perception_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+using Status = humanoid_robot::konka_sdk::common::Status;
+
+/**
+ * @brief 批量检测配置
+ *
+ * 攒批在帧数达到 max_batch_frames、字节数达到 max_batch_bytes 或最早
+ * 一帧等待超过 max_delay_ms 时刷出，单帧附加延迟不超过 max_delay_ms
+ * 加上一个批次的往返时间。
+ */
+struct BatchOptions {
+  size_t max_batch_frames = 8;
+  size_t max_batch_bytes = 3 * 1024 * 1024;
+  int64_t max_delay_ms = 20;
+  int64_t timeout_ms = 10000;
+};
+
+/**
+ * @brief 批量检测中的一帧
+ */
+struct BatchFrame {
+  std::string camera_id;
+  RequestDetection request;
+};
+
+/**
+ * @brief 单帧检测结果
+ */
+struct BatchFrameResult {
+  PerceptionResStatus status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  ResponseDetection detection;
+};
+
+/**
+ * @brief 攒批统计
+ */
+struct BatchStats {
+  uint64_t batches = 0;
+  uint64_t frames = 0;
+  uint64_t size_flushes = 0;   // 因帧数/字节数上限刷出的批次
+  uint64_t time_flushes = 0;   // 因等待超时刷出的批次
+  uint64_t failed_batches = 0;
+  uint64_t callback_errors = 0;  // 回调抛出异常的次数
+  double mean_batch_size = 0.0;
+  // batch_size_counts[n] 为大小为 n 的批次数，长度为 max_batch_frames + 1
+  std::vector<uint64_t> batch_size_counts;
+};
+
+using BatchResultCallback = std::function<void(const BatchFrameResult&)>;
+
+/**
+ * 同步批量检测：frames 按 max_batch_frames 分组打包发送，
+ * results 与 frames 一一对应、顺序一致
+ *
+ * @return 全部成功返回 RESPONSE_SUCCESS，否则返回第一个失败帧的状态
+ */
+PerceptionResStatus DetectionBatch(std::unique_ptr<InterfacesClient>& client,
+                                   const std::vector<BatchFrame>& frames,
+                                   std::vector<BatchFrameResult>& results,
+                                   const BatchOptions& options = BatchOptions());
+
+/**
+ * PerceptionBatcher - 多相机检测请求攒批
+ *
+ * Submit 只把帧序列化进待发批次后立即返回，后台线程按大小/时间窗口
+ * 打包成一个请求发送，返回后按提交顺序逐帧回调。发送期间到达的帧
+ * 进入下一批，因此负载越高批次越大。
+ *
+ * 每批的条数同时记入 MetricsRegistry（方法 SendBatch、命令 kDetection），
+ * 与请求延迟一起导出；回调抛出的异常会被捕获并计入 callback_errors。
+ *
+ * 批量信封格式：
+ *   input.command_id   kDetection
+ *   input.batch        {count, frames: {"0": {camera_id, request_detection}, ...}}
+ *   output.batch       {"0": {code, data}, ...}
+ */
+class PerceptionBatcher {
+public:
+  explicit PerceptionBatcher(std::unique_ptr<InterfacesClient>& client,
+                             BatchOptions options = BatchOptions());
+  ~PerceptionBatcher();
+
+  /**
+   * 提交一帧，结果通过 callback 在后台线程返回
+   */
+  Status Submit(const std::string& camera_id,
+                const RequestDetection& request_detection,
+                BatchResultCallback callback);
+
+  /**
+   * 立即发送当前待发批次并等待回调完成
+   */
+  void Flush();
+
+  /**
+   * 发送剩余帧并停止后台线程
+   */
+  void Stop();
+
+  BatchStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  PerceptionBatcher(const PerceptionBatcher&) = delete;
+  PerceptionBatcher& operator=(const PerceptionBatcher&) = delete;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_PERCEPTION_BATCH
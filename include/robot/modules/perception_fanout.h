@@ -0,0 +1,118 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_PERCEPTION_FANOUT
+#define HUMANOID_ROBOT_INTERFACES_PERCEPTION_FANOUT
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "robot/modules/perception_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+/**
+ * @brief 感知分析类型（可按位组合）
+ */
+enum PerceptionAnalysis : uint32_t {
+  kAnalysisDetection = 1u << 0,
+  kAnalysisDivision = 1u << 1,
+  kAnalysisPerception = 1u << 2,
+  kAnalysisAll = kAnalysisDetection | kAnalysisDivision | kAnalysisPerception,
+};
+
+/**
+ * @brief 扇出调用配置
+ */
+struct FanOutOptions {
+  // false 时按 Detection -> Division -> Perception 顺序执行，用于延迟对比；
+  // true 时调用线程执行一个分析，其余交给进程内共享的两个常驻线程，
+  // 常驻线程繁忙时调用线程收回尚未开始的分析自行执行
+  bool concurrent = true;
+  // 单个分析请求的 gRPC 截止时间(ms)
+  int64_t timeout_ms = 10000;
+  // 各请求类型中承载图像的 bytes 字段名（单值字段），image 非空时使用
+  std::string image_field = "image";
+};
+
+/**
+ * @brief 同一帧的各分析请求
+ *
+ * 图像字段留空，由 PerceptionFanOut 的 image 参数统一提供；其余字段按各自
+ * 的请求类型填写。未请求的分析对应的请求不会被使用。
+ */
+struct PerceptionFrameRequests {
+  RequestDetection detection;
+  RequestDivision division;
+  RequestPerception perception;
+};
+
+/**
+ * @brief 扇出调用结果（时间单位为微秒）
+ *
+ * sequential_us 为各分析耗时之和，即顺序调用的等效延迟；
+ * 并发模式下 wall_us 与 sequential_us 的差值就是扇出节省的时间。
+ */
+struct PerceptionFanOutResult {
+  uint32_t completed = 0;  // 已完成的分析（PerceptionAnalysis 位掩码）
+
+  PerceptionResStatus detection_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  ResponseDetection detection;
+  int64_t detection_us = 0;
+
+  PerceptionResStatus division_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  ResponseDivision division;
+  int64_t division_us = 0;
+
+  PerceptionResStatus perception_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  ResponsePerception perception;
+  int64_t perception_us = 0;
+
+  int64_t wall_us = 0;
+  int64_t sequential_us = 0;
+
+  uint32_t callback_errors = 0;  // 回调抛出异常的次数
+};
+
+/**
+ * @brief 单个分析完成时的回调，在工作线程中调用，需自行保证线程安全
+ *
+ * 回调抛出的异常会被捕获并记录，计入 PerceptionFanOutResult::callback_errors。
+ */
+struct PerceptionFanOutCallbacks {
+  std::function<void(PerceptionResStatus, const ResponseDetection&)> on_detection;
+  std::function<void(PerceptionResStatus, const ResponseDivision&)> on_division;
+  std::function<void(PerceptionResStatus, const ResponsePerception&)> on_perception;
+};
+
+/**
+ * 对同一帧并发发起多个感知分析
+ *
+ * 每个分析按自己的请求类型序列化，图像数据以 options.image_field 字段追加
+ * 在序列化结果末尾（protobuf 中单值字段以最后出现的为准，等价于设置该字段）。
+ * 各分析线程并行读取同一份 image，每个请求只拷贝一次图像，不需要先把
+ * 图像放进三个请求对象。image 为空时请求按原样序列化，图像由调用方自行填写。
+ *
+ * @param requests   各分析的请求，图像字段留空
+ * @param image      共享的图像数据
+ * @param analyses   需要执行的分析（PerceptionAnalysis 位掩码）
+ * @param result     汇总结果，所有分析完成后返回
+ * @param callbacks  可选，每个分析结果到达时立即回调
+ * @return 全部成功返回 RESPONSE_SUCCESS，否则返回第一个失败分析的状态；
+ *         请求类型中没有 image_field 字段时返回 ERROR_PARSE_FAILED
+ */
+PerceptionResStatus PerceptionFanOut(std::unique_ptr<InterfacesClient>& client,
+                                     const PerceptionFrameRequests& requests,
+                                     const std::string& image,
+                                     uint32_t analyses,
+                                     PerceptionFanOutResult& result,
+                                     const PerceptionFanOutCallbacks* callbacks = nullptr,
+                                     const FanOutOptions& options = FanOutOptions());
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_PERCEPTION_FANOUT
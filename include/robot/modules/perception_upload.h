@@ -0,0 +1,95 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_PERCEPTION_UPLOAD
+#define HUMANOID_ROBOT_INTERFACES_PERCEPTION_UPLOAD
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "robot/modules/perception_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+// 分块上传能力名，需通过 InterfacesClient::NegotiateCapabilities 协商
+constexpr const char* kChunkedUploadCapability = "perception.upload.chunked.v1";
+
+/**
+ * @brief 分块上传配置
+ *
+ * 峰值缓冲内存约为 chunk_size * max_inflight_chunks，与图像大小无关。
+ */
+struct ChunkedUploadOptions {
+  // 单个分块大小(字节)
+  size_t chunk_size = 256 * 1024;
+  // 同时存在的分块缓冲数（序列化与发送之间的流水线深度）
+  size_t max_inflight_chunks = 4;
+  // 常驻上传流的 gRPC 截止时间(ms)
+  int64_t stream_timeout_ms = 24LL * 3600 * 1000;
+};
+
+/**
+ * @brief 最近一次上传的统计（时间单位为微秒）
+ */
+struct ChunkedUploadStats {
+  uint64_t total_bytes = 0;
+  uint64_t chunks = 0;     // 回退为单条 Send 时为 0
+  uint64_t peak_buffered_bytes = 0;
+  int64_t upload_us = 0;   // 第一个分块开始序列化到最后一个分块写出
+  int64_t response_us = 0; // 最后一个分块写出到收到响应
+};
+
+/**
+ * ChunkedUploader - 感知请求分块流水线上传
+ *
+ * 请求直接序列化到固定大小的分块缓冲中（不再先生成完整的 payload
+ * 再拷贝进信封），后台线程序列化第 N+1 块的同时调用线程发送第 N 块。
+ * 所有上传复用同一条常驻 Send 流，流异常时下次调用自动重建。
+ *
+ * 分块信封格式：
+ *   input.command_id          感知命令码
+ *   input.chunk               {upload_id, chunk_index, total_size, last}
+ *   input.data.<request_key>  分块数据
+ * 服务端在收到 last=true 的分块后按 upload_id 拼接并返回一次响应。
+ *
+ * 只有服务端接受 kChunkedUploadCapability 时才使用分块协议，否则每次调用
+ * 回退为 perception_api 中对应的单条 Send 接口（不保证峰值内存）。
+ *
+ * 同一对象不可多线程并发上传。
+ */
+class ChunkedUploader {
+public:
+  explicit ChunkedUploader(std::unique_ptr<InterfacesClient>& client,
+                           ChunkedUploadOptions options = ChunkedUploadOptions());
+  ~ChunkedUploader();
+
+  PerceptionResStatus Detection(const RequestDetection& request_detection,
+                                ResponseDetection& response_detection);
+
+  PerceptionResStatus Division(const RequestDivision& request_division,
+                               ResponseDivision& response_division);
+
+  PerceptionResStatus Perception(const RequestPerception& request_perception,
+                                 ResponsePerception& response_perception);
+
+  /**
+   * 关闭常驻上传流
+   */
+  void Close();
+
+  ChunkedUploadStats GetLastStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  ChunkedUploader(const ChunkedUploader&) = delete;
+  ChunkedUploader& operator=(const ChunkedUploader&) = delete;
+};
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_PERCEPTION_UPLOAD
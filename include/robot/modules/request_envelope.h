@@ -0,0 +1,153 @@
+#ifndef HUMANOID_ROBOT_INTERFACES_REQUEST_ENVELOPE
+#define HUMANOID_ROBOT_INTERFACES_REQUEST_ENVELOPE
+
+#include <cstdint>
+#include <string>
+
+#include "common/variant.pb.h"
+#include "interfaces/interfaces_request_response.pb.h"
+#include "robot/modules/compact_codec.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace request_envelope {
+
+/**
+ * Send 请求/响应的信封格式
+ *
+ *   input  = { "command_id": int32, "data": { <data_key>: bytes }
+ *              [, "codec"][, "accept_codec"] }
+ *   output = { "data": bytes[, "codec"] }
+ *
+ * "codec" 只描述所在字典中 data 的编码；"accept_codec" 表示客户端能解析紧凑
+ * 编码的响应，只在响应类型属于白名单时携带。
+ *
+ * 业务数据序列化后放在 Variant 的 bytevalue 中。各模块 API 共用这里的构建与
+ * 解析函数，benchmarks 也直接对它们计时。
+ */
+constexpr const char* kCommandIdKey = "command_id";
+constexpr const char* kDataKey = "data";
+
+using Variant = humanoid_robot::PB::common::Variant;
+using SendRequest = humanoid_robot::PB::interfaces::SendRequest;
+using SendResponse = humanoid_robot::PB::interfaces::SendResponse;
+
+/**
+ * 按协商结果序列化业务数据（白名单类型可使用紧凑编码）
+ */
+template <typename MessageType>
+bool SerializePayload(const MessageType& message, bool use_compact,
+                      std::string* out) {
+  if constexpr (compact_codec::CompactTraits<MessageType>::kSupported) {
+    if (use_compact) {
+      return compact_codec::EncodeCompact(message, out);
+    }
+  }
+  return message.SerializeToString(out);
+}
+
+/**
+ * 按响应中的编码标记反序列化业务数据
+ */
+template <typename MessageType>
+bool ParsePayload(const std::string& data, bool is_compact,
+                  MessageType* message) {
+  if constexpr (compact_codec::CompactTraits<MessageType>::kSupported) {
+    if (is_compact) {
+      return compact_codec::DecodeCompact(data, message);
+    }
+  }
+  return message->ParseFromString(data);
+}
+
+/**
+ * 构建 SendRequest 信封
+ *
+ * 业务数据直接序列化到信封内的 bytevalue，不产生中间拷贝。
+ * @param command_id 命令ID
+ * @param data_key data 字典中业务数据的key
+ * @param request_data 业务请求数据（protobuf对象）
+ * @param use_compact 是否已与服务端协商紧凑编码，请求类型不在白名单时忽略
+ * @param send_req 输出参数，须为空请求
+ * @return 序列化失败时返回false
+ */
+template <typename RequestType>
+bool BuildSendRequest(int32_t command_id, const char* data_key,
+                      const RequestType& request_data, bool use_compact,
+                      SendRequest* send_req) {
+  auto* input_map = send_req->mutable_input()->mutable_keyvaluelist();
+  (*input_map)[kCommandIdKey].set_int32value(command_id);
+
+  auto* request_dict_map =
+      (*input_map)[kDataKey].mutable_dictvalue()->mutable_keyvaluelist();
+  if (!SerializePayload(request_data, use_compact,
+                        (*request_dict_map)[data_key].mutable_bytevalue())) {
+    return false;
+  }
+
+  // 仅在请求数据确实按紧凑格式编码时标记
+  if constexpr (compact_codec::CompactTraits<RequestType>::kSupported) {
+    if (use_compact) {
+      (*input_map)[compact_codec::kCodecKey].set_stringvalue(
+          compact_codec::kCompactCodecName);
+    }
+  }
+  return true;
+}
+
+/**
+ * 声明响应可使用紧凑编码，响应类型不在白名单或未协商时不做任何事
+ */
+template <typename ResponseType>
+void AcceptCompactResponse(bool use_compact, SendRequest* send_req) {
+  if constexpr (compact_codec::CompactTraits<ResponseType>::kSupported) {
+    if (use_compact) {
+      (*send_req->mutable_input()
+            ->mutable_keyvaluelist())[compact_codec::kAcceptCodecKey]
+          .set_stringvalue(compact_codec::kCompactCodecName);
+    }
+  }
+}
+
+enum class ParseResult {
+  kOk,
+  kDataNotFound,  // 响应中没有 data 字段
+  kParseFailed,   // 业务数据反序列化失败
+};
+
+/**
+ * 从 Variant 字典（keyvaluelist）中取出并反序列化 data 字段，
+ * 批量响应中每帧的结果字典也用它解析
+ */
+template <typename VariantMap, typename ResultType>
+ParseResult ParseDictData(const VariantMap& dict, ResultType* result) {
+  auto data_it = dict.find(kDataKey);
+  if (data_it == dict.end()) {
+    return ParseResult::kDataNotFound;
+  }
+
+  auto codec_it = dict.find(compact_codec::kCodecKey);
+  bool is_compact =
+      codec_it != dict.end() &&
+      codec_it->second.stringvalue() == compact_codec::kCompactCodecName;
+  if (!ParsePayload(data_it->second.bytevalue(), is_compact, result)) {
+    return ParseResult::kParseFailed;
+  }
+  return ParseResult::kOk;
+}
+
+/**
+ * 从 SendResponse 信封中取出并反序列化业务数据（不检查 ret 状态码）
+ */
+template <typename ResultType>
+ParseResult ParseResponseData(const SendResponse& send_resp,
+                              ResultType* result) {
+  return ParseDictData(send_resp.output().keyvaluelist(), result);
+}
+
+}  // namespace request_envelope
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_INTERFACES_REQUEST_ENVELOPE
@@ -0,0 +1,254 @@
+#include "benchmark_util.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/reflection.h"
+
+namespace {
+std::atomic<uint64_t> g_allocation_count{0};
+std::atomic<uint64_t> g_allocation_bytes{0};
+
+void* CountedAllocate(size_t size) {
+  g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  g_allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+  void* ptr = std::malloc(size != 0 ? size : 1);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+}  // namespace
+
+// 替换全局 operator new/delete，统计整个进程（含 SDK 与 protobuf）的分配
+void* operator new(size_t size) { return CountedAllocate(size); }
+void* operator new[](size_t size) { return CountedAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return CountedAllocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  try {
+    return CountedAllocate(size);
+  } catch (...) {
+    return nullptr;
+  }
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+uint64_t AllocationCount() {
+  return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocationBytes() {
+  return g_allocation_bytes.load(std::memory_order_relaxed);
+}
+
+void AllocationScope::Report(benchmark::State& state,
+                             size_t payload_bytes) const {
+  state.counters["allocs/op"] =
+      benchmark::Counter(static_cast<double>(AllocationCount() - start_count_),
+                         benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes/op"] =
+      benchmark::Counter(static_cast<double>(AllocationBytes() - start_bytes_),
+                         benchmark::Counter::kAvgIterations);
+  if (payload_bytes != 0) {
+    state.counters["bytes/op"] = static_cast<double>(payload_bytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                            static_cast<int64_t>(payload_bytes));
+  }
+}
+
+void FillScalars(Message* message) {
+  const auto* descriptor = message->GetDescriptor();
+  const Reflection* reflection = message->GetReflection();
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (field->is_repeated()) {
+      continue;
+    }
+    double value = 1.5 + i;
+    switch (field->cpp_type()) {
+      case FieldDescriptor::CPPTYPE_INT32:
+        reflection->SetInt32(message, field, 7 + i);
+        break;
+      case FieldDescriptor::CPPTYPE_INT64:
+        reflection->SetInt64(message, field, 1700000000000LL + i);
+        break;
+      case FieldDescriptor::CPPTYPE_UINT32:
+        reflection->SetUInt32(message, field, 7 + i);
+        break;
+      case FieldDescriptor::CPPTYPE_UINT64:
+        reflection->SetUInt64(message, field, 1700000000000ULL + i);
+        break;
+      case FieldDescriptor::CPPTYPE_DOUBLE:
+        reflection->SetDouble(message, field, value);
+        break;
+      case FieldDescriptor::CPPTYPE_FLOAT:
+        reflection->SetFloat(message, field, static_cast<float>(value));
+        break;
+      case FieldDescriptor::CPPTYPE_BOOL:
+        reflection->SetBool(message, field, true);
+        break;
+      case FieldDescriptor::CPPTYPE_STRING:
+        if (field->type() == FieldDescriptor::TYPE_STRING) {
+          reflection->SetString(message, field, "map");
+        }
+        break;
+      case FieldDescriptor::CPPTYPE_MESSAGE:
+        FillScalars(reflection->MutableMessage(message, field));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+namespace {
+bool IsRepeatedNumeric(const FieldDescriptor* field) {
+  if (!field->is_repeated() || field->is_map()) {
+    return false;
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+    case FieldDescriptor::CPPTYPE_INT64:
+    case FieldDescriptor::CPPTYPE_UINT32:
+    case FieldDescriptor::CPPTYPE_UINT64:
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsBytes(const FieldDescriptor* field) {
+  return !field->is_repeated() && field->type() == FieldDescriptor::TYPE_BYTES;
+}
+
+template <typename T>
+void AddValues(Message* message, const FieldDescriptor* field, size_t count) {
+  auto values =
+      message->GetReflection()->GetMutableRepeatedFieldRef<T>(message, field);
+  values.Clear();
+  for (size_t i = 0; i < count; ++i) {
+    values.Add(static_cast<T>(i % 101));
+  }
+}
+
+void FillField(Message* message, const FieldDescriptor* field, size_t count) {
+  if (IsBytes(field)) {
+    std::string bytes(count, '\0');
+    for (size_t i = 0; i < count; ++i) {
+      bytes[i] = static_cast<char>(i * 31);
+    }
+    message->GetReflection()->SetString(message, field, std::move(bytes));
+    return;
+  }
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      AddValues<int32_t>(message, field, count);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      AddValues<int64_t>(message, field, count);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      AddValues<uint32_t>(message, field, count);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      AddValues<uint64_t>(message, field, count);
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      AddValues<double>(message, field, count);
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      AddValues<float>(message, field, count);
+      break;
+    default:
+      break;
+  }
+}
+}  // namespace
+
+bool FillPayload(Message* message, size_t count) {
+  const auto* descriptor = message->GetDescriptor();
+
+  const FieldDescriptor* target = descriptor->FindFieldByName("data");
+  if (target != nullptr && !IsRepeatedNumeric(target) && !IsBytes(target)) {
+    target = nullptr;
+  }
+  for (int i = 0; target == nullptr && i < descriptor->field_count(); ++i) {
+    if (IsRepeatedNumeric(descriptor->field(i))) {
+      target = descriptor->field(i);
+    }
+  }
+  for (int i = 0; target == nullptr && i < descriptor->field_count(); ++i) {
+    if (IsBytes(descriptor->field(i))) {
+      target = descriptor->field(i);
+    }
+  }
+  if (target != nullptr) {
+    FillField(message, target, count);
+    return true;
+  }
+
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_repeated() &&
+        field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
+        FillPayload(message->GetReflection()->MutableMessage(message, field),
+                    count)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::unique_ptr<robot::InterfacesClient> ConnectMockServer(
+    const std::string& name, const tools::MockServerOptions& options) {
+  // 有意不释放：避免在静态析构阶段关闭 gRPC 服务
+  static std::mutex mutex;
+  static auto* servers =
+      new std::map<std::string, std::unique_ptr<tools::MockInterfacesServer>>();
+  std::string target;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& server = (*servers)[name];
+    if (!server) {
+      auto started = std::make_unique<tools::MockInterfacesServer>(options);
+      if (!started->Start("127.0.0.1", 0)) {
+        return nullptr;
+      }
+      server = std::move(started);
+    }
+    target = server->GetTarget();
+  }
+  auto client = std::make_unique<robot::InterfacesClient>();
+  if (!client->Connect(target)) {
+    return nullptr;
+  }
+  return client;
+}
+
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,76 @@
+#ifndef HUMANOID_ROBOT_BENCHMARKS_BENCHMARK_UTIL
+#define HUMANOID_ROBOT_BENCHMARKS_BENCHMARK_UTIL
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "google/protobuf/message.h"
+#include "mock_interfaces_server.h"
+#include "robot/client/interfaces_client.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+
+/**
+ * @brief 进程内累计的 operator new 次数与字节数（本目标替换了全局 operator new）
+ */
+uint64_t AllocationCount();
+uint64_t AllocationBytes();
+
+/**
+ * @brief 统计计时循环内的内存分配
+ *
+ * 在 `for (auto _ : state)` 之前构造，循环结束后调用 Report()。
+ */
+class AllocationScope {
+ public:
+  AllocationScope()
+      : start_count_(AllocationCount()), start_bytes_(AllocationBytes()) {}
+
+  /**
+   * @brief 写入 allocs/op、alloc_bytes/op 计数器
+   * @param payload_bytes 每次操作处理的业务数据字节数，同时写入 bytes/op
+   *                      并据此设置 bytes_per_second
+   */
+  void Report(benchmark::State& state, size_t payload_bytes = 0) const;
+
+ private:
+  uint64_t start_count_;
+  uint64_t start_bytes_;
+};
+
+/**
+ * @brief 把消息中所有单值数值字段设为非零值（递归进入子消息）
+ *
+ * 通过反射实现，不依赖具体字段名，避免空消息序列化为 0 字节。
+ */
+void FillScalars(google::protobuf::Message* message);
+
+/**
+ * @brief 把消息中的主负载字段填充到 count 个元素
+ *
+ * 依次查找名为 data 的字段、第一个重复数值字段、第一个 bytes 字段，
+ * 找不到时递归进入子消息。重复数值字段按 0..100 循环取值（占用栅格的取值范围），
+ * bytes 字段填充 count 个字节。
+ * @return 找不到可填充的字段时返回false
+ */
+bool FillPayload(google::protobuf::Message* message, size_t count);
+
+/**
+ * @brief 连接进程内的模拟 Interfaces-Server（127.0.0.1，自动分配端口）
+ *
+ * 同名服务端在第一次调用时按 options 启动，之后常驻到进程退出；每次调用
+ * 返回一条新的客户端连接。
+ * @return 启动或连接失败时返回 nullptr
+ */
+std::unique_ptr<robot::InterfacesClient> ConnectMockServer(
+    const std::string& name, const tools::MockServerOptions& options);
+
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
+#endif  // HUMANOID_ROBOT_BENCHMARKS_BENCHMARK_UTIL
@@ -0,0 +1,233 @@
+/**
+ * @brief Send 信封构建/解析的基准测试
+ *
+ * 覆盖导航模块的 BuildSendRequest/ParseResponseData 与控制、感知模块的请求编码，
+ * 负载从几十字节的 ReqPoseMsg 到 4096x4096 的 OccupancyGrid。
+ */
+#include <map>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/modules/control_api.h"
+#include "robot/modules/navigation_api.h"
+#include "robot/modules/perception_api.h"
+#include "robot/modules/request_envelope.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using robot::navigation_api::OccupancyGrid;
+using robot::navigation_api::Pose;
+using robot::navigation_api::ReqPoseMsg;
+using robot::request_envelope::SendRequest;
+using robot::request_envelope::SendResponse;
+using NavigationCommandCode =
+    humanoid_robot::PB::sdk_service::common::NavigationCommandCode;
+using ControlCommandCode =
+    humanoid_robot::PB::sdk_service::common::ControlCommandCode;
+using PerceptionCommandCode =
+    humanoid_robot::PB::sdk_service::common::PerceptionCommandCode;
+
+// 导航模块业务数据在 data 字典中的key
+constexpr const char* kNavigationDataKey = "request_data";
+
+/**
+ * @brief 边长为 side 的占用栅格，按边长缓存（4096x4096 只构建一次）
+ */
+const OccupancyGrid& GridOfSide(int side) {
+  static std::map<int, OccupancyGrid> grids;
+  auto it = grids.find(side);
+  if (it == grids.end()) {
+    OccupancyGrid grid;
+    FillScalars(&grid);
+    FillPayload(&grid, static_cast<size_t>(side) * side);
+    it = grids.emplace(side, std::move(grid)).first;
+  }
+  return it->second;
+}
+
+template <typename MessageType>
+MessageType MakeMessage(size_t payload_count) {
+  MessageType message;
+  FillScalars(&message);
+  if (payload_count != 0) {
+    FillPayload(&message, payload_count);
+  }
+  return message;
+}
+
+template <typename MessageType>
+void RunBuild(benchmark::State& state, int32_t command_id,
+              const char* data_key, const MessageType& message,
+              bool use_compact) {
+  size_t payload_bytes = message.ByteSizeLong();
+  AllocationScope allocs;
+  for (auto _ : state) {
+    SendRequest send_req;
+    bool built = robot::request_envelope::BuildSendRequest(
+        command_id, data_key, message, use_compact, &send_req);
+    benchmark::DoNotOptimize(built);
+    benchmark::DoNotOptimize(send_req);
+  }
+  allocs.Report(state, payload_bytes);
+}
+
+/**
+ * @brief 构建信封并序列化为线上字节（gRPC Write 时的开销）
+ */
+template <typename MessageType>
+void RunBuildAndSerialize(benchmark::State& state, int32_t command_id,
+                          const char* data_key, const MessageType& message) {
+  size_t payload_bytes = message.ByteSizeLong();
+  std::string wire;
+  AllocationScope allocs;
+  for (auto _ : state) {
+    SendRequest send_req;
+    robot::request_envelope::BuildSendRequest(command_id, data_key, message,
+                                              false, &send_req);
+    send_req.SerializeToString(&wire);
+    benchmark::DoNotOptimize(wire.data());
+  }
+  allocs.Report(state, payload_bytes);
+}
+
+template <typename MessageType>
+SendResponse MakeResponse(const MessageType& message, bool use_compact) {
+  SendResponse send_resp;
+  send_resp.mutable_ret()->set_code("0");
+  auto* output_map = send_resp.mutable_output()->mutable_keyvaluelist();
+  robot::request_envelope::SerializePayload(
+      message, use_compact,
+      (*output_map)[robot::request_envelope::kDataKey].mutable_bytevalue());
+  if (use_compact) {
+    (*output_map)[robot::compact_codec::kCodecKey].set_stringvalue(
+        robot::compact_codec::kCompactCodecName);
+  }
+  return send_resp;
+}
+
+template <typename MessageType>
+void RunParse(benchmark::State& state, const MessageType& message,
+              bool use_compact) {
+  SendResponse send_resp = MakeResponse(message, use_compact);
+  size_t payload_bytes = message.ByteSizeLong();
+  AllocationScope allocs;
+  for (auto _ : state) {
+    MessageType result;
+    auto parsed = robot::request_envelope::ParseResponseData(send_resp, &result);
+    benchmark::DoNotOptimize(parsed);
+    benchmark::DoNotOptimize(result);
+  }
+  allocs.Report(state, payload_bytes);
+}
+
+// ===================== 导航 =====================
+
+void BM_NavigationBuild_ReqPoseMsg(benchmark::State& state) {
+  RunBuild(state, NavigationCommandCode::kGetCurrentPose, kNavigationDataKey,
+           MakeMessage<ReqPoseMsg>(0), false);
+}
+BENCHMARK(BM_NavigationBuild_ReqPoseMsg);
+
+void BM_NavigationBuild_Pose(benchmark::State& state) {
+  RunBuild(state, NavigationCommandCode::kGetCurrentPose, kNavigationDataKey,
+           MakeMessage<Pose>(0), state.range(0) != 0);
+}
+BENCHMARK(BM_NavigationBuild_Pose)->ArgName("compact")->Arg(0)->Arg(1);
+
+void BM_NavigationBuild_OccupancyGrid(benchmark::State& state) {
+  RunBuild(state, NavigationCommandCode::kGetGridMap2D, kNavigationDataKey,
+           GridOfSide(static_cast<int>(state.range(0))), false);
+}
+BENCHMARK(BM_NavigationBuild_OccupancyGrid)
+    ->ArgName("side")
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+void BM_NavigationBuildSerialize_OccupancyGrid(benchmark::State& state) {
+  RunBuildAndSerialize(state, NavigationCommandCode::kGetGridMap2D,
+                       kNavigationDataKey,
+                       GridOfSide(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_NavigationBuildSerialize_OccupancyGrid)
+    ->ArgName("side")
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+void BM_NavigationParse_Pose(benchmark::State& state) {
+  RunParse(state, MakeMessage<Pose>(0), state.range(0) != 0);
+}
+BENCHMARK(BM_NavigationParse_Pose)->ArgName("compact")->Arg(0)->Arg(1);
+
+void BM_NavigationParse_OccupancyGrid(benchmark::State& state) {
+  RunParse(state, GridOfSide(static_cast<int>(state.range(0))), false);
+}
+BENCHMARK(BM_NavigationParse_OccupancyGrid)
+    ->ArgName("side")
+    ->RangeMultiplier(4)
+    ->Range(64, 4096);
+
+// ===================== 控制 =====================
+
+void BM_ControlBuild_EmergencyStop(benchmark::State& state) {
+  RunBuild(state, ControlCommandCode::kEmergencyStop, "request_emergency_stop",
+           MakeMessage<robot::control_api::RequestEmergencyStop>(0), false);
+}
+BENCHMARK(BM_ControlBuild_EmergencyStop);
+
+void BM_ControlBuild_JointMotion(benchmark::State& state) {
+  RunBuild(state, ControlCommandCode::kJointMotion, "request_joint_motion",
+           MakeMessage<robot::control_api::RequestJointMotion>(
+               static_cast<size_t>(state.range(0))),
+           false);
+}
+BENCHMARK(BM_ControlBuild_JointMotion)
+    ->ArgName("joints")
+    ->Arg(6)
+    ->Arg(32)
+    ->Arg(256);
+
+// ===================== 感知 =====================
+
+// 负载按 RGB 图像大小：640x480、1280x720、1920x1080
+void BM_PerceptionBuild_Detection(benchmark::State& state) {
+  RunBuild(state, PerceptionCommandCode::kDetection, "request_detection",
+           MakeMessage<robot::perception_api::RequestDetection>(
+               static_cast<size_t>(state.range(0))),
+           false);
+}
+BENCHMARK(BM_PerceptionBuild_Detection)
+    ->ArgName("bytes")
+    ->Arg(640 * 480 * 3)
+    ->Arg(1280 * 720 * 3)
+    ->Arg(1920 * 1080 * 3);
+
+void BM_PerceptionBuildSerialize_Detection(benchmark::State& state) {
+  RunBuildAndSerialize(state, PerceptionCommandCode::kDetection,
+                       "request_detection",
+                       MakeMessage<robot::perception_api::RequestDetection>(
+                           static_cast<size_t>(state.range(0))));
+}
+BENCHMARK(BM_PerceptionBuildSerialize_Detection)
+    ->ArgName("bytes")
+    ->Arg(640 * 480 * 3)
+    ->Arg(1920 * 1080 * 3);
+
+void BM_PerceptionBuild_Perception(benchmark::State& state) {
+  RunBuild(state, PerceptionCommandCode::kPerception, "request_perception",
+           MakeMessage<robot::perception_api::RequestPerception>(
+               static_cast<size_t>(state.range(0))),
+           false);
+}
+BENCHMARK(BM_PerceptionBuild_Perception)
+    ->ArgName("bytes")
+    ->Arg(640 * 480 * 3)
+    ->Arg(1920 * 1080 * 3);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,102 @@
+/**
+ * @brief ImagePreprocessor 各内核在 1920x1080 BGR 帧上的标量/SSSE3/AVX2 对比
+ *
+ * CPU 不支持的指令级别会被跳过。bytes_per_second 按输入帧字节数计算。
+ */
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/modules/image_preprocess.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using robot::perception_api::ImagePreprocessor;
+using robot::perception_api::ImageView;
+using robot::perception_api::PixelFormat;
+using robot::perception_api::PreprocessOptions;
+using robot::perception_api::SimdLevel;
+
+constexpr int kFrameWidth = 1920;
+constexpr int kFrameHeight = 1080;
+
+enum PreprocessKernel : int64_t {
+  kGray = 0,     // BGR -> 灰度
+  kSwap = 1,     // BGR -> RGB
+  kResize = 2,   // 缩放到 640x360，保持 BGR
+};
+
+const std::vector<uint8_t>& Frame() {
+  static const std::vector<uint8_t> frame = []() {
+    std::vector<uint8_t> pixels(static_cast<size_t>(kFrameWidth) * kFrameHeight * 3);
+    uint32_t state = 0x12345678u;
+    for (auto& pixel : pixels) {
+      state = state * 1664525u + 1013904223u;
+      pixel = static_cast<uint8_t>(state >> 24);
+    }
+    return pixels;
+  }();
+  return frame;
+}
+
+void BM_ImagePreprocess(benchmark::State& state) {
+  auto level = static_cast<SimdLevel>(state.range(0));
+  ImagePreprocessor preprocessor(level);
+  if (preprocessor.simd_level() != level) {
+    state.SkipWithError("SIMD level not supported by this CPU");
+    return;
+  }
+
+  ImageView input;
+  input.data = Frame().data();
+  input.width = kFrameWidth;
+  input.height = kFrameHeight;
+  input.format = PixelFormat::kBGR8;
+
+  PreprocessOptions options;
+  switch (state.range(1)) {
+    case kGray:
+      options.out_format = PixelFormat::kGray8;
+      break;
+    case kSwap:
+      options.out_format = PixelFormat::kRGB8;
+      break;
+    default:
+      options.out_width = 640;
+      options.out_height = 360;
+      break;
+  }
+
+  ImageView output;
+  if (!preprocessor.Process(input, options, output)) {
+    state.SkipWithError("Process failed");
+    return;
+  }
+  AllocationScope allocs;
+  for (auto _ : state) {
+    if (!preprocessor.Process(input, options, output)) {
+      state.SkipWithError("Process failed");
+      break;
+    }
+    benchmark::DoNotOptimize(output.data);
+    benchmark::ClobberMemory();
+  }
+  allocs.Report(state, input.ByteSize());
+  state.SetLabel(robot::perception_api::SimdLevelName(level));
+}
+BENCHMARK(BM_ImagePreprocess)
+    ->ArgNames({"simd", "kernel"})
+    ->ArgsProduct({{static_cast<int64_t>(SimdLevel::kScalar),
+                    static_cast<int64_t>(SimdLevel::kSSSE3),
+                    static_cast<int64_t>(SimdLevel::kAVX2)},
+                   {kGray, kSwap, kResize}})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,91 @@
+/**
+ * @brief json_convert_util 中 JSON 选项下 protobuf 与 JSON 互转的基准测试
+ */
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "google/protobuf/util/json_util.h"
+#include "robot/common/json_convert_util.hpp"
+#include "robot/modules/navigation_api.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using robot::navigation_api::OccupancyGrid;
+using robot::navigation_api::Pose;
+
+template <typename MessageType>
+void RunToJson(benchmark::State& state, const MessageType& message) {
+  std::string json;
+  AllocationScope allocs;
+  for (auto _ : state) {
+    json.clear();
+    auto status = google::protobuf::util::MessageToJsonString(
+        message, &json, common::GetJsonPrintOptions());
+    benchmark::DoNotOptimize(status.ok());
+  }
+  allocs.Report(state, json.size());
+}
+
+template <typename MessageType>
+void RunFromJson(benchmark::State& state, const MessageType& message) {
+  std::string json;
+  static_cast<void>(google::protobuf::util::MessageToJsonString(
+      message, &json, common::GetJsonPrintOptions()));
+  AllocationScope allocs;
+  for (auto _ : state) {
+    MessageType result;
+    auto status = google::protobuf::util::JsonStringToMessage(
+        json, &result, common::GetJsonParseOptions());
+    benchmark::DoNotOptimize(status.ok());
+  }
+  allocs.Report(state, json.size());
+}
+
+Pose MakePose() {
+  Pose pose;
+  FillScalars(&pose);
+  return pose;
+}
+
+// add_whitespace 下每个栅格占一行，4096x4096 的 JSON 超过 100MB，只测到 1024
+OccupancyGrid MakeGrid(int side) {
+  OccupancyGrid grid;
+  FillScalars(&grid);
+  FillPayload(&grid, static_cast<size_t>(side) * side);
+  return grid;
+}
+
+void BM_JsonPrint_Pose(benchmark::State& state) {
+  RunToJson(state, MakePose());
+}
+BENCHMARK(BM_JsonPrint_Pose);
+
+void BM_JsonParse_Pose(benchmark::State& state) {
+  RunFromJson(state, MakePose());
+}
+BENCHMARK(BM_JsonParse_Pose);
+
+void BM_JsonPrint_OccupancyGrid(benchmark::State& state) {
+  RunToJson(state, MakeGrid(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_JsonPrint_OccupancyGrid)
+    ->ArgName("side")
+    ->RangeMultiplier(4)
+    ->Range(64, 1024);
+
+void BM_JsonParse_OccupancyGrid(benchmark::State& state) {
+  RunFromJson(state, MakeGrid(static_cast<int>(state.range(0))));
+}
+BENCHMARK(BM_JsonParse_OccupancyGrid)
+    ->ArgName("side")
+    ->RangeMultiplier(4)
+    ->Range(64, 1024);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
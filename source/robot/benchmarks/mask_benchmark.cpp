@@ -0,0 +1,111 @@
+/**
+ * @brief 1920x1080 分割掩码：打包与 IoU（逐像素字节 / BitMask / RleMask）
+ *
+ * 两个掩码为部分重叠的椭圆，接近分割结果中单个目标的形状。
+ * 计数器 mask_bytes 为单个掩码在对应表示下占用的内存。
+ */
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/modules/mask_util.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using robot::perception_api::BitMask;
+using robot::perception_api::RleMask;
+
+constexpr int kMaskWidth = 1920;
+constexpr int kMaskHeight = 1080;
+
+/**
+ * @brief 以 (cx, cy) 为中心、半轴为 (rx, ry) 的椭圆逐字节掩码
+ */
+std::vector<uint8_t> EllipseMask(int cx, int cy, int rx, int ry) {
+  std::vector<uint8_t> mask(static_cast<size_t>(kMaskWidth) * kMaskHeight, 0);
+  for (int y = 0; y < kMaskHeight; ++y) {
+    for (int x = 0; x < kMaskWidth; ++x) {
+      double dx = static_cast<double>(x - cx) / rx;
+      double dy = static_cast<double>(y - cy) / ry;
+      if (dx * dx + dy * dy <= 1.0) {
+        mask[static_cast<size_t>(y) * kMaskWidth + x] = 255;
+      }
+    }
+  }
+  return mask;
+}
+
+const std::vector<uint8_t>& MaskA() {
+  static const std::vector<uint8_t> mask = EllipseMask(860, 540, 500, 380);
+  return mask;
+}
+
+const std::vector<uint8_t>& MaskB() {
+  static const std::vector<uint8_t> mask = EllipseMask(1100, 500, 450, 400);
+  return mask;
+}
+
+void BM_MaskPack(benchmark::State& state) {
+  const std::vector<uint8_t>& bytes = MaskA();
+  size_t mask_bytes = 0;
+  for (auto _ : state) {
+    BitMask mask = BitMask::FromBytes(bytes.data(), kMaskWidth, kMaskHeight);
+    mask_bytes = mask.MemoryBytes();
+    benchmark::DoNotOptimize(mask);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(bytes.size()));
+  state.counters["mask_bytes"] = static_cast<double>(mask_bytes);
+}
+BENCHMARK(BM_MaskPack)->Unit(benchmark::kMicrosecond);
+
+// 逐像素统计交集与并集，对应打包前的做法
+void BM_MaskIoUBytes(benchmark::State& state) {
+  const std::vector<uint8_t>& a = MaskA();
+  const std::vector<uint8_t>& b = MaskB();
+  for (auto _ : state) {
+    uint64_t intersection = 0;
+    uint64_t union_area = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+      bool in_a = a[i] != 0;
+      bool in_b = b[i] != 0;
+      intersection += in_a && in_b;
+      union_area += in_a || in_b;
+    }
+    double iou = union_area == 0 ? 0.0
+                                 : static_cast<double>(intersection) /
+                                       static_cast<double>(union_area);
+    benchmark::DoNotOptimize(iou);
+  }
+  state.counters["mask_bytes"] = static_cast<double>(a.size());
+}
+BENCHMARK(BM_MaskIoUBytes)->Unit(benchmark::kMicrosecond);
+
+void BM_MaskIoUBitMask(benchmark::State& state) {
+  BitMask a = BitMask::FromBytes(MaskA().data(), kMaskWidth, kMaskHeight);
+  BitMask b = BitMask::FromBytes(MaskB().data(), kMaskWidth, kMaskHeight);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(BitMask::IoU(a, b));
+  }
+  state.counters["mask_bytes"] = static_cast<double>(a.MemoryBytes());
+}
+BENCHMARK(BM_MaskIoUBitMask)->Unit(benchmark::kMicrosecond);
+
+void BM_MaskIoURle(benchmark::State& state) {
+  RleMask a = RleMask::FromBytes(MaskA().data(), kMaskWidth, kMaskHeight);
+  RleMask b = RleMask::FromBytes(MaskB().data(), kMaskWidth, kMaskHeight);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RleMask::IoU(a, b));
+  }
+  state.counters["mask_bytes"] = static_cast<double>(a.MemoryBytes());
+}
+BENCHMARK(BM_MaskIoURle)->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
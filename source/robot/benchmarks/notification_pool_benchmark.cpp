@@ -0,0 +1,150 @@
+/**
+ * @brief 订阅回调路径的内存分配：NotificationPool 与逐条新建消息对比
+ *
+ * - BM_NotificationDecode：只比较解码目标，池化 arena 消息与 make_shared 新建消息
+ * - BM_CallbackPath1kHz：按 1kHz 节奏经 OnSubscriptionMessage 推送到进程内的
+ *   ClientCallbackServer，覆盖解码、分发到工作线程、处理器和归还的完整路径。
+ *   allocs/op 为全进程计数，包含进程内推送端 stub 的分配，两组参数下相同，
+ *   差值即对象池节省的分配
+ *
+ * 消息形状接近相机主题：10 个超出 SSO 的字符串字段和 4KB payload。
+ */
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <grpcpp/grpcpp.h>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "common/variant.pb.h"
+#include "robot/client/client_callback_server.h"
+#include "robot/client/notification_pool.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using humanoid_robot::PB::common::Variant;
+using humanoid_robot::PB::interfaces::ClientCallbackService;
+using humanoid_robot::PB::interfaces::Notification;
+using humanoid_robot::PB::interfaces::NotificationAck;
+using robot::CallbackServerMode;
+using robot::CallbackServerOptions;
+using robot::ClientCallbackServer;
+using robot::NotificationPool;
+using robot::NotificationPoolOptions;
+using robot::NotificationPtr;
+
+void SetString(Notification* message, const std::string& key,
+               const std::string& value) {
+  Variant& variant = (*message->mutable_notifymessage()->mutable_keyvaluelist())[key];
+  variant.set_type(Variant::KStringValue);
+  variant.set_stringvalue(value);
+}
+
+const Notification& CameraNotification() {
+  static const Notification message = []() {
+    Notification notification;
+    SetString(&notification, "event_type", "sensor.camera");
+    SetString(&notification, "object_id", "camera-front");
+    SetString(&notification, "subscriptionId", "bench-subscription-0001");
+    for (int i = 0; i < 10; ++i) {
+      SetString(&notification, "meta_" + std::to_string(i),
+                "calibration/intrinsics/camera-front/field-" + std::to_string(i));
+    }
+    auto& fields = *notification.mutable_notifymessage()->mutable_keyvaluelist();
+    fields["timestamp"].set_type(Variant::KInt64Value);
+    fields["timestamp"].set_int64value(1700000000000);
+    fields["payload"].set_bytevalue(std::string(4096, '\x5a'));
+    return notification;
+  }();
+  return message;
+}
+
+void BM_NotificationDecode(benchmark::State& state) {
+  bool pooled = state.range(0) != 0;
+  std::string wire = CameraNotification().SerializeAsString();
+  auto pool = NotificationPool::Create();
+
+  AllocationScope allocs;
+  for (auto _ : state) {
+    std::shared_ptr<Notification> message =
+        pooled ? pool->Acquire() : std::make_shared<Notification>();
+    if (!message->ParseFromString(wire)) {
+      state.SkipWithError("ParseFromString failed");
+      break;
+    }
+    benchmark::DoNotOptimize(message.get());
+  }
+  allocs.Report(state, wire.size());
+}
+BENCHMARK(BM_NotificationDecode)->ArgName("pooled")->Arg(0)->Arg(1);
+
+void BM_CallbackPath1kHz(benchmark::State& state) {
+  bool pooled = state.range(0) != 0;
+  CallbackServerOptions options;
+  options.mode = state.range(1) != 0 ? CallbackServerMode::kAsync
+                                      : CallbackServerMode::kSync;
+  options.pool.max_idle = pooled ? NotificationPoolOptions().max_idle : 0;
+  // 只统计分配，不触发流控
+  options.flow_control.enabled = false;
+
+  ClientCallbackServer server;
+  server.SetServerOptions(options);
+  std::atomic<uint64_t> handled{0};
+  server.AddSubscriptionHandler(
+      "", [&handled](const NotificationPtr&) {
+        handled.fetch_add(1, std::memory_order_relaxed);
+      });
+  int port = 0;
+  if (!server.StartWithAutoPort("127.0.0.1", port)) {
+    state.SkipWithError("Failed to start callback server");
+    return;
+  }
+  auto stub = ClientCallbackService::NewStub(grpc::CreateChannel(
+      "127.0.0.1:" + std::to_string(port), grpc::InsecureChannelCredentials()));
+  const Notification& notification = CameraNotification();
+
+  // 预热：建立连接并填充空闲列表
+  for (int i = 0; i < 64; ++i) {
+    grpc::ClientContext context;
+    NotificationAck ack;
+    stub->OnSubscriptionMessage(&context, notification, &ack);
+  }
+
+  const auto period = std::chrono::microseconds(1000);
+  auto next = std::chrono::steady_clock::now();
+  uint64_t failed = 0;
+  AllocationScope allocs;
+  for (auto _ : state) {
+    next += period;
+    std::this_thread::sleep_until(next);
+    grpc::ClientContext context;
+    NotificationAck ack;
+    if (!stub->OnSubscriptionMessage(&context, notification, &ack).ok()) {
+      ++failed;
+    }
+  }
+  allocs.Report(state, notification.ByteSizeLong());
+
+  auto stats = server.GetStats();
+  server.Stop();
+  state.counters["failed"] = static_cast<double>(failed);
+  state.counters["pool_created"] = static_cast<double>(stats.pool.created);
+  state.SetLabel(options.mode == CallbackServerMode::kAsync ? "async" : "sync");
+}
+BENCHMARK(BM_CallbackPath1kHz)
+    ->ArgNames({"pooled", "async"})
+    ->ArgsProduct({{0, 1}, {0, 1}})
+    ->Iterations(1000)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
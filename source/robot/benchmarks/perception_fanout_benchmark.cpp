@@ -0,0 +1,95 @@
+/**
+ * @brief 感知扇出：同一帧的检测/分割/感知三个分析顺序调用与并发调用对比
+ *
+ * 请求发往进程内的模拟服务端，三个分析分别模拟 30/40/50ms 的服务端处理时延，
+ * 图像为 1920x1080 BGR。计数器 sequential_ms 为三个分析耗时之和，
+ * 并发模式下与 wall 时间的差值即扇出节省的时间。
+ */
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/modules/perception_fanout.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using google::protobuf::Descriptor;
+using google::protobuf::FieldDescriptor;
+using robot::perception_api::FanOutOptions;
+using robot::perception_api::PerceptionFanOutResult;
+using robot::perception_api::PerceptionFrameRequests;
+using robot::perception_api::PerceptionResStatus;
+
+/**
+ * @brief 第一个单值 bytes 字段的字段名，作为图像字段；没有时返回空串
+ */
+std::string ImageFieldOf(const Descriptor* descriptor) {
+  for (int i = 0; i < descriptor->field_count(); ++i) {
+    const FieldDescriptor* field = descriptor->field(i);
+    if (!field->is_repeated() && field->type() == FieldDescriptor::TYPE_BYTES) {
+      return field->name();
+    }
+  }
+  return std::string();
+}
+
+tools::MockServerOptions FanOutServerOptions() {
+  tools::MockServerOptions options;
+  options.profiles["perception.1"].latency_us = 30000;
+  options.profiles["perception.2"].latency_us = 40000;
+  options.profiles["perception.3"].latency_us = 50000;
+  return options;
+}
+
+void BM_PerceptionFanOut(benchmark::State& state) {
+  FanOutOptions options;
+  options.concurrent = state.range(0) != 0;
+  options.image_field = ImageFieldOf(robot::perception_api::RequestDetection::descriptor());
+  if (options.image_field.empty() ||
+      options.image_field != ImageFieldOf(robot::perception_api::RequestDivision::descriptor()) ||
+      options.image_field != ImageFieldOf(robot::perception_api::RequestPerception::descriptor())) {
+    state.SkipWithError("Perception requests have no common bytes image field");
+    return;
+  }
+
+  auto client = ConnectMockServer("fanout", FanOutServerOptions());
+  if (!client) {
+    state.SkipWithError("Failed to connect to the mock server");
+    return;
+  }
+
+  PerceptionFrameRequests requests;
+  FillScalars(&requests.detection);
+  FillScalars(&requests.division);
+  FillScalars(&requests.perception);
+  const std::string image(1920 * 1080 * 3, '\x5a');
+
+  int64_t sequential_us = 0;
+  for (auto _ : state) {
+    PerceptionFanOutResult result;
+    PerceptionResStatus status = robot::perception_api::PerceptionFanOut(
+        client, requests, image, robot::perception_api::kAnalysisAll, result,
+        nullptr, options);
+    if (status != PerceptionResStatus::RESPONSE_SUCCESS) {
+      state.SkipWithError("PerceptionFanOut failed");
+      break;
+    }
+    sequential_us += result.sequential_us;
+  }
+  state.counters["sequential_ms"] = benchmark::Counter(
+      static_cast<double>(sequential_us) / 1000.0, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_PerceptionFanOut)
+    ->ArgName("concurrent")
+    ->Arg(0)
+    ->Arg(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,82 @@
+/**
+ * @brief 感知请求上传吞吐：ChunkedUploader 与单条 Send 信封对比
+ *
+ * 请求发往进程内的模拟服务端（127.0.0.1），服务端不做处理，直接返回 64 字节
+ * 响应，bytes_per_second 即端到端上传吞吐。
+ */
+#include <map>
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/modules/perception_api.h"
+#include "robot/modules/perception_upload.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using robot::perception_api::ChunkedUploader;
+using robot::perception_api::PerceptionResStatus;
+using robot::perception_api::RequestDetection;
+using robot::perception_api::ResponseDetection;
+
+/**
+ * @brief 图像负载为 image_bytes 字节的检测请求，按大小缓存
+ */
+const RequestDetection& DetectionOfSize(size_t image_bytes) {
+  static std::map<size_t, RequestDetection> requests;
+  auto it = requests.find(image_bytes);
+  if (it == requests.end()) {
+    RequestDetection request;
+    FillScalars(&request);
+    FillPayload(&request, image_bytes);
+    it = requests.emplace(image_bytes, std::move(request)).first;
+  }
+  return it->second;
+}
+
+void BM_PerceptionUpload(benchmark::State& state) {
+  bool chunked = state.range(0) != 0;
+  const RequestDetection& request =
+      DetectionOfSize(static_cast<size_t>(state.range(1)));
+  tools::MockServerOptions options;
+  options.capabilities.push_back(robot::perception_api::kChunkedUploadCapability);
+  auto client = ConnectMockServer("upload", options);
+  if (!client ||
+      !client->NegotiateCapabilities(
+          {robot::perception_api::kChunkedUploadCapability})) {
+    state.SkipWithError("Failed to connect to the mock server");
+    return;
+  }
+  ChunkedUploader uploader(client);
+
+  AllocationScope allocs;
+  for (auto _ : state) {
+    ResponseDetection response;
+    PerceptionResStatus status =
+        chunked ? uploader.Detection(request, response)
+                : robot::perception_api::Detection(client, request, response);
+    if (status != PerceptionResStatus::RESPONSE_SUCCESS) {
+      state.SkipWithError("Detection failed");
+      break;
+    }
+  }
+  allocs.Report(state, request.ByteSizeLong());
+  if (chunked) {
+    state.counters["peak_buffered_bytes"] = static_cast<double>(
+        uploader.GetLastStats().peak_buffered_bytes);
+  }
+}
+// 1MB、1920x1080 BGR、3840x2160 BGR
+BENCHMARK(BM_PerceptionUpload)
+    ->ArgNames({"chunked", "image_bytes"})
+    ->ArgsProduct({{0, 1}, {1 << 20, 1920 * 1080 * 3, 3840 * 2160 * 3}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
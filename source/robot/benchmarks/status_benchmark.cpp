@@ -0,0 +1,83 @@
+/**
+ * @brief Status 构造、判断与 Chain 的基准测试
+ */
+#include <string>
+#include <system_error>
+
+#include "benchmark/benchmark.h"
+#include "benchmark_util.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace benchmarks {
+namespace {
+
+using common::Status;
+
+void BM_StatusOk(benchmark::State& state) {
+  AllocationScope allocs;
+  for (auto _ : state) {
+    Status status;
+    benchmark::DoNotOptimize(static_cast<bool>(status));
+  }
+  allocs.Report(state);
+}
+BENCHMARK(BM_StatusOk);
+
+void BM_StatusError(benchmark::State& state) {
+  AllocationScope allocs;
+  for (auto _ : state) {
+    Status status(std::make_error_code(std::errc::timed_out),
+                  "Deadline exceeded while waiting for response");
+    benchmark::DoNotOptimize(static_cast<bool>(status));
+  }
+  allocs.Report(state);
+}
+BENCHMARK(BM_StatusError);
+
+// 错误逐层向上传递时的 Chain 链，range(0) 为层数
+void BM_StatusChain(benchmark::State& state) {
+  const Status origin(std::make_error_code(std::errc::host_unreachable),
+                      "failed to connect to all addresses");
+  AllocationScope allocs;
+  for (auto _ : state) {
+    Status status = origin;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      status = status.Chain("Failed to create stream");
+    }
+    benchmark::DoNotOptimize(status.message().data());
+  }
+  allocs.Report(state);
+}
+BENCHMARK(BM_StatusChain)->ArgName("depth")->Arg(1)->Arg(4)->Arg(16);
+
+void BM_StatusChainWithCode(benchmark::State& state) {
+  const Status origin(std::make_error_code(std::errc::host_unreachable),
+                      "failed to connect to all addresses");
+  AllocationScope allocs;
+  for (auto _ : state) {
+    Status status = origin.Chain(std::make_error_code(std::errc::io_error),
+                                 "Navigation request failed");
+    benchmark::DoNotOptimize(status.message().data());
+  }
+  allocs.Report(state);
+}
+BENCHMARK(BM_StatusChainWithCode);
+
+void BM_StatusDebugString(benchmark::State& state) {
+  const Status status(std::make_error_code(std::errc::timed_out),
+                      "Deadline exceeded while waiting for response");
+  AllocationScope allocs;
+  for (auto _ : state) {
+    std::string text = status.DebugString();
+    benchmark::DoNotOptimize(text.data());
+  }
+  allocs.Report(state);
+}
+BENCHMARK(BM_StatusDebugString);
+
+}  // namespace
+}  // namespace benchmarks
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -6,50 +6,206 @@
 
 #include "robot/client/client_callback_server.h"
 #include "robot/common/error_code.h"
+#include "robot/common/logger.h"
 
 #include <grpcpp/ext/proto_server_reflection_plugin.h>
 #include <grpcpp/grpcpp.h>
 #include <grpcpp/health_check_service_interface.h>
 
-#include <iostream>
+#include <algorithm>
+#include <mutex>
 #include <sstream>
+#include <vector>
 
 using namespace humanoid_robot::konka_sdk::robot;
 using namespace humanoid_robot::konka_sdk::common;
 using namespace humanoid_robot::PB::interfaces;
 
+namespace {
+// 回调执行失败,客户端不关心服务器处理结果，可以不设置ret
+constexpr int32_t kAckCallbackFailed = -0600060001;
+} // namespace
+
 // =============================================================================
 // ClientCallbackServiceImpl - gRPC服务实现
 // =============================================================================
 
 class ClientCallbackServiceImpl final : public ClientCallbackService::Service {
 public:
-  ClientCallbackServiceImpl(SubscriptionMessageCallback message_callback)
-      : message_callback_(message_callback) {}
+  ClientCallbackServiceImpl(NotificationDispatcher *dispatcher,
+                            NotificationPool *pool, FlowController *flow)
+      : dispatcher_(dispatcher), pool_(pool), flow_(flow) {}
 
   grpc::Status OnSubscriptionMessage(grpc::ServerContext *context,
                                      const Notification *request,
                                      NotificationAck *response) override {
-    std::cout << "Received subscription message from client: " << std::endl;
-    if (message_callback_) {
-      try {
-        message_callback_(*request);
-      } catch (const std::exception &e) {
-        std::cerr << "Error in message callback: " << e.what() << std::endl;
-        response->set_ret(
-            -0600060001); // 回调执行失败,客户端不关心服务器处理结果，可以不设置ret
-        return grpc::Status::OK;
-      }
+    // 线程池模式下入队即确认；内联模式下回调失败返回错误码
+    // 同步服务的请求由 gRPC 分配，复制到池化 arena 消息后分发
+    auto message = pool_->Acquire();
+    message->CopyFrom(*request);
+    double queue_fill = 0.0;
+    if (!dispatcher_->Dispatch(NotificationPtr(std::move(message)),
+                               &queue_fill)) {
+      response->set_ret(kAckCallbackFailed);
+      return grpc::Status::OK;
     }
 
-    // 设置确认响应
-    response->set_ret(0);
+    // 设置确认响应，队列积压时附带流控信号
+    ApplyFlowFeedback(flow_->Evaluate(queue_fill), response, context);
 
     return grpc::Status::OK;
   }
 
 private:
-  SubscriptionMessageCallback message_callback_;
+  NotificationDispatcher *dispatcher_;
+  NotificationPool *pool_;
+  FlowController *flow_;
+};
+
+// =============================================================================
+// AsyncCallbackService - 完成队列（异步）服务实现
+// =============================================================================
+
+/**
+ * 每个完成队列预先挂起固定数量的 CallData，由固定数量的轮询线程驱动。
+ * 一次调用结束后 CallData 重置并重新挂起，不随调用分配和释放。
+ */
+class AsyncCallbackService {
+public:
+  AsyncCallbackService(const CallbackServerOptions &options,
+                       NotificationDispatcher *dispatcher,
+                       NotificationPool *pool, FlowController *flow)
+      : options_(options), dispatcher_(dispatcher), pool_(pool),
+        flow_(flow) {}
+
+  ~AsyncCallbackService() { Shutdown(); }
+
+  grpc::Service *service() { return &service_; }
+
+  void AddCompletionQueues(grpc::ServerBuilder &builder) {
+    size_t queue_count = std::max<size_t>(1, options_.completion_queues);
+    for (size_t i = 0; i < queue_count; ++i) {
+      cqs_.push_back(builder.AddCompletionQueue());
+    }
+  }
+
+  void Start() {
+    size_t calls = std::max<size_t>(1, options_.calls_per_queue);
+    size_t threads = std::max<size_t>(1, options_.threads_per_queue);
+    for (auto &cq : cqs_) {
+      for (size_t i = 0; i < calls; ++i) {
+        calls_.push_back(std::make_unique<CallData>(this, cq.get()));
+        calls_.back()->Request();
+      }
+    }
+    for (auto &cq : cqs_) {
+      grpc::ServerCompletionQueue *raw = cq.get();
+      for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([raw]() { PollLoop(raw); });
+      }
+    }
+  }
+
+  /**
+   * 标记停止，之后不再挂起新的调用（需在 grpc::Server::Shutdown 之前调用）
+   */
+  void BeginShutdown() {
+    std::lock_guard<std::mutex> lock(request_mutex_);
+    shutting_down_ = true;
+  }
+
+  /**
+   * 关闭完成队列并等待轮询线程排空（需在 grpc::Server::Shutdown 之后调用）
+   */
+  void Shutdown() {
+    BeginShutdown();
+    for (auto &cq : cqs_) {
+      cq->Shutdown();
+    }
+    for (auto &thread : threads_) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+    threads_.clear();
+    calls_.clear();
+    cqs_.clear();
+  }
+
+private:
+  class CallData {
+  public:
+    CallData(AsyncCallbackService *owner, grpc::ServerCompletionQueue *cq)
+        : owner_(owner), cq_(cq) {}
+
+    void Request() {
+      std::lock_guard<std::mutex> lock(owner_->request_mutex_);
+      if (owner_->shutting_down_) {
+        return;
+      }
+      context_ = std::make_unique<grpc::ServerContext>();
+      responder_ =
+          std::make_unique<grpc::ServerAsyncResponseWriter<NotificationAck>>(
+              context_.get());
+      // 直接解码到池化 arena 消息中
+      request_ = owner_->pool_->Acquire();
+      reply_.Clear();
+      state_ = State::kWaiting;
+      owner_->service_.RequestOnSubscriptionMessage(
+          context_.get(), request_.get(), responder_.get(), cq_, cq_, this);
+    }
+
+    void Proceed(bool ok) {
+      if (state_ == State::kWaiting && ok) {
+        // 消息交给分发器，入队即确认
+        double queue_fill = 0.0;
+        bool accepted = owner_->dispatcher_->Dispatch(
+            NotificationPtr(std::move(request_)), &queue_fill);
+        if (accepted) {
+          ApplyFlowFeedback(owner_->flow_->Evaluate(queue_fill), &reply_,
+                            context_.get());
+        } else {
+          reply_.set_ret(kAckCallbackFailed);
+        }
+        state_ = State::kFinishing;
+        responder_->Finish(reply_, grpc::Status::OK, this);
+        return;
+      }
+      // 调用结束或被取消，重置后重新挂起
+      Request();
+    }
+
+  private:
+    enum class State { kWaiting, kFinishing };
+
+    AsyncCallbackService *owner_;
+    grpc::ServerCompletionQueue *cq_;
+    std::unique_ptr<grpc::ServerContext> context_;
+    std::unique_ptr<grpc::ServerAsyncResponseWriter<NotificationAck>>
+        responder_;
+    std::shared_ptr<Notification> request_;
+    NotificationAck reply_;
+    State state_ = State::kWaiting;
+  };
+
+  static void PollLoop(grpc::ServerCompletionQueue *cq) {
+    void *tag = nullptr;
+    bool ok = false;
+    while (cq->Next(&tag, &ok)) {
+      static_cast<CallData *>(tag)->Proceed(ok);
+    }
+  }
+
+  CallbackServerOptions options_;
+  NotificationDispatcher *dispatcher_;
+  NotificationPool *pool_;
+  FlowController *flow_;
+  ClientCallbackService::AsyncService service_;
+  std::vector<std::unique_ptr<grpc::ServerCompletionQueue>> cqs_;
+  std::vector<std::unique_ptr<CallData>> calls_;
+  std::vector<std::thread> threads_;
+  std::mutex request_mutex_;
+  bool shutting_down_ = false;
 };
 
 // =============================================================================
@@ -60,26 +216,123 @@ class ClientCallbackServer::Impl {
 public:
   std::unique_ptr<grpc::Server> server_;
   std::unique_ptr<ClientCallbackServiceImpl> service_impl_;
+  std::unique_ptr<AsyncCallbackService> async_service_;
+  std::unique_ptr<NotificationDispatcher> dispatcher_;
+  std::shared_ptr<NotificationPool> pool_;
+  std::unique_ptr<FlowController> flow_;
   std::string listen_address_;
   int listen_port_;
   std::atomic<bool> running_;
   std::thread server_thread_;
 
-  // 回调函数
+  // 回调函数与配置
   SubscriptionMessageCallback message_callback_;
+  NotificationRouter router_;
+  CallbackServerOptions options_;
 
   Impl() : listen_port_(0), running_(false) {}
 
   ~Impl() { Stop(); }
 
+  Status StartServer(const std::string &listen_address, int port,
+                     int *selected_port) {
+    if (running_) {
+      return Status(std::make_error_code(std::errc::operation_not_permitted),
+                    "Server is already running");
+    }
+
+    try {
+      listen_address_ = listen_address;
+      listen_port_ = port;
+
+      // 构建监听地址
+      std::string server_address = listen_address + ":" + std::to_string(port);
+
+      // 创建分发线程池和服务实现
+      pool_ = NotificationPool::Create(options_.pool);
+      dispatcher_ = std::make_unique<NotificationDispatcher>(
+          options_.dispatch, router_.BindHandler(message_callback_));
+      flow_ = std::make_unique<FlowController>(options_.flow_control,
+                                               dispatcher_.get());
+      service_impl_.reset();
+      async_service_.reset();
+
+      // 构建服务器
+      grpc::ServerBuilder builder;
+      builder.AddListeningPort(server_address,
+                               grpc::InsecureServerCredentials(),
+                               selected_port);
+      if (options_.mode == CallbackServerMode::kAsync) {
+        async_service_ = std::make_unique<AsyncCallbackService>(
+            options_, dispatcher_.get(), pool_.get(), flow_.get());
+        builder.RegisterService(async_service_->service());
+        async_service_->AddCompletionQueues(builder);
+      } else {
+        service_impl_ =
+            std::make_unique<ClientCallbackServiceImpl>(
+                dispatcher_.get(), pool_.get(), flow_.get());
+        builder.RegisterService(service_impl_.get());
+      }
+
+      // 启用健康检查和反射（可选）
+      grpc::EnableDefaultHealthCheckService(true);
+      grpc::reflection::InitProtoReflectionServerBuilderPlugin();
+
+      // 构建并启动服务器
+      server_ = builder.BuildAndStart();
+
+      if (!server_) {
+        async_service_.reset();
+        dispatcher_.reset();
+        return Status(std::make_error_code(std::errc::address_not_available),
+                      "Failed to start gRPC callback server");
+      }
+
+      if (selected_port != nullptr) {
+        listen_port_ = *selected_port;
+      }
+      running_ = true;
+      if (async_service_) {
+        async_service_->Start();
+      }
+
+      // 在单独线程中运行服务器
+      server_thread_ = std::thread([this]() {
+        try {
+          KONKA_LOG_INFO("callback") << "Client callback server listening on "
+                                     << listen_address_ << ":" << listen_port_;
+          server_->Wait();
+        } catch (const std::exception &e) {
+          KONKA_LOG_ERROR("callback") << "Error in server thread: " << e.what();
+        }
+      });
+
+      return Status();
+    } catch (const std::exception &e) {
+      return Status(std::make_error_code(std::errc::operation_not_supported),
+                    std::string("Failed to start callback server: ") +
+                        e.what());
+    }
+  }
+
   void Stop() {
     running_ = false;
+    if (async_service_) {
+      async_service_->BeginShutdown();
+    }
     if (server_) {
       server_->Shutdown();
       if (server_thread_.joinable()) {
         server_thread_.join();
       }
     }
+    if (async_service_) {
+      async_service_->Shutdown();
+    }
+    // 服务器停止后不再有新消息，处理完已排队的消息
+    if (dispatcher_) {
+      dispatcher_->Stop();
+    }
   }
 };
 
@@ -94,117 +347,19 @@ ClientCallbackServer::~ClientCallbackServer() = default;
 
 Status ClientCallbackServer::Start(const std::string &listen_address,
                                    int port) {
-  if (pImpl_->running_) {
-    return Status(std::make_error_code(std::errc::operation_not_permitted),
-                  "Server is already running");
-  }
-
-  try {
-    pImpl_->listen_address_ = listen_address;
-    pImpl_->listen_port_ = port;
-
-    // 构建监听地址
-    std::string server_address = listen_address + ":" + std::to_string(port);
-
-    // 创建服务实现
-    pImpl_->service_impl_ =
-        std::make_unique<ClientCallbackServiceImpl>(pImpl_->message_callback_);
-
-    // 构建服务器
-    grpc::ServerBuilder builder;
-    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials());
-    builder.RegisterService(pImpl_->service_impl_.get());
-
-    // 启用健康检查和反射（可选）
-    grpc::EnableDefaultHealthCheckService(true);
-    grpc::reflection::InitProtoReflectionServerBuilderPlugin();
-
-    // 构建并启动服务器
-    pImpl_->server_ = builder.BuildAndStart();
-
-    if (!pImpl_->server_) {
-      return Status(std::make_error_code(std::errc::address_not_available),
-                    "Failed to start gRPC callback server");
-    }
-
-    pImpl_->running_ = true;
-
-    // 在单独线程中运行服务器
-    pImpl_->server_thread_ = std::thread([this]() {
-      try {
-
-        std::cout << "Client callback server listening on "
-                  << pImpl_->listen_address_ << ":" << pImpl_->listen_port_
-                  << std::endl;
-        pImpl_->server_->Wait();
-      } catch (const std::exception &e) {
-        std::cerr << "❌ Error in server thread: " << e.what() << std::endl;
-      }
-    });
-
-    return Status();
-  } catch (const std::exception &e) {
-    return Status(std::make_error_code(std::errc::operation_not_supported),
-                  std::string("Failed to start callback server: ") + e.what());
-  }
+  return pImpl_->StartServer(listen_address, port, nullptr);
 }
 
 Status
 ClientCallbackServer::StartWithAutoPort(const std::string &listen_address,
                                         int &assigned_port) {
-  if (pImpl_->running_) {
-    return Status(std::make_error_code(std::errc::operation_not_permitted),
-                  "Server is already running");
-  }
-
-  try {
-    pImpl_->listen_address_ = listen_address;
-    pImpl_->listen_port_ = 0; // 使用0让系统自动分配
-
-    // 构建监听地址
-    std::string server_address = listen_address + ":0";
-
-    // 创建服务实现
-    pImpl_->service_impl_ =
-        std::make_unique<ClientCallbackServiceImpl>(pImpl_->message_callback_);
-
-    // 构建服务器
-    grpc::ServerBuilder builder;
-    int selected_port = 0;
-    builder.AddListeningPort(server_address, grpc::InsecureServerCredentials(),
-                             &selected_port);
-    builder.RegisterService(pImpl_->service_impl_.get());
-
-    // 启用健康检查和反射（可选）
-    grpc::EnableDefaultHealthCheckService(true);
-    grpc::reflection::InitProtoReflectionServerBuilderPlugin();
-
-    // 构建并启动服务器
-    pImpl_->server_ = builder.BuildAndStart();
-
-    if (!pImpl_->server_) {
-      return Status(std::make_error_code(std::errc::address_not_available),
-                    "Failed to start gRPC callback server");
-    }
-
+  int selected_port = 0;
+  Status status = pImpl_->StartServer(listen_address, 0, &selected_port);
+  if (status) {
     // 获取实际分配的端口
     assigned_port = selected_port;
-    pImpl_->listen_port_ = assigned_port;
-    pImpl_->running_ = true;
-
-    // 在单独线程中运行服务器
-    pImpl_->server_thread_ = std::thread([this]() {
-      std::cout << "Client callback server listening on "
-                << pImpl_->listen_address_ << ":" << pImpl_->listen_port_
-                << std::endl;
-      pImpl_->server_->Wait();
-    });
-
-    return Status();
-  } catch (const std::exception &e) {
-    return Status(std::make_error_code(std::errc::operation_not_supported),
-                  std::string("Failed to start callback server: ") + e.what());
   }
+  return status;
 }
 
 void ClientCallbackServer::Stop() { pImpl_->Stop(); }
@@ -227,6 +382,47 @@ void ClientCallbackServer::SetSubscriptionMessageCallback(
   pImpl_->message_callback_ = callback;
 }
 
+SubscriptionHandlerId
+ClientCallbackServer::AddSubscriptionHandler(const std::string &event_type,
+                                             NotificationHandler handler) {
+  return pImpl_->router_.Add(event_type, std::move(handler));
+}
+
+SubscriptionHandlerId
+ClientCallbackServer::AddSubscriptionHandler(const std::string &event_type,
+                                             const std::string &object_id,
+                                             NotificationHandler handler) {
+  return pImpl_->router_.Add(event_type, object_id, std::move(handler));
+}
+
+bool ClientCallbackServer::RemoveSubscriptionHandler(SubscriptionHandlerId id) {
+  return pImpl_->router_.Remove(id);
+}
+
+void ClientCallbackServer::SetServerOptions(
+    const CallbackServerOptions &options) {
+  if (pImpl_->running_) {
+    throw std::runtime_error("Cannot set options while server is running. "
+                             "Please set options before starting the server.");
+  }
+
+  pImpl_->options_ = options;
+}
+
+CallbackServerStats ClientCallbackServer::GetStats() const {
+  CallbackServerStats stats;
+  if (pImpl_->dispatcher_) {
+    stats.dispatch = pImpl_->dispatcher_->GetStats();
+  }
+  if (pImpl_->pool_) {
+    stats.pool = pImpl_->pool_->GetStats();
+  }
+  if (pImpl_->flow_) {
+    stats.flow_control = pImpl_->flow_->GetStats();
+  }
+  return stats;
+}
+
 std::string ClientCallbackServer::GetClientEndpoint() const {
   if (pImpl_->listen_address_.empty() || pImpl_->listen_port_ == 0) {
     return "";
@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of ClockSync
+ */
+
+#include "robot/client/clock_sync.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+using humanoid_robot::PB::common::Variant;
+
+namespace {
+// 漂移估计的上限，超出视为网络抖动造成的拟合误差
+constexpr double kMaxDrift = 500e-6;
+// 拟合漂移所需的最少轮数
+constexpr size_t kMinDriftRounds = 3;
+
+int64_t ReadTimestamp(const QueryResponse &response, const char *key) {
+  const auto &output = response.output().keyvaluelist();
+  auto it = output.find(key);
+  return it == output.end() ? 0 : it->second.int64value();
+}
+} // namespace
+
+// =============================================================================
+// ClockSync::Impl - 私有实现
+// =============================================================================
+
+class ClockSync::Impl {
+public:
+  struct Round {
+    int64_t local_ns;
+    int64_t offset_ns;
+  };
+
+  std::shared_ptr<InterfacesClient> client_;
+  ClockSyncOptions options_;
+
+  // 换算模型：offset(t) = ref_offset + drift * (t - ref_local)，序列锁发布
+  std::atomic<uint64_t> model_seq_{0};
+  std::atomic<int64_t> ref_local_ns_{0};
+  std::atomic<int64_t> ref_offset_ns_{0};
+  std::atomic<double> drift_{0.0};
+  std::atomic<bool> synced_{false};
+
+  std::mutex sync_mutex_; // 串行化对时轮次
+  std::deque<Round> rounds_;
+  std::atomic<int64_t> round_trip_ns_{0};
+  std::atomic<uint64_t> round_count_{0};
+  std::atomic<uint64_t> failures_{0};
+
+  std::thread thread_;
+  std::mutex thread_mutex_;
+  std::condition_variable stop_cv_;
+  bool stopping_ = false;
+
+  Impl(std::shared_ptr<InterfacesClient> client, ClockSyncOptions options)
+      : client_(std::move(client)), options_(options) {
+    if (options_.samples_per_round <= 0) {
+      options_.samples_per_round = 1;
+    }
+  }
+
+  ~Impl() { Stop(); }
+
+  // 单次探测，返回 false 表示失败
+  bool Probe(int64_t *offset_ns, int64_t *round_trip_ns) {
+    QueryRequest request;
+    auto *input = request.mutable_input()->mutable_keyvaluelist();
+    Variant &flag = (*input)[kClockSyncKey];
+    flag.set_type(Variant::KBoolValue);
+    flag.set_boolvalue(true);
+    Variant &t1_value = (*input)[kClockSyncT1Key];
+    t1_value.set_type(Variant::KInt64Value);
+
+    QueryResponse response;
+    int64_t t1 = LocalTimeNs();
+    t1_value.set_int64value(t1);
+    Status status =
+        client_->Query(request, response, options_.request_timeout_ms);
+    int64_t t4 = LocalTimeNs();
+    if (!status) {
+      return false;
+    }
+    int64_t t2 = ReadTimestamp(response, kClockSyncT2Key);
+    int64_t t3 = ReadTimestamp(response, kClockSyncT3Key);
+    if (t2 == 0) {
+      return false; // 网关不支持对时
+    }
+    if (t3 == 0) {
+      t3 = t2;
+    }
+    *round_trip_ns = std::max<int64_t>(0, (t4 - t1) - (t3 - t2));
+    *offset_ns = ((t2 - t1) + (t3 - t4)) / 2;
+    return true;
+  }
+
+  Status SyncOnce() {
+    if (!client_) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Interfaces client is null");
+    }
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    int64_t best_offset = 0;
+    int64_t best_rtt = std::numeric_limits<int64_t>::max();
+    int64_t best_local = 0;
+    for (int i = 0; i < options_.samples_per_round; ++i) {
+      int64_t offset = 0;
+      int64_t rtt = 0;
+      int64_t local = LocalTimeNs();
+      if (Probe(&offset, &rtt) && rtt < best_rtt) {
+        best_rtt = rtt;
+        best_offset = offset;
+        best_local = local + rtt / 2;
+      }
+    }
+    if (best_rtt == std::numeric_limits<int64_t>::max()) {
+      failures_.fetch_add(1, std::memory_order_relaxed);
+      return Status(std::make_error_code(std::errc::timed_out),
+                    "Clock sync probes failed");
+    }
+
+    rounds_.push_back(Round{best_local, best_offset});
+    while (rounds_.size() > std::max<size_t>(options_.drift_window, 1)) {
+      rounds_.pop_front();
+    }
+    round_trip_ns_.store(best_rtt, std::memory_order_relaxed);
+    round_count_.fetch_add(1, std::memory_order_relaxed);
+    UpdateModel();
+    return Status();
+  }
+
+  // 最小二乘拟合最近若干轮的偏移，得到参考点的偏移和漂移
+  void UpdateModel() {
+    const Round &latest = rounds_.back();
+    int64_t ref_offset = latest.offset_ns;
+    double drift = 0.0;
+    if (rounds_.size() >= kMinDriftRounds) {
+      double mean_x = 0.0;
+      double mean_y = 0.0;
+      for (const Round &round : rounds_) {
+        mean_x += static_cast<double>(round.local_ns - latest.local_ns);
+        mean_y += static_cast<double>(round.offset_ns - latest.offset_ns);
+      }
+      mean_x /= rounds_.size();
+      mean_y /= rounds_.size();
+      double sxx = 0.0;
+      double sxy = 0.0;
+      for (const Round &round : rounds_) {
+        double dx =
+            static_cast<double>(round.local_ns - latest.local_ns) - mean_x;
+        double dy =
+            static_cast<double>(round.offset_ns - latest.offset_ns) - mean_y;
+        sxx += dx * dx;
+        sxy += dx * dy;
+      }
+      if (sxx > 0.0) {
+        drift = std::max(-kMaxDrift, std::min(kMaxDrift, sxy / sxx));
+        // 参考点取拟合直线在最新一轮处的值，平滑单轮抖动
+        ref_offset = latest.offset_ns +
+                     static_cast<int64_t>(mean_y - drift * mean_x);
+      }
+    }
+
+    uint64_t seq = model_seq_.load(std::memory_order_relaxed);
+    model_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ref_local_ns_.store(latest.local_ns, std::memory_order_relaxed);
+    ref_offset_ns_.store(ref_offset, std::memory_order_relaxed);
+    drift_.store(drift, std::memory_order_relaxed);
+    model_seq_.store(seq + 2, std::memory_order_release);
+    synced_.store(true, std::memory_order_release);
+  }
+
+  int64_t OffsetNs(int64_t local_ns) const {
+    if (!synced_.load(std::memory_order_acquire)) {
+      return 0;
+    }
+    int64_t ref_local;
+    int64_t ref_offset;
+    double drift;
+    uint64_t seq;
+    do {
+      seq = model_seq_.load(std::memory_order_acquire);
+      ref_local = ref_local_ns_.load(std::memory_order_relaxed);
+      ref_offset = ref_offset_ns_.load(std::memory_order_relaxed);
+      drift = drift_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 ||
+             seq != model_seq_.load(std::memory_order_relaxed));
+    return ref_offset +
+           static_cast<int64_t>(drift * static_cast<double>(local_ns -
+                                                            ref_local));
+  }
+
+  void Loop() {
+    std::unique_lock<std::mutex> lock(thread_mutex_);
+    while (!stopping_) {
+      stop_cv_.wait_for(lock, std::chrono::milliseconds(options_.interval_ms),
+                        [this]() { return stopping_; });
+      if (stopping_) {
+        break;
+      }
+      lock.unlock();
+      SyncOnce().IgnoreError();
+      lock.lock();
+    }
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(thread_mutex_);
+      stopping_ = true;
+    }
+    stop_cv_.notify_all();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+};
+
+// =============================================================================
+// ClockSync 实现
+// =============================================================================
+
+ClockSync::ClockSync(std::shared_ptr<InterfacesClient> client,
+                     ClockSyncOptions options)
+    : pImpl_(std::make_unique<Impl>(std::move(client), options)) {}
+
+ClockSync::~ClockSync() = default;
+
+Status ClockSync::Start() {
+  if (pImpl_->thread_.joinable()) {
+    return Status(std::make_error_code(std::errc::operation_not_permitted),
+                  "Clock sync is already running");
+  }
+  Status status = pImpl_->SyncOnce();
+  if (!status) {
+    return status.Chain("Initial clock sync failed");
+  }
+  pImpl_->stopping_ = false;
+  pImpl_->thread_ = std::thread([this]() { pImpl_->Loop(); });
+  return Status();
+}
+
+void ClockSync::Stop() { pImpl_->Stop(); }
+
+Status ClockSync::SyncOnce() { return pImpl_->SyncOnce(); }
+
+bool ClockSync::IsSynced() const {
+  return pImpl_->synced_.load(std::memory_order_acquire);
+}
+
+int64_t ClockSync::OffsetNs(int64_t local_ns) const {
+  return pImpl_->OffsetNs(local_ns);
+}
+
+int64_t ClockSync::ToServerTimeNs(int64_t local_ns) const {
+  return local_ns + pImpl_->OffsetNs(local_ns);
+}
+
+int64_t ClockSync::ServerTimeNs() const {
+  return ToServerTimeNs(LocalTimeNs());
+}
+
+int64_t ClockSync::LocalTimeNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+ClockSyncStats ClockSync::GetStats() const {
+  ClockSyncStats stats;
+  stats.synced = IsSynced();
+  stats.offset_ns = OffsetNs(LocalTimeNs());
+  stats.drift_ppm = pImpl_->drift_.load(std::memory_order_relaxed) * 1e6;
+  stats.round_trip_ns = pImpl_->round_trip_ns_.load(std::memory_order_relaxed);
+  stats.rounds = pImpl_->round_count_.load(std::memory_order_relaxed);
+  stats.failures = pImpl_->failures_.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of FlowController
+ */
+
+#include "robot/client/flow_control.h"
+#include "robot/client/notification_dispatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+// 消费速率指数平滑系数
+constexpr double kRateSmoothing = 0.5;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+// =============================================================================
+// FlowController::Impl - 私有实现
+// =============================================================================
+
+class FlowController::Impl {
+public:
+  FlowControlOptions options_;
+  const NotificationDispatcher *dispatcher_;
+
+  std::atomic<int64_t> last_sample_ns_;
+  std::atomic<uint64_t> last_count_{0};
+  std::atomic<double> rate_hz_{0.0};
+  std::atomic<uint64_t> slow_down_{0};
+  std::atomic<uint64_t> drop_{0};
+
+  Impl(FlowControlOptions options, const NotificationDispatcher *dispatcher)
+      : options_(options), dispatcher_(dispatcher), last_sample_ns_(NowNs()) {}
+
+  // 周期到达时由一个线程完成采样，其他线程直接使用上一次的结果
+  void Sample() {
+    int64_t now_ns = NowNs();
+    int64_t last_ns = last_sample_ns_.load(std::memory_order_relaxed);
+    int64_t window_ns = options_.rate_window_ms * 1000000;
+    if (now_ns - last_ns < window_ns ||
+        !last_sample_ns_.compare_exchange_strong(last_ns, now_ns)) {
+      return;
+    }
+    uint64_t count = dispatcher_->DispatchedCount();
+    uint64_t last_count = last_count_.exchange(count);
+    double instant = static_cast<double>(count - last_count) * 1e9 /
+                     static_cast<double>(now_ns - last_ns);
+    double previous = rate_hz_.load(std::memory_order_relaxed);
+    rate_hz_.store(previous == 0.0 ? instant
+                                   : previous + kRateSmoothing *
+                                                    (instant - previous),
+                   std::memory_order_relaxed);
+  }
+};
+
+// =============================================================================
+// FlowController 实现
+// =============================================================================
+
+FlowController::FlowController(FlowControlOptions options,
+                               const NotificationDispatcher *dispatcher)
+    : pImpl_(std::make_unique<Impl>(options, dispatcher)) {}
+
+FlowController::~FlowController() = default;
+
+FlowFeedback FlowController::Evaluate(double queue_fill) {
+  FlowFeedback feedback;
+  if (!pImpl_->options_.enabled || pImpl_->dispatcher_ == nullptr) {
+    return feedback;
+  }
+  pImpl_->Sample();
+  if (queue_fill >= pImpl_->options_.drop_watermark) {
+    feedback.signal = FlowSignal::kDrop;
+    pImpl_->drop_.fetch_add(1, std::memory_order_relaxed);
+  } else if (queue_fill >= pImpl_->options_.slow_down_watermark) {
+    feedback.signal = FlowSignal::kSlowDown;
+    pImpl_->slow_down_.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    return feedback;
+  }
+  feedback.suggested_rate_hz =
+      DrainRateHz() * pImpl_->options_.rate_margin;
+  return feedback;
+}
+
+double FlowController::DrainRateHz() const {
+  return pImpl_->rate_hz_.load(std::memory_order_relaxed);
+}
+
+FlowControlStats FlowController::GetStats() const {
+  FlowControlStats stats;
+  stats.slow_down = pImpl_->slow_down_.load(std::memory_order_relaxed);
+  stats.drop = pImpl_->drop_.load(std::memory_order_relaxed);
+  stats.drain_rate_hz = DrainRateHz();
+  return stats;
+}
+
+// =============================================================================
+// 确认消息编解码
+// =============================================================================
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+void ApplyFlowFeedback(const FlowFeedback &feedback, NotificationAck *ack,
+                       grpc::ServerContext *context) {
+  switch (feedback.signal) {
+  case FlowSignal::kSlowDown:
+    ack->set_ret(kAckSlowDown);
+    break;
+  case FlowSignal::kDrop:
+    ack->set_ret(kAckDrop);
+    break;
+  default:
+    ack->set_ret(kAckOk);
+    return;
+  }
+  if (context != nullptr && feedback.suggested_rate_hz > 0.0) {
+    context->AddTrailingMetadata(
+        kSuggestedRateMetadataKey,
+        std::to_string(static_cast<int64_t>(feedback.suggested_rate_hz)));
+  }
+}
+
+FlowFeedback ParseFlowFeedback(const NotificationAck &ack,
+                               const grpc::ClientContext &context) {
+  FlowFeedback feedback;
+  if (ack.ret() == kAckSlowDown) {
+    feedback.signal = FlowSignal::kSlowDown;
+  } else if (ack.ret() == kAckDrop) {
+    feedback.signal = FlowSignal::kDrop;
+  } else {
+    return feedback;
+  }
+  const auto &trailers = context.GetServerTrailingMetadata();
+  auto it = trailers.find(kSuggestedRateMetadataKey);
+  if (it != trailers.end()) {
+    std::string value(it->second.data(), it->second.size());
+    feedback.suggested_rate_hz = std::strtod(value.c_str(), nullptr);
+  }
+  return feedback;
+}
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
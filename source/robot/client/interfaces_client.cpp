@@ -10,15 +10,35 @@
 
 #include <chrono>
 #include <ctime>
-#include <iostream>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <thread>
 
 #include "robot/common/error_code.h"
+#include "robot/common/logger.h"
+#include "robot/common/metrics.h"
+#include "robot/common/tracing.h"
 
 using namespace humanoid_robot::konka_sdk::robot;
 using namespace humanoid_robot::konka_sdk::common;
 using namespace humanoid_robot::PB::interfaces;
 
+namespace {
+// Query key used for the capability handshake, value is a comma separated list
+constexpr const char *kCapabilitiesKey = "capabilities";
+// Action input flag that turns the call into a streaming subscription
+constexpr const char *kSubscribeStreamKey = "subscribe_stream";
+
+// Propagate the current span to the gateway as W3C traceparent metadata
+void InjectTraceContext(grpc::ClientContext &context) {
+  TraceContext trace = Tracer::Current();
+  if (trace.IsValid()) {
+    context.AddMetadata(kTraceparentKey, trace.ToTraceparent());
+  }
+}
+} // namespace
+
 // Private implementation class
 class InterfacesClient::InterfacesClientImpl {
 public:
@@ -27,6 +47,10 @@ public:
   std::string target_;
   bool connected_;
 
+  // Capabilities accepted by the server during negotiation
+  mutable std::mutex capabilities_mutex_;
+  std::set<std::string> capabilities_;
+
   InterfacesClientImpl() : connected_(false) {}
 
   ~InterfacesClientImpl() {
@@ -46,13 +70,15 @@ InterfacesClient::InterfacesClient()
       try {
         loaded_config_ = config_manager_->LoadFromFile(config_path);
         if (loaded_config_.IsEmpty()) {
-          std::cerr << "[InterfacesClient] Config file loaded but empty: " << config_path << std::endl;
+          KONKA_LOG_WARN("client").Field("path", config_path)
+              << "Config file loaded but empty";
         } else {
-          std::cout << "[InterfacesClient] Config file loaded successfully: " << config_path << std::endl;
+          KONKA_LOG_INFO("client").Field("path", config_path)
+              << "Config file loaded successfully";
         }
       } catch (const std::exception& e) {
-        std::cerr << "[InterfacesClient] Failed to load config file: " << config_path 
-                  << ", error: " << e.what() << std::endl;
+        KONKA_LOG_WARN("client").Field("path", config_path)
+            << "Failed to load config file: " << e.what();
         loaded_config_ = humanoid_robot::framework::common::ConfigNode(); // 初始化为空节点
       }
     }
@@ -116,6 +142,9 @@ void InterfacesClient::Disconnect() {
   pImpl_->stub_.reset();
   pImpl_->channel_.reset();
   pImpl_->connected_ = false;
+
+  std::lock_guard<std::mutex> lock(pImpl_->capabilities_mutex_);
+  pImpl_->capabilities_.clear();
 }
 
 bool InterfacesClient::IsConnected() const {
@@ -139,6 +168,7 @@ Status InterfacesClient::Send(
   // Allocate context on heap and pass ownership to caller
   context = std::make_unique<grpc::ClientContext>();
   context->set_deadline(GetDeadline(timeout_ms));
+  InjectTraceContext(*context);
 
   readWriter = pImpl_->stub_->Send(context.get());
   if (!readWriter) {
@@ -152,16 +182,24 @@ Status InterfacesClient::Query(
     const humanoid_robot::PB::interfaces::QueryRequest &request,
     humanoid_robot::PB::interfaces::QueryResponse &response,
     int64_t timeout_ms) {
+  RequestTimer timer(kMetricMethodQuery, 0);
   if (!IsConnected()) {
+    timer.Fail(MetricErrorCategory::kNotConnected);
     return Status(std::make_error_code(std::errc::not_connected),
                   "Client not connected");
   }
 
   grpc::ClientContext context;
   context.set_deadline(GetDeadline(timeout_ms));
+  InjectTraceContext(context);
 
   grpc::Status status = pImpl_->stub_->Query(&context, request, &response);
-  return ConvertGrpcStatus(status);
+  timer.Mark(MetricPhase::kServerWait);
+  Status result = ConvertGrpcStatus(status);
+  if (!result) {
+    timer.Fail(result);
+  }
+  return result;
 }
 
 Status InterfacesClient::Action(
@@ -175,6 +213,7 @@ Status InterfacesClient::Action(
                   "Client not connected");
   }
 
+  InjectTraceContext(context);
   reader = pImpl_->stub_->Action(&context, request);
 
   if (!reader) {
@@ -189,17 +228,25 @@ Status InterfacesClient::Unsubscribe(
     const humanoid_robot::PB::interfaces::UnsubscribeRequest &request,
     humanoid_robot::PB::interfaces::UnsubscribeResponse &response,
     int64_t timeout_ms) {
+  RequestTimer timer(kMetricMethodUnsubscribe, 0);
   if (!IsConnected()) {
+    timer.Fail(MetricErrorCategory::kNotConnected);
     return Status(std::make_error_code(std::errc::not_connected),
                   "Client not connected");
   }
 
   grpc::ClientContext context;
   context.set_deadline(GetDeadline(timeout_ms));
+  InjectTraceContext(context);
 
   grpc::Status status =
       pImpl_->stub_->Unsubscribe(&context, request, &response);
-  return ConvertGrpcStatus(status);
+  timer.Mark(MetricPhase::kServerWait);
+  Status result = ConvertGrpcStatus(status);
+  if (!result) {
+    timer.Fail(result);
+  }
+  return result;
 }
 
 // =================================================================
@@ -289,7 +336,9 @@ Status InterfacesClient::Subscribe(
     const humanoid_robot::PB::interfaces::SubscribeRequest &request,
     humanoid_robot::PB::interfaces::SubscribeResponse &response,
     int64_t timeout_ms) {
+  RequestTimer timer(kMetricMethodSubscribe, 0);
   if (!IsConnected()) {
+    timer.Fail(MetricErrorCategory::kNotConnected);
     return Status(std::make_error_code(std::errc::not_connected),
                   "Client not connected");
   }
@@ -298,9 +347,43 @@ Status InterfacesClient::Subscribe(
   if (timeout_ms > 0) {
     context.set_deadline(GetDeadline(timeout_ms));
   }
+  InjectTraceContext(context);
 
   auto status = pImpl_->stub_->Subscribe(&context, request, &response);
-  return ConvertGrpcStatus(status);
+  timer.Mark(MetricPhase::kServerWait);
+  Status result = ConvertGrpcStatus(status);
+  if (!result) {
+    timer.Fail(result);
+  }
+  return result;
+}
+
+Status InterfacesClient::SubscribeStream(
+    const humanoid_robot::PB::interfaces::SubscribeRequest &request,
+    std::unique_ptr<
+        ::grpc::ClientReader<::humanoid_robot::PB::interfaces::ActionResponse>>
+        &reader,
+    grpc::ClientContext &context) {
+  if (!IsConnected()) {
+    return Status(std::make_error_code(std::errc::not_connected),
+                  "Client not connected");
+  }
+
+  ActionRequest action_request;
+  *action_request.mutable_input() = request.input();
+  *action_request.mutable_params() = request.params();
+  (*action_request.mutable_input()->mutable_keyvaluelist())[kSubscribeStreamKey]
+      .set_boolvalue(true);
+
+  InjectTraceContext(context);
+  reader = pImpl_->stub_->Action(&context, action_request);
+
+  if (!reader) {
+    return Status(std::make_error_code(std::errc::io_error),
+                  "Failed to create subscription stream");
+  }
+
+  return Status(); // 成功
 }
 
 // =================================================================
@@ -327,10 +410,10 @@ bool InterfacesClient::WaitForChannelReady(int64_t timeout_ms) {
     state = pImpl_->channel_->GetState(false);
 
     // print remaining time in seconds
-    std::cout << "Wait for channel ready, remaining time: "
-              << int((deadline - std::chrono::system_clock::now()).count() /
-                     1e9)
-              << " s" << std::endl;
+    KONKA_LOG_DEBUG("client")
+        << "Wait for channel ready, remaining time: "
+        << int((deadline - std::chrono::system_clock::now()).count() / 1e9)
+        << " s";
     // sleep 1 s
     std::this_thread::sleep_for(std::chrono::seconds(1));
   }
@@ -338,6 +421,64 @@ bool InterfacesClient::WaitForChannelReady(int64_t timeout_ms) {
   return state == GRPC_CHANNEL_READY;
 }
 
+// =================================================================
+// Capability Negotiation
+// =================================================================
+
+Status InterfacesClient::NegotiateCapabilities(
+    const std::vector<std::string> &offered, int64_t timeout_ms) {
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->capabilities_mutex_);
+    pImpl_->capabilities_.clear();
+  }
+  if (offered.empty()) {
+    return Status();
+  }
+
+  std::string offered_list;
+  for (const auto &capability : offered) {
+    if (!offered_list.empty()) {
+      offered_list += ",";
+    }
+    offered_list += capability;
+  }
+
+  QueryRequest request;
+  (*request.mutable_input()->mutable_keyvaluelist())[kCapabilitiesKey]
+      .set_stringvalue(offered_list);
+  QueryResponse response;
+  auto status = Query(request, response, timeout_ms);
+  if (!status) {
+    return status.Chain("Capability negotiation failed");
+  }
+
+  const auto &output = response.output().keyvaluelist();
+  auto accepted_it = output.find(kCapabilitiesKey);
+  if (accepted_it == output.end()) {
+    return Status(); // Server knows no optional capability
+  }
+
+  std::set<std::string> offered_set(offered.begin(), offered.end());
+  std::set<std::string> accepted;
+  std::stringstream accepted_list(accepted_it->second.stringvalue());
+  std::string capability;
+  while (std::getline(accepted_list, capability, ',')) {
+    // Only keep capabilities that this client actually offered
+    if (offered_set.count(capability) != 0) {
+      accepted.insert(capability);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(pImpl_->capabilities_mutex_);
+  pImpl_->capabilities_ = std::move(accepted);
+  return Status();
+}
+
+bool InterfacesClient::HasCapability(const std::string &capability) const {
+  std::lock_guard<std::mutex> lock(pImpl_->capabilities_mutex_);
+  return pImpl_->capabilities_.count(capability) != 0;
+}
+
 // =================================================================
 // Private Helper Methods
 // =================================================================
@@ -0,0 +1,186 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of NotificationConflator
+ */
+
+#include "robot/client/notification_conflator.h"
+#include "robot/client/notification_router.h"
+#include "robot/common/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+} // namespace
+
+// =============================================================================
+// NotificationConflator::Impl - 私有实现
+// =============================================================================
+
+class NotificationConflator::Impl {
+public:
+  struct Slot {
+    NotificationPtr latest;
+    int64_t period_ns = 0;
+    int64_t next_due_ns = 0;
+    bool pending = false;
+  };
+
+  // 待投递的槽位，按到期时间排序
+  struct Due {
+    int64_t due_ns;
+    Slot *slot;
+    bool operator>(const Due &other) const { return due_ns > other.due_ns; }
+  };
+
+  std::unordered_map<std::string, int64_t> periods_ns_;
+  NotificationHandler deliver_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  // unordered_map 的节点地址在插入后保持不变，堆中可直接保存指针
+  std::unordered_map<std::string, Slot> slots_;
+  std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due_;
+  bool stopping_ = false;
+  std::thread thread_;
+
+  uint64_t offered_ = 0;
+  uint64_t conflated_ = 0;
+  std::atomic<uint64_t> delivered_{0};
+
+  Impl(std::unordered_map<std::string, double> topics,
+       NotificationHandler deliver)
+      : deliver_(std::move(deliver)) {
+    for (const auto &topic : topics) {
+      periods_ns_[topic.first] =
+          topic.second > 0.0 ? static_cast<int64_t>(1e9 / topic.second) : 0;
+    }
+    thread_ = std::thread([this]() { DeliverLoop(); });
+  }
+
+  void Deliver(const NotificationPtr &message) {
+    try {
+      deliver_(message);
+    } catch (const std::exception &e) {
+      KONKA_LOG_ERROR("conflator") << "Error delivering conflated message: "
+                                   << e.what();
+    }
+    delivered_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void DeliverLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      if (due_.empty()) {
+        if (stopping_) {
+          return;
+        }
+        cv_.wait(lock);
+        continue;
+      }
+      int64_t now_ns = NowNs();
+      Due next = due_.top();
+      // 停止时不再等待限速，直接投递剩余的最新值
+      if (!stopping_ && next.due_ns > now_ns) {
+        cv_.wait_for(lock, std::chrono::nanoseconds(next.due_ns - now_ns));
+        continue;
+      }
+      due_.pop();
+      Slot &slot = *next.slot;
+      NotificationPtr message = std::move(slot.latest);
+      slot.pending = false;
+      slot.next_due_ns = now_ns + slot.period_ns;
+      lock.unlock();
+      Deliver(message);
+      lock.lock();
+    }
+  }
+};
+
+// =============================================================================
+// NotificationConflator 实现
+// =============================================================================
+
+NotificationConflator::NotificationConflator(
+    std::unordered_map<std::string, double> topics,
+    NotificationHandler deliver)
+    : pImpl_(std::make_unique<Impl>(std::move(topics), std::move(deliver))) {}
+
+NotificationConflator::~NotificationConflator() { Stop(); }
+
+bool NotificationConflator::Offer(const NotificationPtr &message) {
+  if (!message) {
+    return false;
+  }
+  std::string event_type = NotificationRouter::EventTypeOf(*message);
+  auto period_it = pImpl_->periods_ns_.find(event_type);
+  if (period_it == pImpl_->periods_ns_.end()) {
+    return false;
+  }
+  std::string key = event_type;
+  key.push_back('\x1f');
+  key.append(NotificationRouter::ObjectIdOf(*message));
+
+  bool wake = false;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    if (pImpl_->stopping_) {
+      return false;
+    }
+    pImpl_->offered_++;
+    Impl::Slot &slot = pImpl_->slots_[key];
+    slot.period_ns = period_it->second;
+    if (slot.pending) {
+      // 上一个值尚未投递，直接覆盖
+      pImpl_->conflated_++;
+      slot.latest = message;
+      return true;
+    }
+    slot.latest = message;
+    slot.pending = true;
+    int64_t due_ns = std::max(NowNs(), slot.next_due_ns);
+    wake = pImpl_->due_.empty() || due_ns < pImpl_->due_.top().due_ns;
+    pImpl_->due_.push(Impl::Due{due_ns, &slot});
+  }
+  if (wake) {
+    pImpl_->cv_.notify_one();
+  }
+  return true;
+}
+
+void NotificationConflator::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    pImpl_->stopping_ = true;
+  }
+  pImpl_->cv_.notify_one();
+  if (pImpl_->thread_.joinable()) {
+    pImpl_->thread_.join();
+  }
+}
+
+NotificationConflationStats NotificationConflator::GetStats() const {
+  NotificationConflationStats stats;
+  std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+  stats.offered = pImpl_->offered_;
+  stats.conflated = pImpl_->conflated_;
+  stats.delivered = pImpl_->delivered_.load(std::memory_order_relaxed);
+  stats.slots = pImpl_->slots_.size();
+  return stats;
+}
@@ -0,0 +1,518 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of NotificationDispatcher
+ */
+
+#include "robot/client/notification_dispatcher.h"
+#include "robot/client/clock_sync.h"
+#include "robot/client/notification_conflator.h"
+#include "robot/common/latency_histogram.h"
+#include "robot/common/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::konka_sdk::common;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+constexpr const char *kEventTypeKey = "event_type";
+constexpr const char *kObjectIdKey = "object_id";
+// 统计的事件类型数上限，防止异常数据撑大统计表
+constexpr size_t kMaxTrackedTopics = 256;
+
+const std::string kUntypedTopic;
+
+thread_local NotificationTiming current_timing;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+size_t HashVariant(const humanoid_robot::PB::common::Variant &value) {
+  if (!value.stringvalue().empty()) {
+    return std::hash<std::string>()(value.stringvalue());
+  }
+  if (value.int64value() != 0) {
+    return std::hash<int64_t>()(value.int64value());
+  }
+  return std::hash<int64_t>()(value.int32value());
+}
+
+size_t HashField(const Notification &message, const char *key) {
+  const auto &fields = message.notifymessage().keyvaluelist();
+  auto it = fields.find(key);
+  return it == fields.end() ? 0 : HashVariant(it->second);
+}
+} // namespace
+
+// =============================================================================
+// NotificationDispatcher::Impl - 私有实现
+// =============================================================================
+
+class NotificationDispatcher::Impl {
+public:
+  struct TopicLatency {
+    LatencyHistogram push_ns;
+    LatencyHistogram queue_wait_ns;
+    LatencyHistogram handler_ns;
+  };
+
+  // 到达时刻的时间戳，随消息一起排队
+  struct Stamp {
+    int64_t arrival_ns = 0;
+    int64_t server_timestamp_ns = 0;
+    TopicLatency *topic = nullptr;
+  };
+
+  struct Item {
+    NotificationPtr message;
+    int64_t enqueue_ns;
+    Stamp stamp;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+    std::deque<Item> queue;
+    std::deque<Item> bulk; // kBulk 消息，普通队列为空时才处理
+    uint64_t max_depth = 0;
+    std::thread worker;
+  };
+
+  NotificationDispatchOptions options_;
+  NotificationHandler handler_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::unique_ptr<Shard> critical_;
+  std::unique_ptr<NotificationConflator> conflator_;
+  std::atomic<bool> stopping_{false};
+
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> dispatched_{0};
+  std::atomic<uint64_t> handler_errors_{0};
+  std::atomic<uint64_t> critical_dispatched_{0};
+  std::atomic<uint64_t> bulk_shed_{0};
+  LatencyHistogram queue_wait_ns_;
+  LatencyHistogram critical_wait_ns_;
+  LatencyHistogram handler_ns_;
+
+  mutable std::shared_mutex topics_mutex_;
+  std::unordered_map<std::string, std::unique_ptr<TopicLatency>> topics_;
+
+  Impl(NotificationDispatchOptions options, NotificationHandler handler)
+      : options_(options), handler_(std::move(handler)) {
+    for (size_t i = 0; i < options_.worker_threads; ++i) {
+      shards_.push_back(std::make_unique<Shard>());
+    }
+    for (auto &shard : shards_) {
+      Shard *raw = shard.get();
+      shard->worker = std::thread([this, raw]() { WorkerLoop(*raw); });
+    }
+    if (!shards_.empty() && HasCriticalTopic()) {
+      critical_ = std::make_unique<Shard>();
+      critical_->worker = std::thread([this]() { WorkerLoop(*critical_); });
+    }
+    if (!options_.conflated_topics.empty()) {
+      conflator_ = std::make_unique<NotificationConflator>(
+          options_.conflated_topics,
+          [this](const NotificationPtr &message) {
+            // 推送延迟已在到达时记录
+            Forward(message, nullptr, StampOf(*message, false));
+          });
+    }
+  }
+
+  bool HasCriticalTopic() const {
+    for (const auto &entry : options_.priorities) {
+      if (entry.second == NotificationPriority::kCritical) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  NotificationPriority PriorityOf(const Notification &message) const {
+    if (options_.priorities.empty()) {
+      return NotificationPriority::kNormal;
+    }
+    const auto &fields = message.notifymessage().keyvaluelist();
+    auto field_it = fields.find(kEventTypeKey);
+    if (field_it == fields.end()) {
+      return NotificationPriority::kNormal;
+    }
+    auto it = options_.priorities.find(field_it->second.stringvalue());
+    return it == options_.priorities.end() ? NotificationPriority::kNormal
+                                           : it->second;
+  }
+
+  int64_t WallNs() const {
+    int64_t local_ns = ClockSync::LocalTimeNs();
+    return options_.clock_sync ? options_.clock_sync->ToServerTimeNs(local_ns)
+                               : local_ns;
+  }
+
+  TopicLatency *TopicOf(const Notification &message) {
+    const auto &fields = message.notifymessage().keyvaluelist();
+    auto field_it = fields.find(kEventTypeKey);
+    const std::string &topic = field_it == fields.end()
+                                   ? kUntypedTopic
+                                   : field_it->second.stringvalue();
+    {
+      std::shared_lock<std::shared_mutex> lock(topics_mutex_);
+      auto it = topics_.find(topic);
+      if (it != topics_.end()) {
+        return it->second.get();
+      }
+    }
+    std::unique_lock<std::shared_mutex> lock(topics_mutex_);
+    auto it = topics_.find(topic);
+    if (it != topics_.end()) {
+      return it->second.get();
+    }
+    if (topics_.size() >= kMaxTrackedTopics) {
+      return nullptr;
+    }
+    return topics_.emplace(topic, std::make_unique<TopicLatency>())
+        .first->second.get();
+  }
+
+  // 记录到达时刻并统计推送延迟
+  Stamp StampOf(const Notification &message, bool record_push = true) {
+    Stamp stamp;
+    if (!options_.track_topics) {
+      return stamp;
+    }
+    stamp.arrival_ns = WallNs();
+    stamp.topic = TopicOf(message);
+    const auto &fields = message.notifymessage().keyvaluelist();
+    auto it = fields.find(options_.timestamp_key);
+    if (it != fields.end()) {
+      int64_t timestamp_ms = it->second.int64value() != 0
+                                 ? it->second.int64value()
+                                 : it->second.int32value();
+      stamp.server_timestamp_ns = timestamp_ms * 1000000;
+    }
+    if (record_push && stamp.topic != nullptr &&
+        stamp.server_timestamp_ns > 0) {
+      // 时钟未同步时可能为负，按 0 计
+      stamp.topic->push_ns.Record(static_cast<uint64_t>(std::max<int64_t>(
+          0, stamp.arrival_ns - stamp.server_timestamp_ns)));
+    }
+    return stamp;
+  }
+
+  bool Forward(NotificationPtr message, double *queue_fill,
+               const Stamp &stamp) {
+    if (shards_.empty()) {
+      return Invoke(message, stamp, 0);
+    }
+    NotificationPriority priority = PriorityOf(*message);
+    if (priority == NotificationPriority::kCritical && critical_) {
+      return Enqueue(*critical_, options_.critical_queue_capacity,
+                     std::move(message), nullptr, stamp);
+    }
+    Shard &shard = ShardOf(*message);
+    if (priority == NotificationPriority::kBulk) {
+      return EnqueueBulk(shard, std::move(message), queue_fill, stamp);
+    }
+    return Enqueue(shard, options_.queue_capacity, std::move(message),
+                   queue_fill, stamp);
+  }
+
+  bool Accept(NotificationPtr message, double *queue_fill) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    if (queue_fill != nullptr) {
+      *queue_fill = 0.0;
+    }
+    Stamp stamp = StampOf(*message);
+    if (conflator_ && conflator_->Offer(message)) {
+      return true;
+    }
+    return Forward(std::move(message), queue_fill, stamp);
+  }
+
+  bool Invoke(const NotificationPtr &message, const Stamp &stamp,
+              int64_t queue_wait_ns) {
+    if (options_.track_topics) {
+      current_timing.server_timestamp_ns = stamp.server_timestamp_ns;
+      current_timing.arrival_ns = stamp.arrival_ns;
+      current_timing.dispatch_ns = WallNs();
+      current_timing.push_latency_ns =
+          stamp.server_timestamp_ns > 0
+              ? stamp.arrival_ns - stamp.server_timestamp_ns
+              : 0;
+      current_timing.queue_wait_ns = queue_wait_ns;
+    }
+    int64_t start_ns = NowNs();
+    bool ok = true;
+    if (handler_) {
+      try {
+        handler_(message);
+      } catch (const std::exception &e) {
+        KONKA_LOG_ERROR("dispatch") << "Error in message callback: "
+                                    << e.what();
+        handler_errors_.fetch_add(1, std::memory_order_relaxed);
+        ok = false;
+      } catch (...) {
+        KONKA_LOG_ERROR("dispatch") << "Unknown error in message callback";
+        handler_errors_.fetch_add(1, std::memory_order_relaxed);
+        ok = false;
+      }
+    }
+    uint64_t elapsed_ns = static_cast<uint64_t>(NowNs() - start_ns);
+    handler_ns_.Record(elapsed_ns);
+    if (stamp.topic != nullptr) {
+      stamp.topic->handler_ns.Record(elapsed_ns);
+    }
+    dispatched_.fetch_add(1, std::memory_order_relaxed);
+    return ok;
+  }
+
+  Shard &ShardOf(const Notification &message) {
+    return *shards_[OrderHash(message, options_.order_key) % shards_.size()];
+  }
+
+  static double Fill(size_t depth, size_t capacity) {
+    return capacity == 0 ? 0.0
+                         : static_cast<double>(depth) /
+                               static_cast<double>(capacity);
+  }
+
+  // 队列满时阻塞等待，capacity 为 0 表示不限
+  bool Enqueue(Shard &shard, size_t capacity, NotificationPtr message,
+               double *queue_fill, const Stamp &stamp) {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    if (capacity > 0) {
+      shard.not_full.wait(lock, [&]() {
+        return stopping_.load() || shard.queue.size() < capacity;
+      });
+    }
+    if (stopping_.load()) {
+      return false;
+    }
+    shard.queue.push_back(Item{std::move(message), NowNs(), stamp});
+    if (shard.queue.size() > shard.max_depth) {
+      shard.max_depth = shard.queue.size();
+    }
+    if (queue_fill != nullptr) {
+      *queue_fill = Fill(shard.queue.size(), capacity);
+    }
+    lock.unlock();
+    shard.not_empty.notify_one();
+    return true;
+  }
+
+  // 大流量消息不阻塞 gRPC 线程：队列满时丢弃最旧的一条
+  bool EnqueueBulk(Shard &shard, NotificationPtr message, double *queue_fill,
+                   const Stamp &stamp) {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    if (stopping_.load()) {
+      return false;
+    }
+    bool shed = false;
+    if (options_.bulk_queue_capacity > 0 &&
+        shard.bulk.size() >= options_.bulk_queue_capacity) {
+      shard.bulk.pop_front();
+      bulk_shed_.fetch_add(1, std::memory_order_relaxed);
+      shed = true;
+    }
+    shard.bulk.push_back(Item{std::move(message), NowNs(), stamp});
+    if (queue_fill != nullptr) {
+      // 已经开始丢弃时视为队列已满
+      *queue_fill =
+          shed ? 1.0 : Fill(shard.bulk.size(), options_.bulk_queue_capacity);
+    }
+    lock.unlock();
+    shard.not_empty.notify_one();
+    return true;
+  }
+
+  void WorkerLoop(Shard &shard) {
+    const bool critical = &shard == critical_.get();
+    LatencyHistogram &wait_ns = critical ? critical_wait_ns_ : queue_wait_ns_;
+    while (true) {
+      Item item;
+      bool from_queue = true;
+      {
+        std::unique_lock<std::mutex> lock(shard.mutex);
+        shard.not_empty.wait(lock, [&]() {
+          return stopping_.load() || !shard.queue.empty() ||
+                 !shard.bulk.empty();
+        });
+        if (!shard.queue.empty()) {
+          item = std::move(shard.queue.front());
+          shard.queue.pop_front();
+        } else if (!shard.bulk.empty()) {
+          item = std::move(shard.bulk.front());
+          shard.bulk.pop_front();
+          from_queue = false;
+        } else {
+          return; // 已停止且队列已排空
+        }
+      }
+      if (from_queue) {
+        shard.not_full.notify_one();
+      }
+      int64_t queue_wait_ns = NowNs() - item.enqueue_ns;
+      wait_ns.Record(static_cast<uint64_t>(queue_wait_ns));
+      if (item.stamp.topic != nullptr) {
+        item.stamp.topic->queue_wait_ns.Record(
+            static_cast<uint64_t>(queue_wait_ns));
+      }
+      Invoke(item.message, item.stamp, queue_wait_ns);
+      if (critical) {
+        critical_dispatched_.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  void Stop() {
+    // 合并槽中的最新值先投递到分片队列
+    if (conflator_) {
+      conflator_->Stop();
+    }
+    if (stopping_.exchange(true)) {
+      return;
+    }
+    std::vector<Shard *> all;
+    for (auto &shard : shards_) {
+      all.push_back(shard.get());
+    }
+    if (critical_) {
+      all.push_back(critical_.get());
+    }
+    for (Shard *shard : all) {
+      // 持锁通知，避免与等待中的线程错过唤醒
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->not_empty.notify_all();
+      shard->not_full.notify_all();
+    }
+    for (Shard *shard : all) {
+      if (shard->worker.joinable()) {
+        shard->worker.join();
+      }
+    }
+  }
+};
+
+// =============================================================================
+// NotificationDispatcher 实现
+// =============================================================================
+
+NotificationDispatcher::NotificationDispatcher(
+    NotificationDispatchOptions options, NotificationHandler handler)
+    : pImpl_(std::make_unique<Impl>(options, std::move(handler))) {}
+
+NotificationDispatcher::~NotificationDispatcher() { pImpl_->Stop(); }
+
+bool NotificationDispatcher::Dispatch(const Notification &message) {
+  if (pImpl_->stopping_.load()) {
+    return false;
+  }
+  return pImpl_->Accept(std::make_shared<const Notification>(message),
+                        nullptr);
+}
+
+bool NotificationDispatcher::Dispatch(NotificationPtr message,
+                                      double *queue_fill) {
+  if (!message || pImpl_->stopping_.load()) {
+    return false;
+  }
+  return pImpl_->Accept(std::move(message), queue_fill);
+}
+
+uint64_t NotificationDispatcher::DispatchedCount() const {
+  return pImpl_->dispatched_.load(std::memory_order_relaxed);
+}
+
+void NotificationDispatcher::Stop() { pImpl_->Stop(); }
+
+NotificationDispatchStats NotificationDispatcher::GetStats() const {
+  NotificationDispatchStats stats;
+  stats.received = pImpl_->received_.load(std::memory_order_relaxed);
+  stats.dispatched = pImpl_->dispatched_.load(std::memory_order_relaxed);
+  stats.handler_errors =
+      pImpl_->handler_errors_.load(std::memory_order_relaxed);
+  for (const auto &shard : pImpl_->shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    uint64_t depth = shard->queue.size() + shard->bulk.size();
+    stats.shard_depths.push_back(depth);
+    stats.queue_depth += depth;
+    if (shard->max_depth > stats.max_queue_depth) {
+      stats.max_queue_depth = shard->max_depth;
+    }
+  }
+  if (pImpl_->critical_) {
+    std::lock_guard<std::mutex> lock(pImpl_->critical_->mutex);
+    stats.queue_depth += pImpl_->critical_->queue.size();
+  }
+  stats.critical_dispatched =
+      pImpl_->critical_dispatched_.load(std::memory_order_relaxed);
+  stats.bulk_shed = pImpl_->bulk_shed_.load(std::memory_order_relaxed);
+  stats.critical_wait_p99_us = pImpl_->critical_wait_ns_.Percentile(0.99) / 1000;
+  if (pImpl_->conflator_) {
+    NotificationConflationStats conflation = pImpl_->conflator_->GetStats();
+    stats.conflated = conflation.conflated;
+    stats.conflation_delivered = conflation.delivered;
+  }
+  stats.queue_wait_p50_us = pImpl_->queue_wait_ns_.Percentile(0.50) / 1000;
+  stats.queue_wait_p99_us = pImpl_->queue_wait_ns_.Percentile(0.99) / 1000;
+  stats.handler_p50_us = pImpl_->handler_ns_.Percentile(0.50) / 1000;
+  stats.handler_p99_us = pImpl_->handler_ns_.Percentile(0.99) / 1000;
+  stats.handler_max_us = pImpl_->handler_ns_.Max() / 1000;
+
+  std::shared_lock<std::shared_mutex> lock(pImpl_->topics_mutex_);
+  for (const auto &entry : pImpl_->topics_) {
+    const Impl::TopicLatency &topic = *entry.second;
+    TopicLatencyStats &out = stats.topics[entry.first];
+    out.count = topic.handler_ns.Count();
+    out.push_p50_us = topic.push_ns.Percentile(0.50) / 1000;
+    out.push_p99_us = topic.push_ns.Percentile(0.99) / 1000;
+    out.push_max_us = topic.push_ns.Max() / 1000;
+    out.queue_wait_p50_us = topic.queue_wait_ns.Percentile(0.50) / 1000;
+    out.queue_wait_p99_us = topic.queue_wait_ns.Percentile(0.99) / 1000;
+    out.handler_p50_us = topic.handler_ns.Percentile(0.50) / 1000;
+    out.handler_p99_us = topic.handler_ns.Percentile(0.99) / 1000;
+    out.handler_max_us = topic.handler_ns.Max() / 1000;
+  }
+  return stats;
+}
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+const NotificationTiming &CurrentNotificationTiming() { return current_timing; }
+} // namespace robot
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+size_t NotificationDispatcher::OrderHash(const Notification &message,
+                                         NotificationOrderKey order_key) {
+  switch (order_key) {
+  case NotificationOrderKey::kEventType:
+    return HashField(message, kEventTypeKey);
+  case NotificationOrderKey::kObjectId:
+    return HashField(message, kObjectIdKey);
+  case NotificationOrderKey::kEventTypeAndObjectId:
+  default: {
+    size_t seed = HashField(message, kEventTypeKey);
+    seed ^= HashField(message, kObjectIdKey) + 0x9e3779b97f4a7c15ULL +
+            (seed << 6) + (seed >> 2);
+    return seed;
+  }
+  }
+}
@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of NotificationPool
+ */
+
+#include "robot/client/notification_pool.h"
+
+#include <google/protobuf/arena.h>
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+// arena 初始块的最小值，小于该值时 arena 会忽略初始块
+constexpr size_t kMinArenaBlockBytes = 256;
+// shared_ptr 控制块（含删除器和分配器）的预留空间
+constexpr size_t kControlBlockBytes = 128;
+} // namespace
+
+// =============================================================================
+// NotificationPool::State - 池状态，由池和所有未归还对象共同持有
+// =============================================================================
+
+class NotificationPool::State {
+public:
+  struct Slot {
+    explicit Slot(size_t block_bytes)
+        : block(new char[block_bytes]),
+          arena(MakeArenaOptions(block.get(), block_bytes)),
+          message(google::protobuf::Arena::CreateMessage<Notification>(
+              &arena)) {}
+
+    // 释放 arena 中的全部对象，保留初始块，重新创建空消息
+    void Reset() {
+      arena.Reset();
+      message = google::protobuf::Arena::CreateMessage<Notification>(&arena);
+    }
+
+    static google::protobuf::ArenaOptions MakeArenaOptions(char *block,
+                                                           size_t size) {
+      google::protobuf::ArenaOptions options;
+      options.initial_block = block;
+      options.initial_block_size = size;
+      return options;
+    }
+
+    std::unique_ptr<char[]> block; // 须先于 arena 构造、后于 arena 析构
+    google::protobuf::Arena arena;
+    Notification *message;
+    alignas(std::max_align_t) unsigned char control[kControlBlockBytes];
+  };
+
+  explicit State(NotificationPoolOptions options) : options_(options) {
+    if (options_.arena_block_bytes < kMinArenaBlockBytes) {
+      options_.arena_block_bytes = kMinArenaBlockBytes;
+    }
+  }
+
+  ~State() {
+    for (Slot *slot : idle_) {
+      delete slot;
+    }
+  }
+
+  Slot *Take() {
+    acquired_.fetch_add(1, std::memory_order_relaxed);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!idle_.empty()) {
+        Slot *slot = idle_.back();
+        idle_.pop_back();
+        return slot;
+      }
+    }
+    created_.fetch_add(1, std::memory_order_relaxed);
+    return new Slot(options_.arena_block_bytes);
+  }
+
+  void Release(Slot *slot) {
+    released_.fetch_add(1, std::memory_order_relaxed);
+    slot->Reset();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!closed_ && idle_.size() < options_.max_idle) {
+        idle_.push_back(slot);
+        return;
+      }
+    }
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    delete slot;
+  }
+
+  void Close() {
+    std::vector<Slot *> idle;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      idle.swap(idle_);
+    }
+    for (Slot *slot : idle) {
+      delete slot;
+    }
+  }
+
+  NotificationPoolOptions options_;
+  mutable std::mutex mutex_;
+  std::vector<Slot *> idle_;
+  bool closed_ = false;
+
+  std::atomic<uint64_t> acquired_{0};
+  std::atomic<uint64_t> created_{0};
+  std::atomic<uint64_t> released_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
+
+namespace {
+using Slot = NotificationPool::State::Slot;
+
+/**
+ * 把 shared_ptr 控制块放进池对象的分配器。
+ * 控制块销毁的最后一步是 deallocate（此时删除器已析构），
+ * 在这里把对象归还给池。
+ */
+template <typename T> class SlotAllocator {
+public:
+  using value_type = T;
+
+  SlotAllocator(Slot *slot, std::shared_ptr<NotificationPool::State> state)
+      : slot_(slot), state_(std::move(state)) {}
+
+  template <typename U>
+  SlotAllocator(const SlotAllocator<U> &other)
+      : slot_(other.slot_), state_(other.state_) {}
+
+  T *allocate(size_t n) {
+    if (n * sizeof(T) <= sizeof(slot_->control) &&
+        alignof(T) <= alignof(std::max_align_t)) {
+      return reinterpret_cast<T *>(slot_->control);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t) {
+    if (static_cast<void *>(p) == static_cast<void *>(slot_->control)) {
+      state_->Release(slot_);
+    } else {
+      ::operator delete(p);
+    }
+  }
+
+  template <typename U> bool operator==(const SlotAllocator<U> &other) const {
+    return slot_ == other.slot_;
+  }
+  template <typename U> bool operator!=(const SlotAllocator<U> &other) const {
+    return slot_ != other.slot_;
+  }
+
+  Slot *slot_;
+  std::shared_ptr<NotificationPool::State> state_;
+};
+} // namespace
+
+// =============================================================================
+// NotificationPool 实现
+// =============================================================================
+
+std::shared_ptr<NotificationPool>
+NotificationPool::Create(NotificationPoolOptions options) {
+  return std::shared_ptr<NotificationPool>(new NotificationPool(options));
+}
+
+NotificationPool::NotificationPool(NotificationPoolOptions options)
+    : state_(std::make_shared<State>(options)) {}
+
+NotificationPool::~NotificationPool() { state_->Close(); }
+
+std::shared_ptr<Notification> NotificationPool::Acquire() {
+  if (state_->options_.max_idle == 0) {
+    state_->acquired_.fetch_add(1, std::memory_order_relaxed);
+    return std::make_shared<Notification>();
+  }
+  Slot *slot = state_->Take();
+  // 消息由 arena 管理，删除器无需释放；回收在控制块释放时进行
+  return std::shared_ptr<Notification>(slot->message, [](Notification *) {},
+                                       SlotAllocator<Notification>(slot,
+                                                                   state_));
+}
+
+NotificationPoolStats NotificationPool::GetStats() const {
+  NotificationPoolStats stats;
+  stats.acquired = state_->acquired_.load(std::memory_order_relaxed);
+  stats.created = state_->created_.load(std::memory_order_relaxed);
+  stats.released = state_->released_.load(std::memory_order_relaxed);
+  stats.dropped = state_->dropped_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(state_->mutex_);
+  stats.idle = state_->idle_.size();
+  return stats;
+}
@@ -0,0 +1,224 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of NotificationRouter
+ */
+
+#include "robot/client/notification_router.h"
+#include "robot/common/logger.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+constexpr const char *kEventTypeKey = "event_type";
+constexpr const char *kObjectIdKey = "object_id";
+// event_type 与 object_id 之间的分隔符，不会出现在正常主题名中
+constexpr char kKeySeparator = '\x1f';
+
+std::string RouteKey(const std::string &event_type,
+                     const std::string &object_id) {
+  if (object_id.empty()) {
+    return event_type;
+  }
+  std::string key;
+  key.reserve(event_type.size() + 1 + object_id.size());
+  key.append(event_type).push_back(kKeySeparator);
+  key.append(object_id);
+  return key;
+}
+
+const humanoid_robot::PB::common::Variant *
+FindField(const Notification &message, const char *key) {
+  const auto &fields = message.notifymessage().keyvaluelist();
+  auto it = fields.find(key);
+  return it == fields.end() ? nullptr : &it->second;
+}
+} // namespace
+
+// =============================================================================
+// NotificationRouter::Impl - 私有实现
+// =============================================================================
+
+class NotificationRouter::Impl {
+public:
+  struct Entry {
+    SubscriptionHandlerId id;
+    std::shared_ptr<const NotificationHandler> handler;
+  };
+
+  // 路由表发布后只读
+  struct Table {
+    std::unordered_map<std::string, std::vector<Entry>> routes;
+    size_t handler_count = 0;
+  };
+
+  std::shared_ptr<const Table> table_ = std::make_shared<const Table>();
+
+  // 写者之间串行
+  std::mutex write_mutex_;
+  std::unordered_map<SubscriptionHandlerId, std::string> keys_;
+  SubscriptionHandlerId next_id_ = 1;
+
+  std::shared_ptr<const Table> Load() const {
+    return std::atomic_load_explicit(&table_, std::memory_order_acquire);
+  }
+
+  void Publish(std::shared_ptr<const Table> table) {
+    std::atomic_store_explicit(&table_, std::move(table),
+                               std::memory_order_release);
+  }
+
+  static void Invoke(const Table &table, const std::string &key,
+                     const NotificationPtr &message, size_t &invoked,
+                     size_t &failed) {
+    auto it = table.routes.find(key);
+    if (it == table.routes.end()) {
+      return;
+    }
+    for (const auto &entry : it->second) {
+      ++invoked;
+      try {
+        (*entry.handler)(message);
+      } catch (const std::exception &e) {
+        KONKA_LOG_ERROR("router") << "Error in subscription handler: "
+                                  << e.what();
+        ++failed;
+      } catch (...) {
+        KONKA_LOG_ERROR("router") << "Unknown error in subscription handler";
+        ++failed;
+      }
+    }
+  }
+};
+
+// =============================================================================
+// NotificationRouter 实现
+// =============================================================================
+
+NotificationRouter::NotificationRouter() : pImpl_(std::make_unique<Impl>()) {}
+
+NotificationRouter::~NotificationRouter() = default;
+
+SubscriptionHandlerId NotificationRouter::Add(const std::string &event_type,
+                                              const std::string &object_id,
+                                              NotificationHandler handler) {
+  if (!handler) {
+    return 0;
+  }
+  std::lock_guard<std::mutex> lock(pImpl_->write_mutex_);
+  std::string key = RouteKey(event_type, object_id);
+  SubscriptionHandlerId id = pImpl_->next_id_++;
+
+  auto table = std::make_shared<Impl::Table>(*pImpl_->Load());
+  table->routes[key].push_back(Impl::Entry{
+      id, std::make_shared<const NotificationHandler>(std::move(handler))});
+  table->handler_count++;
+  pImpl_->keys_.emplace(id, std::move(key));
+  pImpl_->Publish(std::move(table));
+  return id;
+}
+
+bool NotificationRouter::Remove(SubscriptionHandlerId id) {
+  std::lock_guard<std::mutex> lock(pImpl_->write_mutex_);
+  auto key_it = pImpl_->keys_.find(id);
+  if (key_it == pImpl_->keys_.end()) {
+    return false;
+  }
+
+  auto table = std::make_shared<Impl::Table>(*pImpl_->Load());
+  auto route_it = table->routes.find(key_it->second);
+  if (route_it != table->routes.end()) {
+    auto &entries = route_it->second;
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      if (it->id == id) {
+        entries.erase(it);
+        table->handler_count--;
+        break;
+      }
+    }
+    if (entries.empty()) {
+      table->routes.erase(route_it);
+    }
+  }
+  pImpl_->keys_.erase(key_it);
+  pImpl_->Publish(std::move(table));
+  return true;
+}
+
+void NotificationRouter::Clear() {
+  std::lock_guard<std::mutex> lock(pImpl_->write_mutex_);
+  pImpl_->keys_.clear();
+  pImpl_->Publish(std::make_shared<const Impl::Table>());
+}
+
+size_t NotificationRouter::Route(const NotificationPtr &message,
+                                 size_t *failed) const {
+  size_t invoked = 0;
+  size_t failures = 0;
+  if (message) {
+    std::shared_ptr<const Impl::Table> table = pImpl_->Load();
+    if (!table->routes.empty()) {
+      std::string event_type = EventTypeOf(*message);
+      Impl::Invoke(*table, event_type, message, invoked, failures);
+      std::string object_id = ObjectIdOf(*message);
+      if (!object_id.empty()) {
+        Impl::Invoke(*table, RouteKey(event_type, object_id), message,
+                     invoked, failures);
+      }
+      if (!event_type.empty()) {
+        Impl::Invoke(*table, std::string(), message, invoked, failures);
+      }
+    }
+  }
+  if (failed != nullptr) {
+    *failed = failures;
+  }
+  return invoked;
+}
+
+size_t NotificationRouter::HandlerCount() const {
+  return pImpl_->Load()->handler_count;
+}
+
+NotificationHandler
+NotificationRouter::BindHandler(SubscriptionMessageCallback callback) {
+  return [callback, this](const NotificationPtr &message) {
+    if (callback) {
+      callback(*message);
+    }
+    size_t failed = 0;
+    Route(message, &failed);
+    if (failed > 0) {
+      throw std::runtime_error(std::to_string(failed) +
+                               " subscription handler(s) failed");
+    }
+  };
+}
+
+std::string NotificationRouter::EventTypeOf(const Notification &message) {
+  const auto *value = FindField(message, kEventTypeKey);
+  return value == nullptr ? std::string() : value->stringvalue();
+}
+
+std::string NotificationRouter::ObjectIdOf(const Notification &message) {
+  const auto *value = FindField(message, kObjectIdKey);
+  if (value == nullptr) {
+    return std::string();
+  }
+  if (!value->stringvalue().empty()) {
+    return value->stringvalue();
+  }
+  if (value->int64value() != 0) {
+    return std::to_string(value->int64value());
+  }
+  return std::to_string(value->int32value());
+}
@@ -0,0 +1,424 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of ShmRingWriter / ShmRingReader
+ */
+
+#include "robot/client/shm_ring.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::konka_sdk::common;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+constexpr uint64_t kRingMagic = 0x4b4f4e4b41524e47ULL; // "KONKARNG"
+constexpr uint32_t kRingVersion = 1;
+constexpr size_t kCacheLine = 64;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory ring requires lock-free 64-bit atomics");
+
+struct alignas(kCacheLine) ReaderEntry {
+  std::atomic<int64_t> pid;     // 0 表示空闲
+  std::atomic<uint64_t> cursor; // 下一条待读消息的序号
+};
+
+struct alignas(kCacheLine) RingHeader {
+  std::atomic<uint64_t> magic; // 初始化完成后最后写入
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t slot_count;
+  uint64_t slot_bytes;
+  uint64_t slot_stride;
+  alignas(kCacheLine) std::atomic<uint64_t> write_index; // 已发布消息数
+  ReaderEntry readers[kShmRingMaxReaders];
+};
+
+struct SlotHeader {
+  // 序列锁：写入消息 i 期间为 2i+1，写完后为 2i+2
+  std::atomic<uint64_t> seq;
+  uint64_t size;
+};
+
+size_t AlignUp(size_t value, size_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+Status ErrnoStatus(const std::string &message) {
+  return Status(std::error_code(errno, std::generic_category()), message);
+}
+
+bool ProcessAlive(int64_t pid) {
+  return pid > 0 &&
+         (kill(static_cast<pid_t>(pid), 0) == 0 || errno != ESRCH);
+}
+
+/**
+ * 映射区域：头部之后紧跟 slot_count 个槽位
+ */
+class Mapping {
+public:
+  Mapping() = default;
+  ~Mapping() {
+    if (base_ != nullptr) {
+      munmap(base_, size_);
+    }
+  }
+
+  Status Map(int fd, size_t size) {
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+      return ErrnoStatus("Failed to map shared memory");
+    }
+    base_ = base;
+    size_ = size;
+    return Status();
+  }
+
+  RingHeader *header() const { return static_cast<RingHeader *>(base_); }
+
+  SlotHeader *slot(uint64_t index) const {
+    RingHeader *h = header();
+    char *slots = static_cast<char *>(base_) + AlignUp(sizeof(RingHeader),
+                                                       kCacheLine);
+    return reinterpret_cast<SlotHeader *>(slots + (index % h->slot_count) *
+                                                      h->slot_stride);
+  }
+
+  static char *payload(SlotHeader *slot) {
+    return reinterpret_cast<char *>(slot) + sizeof(SlotHeader);
+  }
+
+private:
+  void *base_ = nullptr;
+  size_t size_ = 0;
+};
+} // namespace
+
+// =============================================================================
+// ShmRingWriter::Impl - 私有实现
+// =============================================================================
+
+class ShmRingWriter::Impl {
+public:
+  std::string name_;
+  ShmRingOptions options_;
+  Mapping mapping_;
+  std::mutex write_mutex_;
+  std::atomic<uint64_t> oversize_{0};
+
+  ~Impl() {
+    if (options_.unlink_on_close && !name_.empty()) {
+      shm_unlink(name_.c_str());
+    }
+  }
+
+  Status Init(const std::string &name, ShmRingOptions options) {
+    if (options.slot_count == 0 || options.slot_bytes == 0) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Slot count and slot size must be positive");
+    }
+    options_ = options;
+
+    // 替换残留对象：已打开旧对象的读者保留旧映射，需重新打开
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd < 0) {
+      return ErrnoStatus("Failed to create shared memory " + name);
+    }
+    name_ = name;
+
+    size_t stride = AlignUp(sizeof(SlotHeader) + options.slot_bytes, kCacheLine);
+    size_t size =
+        AlignUp(sizeof(RingHeader), kCacheLine) + options.slot_count * stride;
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      Status status = ErrnoStatus("Failed to size shared memory " + name);
+      close(fd);
+      return status;
+    }
+    Status status = mapping_.Map(fd, size);
+    close(fd);
+    if (!status) {
+      return status;
+    }
+
+    // ftruncate 保证内容为零，原子量的零值即为初始状态
+    RingHeader *header = mapping_.header();
+    header->version = kRingVersion;
+    header->slot_count = options.slot_count;
+    header->slot_bytes = options.slot_bytes;
+    header->slot_stride = stride;
+    header->magic.store(kRingMagic, std::memory_order_release);
+    return Status();
+  }
+
+  Status Publish(const Notification &message) {
+    size_t size = message.ByteSizeLong();
+    if (size > options_.slot_bytes) {
+      oversize_.fetch_add(1, std::memory_order_relaxed);
+      return Status(std::make_error_code(std::errc::message_size),
+                    "Notification exceeds shared-memory slot size");
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    RingHeader *header = mapping_.header();
+    uint64_t index = header->write_index.load(std::memory_order_relaxed);
+    SlotHeader *slot = mapping_.slot(index);
+    slot->seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    // 直接序列化到共享内存，不经过中间缓冲
+    message.SerializeWithCachedSizesToArray(
+        reinterpret_cast<uint8_t *>(Mapping::payload(slot)));
+    slot->size = size;
+    slot->seq.store(2 * index + 2, std::memory_order_release);
+    header->write_index.store(index + 1, std::memory_order_release);
+    return Status();
+  }
+};
+
+// =============================================================================
+// ShmRingWriter 实现
+// =============================================================================
+
+Status ShmRingWriter::Create(const std::string &name, ShmRingOptions options,
+                             std::unique_ptr<ShmRingWriter> &writer) {
+  auto impl = std::make_unique<Impl>();
+  Status status = impl->Init(name, options);
+  if (!status) {
+    return status;
+  }
+  writer.reset(new ShmRingWriter(std::move(impl)));
+  return Status();
+}
+
+ShmRingWriter::ShmRingWriter(std::unique_ptr<Impl> impl)
+    : pImpl_(std::move(impl)) {}
+
+ShmRingWriter::~ShmRingWriter() = default;
+
+Status ShmRingWriter::Publish(const Notification &message) {
+  return pImpl_->Publish(message);
+}
+
+NotificationHandler ShmRingWriter::AsHandler() {
+  std::weak_ptr<Impl> weak_impl = pImpl_;
+  return [weak_impl](const NotificationPtr &message) {
+    if (auto impl = weak_impl.lock()) {
+      impl->Publish(*message).IgnoreError();
+    }
+  };
+}
+
+const std::string &ShmRingWriter::Name() const { return pImpl_->name_; }
+
+ShmRingStats ShmRingWriter::GetStats() const {
+  ShmRingStats stats;
+  RingHeader *header = pImpl_->mapping_.header();
+  uint64_t head = header->write_index.load(std::memory_order_acquire);
+  stats.published = head;
+  stats.oversize = pImpl_->oversize_.load(std::memory_order_relaxed);
+  for (const ReaderEntry &entry : header->readers) {
+    int64_t pid = entry.pid.load(std::memory_order_acquire);
+    if (pid == 0 || !ProcessAlive(pid)) {
+      continue;
+    }
+    ++stats.readers;
+    uint64_t cursor = entry.cursor.load(std::memory_order_relaxed);
+    if (head > cursor) {
+      stats.max_reader_lag = std::max(stats.max_reader_lag, head - cursor);
+    }
+  }
+  return stats;
+}
+
+// =============================================================================
+// ShmRingReader::Impl - 私有实现
+// =============================================================================
+
+class ShmRingReader::Impl {
+public:
+  Mapping mapping_;
+  ReaderEntry *entry_ = nullptr;
+  uint64_t cursor_ = 0;
+  uint64_t lost_ = 0;
+
+  ~Impl() {
+    if (entry_ != nullptr) {
+      entry_->pid.store(0, std::memory_order_release);
+    }
+  }
+
+  Status Init(const std::string &name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      return ErrnoStatus("Failed to open shared memory " + name);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      Status status = ErrnoStatus("Failed to stat shared memory " + name);
+      close(fd);
+      return status;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(RingHeader)) {
+      close(fd);
+      return Status(std::make_error_code(std::errc::resource_unavailable_try_again),
+                    "Shared memory " + name + " is not initialized");
+    }
+    Status status = mapping_.Map(fd, size);
+    close(fd);
+    if (!status) {
+      return status;
+    }
+
+    RingHeader *header = mapping_.header();
+    if (header->magic.load(std::memory_order_acquire) != kRingMagic ||
+        header->version != kRingVersion) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Shared memory " + name + " is not a notification ring");
+    }
+    // 头部来自其他进程，先校验几何参数再据此寻址槽位
+    if (header->slot_count == 0 ||
+        header->slot_bytes > header->slot_stride ||
+        header->slot_stride < sizeof(SlotHeader) + header->slot_bytes) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Shared memory " + name + " has an invalid slot layout");
+    }
+    size_t slots_offset = AlignUp(sizeof(RingHeader), kCacheLine);
+    if (size < slots_offset ||
+        header->slot_count > (size - slots_offset) / header->slot_stride) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Shared memory " + name + " is truncated");
+    }
+
+    cursor_ = header->write_index.load(std::memory_order_acquire);
+    Register(header);
+    return Status();
+  }
+
+  // 占用一个空闲或属于已退出进程的游标位置
+  void Register(RingHeader *header) {
+    int64_t self = static_cast<int64_t>(getpid());
+    for (ReaderEntry &entry : header->readers) {
+      int64_t pid = entry.pid.load(std::memory_order_acquire);
+      if (pid != 0 && ProcessAlive(pid)) {
+        continue;
+      }
+      if (entry.pid.compare_exchange_strong(pid, self)) {
+        entry.cursor.store(cursor_, std::memory_order_relaxed);
+        entry_ = &entry;
+        return;
+      }
+    }
+  }
+
+  bool TryRead(ShmMessageView *view) {
+    RingHeader *header = mapping_.header();
+    while (true) {
+      uint64_t head = header->write_index.load(std::memory_order_acquire);
+      if (cursor_ >= head) {
+        return false;
+      }
+      if (head - cursor_ > header->slot_count) {
+        lost_ += head - cursor_ - header->slot_count;
+        cursor_ = head - header->slot_count;
+      }
+
+      uint64_t index = cursor_++;
+      if (entry_ != nullptr) {
+        entry_->cursor.store(cursor_, std::memory_order_relaxed);
+      }
+      SlotHeader *slot = mapping_.slot(index);
+      if (slot->seq.load(std::memory_order_acquire) != 2 * index + 2) {
+        // 已被覆盖或正在被覆盖
+        ++lost_;
+        continue;
+      }
+      view->data = Mapping::payload(slot);
+      view->size = std::min<uint64_t>(slot->size, header->slot_bytes);
+      view->sequence = index;
+      return true;
+    }
+  }
+
+  bool Validate(const ShmMessageView &view) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return mapping_.slot(view.sequence)->seq.load(std::memory_order_relaxed) ==
+           2 * view.sequence + 2;
+  }
+};
+
+// =============================================================================
+// ShmRingReader 实现
+// =============================================================================
+
+Status ShmRingReader::Open(const std::string &name,
+                           std::unique_ptr<ShmRingReader> &reader) {
+  auto impl = std::make_unique<Impl>();
+  Status status = impl->Init(name);
+  if (!status) {
+    return status;
+  }
+  reader.reset(new ShmRingReader(std::move(impl)));
+  return Status();
+}
+
+ShmRingReader::ShmRingReader(std::unique_ptr<Impl> impl)
+    : pImpl_(std::move(impl)) {}
+
+ShmRingReader::~ShmRingReader() = default;
+
+bool ShmRingReader::TryRead(ShmMessageView *view) {
+  return pImpl_->TryRead(view);
+}
+
+bool ShmRingReader::Validate(const ShmMessageView &view) const {
+  return pImpl_->Validate(view);
+}
+
+bool ShmRingReader::TryRead(Notification *message) {
+  ShmMessageView view;
+  while (pImpl_->TryRead(&view)) {
+    bool parsed =
+        message->ParseFromArray(view.data, static_cast<int>(view.size));
+    if (pImpl_->Validate(view) && parsed) {
+      return true;
+    }
+    ++pImpl_->lost_;
+  }
+  return false;
+}
+
+bool ShmRingReader::Read(Notification *message, int64_t timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  int spins = 0;
+  while (!TryRead(message)) {
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+    // 先短暂自旋，之后退避为短睡眠，避免空闲时占满 CPU
+    if (++spins < 64) {
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  return true;
+}
+
+uint64_t ShmRingReader::Lost() const { return pImpl_->lost_; }
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of StreamSubscription
+ */
+
+#include "robot/client/stream_subscription.h"
+#include "robot/common/logger.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "common/variant.pb.h"
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::konka_sdk::common;
+using namespace humanoid_robot::PB::interfaces;
+
+namespace {
+constexpr const char *kEventTypeKey = "event_type";
+constexpr const char *kSubscriptionIdKey = "subscriptionId";
+} // namespace
+
+// =============================================================================
+// StreamSubscription::Impl - 私有实现
+// =============================================================================
+
+class StreamSubscription::Impl {
+public:
+  std::shared_ptr<InterfacesClient> client_;
+  StreamSubscriptionOptions options_;
+  SubscriptionMessageCallback message_callback_;
+  NotificationRouter router_;
+  std::unique_ptr<NotificationDispatcher> dispatcher_;
+
+  SubscribeRequest request_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stopping_{false};
+  std::thread reader_thread_;
+
+  // 保护当前流的 context，Stop 时用于取消
+  std::mutex stream_mutex_;
+  std::condition_variable stop_cv_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  std::unique_ptr<grpc::ClientReader<ActionResponse>> reader_;
+
+  std::atomic<uint64_t> messages_{0};
+  std::atomic<uint64_t> reconnects_{0};
+  mutable std::mutex id_mutex_;
+  std::string subscription_id_;
+
+  Impl(std::shared_ptr<InterfacesClient> client,
+       StreamSubscriptionOptions options)
+      : client_(std::move(client)), options_(std::move(options)) {}
+
+  ~Impl() { Stop(); }
+
+  Status OpenStream() {
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    if (stopping_) {
+      return Status(std::make_error_code(std::errc::operation_canceled),
+                    "Subscription is stopping");
+    }
+    context_ = std::make_unique<grpc::ClientContext>();
+    return client_->SubscribeStream(request_, reader_, *context_);
+  }
+
+  void Handle(ActionResponse &response) {
+    const auto &output = response.output().keyvaluelist();
+    if (output.find(kEventTypeKey) == output.end()) {
+      // 非通知消息：订阅确认
+      auto id_it = output.find(kSubscriptionIdKey);
+      if (id_it != output.end()) {
+        std::lock_guard<std::mutex> lock(id_mutex_);
+        subscription_id_ = id_it->second.stringvalue();
+      }
+      return;
+    }
+    messages_.fetch_add(1, std::memory_order_relaxed);
+    // 直接交换字典，不拷贝消息体
+    auto message = std::make_shared<Notification>();
+    message->mutable_notifymessage()->Swap(response.mutable_output());
+    dispatcher_->Dispatch(NotificationPtr(std::move(message)));
+  }
+
+  void ReadLoop() {
+    while (true) {
+      ActionResponse response;
+      while (reader_->Read(&response)) {
+        Handle(response);
+      }
+      grpc::Status status = reader_->Finish();
+      if (stopping_) {
+        break;
+      }
+      if (status.ok()) {
+        // 服务端正常结束流（订阅被取消或到期），不再重连
+        KONKA_LOG_INFO("stream") << "Subscription stream closed by server";
+        break;
+      }
+      if (options_.reconnect_delay_ms <= 0) {
+        KONKA_LOG_WARN("stream") << "Subscription stream ended: "
+                                 << status.error_message();
+        break;
+      }
+      KONKA_LOG_WARN("stream") << "Subscription stream ended: "
+                               << status.error_message() << ", reconnecting";
+
+      {
+        std::unique_lock<std::mutex> lock(stream_mutex_);
+        stop_cv_.wait_for(lock,
+                          std::chrono::milliseconds(options_.reconnect_delay_ms),
+                          [this]() { return stopping_.load(); });
+      }
+      if (stopping_ || !OpenStream()) {
+        break;
+      }
+      reconnects_.fetch_add(1, std::memory_order_relaxed);
+    }
+    running_ = false;
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex_);
+      stopping_ = true;
+      if (context_) {
+        context_->TryCancel();
+      }
+    }
+    stop_cv_.notify_all();
+    if (reader_thread_.joinable()) {
+      reader_thread_.join();
+    }
+    if (dispatcher_) {
+      dispatcher_->Stop();
+    }
+    running_ = false;
+  }
+};
+
+// =============================================================================
+// StreamSubscription 实现
+// =============================================================================
+
+StreamSubscription::StreamSubscription(std::shared_ptr<InterfacesClient> client,
+                                       StreamSubscriptionOptions options)
+    : pImpl_(std::make_unique<Impl>(std::move(client), std::move(options))) {}
+
+StreamSubscription::~StreamSubscription() = default;
+
+void StreamSubscription::SetSubscriptionMessageCallback(
+    SubscriptionMessageCallback callback) {
+  if (pImpl_->running_) {
+    throw std::runtime_error(
+        "Cannot set callback while subscription is running. "
+        "Please set callback before starting the subscription.");
+  }
+
+  pImpl_->message_callback_ = callback;
+}
+
+SubscriptionHandlerId
+StreamSubscription::AddSubscriptionHandler(const std::string &event_type,
+                                           NotificationHandler handler) {
+  return pImpl_->router_.Add(event_type, std::move(handler));
+}
+
+SubscriptionHandlerId
+StreamSubscription::AddSubscriptionHandler(const std::string &event_type,
+                                           const std::string &object_id,
+                                           NotificationHandler handler) {
+  return pImpl_->router_.Add(event_type, object_id, std::move(handler));
+}
+
+bool StreamSubscription::RemoveSubscriptionHandler(SubscriptionHandlerId id) {
+  return pImpl_->router_.Remove(id);
+}
+
+Status StreamSubscription::Start(const SubscribeRequest &request) {
+  if (pImpl_->running_) {
+    return Status(std::make_error_code(std::errc::operation_not_permitted),
+                  "Subscription is already running");
+  }
+  if (!pImpl_->client_) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Interfaces client is null");
+  }
+  if (!pImpl_->client_->HasCapability(kStreamSubscribeCapability)) {
+    return Status(std::make_error_code(std::errc::not_supported),
+                  "Gateway did not accept " +
+                      std::string(kStreamSubscribeCapability) +
+                      ", use ClientCallbackServer instead");
+  }
+  if (pImpl_->reader_thread_.joinable()) {
+    pImpl_->reader_thread_.join();
+  }
+
+  pImpl_->request_ = request;
+  pImpl_->stopping_ = false;
+  pImpl_->dispatcher_ = std::make_unique<NotificationDispatcher>(
+      pImpl_->options_.dispatch,
+      pImpl_->router_.BindHandler(pImpl_->message_callback_));
+
+  Status status = pImpl_->OpenStream();
+  if (!status) {
+    pImpl_->dispatcher_->Stop();
+    return status.Chain("Failed to open subscription stream");
+  }
+
+  pImpl_->running_ = true;
+  pImpl_->reader_thread_ = std::thread([this]() { pImpl_->ReadLoop(); });
+  return Status();
+}
+
+void StreamSubscription::Stop() { pImpl_->Stop(); }
+
+bool StreamSubscription::IsRunning() const { return pImpl_->running_; }
+
+StreamSubscriptionStats StreamSubscription::GetStats() const {
+  StreamSubscriptionStats stats;
+  stats.messages = pImpl_->messages_.load(std::memory_order_relaxed);
+  stats.reconnects = pImpl_->reconnects_.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->id_mutex_);
+    stats.subscription_id = pImpl_->subscription_id_;
+  }
+  if (pImpl_->dispatcher_) {
+    stats.dispatch = pImpl_->dispatcher_->GetStats();
+  }
+  return stats;
+}
@@ -0,0 +1,670 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of SubscriptionManager
+ */
+
+#include "robot/client/subscription_manager.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/variant.pb.h"
+#include "robot/common/logger.h"
+
+using namespace humanoid_robot::konka_sdk::robot;
+using namespace humanoid_robot::PB::interfaces;
+using humanoid_robot::PB::common::Variant;
+
+namespace {
+
+/**
+ * 分层时间轮：kLevels 层，每层 kSlots 个槽。
+ * 第 L 层的一个槽覆盖 kSlots^L 个刻度；低层转完一圈时把上一层对应槽的
+ * 定时器重新分配到下层。调度、取消均为 O(1)，推进一个刻度只处理该刻度
+ * 到期（及需要下沉）的定时器。非线程安全，由调用方加锁。
+ */
+class TimerWheel {
+public:
+  static constexpr int kLevels = 4;
+  static constexpr int kBits = 6;
+  static constexpr uint64_t kSlots = 1ULL << kBits;
+  static constexpr uint64_t kMask = kSlots - 1;
+
+  struct Node {
+    Node *prev = nullptr;
+    Node *next = nullptr;
+    uint64_t expires = 0;
+    uint64_t owner = 0;
+  };
+
+  TimerWheel() {
+    for (auto &level : heads_) {
+      for (Node &head : level) {
+        head.prev = head.next = &head;
+      }
+    }
+  }
+
+  uint64_t Current() const { return current_; }
+
+  void Schedule(Node *node, uint64_t expires) {
+    Cancel(node);
+    node->expires = std::max(expires, current_ + 1);
+    Link(SlotFor(node->expires), node);
+  }
+
+  static void Cancel(Node *node) {
+    if (node->next == nullptr) {
+      return;
+    }
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->prev = node->next = nullptr;
+  }
+
+  // 推进到 now，对每个到期的定时器调用 fire(node)，调用前已取消
+  template <typename F> void Advance(uint64_t now, F &&fire) {
+    while (current_ < now) {
+      ++current_;
+      for (int level = 1; level < kLevels; ++level) {
+        if (((current_ >> ((level - 1) * kBits)) & kMask) != 0) {
+          break;
+        }
+        Cascade(level, (current_ >> (level * kBits)) & kMask);
+      }
+      Node &head = heads_[0][current_ & kMask];
+      while (head.next != &head) {
+        Node *node = head.next;
+        Cancel(node);
+        fire(node);
+      }
+    }
+  }
+
+private:
+  static void Link(Node *head, Node *node) {
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+  }
+
+  Node *SlotFor(uint64_t expires) {
+    uint64_t delta = expires - current_;
+    for (int level = 0; level < kLevels; ++level) {
+      if (delta < (1ULL << ((level + 1) * kBits))) {
+        return &heads_[level][(expires >> (level * kBits)) & kMask];
+      }
+    }
+    // 超出时间轮范围：放在最高层最远的槽，下沉时重新计算
+    uint64_t capped = current_ + (1ULL << (kLevels * kBits)) - 1;
+    return &heads_[kLevels - 1][(capped >> ((kLevels - 1) * kBits)) & kMask];
+  }
+
+  void Cascade(int level, uint64_t index) {
+    Node &head = heads_[level][index];
+    Node *node = head.next;
+    head.prev = head.next = &head;
+    while (node != &head) {
+      Node *next = node->next;
+      node->prev = node->next = nullptr;
+      Link(SlotFor(node->expires), node);
+      node = next;
+    }
+  }
+
+  Node heads_[kLevels][kSlots];
+  uint64_t current_ = 0;
+};
+
+bool IsConnectionError(const Status &status) {
+  std::error_code code = status.code();
+  return code == std::errc::host_unreachable || code == std::errc::timed_out ||
+         code == std::errc::not_connected ||
+         code == std::errc::connection_refused;
+}
+
+Status CheckRet(const humanoid_robot::PB::common::ErrorInfo &ret) {
+  if (!ret.code().empty() && ret.code() != "0") {
+    return Status(std::make_error_code(std::errc::protocol_error),
+                  "Gateway returned code " + ret.code() + ": " +
+                      ret.message());
+  }
+  return Status();
+}
+
+struct Entry {
+  ManagedSubscriptionId id = 0;
+  SubscribeRequest request;
+  std::string subscription_id;
+  int32_t heartbeat_s = 0;
+  bool pending = false;
+  uint32_t restore_attempts = 0; // 连续恢复失败次数
+  uint64_t restore_tick = 0;     // 不早于该刻度再次尝试恢复
+  TimerWheel::Node timer;
+};
+
+struct RenewItem {
+  ManagedSubscriptionId id;
+  std::string subscription_id;
+  int32_t heartbeat_s;
+};
+} // namespace
+
+// =============================================================================
+// SubscriptionManager::Impl - 私有实现
+// =============================================================================
+
+class SubscriptionManager::Impl {
+public:
+  std::shared_ptr<InterfacesClient> client_;
+  SubscriptionManagerOptions options_;
+  std::chrono::steady_clock::time_point epoch_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<ManagedSubscriptionId, std::unique_ptr<Entry>> entries_;
+  TimerWheel wheel_;
+  ManagedSubscriptionId next_id_ = 1;
+
+  std::mutex restore_mutex_;
+  std::atomic<bool> disconnected_{false};
+
+  std::thread tick_thread_;
+  std::mutex tick_mutex_;
+  std::condition_variable tick_cv_;
+  std::atomic<bool> running_{false};
+  std::atomic<bool> stopping_{false};
+
+  std::atomic<uint64_t> renew_requests_{0};
+  std::atomic<uint64_t> renewed_{0};
+  std::atomic<uint64_t> renew_failures_{0};
+  std::atomic<uint64_t> renew_skipped_{0};
+  std::atomic<uint64_t> restored_{0};
+  std::atomic<uint64_t> restore_failures_{0};
+  std::atomic<uint64_t> restores_{0};
+  std::atomic<int64_t> last_restore_ms_{0};
+
+  Impl(std::shared_ptr<InterfacesClient> client,
+       SubscriptionManagerOptions options)
+      : client_(std::move(client)), options_(options),
+        epoch_(std::chrono::steady_clock::now()) {
+    if (options_.tick_ms <= 0) {
+      options_.tick_ms = 100;
+    }
+    if (options_.renew_batch_size == 0) {
+      options_.renew_batch_size = 1;
+    }
+    if (options_.restore_threads == 0) {
+      options_.restore_threads = 1;
+    }
+    options_.restore_backoff_ms =
+        std::max(options_.restore_backoff_ms, options_.tick_ms);
+    options_.restore_backoff_max_ms =
+        std::max(options_.restore_backoff_max_ms, options_.restore_backoff_ms);
+  }
+
+  ~Impl() { Stop(); }
+
+  uint64_t NowTick() const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - epoch_)
+                       .count();
+    return static_cast<uint64_t>(elapsed / options_.tick_ms);
+  }
+
+  uint64_t RenewTicks(int32_t heartbeat_s) const {
+    double ms = heartbeat_s * 1000.0 * options_.renew_fraction;
+    return std::max<uint64_t>(1, static_cast<uint64_t>(ms / options_.tick_ms));
+  }
+
+  int32_t HeartbeatOf(const SubscribeRequest &request) const {
+    for (const auto *dict : {&request.params(), &request.input()}) {
+      auto it = dict->keyvaluelist().find(kHeartbeatIntervalKey);
+      if (it != dict->keyvaluelist().end() && it->second.int32value() > 0) {
+        return it->second.int32value();
+      }
+    }
+    return options_.default_heartbeat_s;
+  }
+
+  Status SubscribeOnce(const SubscribeRequest &request,
+                       std::string *subscription_id) {
+    SubscribeResponse response;
+    Status status =
+        client_->Subscribe(request, response, options_.request_timeout_ms);
+    if (!status) {
+      return status;
+    }
+    status = CheckRet(response.ret());
+    if (!status) {
+      return status;
+    }
+    const auto &output = response.output().keyvaluelist();
+    auto it = output.find(kSubscriptionIdKey);
+    subscription_id->clear();
+    if (it != output.end()) {
+      *subscription_id = it->second.stringvalue();
+    }
+    return Status();
+  }
+
+  Status UnsubscribeOnce(const std::string &subscription_id) {
+    UnsubscribeRequest request;
+    Variant &value =
+        (*request.mutable_input()->mutable_keyvaluelist())[kSubscriptionIdKey];
+    value.set_type(Variant::KStringValue);
+    value.set_stringvalue(subscription_id);
+    UnsubscribeResponse response;
+    Status status =
+        client_->Unsubscribe(request, response, options_.request_timeout_ms);
+    if (status) {
+      status = CheckRet(response.ret());
+    }
+    return status;
+  }
+
+  // 第 attempts 次失败后的重试间隔(刻度)
+  uint64_t RestoreBackoffTicks(uint32_t attempts) const {
+    int64_t ms = options_.restore_backoff_ms;
+    for (uint32_t i = 1; i < attempts && ms < options_.restore_backoff_max_ms;
+         ++i) {
+      ms *= 2;
+    }
+    ms = std::min(ms, options_.restore_backoff_max_ms);
+    return static_cast<uint64_t>(ms / options_.tick_ms);
+  }
+
+  // 须持有 mutex_；没有订阅ID的订阅无法续租，只在重连后恢复
+  void ScheduleRenew(Entry *entry, uint64_t delay_ticks) {
+    if (entry->subscription_id.empty()) {
+      TimerWheel::Cancel(&entry->timer);
+      return;
+    }
+    wheel_.Schedule(&entry->timer, NowTick() + delay_ticks);
+  }
+
+  // 连接重新建立或显式恢复，所有订阅立即重试
+  void MarkAllPending() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &item : entries_) {
+      item.second->pending = true;
+      item.second->restore_attempts = 0;
+      item.second->restore_tick = 0;
+      TimerWheel::Cancel(&item.second->timer);
+    }
+  }
+
+  bool HasPending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &item : entries_) {
+      if (item.second->pending) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // 并行重新订阅所有待恢复且已过退避时间的订阅
+  Status RestorePending() {
+    std::lock_guard<std::mutex> restore_lock(restore_mutex_);
+    std::vector<std::pair<ManagedSubscriptionId, SubscribeRequest>> work;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint64_t now = NowTick();
+      for (auto &item : entries_) {
+        if (item.second->pending && item.second->restore_tick <= now) {
+          work.emplace_back(item.first, item.second->request);
+        }
+      }
+    }
+    if (work.empty()) {
+      return Status();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Status> results(work.size());
+    std::vector<std::string> ids(work.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+      for (size_t i = next.fetch_add(1); i < work.size();
+           i = next.fetch_add(1)) {
+        results[i] = SubscribeOnce(work[i].second, &ids[i]);
+      }
+    };
+    size_t thread_count = std::min(options_.restore_threads, work.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; ++i) {
+      threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    Status first_error;
+    size_t failed = 0;
+    std::vector<std::string> orphaned;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      uint64_t now = NowTick();
+      for (size_t i = 0; i < work.size(); ++i) {
+        auto it = entries_.find(work[i].first);
+        if (!results[i]) {
+          ++failed;
+          if (first_error) {
+            first_error = results[i];
+          }
+          if (it != entries_.end()) {
+            Entry *entry = it->second.get();
+            ++entry->restore_attempts;
+            entry->restore_tick =
+                now + RestoreBackoffTicks(entry->restore_attempts);
+          }
+          continue;
+        }
+        if (it == entries_.end()) {
+          // 恢复期间已被移除，网关上新建的订阅需要退订
+          if (!ids[i].empty()) {
+            orphaned.push_back(ids[i]);
+          }
+          continue;
+        }
+        Entry *entry = it->second.get();
+        entry->subscription_id = ids[i];
+        entry->pending = false;
+        entry->restore_attempts = 0;
+        entry->restore_tick = 0;
+        ScheduleRenew(entry, RenewTicks(entry->heartbeat_s));
+      }
+    }
+    for (const std::string &subscription_id : orphaned) {
+      Status status = UnsubscribeOnce(subscription_id);
+      if (!status) {
+        KONKA_LOG_WARN("subscription").Field("subscription", subscription_id)
+            << "Failed to unsubscribe orphaned subscription: "
+            << status.message();
+      }
+    }
+
+    restores_.fetch_add(1, std::memory_order_relaxed);
+    restored_.fetch_add(work.size() - failed, std::memory_order_relaxed);
+    restore_failures_.fetch_add(failed, std::memory_order_relaxed);
+    last_restore_ms_.store(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        std::memory_order_relaxed);
+    if (failed != 0) {
+      return first_error.Chain("Failed to restore " + std::to_string(failed) +
+                               " of " + std::to_string(work.size()) +
+                               " subscriptions");
+    }
+    return Status();
+  }
+
+  void RenewBatch(const std::vector<RenewItem> &batch) {
+    SubscribeRequest request;
+    Variant &renew_value =
+        (*request.mutable_input()->mutable_keyvaluelist())[kRenewSubscriptionsKey];
+    renew_value.set_type(Variant::KDictValue);
+    auto *renew = renew_value.mutable_dictvalue()->mutable_keyvaluelist();
+    for (const RenewItem &item : batch) {
+      Variant &heartbeat = (*renew)[item.subscription_id];
+      heartbeat.set_type(Variant::KInt32Value);
+      heartbeat.set_int32value(item.heartbeat_s);
+    }
+
+    renew_requests_.fetch_add(1, std::memory_order_relaxed);
+    SubscribeResponse response;
+    Status status =
+        client_->Subscribe(request, response, options_.request_timeout_ms);
+    if (status) {
+      status = CheckRet(response.ret());
+    }
+    if (!status) {
+      renew_failures_.fetch_add(1, std::memory_order_relaxed);
+      if (IsConnectionError(status)) {
+        disconnected_ = true;
+        MarkAllPending();
+        return;
+      }
+    }
+
+    std::unordered_set<std::string> expired;
+    auto expired_it = response.output().keyvaluelist().find(
+        kExpiredSubscriptionsKey);
+    if (status && expired_it != response.output().keyvaluelist().end()) {
+      for (const auto &kv : expired_it->second.dictvalue().keyvaluelist()) {
+        expired.insert(kv.first);
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const RenewItem &item : batch) {
+      auto it = entries_.find(item.id);
+      if (it == entries_.end() || it->second->pending) {
+        continue;
+      }
+      Entry *entry = it->second.get();
+      if (!status) {
+        // 网关拒绝续租，稍后重试
+        ScheduleRenew(entry, std::max<uint64_t>(
+                                 1, RenewTicks(entry->heartbeat_s) / 4));
+      } else if (expired.count(item.subscription_id) != 0) {
+        entry->pending = true;
+      } else {
+        renewed_.fetch_add(1, std::memory_order_relaxed);
+        ScheduleRenew(entry, RenewTicks(entry->heartbeat_s));
+      }
+    }
+  }
+
+  void CheckConnection() {
+    grpc_connectivity_state state = client_->GetChannelState(true);
+    if (state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
+        state == GRPC_CHANNEL_SHUTDOWN) {
+      if (!disconnected_) {
+        disconnected_ = true;
+        MarkAllPending();
+      }
+    } else if (state == GRPC_CHANNEL_READY && disconnected_) {
+      disconnected_ = false;
+    }
+  }
+
+  void Tick() {
+    CheckConnection();
+    if (disconnected_) {
+      return;
+    }
+
+    std::vector<RenewItem> due;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      wheel_.Advance(NowTick(), [&](TimerWheel::Node *node) {
+        auto it = entries_.find(node->owner);
+        if (it != entries_.end() && !it->second->pending) {
+          Entry *entry = it->second.get();
+          due.push_back({entry->id, entry->subscription_id, entry->heartbeat_s});
+        }
+      });
+    }
+    if (!due.empty() && !client_->HasCapability(kSubscriptionRenewCapability)) {
+      // 网关不支持批量续租：不发请求，按原间隔重新排期以便协商后续租
+      renew_skipped_.fetch_add(due.size(), std::memory_order_relaxed);
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const RenewItem &item : due) {
+        auto it = entries_.find(item.id);
+        if (it != entries_.end() && !it->second->pending) {
+          ScheduleRenew(it->second.get(), RenewTicks(it->second->heartbeat_s));
+        }
+      }
+      due.clear();
+    }
+    for (size_t i = 0; i < due.size() && !disconnected_;
+         i += options_.renew_batch_size) {
+      size_t end = std::min(due.size(), i + options_.renew_batch_size);
+      RenewBatch(std::vector<RenewItem>(due.begin() + i, due.begin() + end));
+    }
+
+    if (!disconnected_ && HasPending()) {
+      RestorePending().IgnoreError();
+    }
+  }
+
+  void TickLoop() {
+    std::unique_lock<std::mutex> lock(tick_mutex_);
+    while (!stopping_) {
+      tick_cv_.wait_for(lock, std::chrono::milliseconds(options_.tick_ms),
+                        [this]() { return stopping_.load(); });
+      if (stopping_) {
+        break;
+      }
+      lock.unlock();
+      Tick();
+      lock.lock();
+    }
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(tick_mutex_);
+      stopping_ = true;
+    }
+    tick_cv_.notify_all();
+    if (tick_thread_.joinable()) {
+      tick_thread_.join();
+    }
+    running_ = false;
+  }
+};
+
+// =============================================================================
+// SubscriptionManager 实现
+// =============================================================================
+
+SubscriptionManager::SubscriptionManager(
+    std::shared_ptr<InterfacesClient> client,
+    SubscriptionManagerOptions options)
+    : pImpl_(std::make_unique<Impl>(std::move(client), options)) {}
+
+SubscriptionManager::~SubscriptionManager() = default;
+
+Status SubscriptionManager::Start() {
+  if (pImpl_->running_) {
+    return Status(std::make_error_code(std::errc::operation_not_permitted),
+                  "Subscription manager is already running");
+  }
+  if (!pImpl_->client_) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Interfaces client is null");
+  }
+  pImpl_->stopping_ = false;
+  pImpl_->running_ = true;
+  pImpl_->tick_thread_ = std::thread([this]() { pImpl_->TickLoop(); });
+  return Status();
+}
+
+void SubscriptionManager::Stop() { pImpl_->Stop(); }
+
+bool SubscriptionManager::IsRunning() const { return pImpl_->running_; }
+
+Status SubscriptionManager::Add(const SubscribeRequest &request,
+                                ManagedSubscriptionId *id) {
+  if (!pImpl_->client_) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Interfaces client is null");
+  }
+
+  auto entry = std::make_unique<Entry>();
+  entry->request = request;
+  entry->heartbeat_s = pImpl_->HeartbeatOf(request);
+  Status status = pImpl_->SubscribeOnce(request, &entry->subscription_id);
+  if (!status) {
+    return status.Chain("Failed to subscribe");
+  }
+
+  std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+  entry->id = pImpl_->next_id_++;
+  entry->timer.owner = entry->id;
+  pImpl_->ScheduleRenew(entry.get(), pImpl_->RenewTicks(entry->heartbeat_s));
+  if (id != nullptr) {
+    *id = entry->id;
+  }
+  pImpl_->entries_.emplace(entry->id, std::move(entry));
+  return Status();
+}
+
+Status SubscriptionManager::Remove(ManagedSubscriptionId id) {
+  std::string subscription_id;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    auto it = pImpl_->entries_.find(id);
+    if (it == pImpl_->entries_.end()) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Unknown subscription handle");
+    }
+    TimerWheel::Cancel(&it->second->timer);
+    if (!it->second->pending) {
+      subscription_id = it->second->subscription_id;
+    }
+    pImpl_->entries_.erase(it);
+  }
+  if (subscription_id.empty()) {
+    return Status();
+  }
+  return pImpl_->UnsubscribeOnce(subscription_id);
+}
+
+std::string
+SubscriptionManager::SubscriptionIdOf(ManagedSubscriptionId id) const {
+  std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+  auto it = pImpl_->entries_.find(id);
+  return it == pImpl_->entries_.end() ? std::string()
+                                      : it->second->subscription_id;
+}
+
+size_t SubscriptionManager::Size() const {
+  std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+  return pImpl_->entries_.size();
+}
+
+Status SubscriptionManager::RestoreAll() {
+  pImpl_->MarkAllPending();
+  return pImpl_->RestorePending();
+}
+
+SubscriptionManagerStats SubscriptionManager::GetStats() const {
+  SubscriptionManagerStats stats;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    for (const auto &item : pImpl_->entries_) {
+      if (item.second->pending) {
+        ++stats.pending;
+      } else {
+        ++stats.active;
+      }
+    }
+  }
+  stats.renew_requests =
+      pImpl_->renew_requests_.load(std::memory_order_relaxed);
+  stats.renewed = pImpl_->renewed_.load(std::memory_order_relaxed);
+  stats.renew_failures =
+      pImpl_->renew_failures_.load(std::memory_order_relaxed);
+  stats.renew_skipped = pImpl_->renew_skipped_.load(std::memory_order_relaxed);
+  stats.restored = pImpl_->restored_.load(std::memory_order_relaxed);
+  stats.restore_failures =
+      pImpl_->restore_failures_.load(std::memory_order_relaxed);
+  stats.restores = pImpl_->restores_.load(std::memory_order_relaxed);
+  stats.last_restore_ms =
+      pImpl_->last_restore_ms_.load(std::memory_order_relaxed);
+  return stats;
+}
@@ -0,0 +1,355 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of Logger
+ */
+
+#include "robot/common/logger.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace humanoid_robot::konka_sdk::common;
+
+namespace {
+// 每个线程缓冲的记录数
+constexpr uint64_t kThreadBufferRecords = 64;
+// 后台线程的汇总周期
+constexpr int64_t kDrainIntervalMs = 20;
+
+struct ThreadBuffer {
+  std::atomic<uint64_t> head{0}; // 生产者（所属线程）写
+  std::atomic<uint64_t> tail{0}; // 消费者（后台线程）写
+  std::atomic<bool> orphaned{false};
+  LogRecord records[kThreadBufferRecords];
+};
+
+uint32_t CurrentThreadId() {
+  thread_local uint32_t id = static_cast<uint32_t>(syscall(SYS_gettid));
+  return id;
+}
+
+LogLevel ParseLevel(const char *value, LogLevel fallback) {
+  if (value == nullptr) {
+    return fallback;
+  }
+  static const struct {
+    const char *name;
+    LogLevel level;
+  } kNames[] = {{"trace", LogLevel::kTrace}, {"debug", LogLevel::kDebug},
+                {"info", LogLevel::kInfo},   {"warn", LogLevel::kWarn},
+                {"error", LogLevel::kError}, {"off", LogLevel::kOff}};
+  for (const auto &entry : kNames) {
+    if (strcasecmp(value, entry.name) == 0) {
+      return entry.level;
+    }
+  }
+  return fallback;
+}
+
+const char *Basename(const char *path) {
+  const char *slash = std::strrchr(path, '/');
+  return slash != nullptr ? slash + 1 : path;
+}
+
+// 2025-01-01 12:00:00.123456 W 1234 [module] message key=value (file.cpp:42)
+void FormatRecord(const LogRecord &record, std::string &out) {
+  static const char kLevelChars[] = {'T', 'D', 'I', 'W', 'E', 'O'};
+  time_t seconds = static_cast<time_t>(record.time_ns / 1000000000);
+  struct tm tm_buf;
+  localtime_r(&seconds, &tm_buf);
+  char prefix[96];
+  size_t length = std::strftime(prefix, sizeof(prefix), "%Y-%m-%d %H:%M:%S",
+                                &tm_buf);
+  length += std::snprintf(
+      prefix + length, sizeof(prefix) - length, ".%06ld %c %u [",
+      static_cast<long>((record.time_ns % 1000000000) / 1000),
+      kLevelChars[static_cast<int>(record.level)], record.thread_id);
+  out.append(prefix, length);
+  out.append(record.module);
+  out.append("] ");
+  out.append(record.text, record.length);
+  char suffix[64];
+  int suffix_length = std::snprintf(suffix, sizeof(suffix), " (%s:%d)\n",
+                                    Basename(record.file), record.line);
+  out.append(suffix, std::min<size_t>(suffix_length, sizeof(suffix) - 1));
+}
+
+void WriteAll(int fd, const std::string &data) {
+  size_t offset = 0;
+  while (offset < data.size()) {
+    ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    offset += static_cast<size_t>(written);
+  }
+}
+} // namespace
+
+// =============================================================================
+// Logger::Impl - 私有实现
+// =============================================================================
+
+class Logger::Impl {
+public:
+  // 线程退出时标记缓冲区，由后台线程输出剩余记录后回收
+  struct LocalHolder {
+    std::shared_ptr<ThreadBuffer> buffer;
+    ~LocalHolder() {
+      if (buffer) {
+        buffer->orphaned.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+  std::mutex registry_mutex_;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+
+  std::mutex drain_mutex_; // 串行化汇总与输出目标的替换
+  LogSink sink_;
+  std::string batch_;
+
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+
+  std::mutex wake_mutex_;
+  std::condition_variable wake_cv_;
+  std::thread thread_;
+
+  Impl() {
+    thread_ = std::thread([this]() { Loop(); });
+    thread_.detach();
+  }
+
+  ThreadBuffer *Local() {
+    thread_local LocalHolder holder;
+    if (!holder.buffer) {
+      holder.buffer = std::make_shared<ThreadBuffer>();
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      buffers_.push_back(holder.buffer);
+    }
+    return holder.buffer.get();
+  }
+
+  void Submit(const LogRecord &record) {
+    ThreadBuffer *buffer = Local();
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    uint64_t used = head - buffer->tail.load(std::memory_order_acquire);
+    if (used >= kThreadBufferRecords) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    LogRecord &slot = buffer->records[head % kThreadBufferRecords];
+    slot.time_ns = record.time_ns;
+    slot.level = record.level;
+    slot.thread_id = record.thread_id;
+    slot.module = record.module;
+    slot.file = record.file;
+    slot.line = record.line;
+    slot.message_length = record.message_length;
+    slot.length = record.length;
+    std::memcpy(slot.text, record.text, record.length);
+    buffer->head.store(head + 1, std::memory_order_release);
+    // 过半时提前唤醒后台线程，降低丢弃概率
+    if (used + 1 == kThreadBufferRecords / 2) {
+      wake_cv_.notify_one();
+    }
+  }
+
+  void Drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      buffers = buffers_;
+    }
+
+    // 按时间合并各线程的记录
+    std::vector<const LogRecord *> records;
+    std::vector<uint64_t> heads(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      ThreadBuffer &buffer = *buffers[i];
+      heads[i] = buffer.head.load(std::memory_order_acquire);
+      for (uint64_t index = buffer.tail.load(std::memory_order_relaxed);
+           index < heads[i]; ++index) {
+        records.push_back(&buffer.records[index % kThreadBufferRecords]);
+      }
+    }
+    std::stable_sort(records.begin(), records.end(),
+                     [](const LogRecord *a, const LogRecord *b) {
+                       return a->time_ns < b->time_ns;
+                     });
+
+    if (sink_) {
+      for (const LogRecord *record : records) {
+        try {
+          sink_(*record);
+        } catch (...) {
+          // 日志输出目标的异常不向外传播
+        }
+      }
+    } else if (!records.empty()) {
+      batch_.clear();
+      for (const LogRecord *record : records) {
+        FormatRecord(*record, batch_);
+      }
+      WriteAll(STDERR_FILENO, batch_);
+    }
+    written_.fetch_add(records.size(), std::memory_order_relaxed);
+
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      buffers[i]->tail.store(heads[i], std::memory_order_release);
+    }
+
+    // 回收已退出线程的空缓冲区
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    buffers_.erase(
+        std::remove_if(buffers_.begin(), buffers_.end(),
+                       [](const std::shared_ptr<ThreadBuffer> &buffer) {
+                         return buffer->orphaned.load(
+                                    std::memory_order_acquire) &&
+                                buffer->tail.load(std::memory_order_relaxed) ==
+                                    buffer->head.load(
+                                        std::memory_order_acquire);
+                       }),
+        buffers_.end());
+  }
+
+  void Loop() {
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait_for(lock, std::chrono::milliseconds(kDrainIntervalMs));
+      }
+      Drain();
+    }
+  }
+};
+
+// =============================================================================
+// Logger 实现
+// =============================================================================
+
+Logger &Logger::Instance() {
+  // 有意不析构：进程退出阶段的日志调用仍然安全，退出时同步输出剩余记录
+  static Logger *instance = []() {
+    Logger *logger = new Logger();
+    std::atexit([]() { Logger::Instance().Flush(); });
+    return logger;
+  }();
+  return *instance;
+}
+
+Logger::Logger()
+    : level_(static_cast<int>(
+          ParseLevel(std::getenv("KONKA_SDK_LOG_LEVEL"), LogLevel::kWarn))),
+      impl_(new Impl()) {}
+
+void Logger::SetSink(LogSink sink) {
+  Flush();
+  std::lock_guard<std::mutex> lock(impl_->drain_mutex_);
+  impl_->sink_ = std::move(sink);
+}
+
+void Logger::Submit(const LogRecord &record) { impl_->Submit(record); }
+
+void Logger::Flush() { impl_->Drain(); }
+
+LoggerStats Logger::GetStats() const {
+  LoggerStats stats;
+  stats.written = impl_->written_.load(std::memory_order_relaxed);
+  stats.dropped = impl_->dropped_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(impl_->registry_mutex_);
+  stats.threads = impl_->buffers_.size();
+  return stats;
+}
+
+// =============================================================================
+// LogLine 实现
+// =============================================================================
+
+LogLine::LogLine(LogLevel level, const char *module, const char *file,
+                 int line)
+    : level_(level), module_(module), file_(file), line_(line) {}
+
+LogLine::~LogLine() {
+  LogRecord record;
+  record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  record.level = level_;
+  record.thread_id = CurrentThreadId();
+  record.module = module_;
+  record.file = file_;
+  record.line = line_;
+  size_t length = 0;
+  Append(record.text, length, kMaxLogText,
+         std::string_view(message_, message_length_));
+  record.message_length = static_cast<uint16_t>(length);
+  Append(record.text, length, kMaxLogText,
+         std::string_view(fields_, fields_length_));
+  record.length = static_cast<uint16_t>(length);
+  Logger::Instance().Submit(record);
+}
+
+LogLine &LogLine::Field(std::string_view key, std::string_view value) {
+  Append(fields_, fields_length_, kMaxLogText, " ");
+  Append(fields_, fields_length_, kMaxLogText, key);
+  Append(fields_, fields_length_, kMaxLogText, "=");
+  bool quote = value.empty() ||
+               value.find_first_of(" =\"") != std::string_view::npos;
+  if (!quote) {
+    Append(fields_, fields_length_, kMaxLogText, value);
+    return *this;
+  }
+  Append(fields_, fields_length_, kMaxLogText, "\"");
+  for (char c : value) {
+    if (c == '"') {
+      Append(fields_, fields_length_, kMaxLogText, "\\\"");
+    } else {
+      Append(fields_, fields_length_, kMaxLogText, std::string_view(&c, 1));
+    }
+  }
+  Append(fields_, fields_length_, kMaxLogText, "\"");
+  return *this;
+}
+
+size_t LogLine::FormatInteger(char *buffer, int64_t value) {
+  return static_cast<size_t>(std::to_chars(buffer, buffer + 32, value).ptr -
+                             buffer);
+}
+
+size_t LogLine::FormatUnsigned(char *buffer, uint64_t value) {
+  return static_cast<size_t>(std::to_chars(buffer, buffer + 32, value).ptr -
+                             buffer);
+}
+
+size_t LogLine::FormatDouble(char *buffer, double value) {
+  int length = std::snprintf(buffer, 32, "%.6g", value);
+  return length < 0 ? 0 : std::min<size_t>(length, 31);
+}
+
+void LogLine::Append(char *target, size_t &length, size_t capacity,
+                     std::string_view value) {
+  size_t count = std::min(value.size(), capacity - length);
+  std::memcpy(target + length, value.data(), count);
+  length += count;
+}
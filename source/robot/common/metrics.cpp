@@ -0,0 +1,514 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of MetricsRegistry
+ */
+
+#include "robot/common/metrics.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "robot/common/latency_histogram.h"
+
+using namespace humanoid_robot::konka_sdk::common;
+
+namespace {
+constexpr size_t kPhaseCount = static_cast<size_t>(MetricPhase::kCount);
+constexpr size_t kErrorCount = static_cast<size_t>(MetricErrorCategory::kCount);
+
+// Prometheus histogram 的桶边界(秒)
+constexpr double kBucketBounds[] = {0.0001, 0.00025, 0.0005, 0.001, 0.0025,
+                                    0.005,  0.01,    0.025,  0.05,  0.1,
+                                    0.25,   0.5,     1.0,    2.5,   5.0,
+                                    10.0};
+
+// 批量条数 histogram 的桶边界
+constexpr uint64_t kBatchSizeBounds[] = {1, 2, 4, 8, 16, 32, 64, 128};
+
+struct CommandShard {
+  MetricKey key;
+  LatencyHistogram phases[kPhaseCount];
+  std::atomic<uint64_t> errors[kErrorCount] = {};
+  LatencyHistogram batch_size;
+
+  explicit CommandShard(const MetricKey &key) : key(key) {}
+};
+
+// 分片内按方法名指针 + 命令码查找；合并时再按方法名字符串归并
+struct ShardKeyHash {
+  size_t operator()(const std::pair<const char *, int32_t> &key) const {
+    return std::hash<const void *>()(key.first) ^
+           (static_cast<size_t>(static_cast<uint32_t>(key.second)) *
+            0x9E3779B97F4A7C15ull);
+  }
+};
+
+struct ThreadShard {
+  // 保护 commands 的结构；所属线程查找时不加锁。
+  // 分片内的计数只有所属线程写入，Reset() 与写入并发时可能残留少量样本
+  std::mutex mutex;
+  std::unordered_map<std::pair<const char *, int32_t>,
+                     std::unique_ptr<CommandShard>, ShardKeyHash>
+      commands;
+  CommandShard *last = nullptr; // 最近一次使用的命令，命中时跳过哈希查找
+
+  CommandShard *Find(const MetricKey &key) {
+    if (last != nullptr && last->key.method == key.method &&
+        last->key.command == key.command) {
+      return last;
+    }
+    auto it = commands.find({key.method, key.command});
+    if (it == commands.end()) {
+      auto shard = std::make_unique<CommandShard>(key);
+      std::lock_guard<std::mutex> lock(mutex);
+      it = commands.emplace(std::make_pair(key.method, key.command),
+                            std::move(shard))
+               .first;
+    }
+    last = it->second.get();
+    return last;
+  }
+};
+
+// 合并后的单个命令
+struct MergedCommand {
+  std::array<std::unique_ptr<LatencyHistogram>, kPhaseCount> phases;
+  std::array<uint64_t, kErrorCount> errors{};
+  std::unique_ptr<LatencyHistogram> batch_size;
+
+  MergedCommand() : batch_size(std::make_unique<LatencyHistogram>()) {
+    for (auto &phase : phases) {
+      phase = std::make_unique<LatencyHistogram>();
+    }
+  }
+
+  void Merge(const CommandShard &shard) {
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+      phases[i]->Merge(shard.phases[i]);
+    }
+    for (size_t i = 0; i < kErrorCount; ++i) {
+      errors[i] += shard.errors[i].load(std::memory_order_relaxed);
+    }
+    batch_size->Merge(shard.batch_size);
+  }
+};
+
+void MergeShard(ThreadShard &shard, std::map<MetricKey, MergedCommand> &out) {
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  for (const auto &entry : shard.commands) {
+    out[entry.second->key].Merge(*entry.second);
+  }
+}
+
+void AppendLabels(std::ostringstream &out, const MetricKey &key) {
+  out << "method=\"" << key.method << "\",command=\"" << key.command << "\"";
+}
+} // namespace
+
+// =============================================================================
+// 名称与归类
+// =============================================================================
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace common {
+
+const char *MetricPhaseName(MetricPhase phase) {
+  switch (phase) {
+  case MetricPhase::kTotal:
+    return "total";
+  case MetricPhase::kEnvelopeBuild:
+    return "envelope_build";
+  case MetricPhase::kStreamOpen:
+    return "stream_open";
+  case MetricPhase::kWrite:
+    return "write";
+  case MetricPhase::kServerWait:
+    return "server_wait";
+  case MetricPhase::kParse:
+    return "parse";
+  default:
+    return "unknown";
+  }
+}
+
+const char *MetricErrorCategoryName(MetricErrorCategory category) {
+  switch (category) {
+  case MetricErrorCategory::kNotConnected:
+    return "not_connected";
+  case MetricErrorCategory::kCancelled:
+    return "cancelled";
+  case MetricErrorCategory::kTimedOut:
+    return "timed_out";
+  case MetricErrorCategory::kNotFound:
+    return "not_found";
+  case MetricErrorCategory::kAlreadyExists:
+    return "already_exists";
+  case MetricErrorCategory::kPermissionDenied:
+    return "permission_denied";
+  case MetricErrorCategory::kUnavailable:
+    return "unavailable";
+  case MetricErrorCategory::kUnimplemented:
+    return "unimplemented";
+  case MetricErrorCategory::kIoError:
+    return "io_error";
+  case MetricErrorCategory::kParse:
+    return "parse";
+  default:
+    return "unknown";
+  }
+}
+
+MetricErrorCategory ErrorCategoryOf(const std::error_code &code) {
+  if (code == std::errc::not_connected) {
+    return MetricErrorCategory::kNotConnected;
+  }
+  if (code == std::errc::operation_canceled) {
+    return MetricErrorCategory::kCancelled;
+  }
+  if (code == std::errc::timed_out) {
+    return MetricErrorCategory::kTimedOut;
+  }
+  if (code == std::errc::no_such_file_or_directory) {
+    return MetricErrorCategory::kNotFound;
+  }
+  if (code == std::errc::file_exists) {
+    return MetricErrorCategory::kAlreadyExists;
+  }
+  if (code == std::errc::permission_denied) {
+    return MetricErrorCategory::kPermissionDenied;
+  }
+  if (code == std::errc::host_unreachable) {
+    return MetricErrorCategory::kUnavailable;
+  }
+  if (code == std::errc::function_not_supported) {
+    return MetricErrorCategory::kUnimplemented;
+  }
+  if (code == std::errc::bad_message) {
+    return MetricErrorCategory::kParse;
+  }
+  return MetricErrorCategory::kIoError;
+}
+
+bool MetricKey::operator<(const MetricKey &other) const {
+  int order = method == other.method ? 0 : std::strcmp(method, other.method);
+  return order != 0 ? order < 0 : command < other.command;
+}
+
+} // namespace common
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+// =============================================================================
+// MetricsRegistry::Impl - 私有实现
+// =============================================================================
+
+class MetricsRegistry::Impl {
+public:
+  // 线程退出时把分片并入 retired_
+  struct LocalHolder {
+    Impl *owner = nullptr;
+    std::shared_ptr<ThreadShard> shard;
+    ~LocalHolder() {
+      if (owner != nullptr && shard) {
+        owner->Retire(shard);
+      }
+    }
+  };
+
+  std::mutex shards_mutex_;
+  std::vector<std::shared_ptr<ThreadShard>> shards_;
+  std::map<MetricKey, MergedCommand> retired_; // 受 shards_mutex_ 保护
+
+  std::thread dump_thread_;
+  std::mutex dump_mutex_;
+  std::condition_variable dump_cv_;
+  bool dump_stopping_ = false;
+
+  ThreadShard *Local() {
+    thread_local LocalHolder holder;
+    if (!holder.shard) {
+      holder.owner = this;
+      holder.shard = std::make_shared<ThreadShard>();
+      std::lock_guard<std::mutex> lock(shards_mutex_);
+      shards_.push_back(holder.shard);
+    }
+    return holder.shard.get();
+  }
+
+  void Retire(const std::shared_ptr<ThreadShard> &shard) {
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    MergeShard(*shard, retired_);
+    for (auto it = shards_.begin(); it != shards_.end(); ++it) {
+      if (*it == shard) {
+        shards_.erase(it);
+        break;
+      }
+    }
+  }
+
+  std::map<MetricKey, MergedCommand> Merge() {
+    std::map<MetricKey, MergedCommand> merged;
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    for (const auto &entry : retired_) {
+      MergedCommand &target = merged[entry.first];
+      for (size_t i = 0; i < kPhaseCount; ++i) {
+        target.phases[i]->Merge(*entry.second.phases[i]);
+      }
+      for (size_t i = 0; i < kErrorCount; ++i) {
+        target.errors[i] += entry.second.errors[i];
+      }
+      target.batch_size->Merge(*entry.second.batch_size);
+    }
+    for (const auto &shard : shards_) {
+      MergeShard(*shard, merged);
+    }
+    return merged;
+  }
+};
+
+// =============================================================================
+// MetricsRegistry 实现
+// =============================================================================
+
+MetricsRegistry &MetricsRegistry::Instance() {
+  // 有意不析构：线程退出和进程退出阶段仍可安全记录
+  static MetricsRegistry *instance = new MetricsRegistry();
+  return *instance;
+}
+
+MetricsRegistry::MetricsRegistry() : impl_(new Impl()) {}
+
+void MetricsRegistry::RecordLatency(const MetricKey &key, MetricPhase phase,
+                                    uint64_t latency_ns) {
+  if (!IsEnabled()) {
+    return;
+  }
+  impl_->Local()
+      ->Find(key)
+      ->phases[static_cast<size_t>(phase)]
+      .RecordSingleWriter(latency_ns);
+}
+
+void MetricsRegistry::RecordError(const MetricKey &key,
+                                  MetricErrorCategory category) {
+  if (!IsEnabled()) {
+    return;
+  }
+  std::atomic<uint64_t> &errors =
+      impl_->Local()->Find(key)->errors[static_cast<size_t>(category)];
+  errors.store(errors.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+}
+
+void MetricsRegistry::RecordBatchSize(const MetricKey &key, uint64_t items) {
+  if (!IsEnabled()) {
+    return;
+  }
+  impl_->Local()->Find(key)->batch_size.RecordSingleWriter(items);
+}
+
+MetricsSnapshot MetricsRegistry::Snapshot() const {
+  MetricsSnapshot snapshot;
+  for (const auto &entry : impl_->Merge()) {
+    CommandMetrics &metrics = snapshot[entry.first];
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+      const LatencyHistogram &histogram = *entry.second.phases[i];
+      PhaseMetrics &phase = metrics.phases[i];
+      phase.count = histogram.Count();
+      phase.sum_ns = histogram.Sum();
+      phase.max_ns = histogram.Max();
+      phase.p50_ns = histogram.Percentile(0.5);
+      phase.p99_ns = histogram.Percentile(0.99);
+      phase.p999_ns = histogram.Percentile(0.999);
+    }
+    metrics.errors = entry.second.errors;
+    const LatencyHistogram &batch_size = *entry.second.batch_size;
+    metrics.batch_size.count = batch_size.Count();
+    metrics.batch_size.sum = batch_size.Sum();
+    metrics.batch_size.max = batch_size.Max();
+    metrics.batch_size.p50 = batch_size.Percentile(0.5);
+    metrics.batch_size.p99 = batch_size.Percentile(0.99);
+  }
+  return snapshot;
+}
+
+void MetricsRegistry::Reset() {
+  std::lock_guard<std::mutex> lock(impl_->shards_mutex_);
+  impl_->retired_.clear();
+  for (const auto &shard : impl_->shards_) {
+    std::lock_guard<std::mutex> shard_lock(shard->mutex);
+    for (auto &entry : shard->commands) {
+      for (auto &phase : entry.second->phases) {
+        phase.Reset();
+      }
+      for (auto &error : entry.second->errors) {
+        error.store(0, std::memory_order_relaxed);
+      }
+      entry.second->batch_size.Reset();
+    }
+  }
+}
+
+std::string MetricsRegistry::ExportPrometheus() const {
+  auto merged = impl_->Merge();
+  std::ostringstream out;
+
+  out << "# HELP konka_sdk_request_duration_seconds SDK request latency by "
+         "phase\n"
+      << "# TYPE konka_sdk_request_duration_seconds histogram\n";
+  for (const auto &entry : merged) {
+    for (size_t i = 0; i < kPhaseCount; ++i) {
+      const LatencyHistogram &histogram = *entry.second.phases[i];
+      if (histogram.Count() == 0) {
+        continue;
+      }
+      const char *phase = MetricPhaseName(static_cast<MetricPhase>(i));
+      // 对数线性桶按上界归入不小于它的 Prometheus 桶
+      uint64_t cumulative = 0;
+      size_t bucket = 0;
+      for (double bound : kBucketBounds) {
+        uint64_t bound_ns = static_cast<uint64_t>(bound * 1e9);
+        while (bucket < LatencyHistogram::kBucketCount &&
+               LatencyHistogram::BucketUpperBound(bucket) <= bound_ns) {
+          cumulative += histogram.BucketCountAt(bucket++);
+        }
+        out << "konka_sdk_request_duration_seconds_bucket{";
+        AppendLabels(out, entry.first);
+        out << ",phase=\"" << phase << "\",le=\"" << bound << "\"} "
+            << cumulative << "\n";
+      }
+      out << "konka_sdk_request_duration_seconds_bucket{";
+      AppendLabels(out, entry.first);
+      out << ",phase=\"" << phase << "\",le=\"+Inf\"} " << histogram.Count()
+          << "\n";
+      out << "konka_sdk_request_duration_seconds_sum{";
+      AppendLabels(out, entry.first);
+      out << ",phase=\"" << phase << "\"} "
+          << static_cast<double>(histogram.Sum()) / 1e9 << "\n";
+      out << "konka_sdk_request_duration_seconds_count{";
+      AppendLabels(out, entry.first);
+      out << ",phase=\"" << phase << "\"} " << histogram.Count() << "\n";
+    }
+  }
+
+  out << "# HELP konka_sdk_request_errors_total SDK request errors by "
+         "category\n"
+      << "# TYPE konka_sdk_request_errors_total counter\n";
+  for (const auto &entry : merged) {
+    for (size_t i = 0; i < kErrorCount; ++i) {
+      if (entry.second.errors[i] == 0) {
+        continue;
+      }
+      out << "konka_sdk_request_errors_total{";
+      AppendLabels(out, entry.first);
+      out << ",category=\""
+          << MetricErrorCategoryName(static_cast<MetricErrorCategory>(i))
+          << "\"} " << entry.second.errors[i] << "\n";
+    }
+  }
+
+  out << "# HELP konka_sdk_request_batch_size Items packed into one batched "
+         "request\n"
+      << "# TYPE konka_sdk_request_batch_size histogram\n";
+  for (const auto &entry : merged) {
+    const LatencyHistogram &histogram = *entry.second.batch_size;
+    if (histogram.Count() == 0) {
+      continue;
+    }
+    // 与延迟相同按桶上界归入，16 条以下每个值独占一个桶
+    uint64_t cumulative = 0;
+    size_t bucket = 0;
+    for (uint64_t bound : kBatchSizeBounds) {
+      while (bucket < LatencyHistogram::kBucketCount &&
+             LatencyHistogram::BucketUpperBound(bucket) <= bound) {
+        cumulative += histogram.BucketCountAt(bucket++);
+      }
+      out << "konka_sdk_request_batch_size_bucket{";
+      AppendLabels(out, entry.first);
+      out << ",le=\"" << bound << "\"} " << cumulative << "\n";
+    }
+    out << "konka_sdk_request_batch_size_bucket{";
+    AppendLabels(out, entry.first);
+    out << ",le=\"+Inf\"} " << histogram.Count() << "\n";
+    out << "konka_sdk_request_batch_size_sum{";
+    AppendLabels(out, entry.first);
+    out << "} " << histogram.Sum() << "\n";
+    out << "konka_sdk_request_batch_size_count{";
+    AppendLabels(out, entry.first);
+    out << "} " << histogram.Count() << "\n";
+  }
+  return out.str();
+}
+
+Status MetricsRegistry::WriteToFile(const std::string &path) const {
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream file(temp_path, std::ios::out | std::ios::trunc);
+    if (!file) {
+      return Status(std::make_error_code(std::errc::io_error),
+                    "Failed to open metrics file: " + temp_path);
+    }
+    file << ExportPrometheus();
+    if (!file) {
+      return Status(std::make_error_code(std::errc::io_error),
+                    "Failed to write metrics file: " + temp_path);
+    }
+  }
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    return Status(std::make_error_code(std::errc::io_error),
+                  "Failed to rename metrics file: " + path);
+  }
+  return Status();
+}
+
+Status MetricsRegistry::StartFileDump(const std::string &path,
+                                      int64_t interval_ms) {
+  if (interval_ms <= 0) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Metrics dump interval must be positive");
+  }
+  if (impl_->dump_thread_.joinable()) {
+    return Status(std::make_error_code(std::errc::operation_not_permitted),
+                  "Metrics file dump is already running");
+  }
+  Status status = WriteToFile(path);
+  if (!status) {
+    return status;
+  }
+  impl_->dump_stopping_ = false;
+  impl_->dump_thread_ = std::thread([this, path, interval_ms]() {
+    std::unique_lock<std::mutex> lock(impl_->dump_mutex_);
+    while (!impl_->dump_stopping_) {
+      impl_->dump_cv_.wait_for(lock, std::chrono::milliseconds(interval_ms),
+                               [this]() { return impl_->dump_stopping_; });
+      if (impl_->dump_stopping_) {
+        break;
+      }
+      lock.unlock();
+      WriteToFile(path).IgnoreError();
+      lock.lock();
+    }
+  });
+  return Status();
+}
+
+void MetricsRegistry::StopFileDump() {
+  {
+    std::lock_guard<std::mutex> lock(impl_->dump_mutex_);
+    impl_->dump_stopping_ = true;
+  }
+  impl_->dump_cv_.notify_all();
+  if (impl_->dump_thread_.joinable()) {
+    impl_->dump_thread_.join();
+  }
+}
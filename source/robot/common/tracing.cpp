@@ -0,0 +1,330 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of Tracer
+ */
+
+#include "robot/common/tracing.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+using namespace humanoid_robot::konka_sdk::common;
+
+namespace {
+// 当前线程上正在进行的 span
+thread_local const TraceContext *current_context = nullptr;
+
+uint32_t CurrentThreadId() {
+  thread_local uint32_t id = static_cast<uint32_t>(syscall(SYS_gettid));
+  return id;
+}
+
+// 线程局部的 xorshift 生成器，避免 id 生成成为竞争点
+uint64_t NewId() {
+  thread_local uint64_t state = []() {
+    std::random_device device;
+    uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device() ^
+                    (static_cast<uint64_t>(CurrentThreadId()) << 17);
+    return seed != 0 ? seed : 0x9E3779B97F4A7C15ull;
+  }();
+  uint64_t id;
+  do {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    id = state;
+  } while (id == 0);
+  return id;
+}
+
+bool ParseHex(const std::string &text, size_t offset, size_t length,
+              uint64_t *value) {
+  uint64_t result = 0;
+  for (size_t i = offset; i < offset + length; ++i) {
+    char c = text[i];
+    result <<= 4;
+    if (c >= '0' && c <= '9') {
+      result |= static_cast<uint64_t>(c - '0');
+    } else if (c >= 'a' && c <= 'f') {
+      result |= static_cast<uint64_t>(c - 'a' + 10);
+    } else {
+      return false;
+    }
+  }
+  *value = result;
+  return true;
+}
+
+void AppendJsonString(std::string &out, const char *value) {
+  out.push_back('"');
+  for (const char *p = value; *p != '\0'; ++p) {
+    if (*p == '"' || *p == '\\') {
+      out.push_back('\\');
+    }
+    out.push_back(*p);
+  }
+  out.push_back('"');
+}
+
+struct Slot {
+  std::atomic<uint64_t> sequence{0}; // 2i+1 写入中，2i+2 写入完成
+  SpanRecord record;
+};
+} // namespace
+
+// =============================================================================
+// TraceContext
+// =============================================================================
+
+std::string TraceContext::ToTraceparent() const {
+  char buffer[64];
+  std::snprintf(buffer, sizeof(buffer), "00-%016" PRIx64 "%016" PRIx64
+                                        "-%016" PRIx64 "-01",
+                trace_id_high, trace_id_low, span_id);
+  return buffer;
+}
+
+bool TraceContext::FromTraceparent(const std::string &value,
+                                   TraceContext *context) {
+  // 00-<32 hex>-<16 hex>-<2 hex>
+  if (value.size() < 55 || value[0] != '0' || value[1] != '0' ||
+      value[2] != '-' || value[35] != '-' || value[52] != '-') {
+    return false;
+  }
+  TraceContext parsed;
+  uint64_t flags = 0;
+  if (!ParseHex(value, 53, 2, &flags) ||
+      !ParseHex(value, 3, 16, &parsed.trace_id_high) ||
+      !ParseHex(value, 19, 16, &parsed.trace_id_low) ||
+      !ParseHex(value, 36, 16, &parsed.span_id) || !parsed.IsValid()) {
+    return false;
+  }
+  *context = parsed;
+  return true;
+}
+
+// =============================================================================
+// Tracer::Impl - 私有实现
+// =============================================================================
+
+class Tracer::Impl {
+public:
+  std::atomic<uint64_t> head_{0};
+  // Clear() 时的 head_：序号小于它的记录视为已清除，槽位本身不被改写
+  std::atomic<uint64_t> cleared_{0};
+  Slot slots_[kCapacity];
+
+  void Record(const SpanRecord &record) {
+    uint64_t index = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[index % kCapacity];
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.record = record;
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+  }
+
+  bool Read(const Slot &slot, SpanRecord *record) const {
+    uint64_t before = slot.sequence.load(std::memory_order_acquire);
+    if (before == 0 || (before & 1) != 0 ||
+        before / 2 - 1 < cleared_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *record = slot.record;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == before;
+  }
+};
+
+// =============================================================================
+// Tracer 实现
+// =============================================================================
+
+Tracer &Tracer::Instance() {
+  // 有意不析构：线程退出和进程退出阶段仍可安全记录
+  static Tracer *instance = new Tracer();
+  return *instance;
+}
+
+Tracer::Tracer() : enabled_(true), impl_(new Impl()) {
+  const char *value = std::getenv("KONKA_SDK_TRACE");
+  if (value != nullptr && std::strcmp(value, "0") == 0) {
+    enabled_.store(false, std::memory_order_relaxed);
+  }
+}
+
+void Tracer::Record(const SpanRecord &record) {
+  if (IsEnabled()) {
+    impl_->Record(record);
+  }
+}
+
+std::vector<SpanRecord> Tracer::Collect() const {
+  std::vector<SpanRecord> records;
+  records.reserve(kCapacity);
+  SpanRecord record;
+  for (const Slot &slot : impl_->slots_) {
+    if (impl_->Read(slot, &record)) {
+      records.push_back(record);
+    }
+  }
+  std::sort(records.begin(), records.end(),
+            [](const SpanRecord &a, const SpanRecord &b) {
+              return a.start_ns < b.start_ns;
+            });
+  return records;
+}
+
+void Tracer::Clear() {
+  impl_->cleared_.store(impl_->head_.load(std::memory_order_relaxed),
+                        std::memory_order_release);
+}
+
+std::string Tracer::ExportChromeTrace() const {
+  std::vector<SpanRecord> records = Collect();
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  int pid = static_cast<int>(getpid());
+  char buffer[320];
+  for (size_t i = 0; i < records.size(); ++i) {
+    const SpanRecord &record = records[i];
+    if (i != 0) {
+      out.push_back(',');
+    }
+    out += "\n{\"name\":";
+    AppendJsonString(out, record.name);
+    out += ",\"cat\":";
+    AppendJsonString(out, record.category);
+    std::snprintf(
+        buffer, sizeof(buffer),
+        ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%u,"
+        "\"args\":{\"trace_id\":\"%016" PRIx64 "%016" PRIx64
+        "\",\"span_id\":\"%016" PRIx64 "\",\"parent_id\":\"%016" PRIx64
+        "\",\"command\":%d,\"error\":%s}}",
+        static_cast<double>(record.start_ns) / 1e3,
+        static_cast<double>(record.end_ns - record.start_ns) / 1e3, pid,
+        record.thread_id, record.trace_id_high, record.trace_id_low,
+        record.span_id, record.parent_span_id, record.command,
+        record.error ? "true" : "false");
+    out += buffer;
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+Status Tracer::WriteChromeTrace(const std::string &path) const {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  if (!file) {
+    return Status(std::make_error_code(std::errc::io_error),
+                  "Failed to open trace file: " + path);
+  }
+  file << ExportChromeTrace();
+  if (!file) {
+    return Status(std::make_error_code(std::errc::io_error),
+                  "Failed to write trace file: " + path);
+  }
+  return Status();
+}
+
+TracerStats Tracer::GetStats() const {
+  TracerStats stats;
+  stats.recorded = impl_->head_.load(std::memory_order_relaxed);
+  stats.overwritten =
+      stats.recorded > kCapacity ? stats.recorded - kCapacity : 0;
+  return stats;
+}
+
+TraceContext Tracer::Current() {
+  return current_context != nullptr ? *current_context : TraceContext();
+}
+
+int64_t Tracer::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// =============================================================================
+// TraceSpan 实现
+// =============================================================================
+
+TraceSpan::TraceSpan(const char *name, const char *category,
+                     int32_t command) {
+  Begin(name, category, command, current_context);
+}
+
+TraceSpan::TraceSpan(const char *name, const TraceContext &parent,
+                     const char *category, int32_t command) {
+  Begin(name, category, command, parent.IsValid() ? &parent : nullptr);
+}
+
+void TraceSpan::Begin(const char *name, const char *category,
+                      int32_t command, const TraceContext *parent) {
+  if (!Tracer::Instance().IsEnabled()) {
+    return;
+  }
+  active_ = true;
+  name_ = name;
+  category_ = category;
+  command_ = command;
+  if (parent != nullptr) {
+    context_.trace_id_high = parent->trace_id_high;
+    context_.trace_id_low = parent->trace_id_low;
+    parent_span_id_ = parent->span_id;
+  } else {
+    context_.trace_id_high = NewId();
+    context_.trace_id_low = NewId();
+  }
+  context_.span_id = NewId();
+  start_ns_ = Tracer::NowNs();
+  previous_ = current_context;
+  current_context = &context_;
+}
+
+TraceSpan::~TraceSpan() {
+  if (!active_) {
+    return;
+  }
+  current_context = previous_;
+  SpanRecord record;
+  record.trace_id_high = context_.trace_id_high;
+  record.trace_id_low = context_.trace_id_low;
+  record.span_id = context_.span_id;
+  record.parent_span_id = parent_span_id_;
+  record.name = name_;
+  record.category = category_;
+  record.command = command_;
+  record.thread_id = CurrentThreadId();
+  record.start_ns = start_ns_;
+  record.end_ns = Tracer::NowNs();
+  record.error = error_;
+  Tracer::Instance().Record(record);
+}
+
+void TraceSpan::RecordChild(const char *name, int64_t start_ns,
+                            int64_t end_ns, bool error) const {
+  if (!active_) {
+    return;
+  }
+  SpanRecord record;
+  record.trace_id_high = context_.trace_id_high;
+  record.trace_id_low = context_.trace_id_low;
+  record.span_id = NewId();
+  record.parent_span_id = context_.span_id;
+  record.name = name;
+  record.category = category_;
+  record.command = command_;
+  record.thread_id = CurrentThreadId();
+  record.start_ns = start_ns;
+  record.end_ns = end_ns;
+  record.error = error;
+  Tracer::Instance().Record(record);
+}
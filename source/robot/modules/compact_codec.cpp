@@ -0,0 +1,59 @@
+#include "robot/modules/compact_codec.h"
+
+#include <cstring>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace compact_codec {
+
+namespace {
+inline void PutF64(uint8_t* out, double value) {
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  bits = __builtin_bswap64(bits);
+#endif
+  std::memcpy(out, &bits, sizeof(bits));
+}
+
+inline double GetF64(const uint8_t* in) {
+  uint64_t bits;
+  std::memcpy(&bits, in, sizeof(bits));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  bits = __builtin_bswap64(bits);
+#endif
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+}  // namespace
+
+void CompactTraits<Pose>::Encode(const Pose& pose, uint8_t* out) {
+  const auto& position = pose.position();
+  const auto& orientation = pose.orientation();
+  PutF64(out + 0, position.x());
+  PutF64(out + 8, position.y());
+  PutF64(out + 16, position.z());
+  PutF64(out + 24, orientation.x());
+  PutF64(out + 32, orientation.y());
+  PutF64(out + 40, orientation.z());
+  PutF64(out + 48, orientation.w());
+}
+
+void CompactTraits<Pose>::Decode(const uint8_t* in, Pose* pose) {
+  auto* position = pose->mutable_position();
+  auto* orientation = pose->mutable_orientation();
+  position->set_x(GetF64(in + 0));
+  position->set_y(GetF64(in + 8));
+  position->set_z(GetF64(in + 16));
+  orientation->set_x(GetF64(in + 24));
+  orientation->set_y(GetF64(in + 32));
+  orientation->set_z(GetF64(in + 40));
+  orientation->set_w(GetF64(in + 48));
+}
+
+}  // namespace compact_codec
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
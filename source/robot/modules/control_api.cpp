@@ -1,6 +1,5 @@
 #include "robot/modules/control_api.h"
 
-#include <iostream>
 #include <string>
 #include <stdexcept>
 
@@ -11,6 +10,9 @@
 #include "sdk_service/common/service.pb.h"
 
 #include "robot/common/json_convert_util.hpp"
+#include "robot/common/logger.h"
+#include "robot/common/metrics.h"
+#include "robot/modules/request_envelope.h"
 
 namespace humanoid_robot {
 namespace konka_sdk {
@@ -19,6 +21,10 @@ namespace control_api {
 
 using Variant = humanoid_robot::PB::common::Variant;
 using ControlResStatus = humanoid_robot::PB::sdk_service::control::ResponseStatus;
+using RequestTimer = humanoid_robot::konka_sdk::common::RequestTimer;
+using MetricPhase = humanoid_robot::konka_sdk::common::MetricPhase;
+using MetricErrorCategory = humanoid_robot::konka_sdk::common::MetricErrorCategory;
+using humanoid_robot::konka_sdk::common::kMetricMethodSend;
 
 ControlResStatus EmergencyStop(
     std::unique_ptr<InterfacesClient>& client,
@@ -26,72 +32,63 @@ ControlResStatus EmergencyStop(
     ResponseEmergencyStop& response_emergency_stop) {
     
     ControlResStatus res_status = ControlResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, ControlCommandCode::kEmergencyStop,
+                       "EmergencyStop", "control");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(ControlCommandCode::kEmergencyStop);
-            input_map->insert(std::make_pair(std::string("command_id"), command_id));
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            
-            auto serialize_status = request_emergency_stop.SerializeToString(&serialize_data);
-            
-            if (!serialize_status) {
-                std::cerr << "Failed to serialize request_emergency_stop." << std::endl;
-                return ControlResStatus::ERROR_PARSE_FAILED;
-            }
-            
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_emergency_stop"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            ControlCommandCode::kEmergencyStop, "request_emergency_stop",
+            request_emergency_stop, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("control") << "Failed to serialize request_emergency_stop.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return ControlResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
-        
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Failed to create gRPC stream: " 
-                      << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("control") << "Failed to create gRPC stream: " << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Failed to write EmergencyStop request" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("control") << "Failed to write EmergencyStop request";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] EmergencyStop response received" << std::endl;
-            std::cout << "[✓] Response code: " << send_resp.ret().code() << std::endl;
-            std::cout << "[✓] Response message: " << send_resp.ret().message() << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("control")
+                .Field("code", send_resp.ret().code())
+                .Field("message", send_resp.ret().message())
+                << "EmergencyStop response received";
 
             auto response_status = send_resp.ret();
             try {
                 res_status = static_cast<ControlResStatus>(std::stoi(response_status.code()));
             } catch (const std::invalid_argument& e) {
-                std::cerr << "Invalid response code: " << response_status.code() << std::endl;
+                KONKA_LOG_ERROR("control") << "Invalid response code: " << response_status.code();
+                timer.Fail(MetricErrorCategory::kParse);
                 return ControlResStatus::ERROR_UNKNOWN_SERVICE;
             }
 
             auto response_output = send_resp.output();
             auto data_it = response_output.keyvaluelist().find("data");
             if (data_it == response_output.keyvaluelist().end()) {
-                std::cerr << "'data' field not found in EmergencyStop response" << std::endl;
+                KONKA_LOG_ERROR("control") << "'data' field not found in EmergencyStop response";
+                timer.Fail(MetricErrorCategory::kParse);
                 return res_status;
             }
 
@@ -99,22 +96,27 @@ ControlResStatus EmergencyStop(
             auto unserialize_status =
                 response_emergency_stop.ParseFromString(data_var.bytevalue());
             if (!unserialize_status) {
-                std::cerr << "Failed to unserialize response_emergency_stop" << std::endl;
+                KONKA_LOG_ERROR("control") << "Failed to unserialize response_emergency_stop";
+                timer.Fail(MetricErrorCategory::kParse);
                 return ControlResStatus::ERROR_PARSE_FAILED;
             }
             
         } else {
-            std::cerr << "No EmergencyStop response received from server" << std::endl;
+            KONKA_LOG_ERROR("control") << "No EmergencyStop response received from server";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         auto finish_status = stream->Finish();
-        std::cout << "[✓] EmergencyStop stream finished: " 
-                  << (finish_status.ok() ? "success" : "failed") << std::endl;
+        KONKA_LOG_DEBUG("control") << "EmergencyStop stream finished: "
+            << (finish_status.ok() ? "success" : "failed");
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in EmergencyStop: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("control") << "Exception in EmergencyStop: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
         res_status = ControlResStatus::ERROR_UNKNOWN_SERVICE;
     }
     return res_status;
@@ -126,52 +128,45 @@ ControlResStatus GetJointInfo(
     ResponseGetJointInfo& response_get_joint_info) {
     
     ControlResStatus res_status = ControlResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, ControlCommandCode::kGetJointInfo,
+                       "GetJointInfo", "control");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(ControlCommandCode::kGetJointInfo);
-            input_map->insert({"command_id", command_id});
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            auto serialize_status = request_get_joint_info.SerializeToString(&serialize_data);
-            if (!serialize_status) {
-                std::cerr << "Serialize request_get_joint_info failed." << std::endl;
-                return ControlResStatus::ERROR_PARSE_FAILED;
-            }
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_get_joint_info"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            ControlCommandCode::kGetJointInfo, "request_get_joint_info",
+            request_get_joint_info, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("control") << "Serialize request_get_joint_info failed.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return ControlResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Create stream failed: " << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("control") << "Create stream failed: " << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Write GetJointInfo request failed" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("control") << "Write GetJointInfo request failed";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] GetJointInfo response received" << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("control") << "GetJointInfo response received";
             res_status = static_cast<ControlResStatus>(std::stoi(send_resp.ret().code()));
 
             auto data_it = send_resp.output().keyvaluelist().find("data");
@@ -180,20 +175,25 @@ ControlResStatus GetJointInfo(
                 auto unserialize_status =
                 response_get_joint_info.ParseFromString(data_var.bytevalue());
                 if (!unserialize_status) {
-                    std::cerr << "Failed to unserialize response_get_joint_info" << std::endl;
+                    KONKA_LOG_ERROR("control") << "Failed to unserialize response_get_joint_info";
+                    timer.Fail(MetricErrorCategory::kParse);
                     return ControlResStatus::ERROR_PARSE_FAILED;
                 }
             }
         } else {
-            std::cerr << "No GetJointInfo response received" << std::endl;
+            KONKA_LOG_ERROR("control") << "No GetJointInfo response received";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         stream->Finish();
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in GetJointInfo: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("control") << "Exception in GetJointInfo: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
     }
 
     return res_status;
@@ -205,52 +205,45 @@ ControlResStatus JointMotion(
     ResponseJointMotion& response_joint_motion) {
     
     ControlResStatus res_status = ControlResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, ControlCommandCode::kJointMotion,
+                       "JointMotion", "control");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(ControlCommandCode::kJointMotion);
-            input_map->insert({"command_id", command_id});
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            auto serialize_status = request_joint_motion.SerializeToString(&serialize_data);
-            if (!serialize_status) {
-                std::cerr << "Serialize request_joint_motion failed." << std::endl;
-                return ControlResStatus::ERROR_PARSE_FAILED;
-            }
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_joint_motion"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            ControlCommandCode::kJointMotion, "request_joint_motion",
+            request_joint_motion, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("control") << "Serialize request_joint_motion failed.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return ControlResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Create stream failed: " << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("control") << "Create stream failed: " << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Write JointMotion request failed" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("control") << "Write JointMotion request failed";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] JointMotion response received" << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("control") << "JointMotion response received";
             res_status = static_cast<ControlResStatus>(std::stoi(send_resp.ret().code()));
 
             auto data_it = send_resp.output().keyvaluelist().find("data");
@@ -259,21 +252,26 @@ ControlResStatus JointMotion(
                 auto unserialize_status = 
                 response_joint_motion.ParseFromString(data_var.bytevalue());
                 if (!unserialize_status) {
-                    std::cerr << "Failed to unserialize response_joint_motion" << std::endl;
+                    KONKA_LOG_ERROR("control") << "Failed to unserialize response_joint_motion";
+                    timer.Fail(MetricErrorCategory::kParse);
                     return ControlResStatus::ERROR_PARSE_FAILED;
                 }
                 }
             
         } else {
-            std::cerr << "No JointMotion response received" << std::endl;
+            KONKA_LOG_ERROR("control") << "No JointMotion response received";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         stream->Finish();
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in JointMotion: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("control") << "Exception in JointMotion: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
     }
 
     return res_status;
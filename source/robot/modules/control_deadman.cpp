@@ -0,0 +1,333 @@
+#include "robot/modules/control_deadman.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "grpcpp/support/sync_stream.h"
+#include "robot/common/latency_histogram.h"
+#include "robot/common/logger.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace control_api {
+
+namespace {
+// 请求/回执中使用的key
+constexpr const char* kCommandIdKey = "command_id";
+constexpr const char* kHeartbeatSeqKey = "heartbeat_seq";
+constexpr const char* kClientSendNsKey = "client_send_ns";
+// 在途心跳发送时间记录槽位数（需远大于 rtt阈值 * 心跳频率）
+constexpr size_t kInflightSlots = 1024;
+
+using Variant = humanoid_robot::PB::common::Variant;
+using LatencyHistogram = humanoid_robot::konka_sdk::common::LatencyHistogram;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+constexpr int64_t MsToNs(int64_t ms) { return ms * 1000 * 1000; }
+}  // namespace
+
+class DeadmanSession::Impl {
+public:
+  Impl(std::unique_ptr<InterfacesClient>& client, DeadmanOptions options)
+      : client_(client), options_(options) {
+    for (size_t i = 0; i < kInflightSlots; ++i) {
+      send_seq_[i].store(UINT64_MAX, std::memory_order_relaxed);
+      send_ns_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  ~Impl() { Stop(); }
+
+  Status Start() {
+    if (running_) {
+      return Status(std::make_error_code(std::errc::operation_not_permitted),
+                    "Deadman session is already running");
+    }
+    if (!client_ || options_.heartbeat_hz <= 0.0) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Invalid deadman client or heartbeat rate");
+    }
+
+    auto send_status =
+        client_->Send(stream_, context_, options_.stream_timeout_ms);
+    if (!send_status) {
+      return send_status.Chain("Failed to open deadman heartbeat stream");
+    }
+
+    echo_ = client_->HasCapability(kDeadmanHeartbeatCapability);
+    if (!echo_) {
+      KONKA_LOG_INFO("control")
+          << "Gateway does not echo deadman heartbeats, using write liveness";
+    }
+
+    int64_t now = NowNs();
+    last_feed_ns_ = now;
+    last_ack_ns_ = now;
+    rtt_exceeded_ns_ = 0;
+    stream_broken_ = false;
+    tripped_ = false;
+    sent_ = 0;
+    acked_ = 0;
+    rtt_ns_.Reset();
+    {
+      std::lock_guard<std::mutex> lock(trip_mutex_);
+      trip_stats_ = DeadmanStats();
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread([this]() { WriterLoop(); });
+    reader_thread_ = std::thread([this]() { ReaderLoop(); });
+    monitor_thread_ = std::thread([this]() { MonitorLoop(); });
+    return Status();
+  }
+
+  void Stop() {
+    bool was_running = running_.exchange(false);
+    if (context_) {
+      context_->TryCancel();
+    }
+    if (writer_thread_.joinable()) {
+      writer_thread_.join();
+    }
+    if (reader_thread_.joinable()) {
+      reader_thread_.join();
+    }
+    if (monitor_thread_.joinable()) {
+      monitor_thread_.join();
+    }
+    if (was_running && stream_) {
+      stream_->Finish();
+    }
+    stream_.reset();
+    context_.reset();
+  }
+
+  void Feed() { last_feed_ns_.store(NowNs(), std::memory_order_relaxed); }
+
+  DeadmanStats GetStats() {
+    DeadmanStats stats;
+    {
+      std::lock_guard<std::mutex> lock(trip_mutex_);
+      stats = trip_stats_;
+    }
+    FillCounters(stats);
+    return stats;
+  }
+
+  std::unique_ptr<InterfacesClient>& client_;
+  DeadmanOptions options_;
+  DeadmanTripCallback trip_callback_;
+
+  std::atomic<bool> running_{false};
+  std::atomic<bool> tripped_{false};
+
+private:
+  int64_t PeriodNs() const {
+    return static_cast<int64_t>(1e9 / options_.heartbeat_hz);
+  }
+
+  void FillCounters(DeadmanStats& stats) const {
+    stats.heartbeats_sent = sent_.load(std::memory_order_relaxed);
+    stats.heartbeats_acked = acked_.load(std::memory_order_relaxed);
+    stats.rtt_p50_us = rtt_ns_.Percentile(0.50) / 1000;
+    stats.rtt_p99_us = rtt_ns_.Percentile(0.99) / 1000;
+    stats.rtt_max_us = rtt_ns_.Max() / 1000;
+    stats.heartbeat_echo = echo_;
+  }
+
+  void WriterLoop() {
+    const int64_t period = PeriodNs();
+    int64_t next = NowNs();
+    uint64_t seq = 0;
+
+    while (running_ && !tripped_) {
+      int64_t now = NowNs();
+      SendRequest heartbeat;
+      auto input_map = heartbeat.mutable_input()->mutable_keyvaluelist();
+      (*input_map)[kCommandIdKey].set_int32value(kDeadmanHeartbeatCommandId);
+      (*input_map)[kHeartbeatSeqKey].set_int64value(static_cast<int64_t>(seq));
+      (*input_map)[kClientSendNsKey].set_int64value(now);
+
+      size_t slot = seq % kInflightSlots;
+      send_ns_[slot].store(now, std::memory_order_relaxed);
+      send_seq_[slot].store(seq, std::memory_order_release);
+
+      if (!stream_->Write(heartbeat)) {
+        stream_broken_ = true;
+        break;
+      }
+      sent_.fetch_add(1, std::memory_order_relaxed);
+      if (!echo_) {
+        // 网关不回显时以写入成功作为存活信号
+        last_ack_ns_.store(NowNs(), std::memory_order_relaxed);
+      }
+      ++seq;
+
+      // 落后超过一个周期时不追发，直接对齐到当前时刻
+      next += period;
+      now = NowNs();
+      if (next < now) {
+        next = now;
+      }
+      std::this_thread::sleep_for(std::chrono::nanoseconds(next - now));
+    }
+  }
+
+  void ReaderLoop() {
+    SendResponse ack;
+    while (stream_->Read(&ack)) {
+      if (!echo_) {
+        continue; // 只排空响应，存活由写入判定
+      }
+      int64_t now = NowNs();
+      last_ack_ns_.store(now, std::memory_order_relaxed);
+      acked_.fetch_add(1, std::memory_order_relaxed);
+
+      const auto& output = ack.output().keyvaluelist();
+      auto seq_it = output.find(kHeartbeatSeqKey);
+      if (seq_it == output.end()) {
+        continue;
+      }
+      uint64_t seq = static_cast<uint64_t>(seq_it->second.int64value());
+      size_t slot = seq % kInflightSlots;
+      if (send_seq_[slot].load(std::memory_order_acquire) != seq) {
+        continue;  // 回执过旧，槽位已被覆盖
+      }
+      int64_t rtt = now - send_ns_[slot].load(std::memory_order_relaxed);
+      if (rtt < 0) {
+        continue;
+      }
+      rtt_ns_.Record(static_cast<uint64_t>(rtt));
+      if (rtt > MsToNs(options_.max_rtt_ms)) {
+        int64_t expected = 0;
+        rtt_exceeded_ns_.compare_exchange_strong(expected, now);
+      }
+    }
+    if (running_) {
+      stream_broken_ = true;
+    }
+  }
+
+  void MonitorLoop() {
+    // 检测周期取心跳周期与1ms中的较小值，保证检测延迟有界
+    const int64_t period = std::min<int64_t>(PeriodNs(), MsToNs(1));
+    while (running_ && !tripped_) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(period));
+      int64_t now = NowNs();
+      int64_t last_feed = last_feed_ns_.load(std::memory_order_relaxed);
+      int64_t last_ack = last_ack_ns_.load(std::memory_order_relaxed);
+      int64_t rtt_exceeded = rtt_exceeded_ns_.load(std::memory_order_relaxed);
+
+      if (options_.app_stall_timeout_ms > 0 &&
+          now - last_feed > MsToNs(options_.app_stall_timeout_ms)) {
+        Trip(DeadmanTripReason::kAppStalled, now, last_feed);
+      } else if (rtt_exceeded != 0) {
+        Trip(DeadmanTripReason::kRttExceeded, now, rtt_exceeded);
+      } else if (now - last_ack > MsToNs(options_.max_gap_ms)) {
+        Trip(DeadmanTripReason::kHeartbeatGap, now, last_ack);
+      } else if (stream_broken_ && running_) {
+        Trip(DeadmanTripReason::kStreamBroken, now, now);
+      }
+    }
+  }
+
+  void Trip(DeadmanTripReason reason, int64_t detect_ns, int64_t signal_ns) {
+    if (tripped_.exchange(true)) {
+      return;
+    }
+
+    DeadmanStats stats;
+    stats.trip_reason = reason;
+    stats.detection_latency_us = (detect_ns - signal_ns) / 1000;
+
+    KONKA_LOG_WARN("control") << "Tripped, reason: " << static_cast<int>(reason)
+                              << ", detection latency(us): "
+                              << stats.detection_latency_us;
+
+    if (options_.trigger_emergency_stop) {
+      RequestEmergencyStop request;
+      ResponseEmergencyStop response;
+      stats.stop_status = EmergencyStop(client_, request, response);
+      stats.stop_request_latency_us = (NowNs() - detect_ns) / 1000;
+    }
+
+    FillCounters(stats);
+    {
+      std::lock_guard<std::mutex> lock(trip_mutex_);
+      trip_stats_ = stats;
+    }
+
+    if (trip_callback_) {
+      try {
+        trip_callback_(reason, stats);
+      } catch (const std::exception& e) {
+        KONKA_LOG_ERROR("control") << "Error in deadman trip callback: "
+                                   << e.what();
+      }
+    }
+  }
+
+  std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>>
+      stream_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  std::thread writer_thread_;
+  std::thread reader_thread_;
+  std::thread monitor_thread_;
+
+  std::atomic<int64_t> last_feed_ns_{0};
+  std::atomic<int64_t> last_ack_ns_{0};
+  std::atomic<int64_t> rtt_exceeded_ns_{0};
+  std::atomic<bool> stream_broken_{false};
+  bool echo_ = false; // Start() 中确定，线程启动后只读
+  std::atomic<uint64_t> sent_{0};
+  std::atomic<uint64_t> acked_{0};
+  std::array<std::atomic<uint64_t>, kInflightSlots> send_seq_;
+  std::array<std::atomic<int64_t>, kInflightSlots> send_ns_;
+  LatencyHistogram rtt_ns_;
+
+  std::mutex trip_mutex_;
+  DeadmanStats trip_stats_;
+};
+
+DeadmanSession::DeadmanSession(std::unique_ptr<InterfacesClient>& client,
+                               DeadmanOptions options)
+    : pImpl_(std::make_unique<Impl>(client, options)) {}
+
+DeadmanSession::~DeadmanSession() = default;
+
+Status DeadmanSession::Start() { return pImpl_->Start(); }
+
+void DeadmanSession::Stop() { pImpl_->Stop(); }
+
+void DeadmanSession::Feed() { pImpl_->Feed(); }
+
+bool DeadmanSession::IsRunning() const { return pImpl_->running_; }
+
+bool DeadmanSession::IsTripped() const { return pImpl_->tripped_; }
+
+void DeadmanSession::SetTripCallback(DeadmanTripCallback callback) {
+  if (pImpl_->running_) {
+    throw std::runtime_error(
+        "Cannot set trip callback while deadman session is running.");
+  }
+  pImpl_->trip_callback_ = std::move(callback);
+}
+
+DeadmanStats DeadmanSession::GetStats() const { return pImpl_->GetStats(); }
+
+}  // namespace control_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
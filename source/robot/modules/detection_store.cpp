@@ -0,0 +1,570 @@
+#include "robot/modules/detection_store.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+// 单个二维框最多占用的网格数，超过的框放入单独列表线性检查
+constexpr int64_t kMaxCellsPerBox = 64;
+// 网格坐标夹紧范围，保证网格范围的差值与计数不溢出 int32
+constexpr double kMaxCellIndex = 1 << 29;
+
+struct PointEntry {
+  float x;
+  float y;
+  float z;
+  uint32_t index;
+};
+
+struct BoxEntry {
+  Box2D box;
+  uint32_t camera;
+  uint32_t index;
+  int32_t cx;  // 本条目所在的网格，用于区分同一框哈希到同一桶的多个网格
+  int32_t cy;
+};
+
+struct CellRange {
+  int32_t x0, y0, x1, y1;
+};
+
+// 超大坐标夹紧到 ±kMaxCellIndex，NaN 归到 0 号网格（调用方应先过滤）
+inline int32_t CellOf(double value, double inv_cell) {
+  double cell = std::floor(value * inv_cell);
+  if (std::isnan(cell)) {
+    return 0;
+  }
+  return static_cast<int32_t>(std::clamp(cell, -kMaxCellIndex, kMaxCellIndex));
+}
+
+inline bool HasNaN(const Box2D& box) {
+  return std::isnan(box.x_min) || std::isnan(box.y_min) ||
+         std::isnan(box.x_max) || std::isnan(box.y_max);
+}
+
+// 不参与空间索引的框：空框或含 NaN 的框（NaN 与任何框都不相交）
+inline bool Unindexable(const Box2D& box) { return box.Empty() || HasNaN(box); }
+
+inline uint32_t HashCell(int32_t x, int32_t y, int32_t z) {
+  return (static_cast<uint32_t>(x) * 73856093u) ^
+         (static_cast<uint32_t>(y) * 19349663u) ^
+         (static_cast<uint32_t>(z) * 83492791u);
+}
+
+size_t BucketCount(size_t entries) {
+  size_t count = 16;
+  while (count < entries * 2) {
+    count <<= 1;
+  }
+  return count;
+}
+
+float BoxIoU(const Box2D& a, const Box2D& b) {
+  float ix = std::min(a.x_max, b.x_max) - std::max(a.x_min, b.x_min);
+  float iy = std::min(a.y_max, b.y_max) - std::max(a.y_min, b.y_min);
+  if (ix <= 0.0f || iy <= 0.0f) {
+    return 0.0f;
+  }
+  float inter = ix * iy;
+  return inter / (a.Area() + b.Area() - inter);
+}
+
+inline bool BoxesOverlap(const Box2D& a, const Box2D& b) {
+  return a.x_min < b.x_max && b.x_min < a.x_max && a.y_min < b.y_max &&
+         b.y_min < a.y_max;
+}
+}  // namespace
+
+class DetectionStore::Impl {
+public:
+  explicit Impl(DetectionStoreOptions options)
+      : options_(options),
+        inv_cell_m_(1.0 / (options.cell_size_m > 0.0 ? options.cell_size_m : 1.0)),
+        inv_cell_px_(1.0 / (options.cell_size_px > 0.0f ? options.cell_size_px : 64.0f)) {
+    Rebuild();
+  }
+
+  void InsertFrame(const std::vector<TrackedDetection>& detections,
+                   int64_t now_ns) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (options_.replace_by_track_id) {
+      std::unordered_map<uint64_t, size_t> by_track;
+      by_track.reserve(objects_.size() + detections.size());
+      for (size_t i = 0; i < objects_.size(); ++i) {
+        if (objects_[i].track_id != 0) {
+          by_track[objects_[i].track_id] = i;
+        }
+      }
+      for (const auto& detection : detections) {
+        if (detection.track_id != 0) {
+          auto it = by_track.find(detection.track_id);
+          if (it != by_track.end()) {
+            if (objects_[it->second].timestamp_ns <= detection.timestamp_ns) {
+              objects_[it->second] = detection;
+            }
+            continue;
+          }
+          by_track[detection.track_id] = objects_.size();
+        }
+        objects_.push_back(detection);
+      }
+    } else {
+      objects_.insert(objects_.end(), detections.begin(), detections.end());
+    }
+    ExpireLocked(now_ns);
+    Rebuild();
+  }
+
+  void Expire(int64_t now_ns) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (ExpireLocked(now_ns)) {
+      Rebuild();
+    }
+  }
+
+  void Clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    objects_.clear();
+    Rebuild();
+  }
+
+  size_t Size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return objects_.size();
+  }
+
+  size_t QueryRadius(const Vec3& center, double radius,
+                     std::vector<TrackedDetection>& out) const {
+    out.clear();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (radius < 0.0) {
+      return 0;
+    }
+    const float r2 = static_cast<float>(radius * radius);
+    const float cx = static_cast<float>(center.x);
+    const float cy = static_cast<float>(center.y);
+    const float cz = static_cast<float>(center.z);
+    auto accept = [&](const PointEntry& entry) {
+      float dx = entry.x - cx;
+      float dy = entry.y - cy;
+      float dz = entry.z - cz;
+      if (dx * dx + dy * dy + dz * dz <= r2) {
+        out.push_back(objects_[entry.index]);
+      }
+    };
+    Vec3 lo{center.x - radius, center.y - radius, center.z - radius};
+    Vec3 hi{center.x + radius, center.y + radius, center.z + radius};
+    VisitPointRange(lo, hi, accept);
+    return out.size();
+  }
+
+  size_t QueryRegion(const Vec3& min_corner, const Vec3& max_corner,
+                     std::vector<TrackedDetection>& out) const {
+    out.clear();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto accept = [&](const PointEntry& entry) {
+      if (entry.x >= min_corner.x && entry.x <= max_corner.x &&
+          entry.y >= min_corner.y && entry.y <= max_corner.y &&
+          entry.z >= min_corner.z && entry.z <= max_corner.z) {
+        out.push_back(objects_[entry.index]);
+      }
+    };
+    VisitPointRange(min_corner, max_corner, accept);
+    return out.size();
+  }
+
+  size_t QueryNearest(const Vec3& point, size_t k,
+                      std::vector<TrackedDetection>& out) const {
+    out.clear();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (k == 0 || points_.empty()) {
+      return 0;
+    }
+
+    const float px = static_cast<float>(point.x);
+    const float py = static_cast<float>(point.y);
+    const float pz = static_cast<float>(point.z);
+    // 大顶堆保存当前最近的 k 个 (距离平方, 下标)
+    std::priority_queue<std::pair<float, uint32_t>> heap;
+    auto consider = [&](const PointEntry& entry) {
+      float dx = entry.x - px;
+      float dy = entry.y - py;
+      float dz = entry.z - pz;
+      float d2 = dx * dx + dy * dy + dz * dz;
+      if (heap.size() < k) {
+        heap.emplace(d2, entry.index);
+      } else if (d2 < heap.top().first) {
+        heap.pop();
+        heap.emplace(d2, entry.index);
+      }
+    };
+
+    if (k >= points_.size()) {
+      for (const auto& entry : points_) {
+        consider(entry);
+      }
+    } else {
+      SearchRings(point, k, heap, consider);
+    }
+
+    out.resize(heap.size());
+    for (size_t i = heap.size(); i > 0; --i) {
+      out[i - 1] = objects_[heap.top().second];
+      heap.pop();
+    }
+    return out.size();
+  }
+
+  size_t QueryBoxOverlap(const Box2D& box, std::vector<TrackedDetection>& out,
+                         float min_iou, int64_t camera) const {
+    out.clear();
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (Unindexable(box)) {
+      return 0;
+    }
+    auto accept = [&](const BoxEntry& entry) {
+      if (camera >= 0 && entry.camera != static_cast<uint32_t>(camera)) {
+        return;
+      }
+      if (!BoxesOverlap(entry.box, box)) {
+        return;
+      }
+      if (min_iou > 0.0f && BoxIoU(entry.box, box) < min_iou) {
+        return;
+      }
+      out.push_back(objects_[entry.index]);
+    };
+
+    for (const auto& entry : oversized_) {
+      accept(entry);
+    }
+
+    CellRange query = BoxCells(box);
+    int64_t cells = static_cast<int64_t>(query.x1 - query.x0 + 1) *
+                    (query.y1 - query.y0 + 1);
+    if (cells > static_cast<int64_t>(box_entries_.size())) {
+      // 查询范围大于条目数时直接线性扫描（每个目标只检查一次）
+      for (size_t i = 0; i < objects_.size(); ++i) {
+        const auto& object = objects_[i];
+        if (Unindexable(object.box) || IsOversized(BoxCells(object.box))) {
+          continue;
+        }
+        accept(BoxEntry{object.box, object.camera, static_cast<uint32_t>(i), 0, 0});
+      }
+      return out.size();
+    }
+
+    for (int32_t cy = query.y0; cy <= query.y1; ++cy) {
+      for (int32_t cx = query.x0; cx <= query.x1; ++cx) {
+        uint32_t bucket = HashCell(cx, cy, 0) & box_mask_;
+        for (uint32_t i = box_start_[bucket]; i < box_start_[bucket + 1]; ++i) {
+          const BoxEntry& entry = box_entries_[i];
+          // 排除哈希冲突（包括同一框的其它网格落在同一桶），
+          // 并且只在目标与查询范围交集的首个网格上报告一次
+          if (entry.cx != cx || entry.cy != cy) {
+            continue;
+          }
+          CellRange range = BoxCells(entry.box);
+          if (cx != std::max(range.x0, query.x0) ||
+              cy != std::max(range.y0, query.y0)) {
+            continue;
+          }
+          accept(entry);
+        }
+      }
+    }
+    return out.size();
+  }
+
+private:
+  bool ExpireLocked(int64_t now_ns) {
+    const int64_t cutoff = now_ns - options_.max_age_ms * 1000000LL;
+    size_t before = objects_.size();
+    objects_.erase(std::remove_if(objects_.begin(), objects_.end(),
+                                  [cutoff](const TrackedDetection& detection) {
+                                    return detection.timestamp_ns < cutoff;
+                                  }),
+                   objects_.end());
+    return objects_.size() != before;
+  }
+
+  CellRange BoxCells(const Box2D& box) const {
+    return CellRange{CellOf(box.x_min, inv_cell_px_), CellOf(box.y_min, inv_cell_px_),
+                     CellOf(box.x_max, inv_cell_px_), CellOf(box.y_max, inv_cell_px_)};
+  }
+
+  static bool IsOversized(const CellRange& range) {
+    return static_cast<int64_t>(range.x1 - range.x0 + 1) * (range.y1 - range.y0 + 1) >
+           kMaxCellsPerBox;
+  }
+
+  void PointCell(const PointEntry& entry, int32_t cell[3]) const {
+    cell[0] = CellOf(entry.x, inv_cell_m_);
+    cell[1] = CellOf(entry.y, inv_cell_m_);
+    cell[2] = CellOf(entry.z, inv_cell_m_);
+  }
+
+  // 以计数排序构建 CSR：start[b]..start[b+1] 为桶 b 的条目
+  void Rebuild() {
+    // 三维网格
+    std::vector<PointEntry> points;
+    std::vector<uint32_t> point_buckets;
+    for (size_t i = 0; i < objects_.size(); ++i) {
+      const auto& object = objects_[i];
+      // 非有限坐标无法参与距离比较，不进入三维网格
+      const auto& position = object.position;
+      if (!object.has_position ||
+          !std::isfinite(static_cast<float>(position.x)) ||
+          !std::isfinite(static_cast<float>(position.y)) ||
+          !std::isfinite(static_cast<float>(position.z))) {
+        continue;
+      }
+      points.push_back(PointEntry{static_cast<float>(object.position.x),
+                                  static_cast<float>(object.position.y),
+                                  static_cast<float>(object.position.z),
+                                  static_cast<uint32_t>(i)});
+    }
+    size_t point_buckets_count = BucketCount(points.size());
+    point_mask_ = static_cast<uint32_t>(point_buckets_count - 1);
+    point_start_.assign(point_buckets_count + 1, 0);
+    point_buckets.resize(points.size());
+    has_bounds_ = false;
+    for (size_t i = 0; i < points.size(); ++i) {
+      int32_t cell[3];
+      PointCell(points[i], cell);
+      for (int axis = 0; axis < 3; ++axis) {
+        if (!has_bounds_) {
+          cell_min_[axis] = cell_max_[axis] = cell[axis];
+        } else {
+          cell_min_[axis] = std::min(cell_min_[axis], cell[axis]);
+          cell_max_[axis] = std::max(cell_max_[axis], cell[axis]);
+        }
+      }
+      has_bounds_ = true;
+      point_buckets[i] = HashCell(cell[0], cell[1], cell[2]) & point_mask_;
+      ++point_start_[point_buckets[i] + 1];
+    }
+    for (size_t b = 0; b < point_buckets_count; ++b) {
+      point_start_[b + 1] += point_start_[b];
+    }
+    points_.resize(points.size());
+    {
+      std::vector<uint32_t> cursor(point_start_.begin(), point_start_.end() - 1);
+      for (size_t i = 0; i < points.size(); ++i) {
+        points_[cursor[point_buckets[i]]++] = points[i];
+      }
+    }
+
+    // 二维网格：框覆盖的每个网格各放一份
+    oversized_.clear();
+    std::vector<std::pair<uint32_t, BoxEntry>> cells;
+    for (size_t i = 0; i < objects_.size(); ++i) {
+      const auto& object = objects_[i];
+      if (Unindexable(object.box)) {
+        continue;
+      }
+      BoxEntry entry{object.box, object.camera, static_cast<uint32_t>(i), 0, 0};
+      CellRange range = BoxCells(object.box);
+      if (IsOversized(range)) {
+        oversized_.push_back(entry);
+        continue;
+      }
+      for (int32_t cy = range.y0; cy <= range.y1; ++cy) {
+        for (int32_t cx = range.x0; cx <= range.x1; ++cx) {
+          entry.cx = cx;
+          entry.cy = cy;
+          cells.emplace_back(HashCell(cx, cy, 0), entry);
+        }
+      }
+    }
+    size_t box_buckets_count = BucketCount(cells.size());
+    box_mask_ = static_cast<uint32_t>(box_buckets_count - 1);
+    box_start_.assign(box_buckets_count + 1, 0);
+    for (auto& cell : cells) {
+      cell.first &= box_mask_;
+      ++box_start_[cell.first + 1];
+    }
+    for (size_t b = 0; b < box_buckets_count; ++b) {
+      box_start_[b + 1] += box_start_[b];
+    }
+    box_entries_.resize(cells.size());
+    {
+      std::vector<uint32_t> cursor(box_start_.begin(), box_start_.end() - 1);
+      for (const auto& cell : cells) {
+        box_entries_[cursor[cell.first]++] = cell.second;
+      }
+    }
+  }
+
+  // 访问单个三维网格中的条目（过滤哈希冲突）
+  template <typename Fn>
+  void VisitPointCell(int32_t cx, int32_t cy, int32_t cz, Fn& fn) const {
+    uint32_t bucket = HashCell(cx, cy, cz) & point_mask_;
+    for (uint32_t i = point_start_[bucket]; i < point_start_[bucket + 1]; ++i) {
+      const PointEntry& entry = points_[i];
+      int32_t cell[3];
+      PointCell(entry, cell);
+      if (cell[0] == cx && cell[1] == cy && cell[2] == cz) {
+        fn(entry);
+      }
+    }
+  }
+
+  template <typename Fn>
+  void VisitPointRange(const Vec3& lo, const Vec3& hi, Fn& fn) const {
+    if (!has_bounds_ || lo.x > hi.x || lo.y > hi.y || lo.z > hi.z) {
+      return;
+    }
+    // 裁剪到数据所在的网格范围
+    int32_t x0 = std::max(CellOf(lo.x, inv_cell_m_), cell_min_[0]);
+    int32_t y0 = std::max(CellOf(lo.y, inv_cell_m_), cell_min_[1]);
+    int32_t z0 = std::max(CellOf(lo.z, inv_cell_m_), cell_min_[2]);
+    int32_t x1 = std::min(CellOf(hi.x, inv_cell_m_), cell_max_[0]);
+    int32_t y1 = std::min(CellOf(hi.y, inv_cell_m_), cell_max_[1]);
+    int32_t z1 = std::min(CellOf(hi.z, inv_cell_m_), cell_max_[2]);
+    if (x0 > x1 || y0 > y1 || z0 > z1) {
+      return;
+    }
+    int64_t cells = static_cast<int64_t>(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+    if (cells > static_cast<int64_t>(points_.size())) {
+      for (const auto& entry : points_) {
+        fn(entry);
+      }
+      return;
+    }
+    for (int32_t cz = z0; cz <= z1; ++cz) {
+      for (int32_t cy = y0; cy <= y1; ++cy) {
+        for (int32_t cx = x0; cx <= x1; ++cx) {
+          VisitPointCell(cx, cy, cz, fn);
+        }
+      }
+    }
+  }
+
+  // 从查询点所在网格逐圈向外搜索，直到第 k 近的距离不超过已搜索半径
+  template <typename Heap, typename Fn>
+  void SearchRings(const Vec3& point, size_t k, Heap& heap, Fn& consider) const {
+    const int32_t center[3] = {CellOf(point.x, inv_cell_m_),
+                               CellOf(point.y, inv_cell_m_),
+                               CellOf(point.z, inv_cell_m_)};
+    int32_t max_ring = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+      max_ring = std::max(max_ring, std::abs(center[axis] - cell_min_[axis]));
+      max_ring = std::max(max_ring, std::abs(center[axis] - cell_max_[axis]));
+    }
+
+    const float cell_size = static_cast<float>(1.0 / inv_cell_m_);
+    int64_t visited = 0;
+    for (int32_t ring = 0; ring <= max_ring; ++ring) {
+      for (int32_t dz = -ring; dz <= ring; ++dz) {
+        int32_t cz = center[2] + dz;
+        if (cz < cell_min_[2] || cz > cell_max_[2]) {
+          continue;
+        }
+        for (int32_t dy = -ring; dy <= ring; ++dy) {
+          int32_t cy = center[1] + dy;
+          if (cy < cell_min_[1] || cy > cell_max_[1]) {
+            continue;
+          }
+          bool on_shell = std::abs(dz) == ring || std::abs(dy) == ring;
+          int32_t step = on_shell ? 1 : std::max(1, 2 * ring);
+          for (int32_t dx = -ring; dx <= ring; dx += step) {
+            int32_t cx = center[0] + dx;
+            if (cx < cell_min_[0] || cx > cell_max_[0]) {
+              continue;
+            }
+            VisitPointCell(cx, cy, cz, consider);
+            ++visited;
+          }
+        }
+      }
+      if (heap.size() == k) {
+        float reach = ring * cell_size;
+        if (heap.top().first <= reach * reach) {
+          return;
+        }
+      }
+      if (visited > static_cast<int64_t>(points_.size()) * 4) {
+        // 数据稀疏时环形搜索不划算，剩余部分退化为线性扫描
+        while (!heap.empty()) {
+          heap.pop();
+        }
+        for (const auto& entry : points_) {
+          consider(entry);
+        }
+        return;
+      }
+    }
+  }
+
+  DetectionStoreOptions options_;
+  const double inv_cell_m_;
+  const double inv_cell_px_;
+
+  mutable std::shared_mutex mutex_;
+  std::vector<TrackedDetection> objects_;
+
+  uint32_t point_mask_ = 0;
+  std::vector<uint32_t> point_start_;
+  std::vector<PointEntry> points_;
+  bool has_bounds_ = false;
+  int32_t cell_min_[3] = {0, 0, 0};
+  int32_t cell_max_[3] = {0, 0, 0};
+
+  uint32_t box_mask_ = 0;
+  std::vector<uint32_t> box_start_;
+  std::vector<BoxEntry> box_entries_;
+  std::vector<BoxEntry> oversized_;
+};
+
+DetectionStore::DetectionStore(DetectionStoreOptions options)
+    : pImpl_(std::make_unique<Impl>(options)) {}
+
+DetectionStore::~DetectionStore() = default;
+
+void DetectionStore::InsertFrame(const std::vector<TrackedDetection>& detections,
+                                 int64_t now_ns) {
+  pImpl_->InsertFrame(detections, now_ns);
+}
+
+void DetectionStore::Expire(int64_t now_ns) { pImpl_->Expire(now_ns); }
+
+void DetectionStore::Clear() { pImpl_->Clear(); }
+
+size_t DetectionStore::Size() const { return pImpl_->Size(); }
+
+size_t DetectionStore::QueryRadius(const Vec3& center, double radius,
+                                   std::vector<TrackedDetection>& out) const {
+  return pImpl_->QueryRadius(center, radius, out);
+}
+
+size_t DetectionStore::QueryRegion(const Vec3& min_corner, const Vec3& max_corner,
+                                   std::vector<TrackedDetection>& out) const {
+  return pImpl_->QueryRegion(min_corner, max_corner, out);
+}
+
+size_t DetectionStore::QueryNearest(const Vec3& point, size_t k,
+                                    std::vector<TrackedDetection>& out) const {
+  return pImpl_->QueryNearest(point, k, out);
+}
+
+size_t DetectionStore::QueryBoxOverlap(const Box2D& box,
+                                       std::vector<TrackedDetection>& out,
+                                       float min_iou, int64_t camera) const {
+  return pImpl_->QueryBoxOverlap(box, out, min_iou, camera);
+}
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,267 @@
+#include "robot/modules/detection_stream.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "grpcpp/support/sync_stream.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+constexpr const char* kCommandIdKey = "command_id";
+constexpr const char* kDataKey = "data";
+constexpr const char* kRequestDetectionKey = "request_detection";
+constexpr const char* kEventTypeKey = "event_type";
+
+using Variant = humanoid_robot::PB::common::Variant;
+using ActionRequest = humanoid_robot::PB::interfaces::ActionRequest;
+using ActionResponse = humanoid_robot::PB::interfaces::ActionResponse;
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+class DetectionStream::Impl {
+public:
+  explicit Impl(size_t capacity) : ring_(capacity) {}
+
+  DetectionRing ring_;
+  std::atomic<uint64_t> next_sequence_{0};
+  std::atomic<uint64_t> parse_failures_{0};
+
+  // 仅用于唤醒阻塞读取的消费者，发布路径只在有等待者时加锁
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+  std::atomic<int> waiters_{0};
+
+  // 消费者登记（仅用于统计）
+  mutable std::mutex consumers_mutex_;
+  std::set<const DetectionConsumer*> consumers_;
+
+  // Action 数据源
+  std::unique_ptr<grpc::ClientContext> action_context_;
+  std::unique_ptr<::grpc::ClientReader<ActionResponse>> action_reader_;
+  std::thread action_thread_;
+  std::atomic<bool> action_running_{false};
+
+  uint64_t Publish(ResponseDetection&& detection) {
+    auto frame = std::make_shared<DetectionFrame>();
+    frame->sequence = next_sequence_.fetch_add(1, std::memory_order_relaxed);
+    frame->receive_ns = NowNs();
+    frame->detection = std::move(detection);
+    uint64_t seq = ring_.Publish(std::move(frame));
+
+    // 与 Next() 中 waiters_ 的递增构成 Dekker 式握手：发布对等待者可见，
+    // 或者这里能看到等待者，两者至少成立其一，唤醒不会丢失
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_seq_cst) > 0) {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      wait_cv_.notify_all();
+    }
+    return seq;
+  }
+
+  bool PublishSerialized(const std::string& data) {
+    ResponseDetection detection;
+    if (!detection.ParseFromString(data)) {
+      parse_failures_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    Publish(std::move(detection));
+    return true;
+  }
+
+  void ActionLoop() {
+    ActionResponse response;
+    while (action_reader_->Read(&response)) {
+      const auto& output = response.output().keyvaluelist();
+      auto data_it = output.find(kDataKey);
+      if (data_it == output.end()) {
+        continue;
+      }
+      PublishSerialized(data_it->second.bytevalue());
+    }
+  }
+
+  void StopAction() {
+    bool was_running = action_running_.exchange(false);
+    if (action_context_) {
+      action_context_->TryCancel();
+    }
+    if (action_thread_.joinable()) {
+      action_thread_.join();
+    }
+    if (was_running && action_reader_) {
+      action_reader_->Finish();
+    }
+    action_reader_.reset();
+    action_context_.reset();
+  }
+};
+
+// =============================================================================
+// DetectionStream
+// =============================================================================
+
+std::shared_ptr<DetectionStream> DetectionStream::Create(size_t capacity) {
+  return std::shared_ptr<DetectionStream>(new DetectionStream(capacity));
+}
+
+DetectionStream::DetectionStream(size_t capacity)
+    : pImpl_(std::make_unique<Impl>(capacity)) {}
+
+DetectionStream::~DetectionStream() { Stop(); }
+
+Status DetectionStream::StartFromAction(
+    std::unique_ptr<InterfacesClient>& client,
+    const RequestDetection& request_detection) {
+  if (pImpl_->action_running_) {
+    return Status(std::make_error_code(std::errc::operation_not_permitted),
+                  "Detection stream is already running");
+  }
+
+  ActionRequest action_req;
+  auto input_map = action_req.mutable_input()->mutable_keyvaluelist();
+  (*input_map)[kCommandIdKey].set_int32value(PerceptionCommandCode::kDetection);
+  std::string serialize_data;
+  if (!request_detection.SerializeToString(&serialize_data)) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Failed to serialize request_detection");
+  }
+  auto request_dict_map =
+      (*input_map)[kDataKey].mutable_dictvalue()->mutable_keyvaluelist();
+  (*request_dict_map)[kRequestDetectionKey].set_bytevalue(
+      std::move(serialize_data));
+
+  pImpl_->action_context_ = std::make_unique<grpc::ClientContext>();
+  auto status =
+      client->Action(action_req, pImpl_->action_reader_, *pImpl_->action_context_);
+  if (!status) {
+    pImpl_->action_context_.reset();
+    return status.Chain("Failed to start detection action stream");
+  }
+
+  pImpl_->action_running_ = true;
+  pImpl_->action_thread_ = std::thread([this]() { pImpl_->ActionLoop(); });
+  return Status();
+}
+
+void DetectionStream::Stop() { pImpl_->StopAction(); }
+
+void DetectionStream::OnNotification(const Notification& notification) {
+  const auto& notify_kv = notification.notifymessage().keyvaluelist();
+  auto event_it = notify_kv.find(kEventTypeKey);
+  if (event_it == notify_kv.end() ||
+      event_it->second.stringvalue() != kDetectionEventType) {
+    return;
+  }
+  auto data_it = notify_kv.find(kDataKey);
+  if (data_it == notify_kv.end()) {
+    return;
+  }
+  pImpl_->PublishSerialized(data_it->second.bytevalue());
+}
+
+uint64_t DetectionStream::Publish(ResponseDetection detection) {
+  return pImpl_->Publish(std::move(detection));
+}
+
+std::unique_ptr<DetectionConsumer> DetectionStream::Subscribe() {
+  std::unique_ptr<DetectionConsumer> consumer(
+      new DetectionConsumer(shared_from_this()));
+  std::lock_guard<std::mutex> lock(pImpl_->consumers_mutex_);
+  pImpl_->consumers_.insert(consumer.get());
+  return consumer;
+}
+
+DetectionStreamStats DetectionStream::GetStats() const {
+  DetectionStreamStats stats;
+  stats.published = pImpl_->ring_.Published();
+  stats.parse_failures =
+      pImpl_->parse_failures_.load(std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(pImpl_->consumers_mutex_);
+  stats.consumers = pImpl_->consumers_.size();
+  for (const auto* consumer : pImpl_->consumers_) {
+    stats.max_depth = std::max(stats.max_depth, consumer->Depth());
+    stats.dropped += consumer->Dropped();
+  }
+  return stats;
+}
+
+// =============================================================================
+// DetectionConsumer
+// =============================================================================
+
+DetectionConsumer::DetectionConsumer(std::shared_ptr<DetectionStream> stream)
+    : stream_(std::move(stream)),
+      cursor_(stream_->pImpl_->ring_.NewCursor()) {
+  SyncCounters();
+}
+
+DetectionConsumer::~DetectionConsumer() {
+  std::lock_guard<std::mutex> lock(stream_->pImpl_->consumers_mutex_);
+  stream_->pImpl_->consumers_.erase(this);
+}
+
+void DetectionConsumer::SyncCounters() {
+  position_.store(cursor_.next, std::memory_order_relaxed);
+  dropped_.store(cursor_.dropped, std::memory_order_relaxed);
+  delivered_.store(cursor_.delivered, std::memory_order_relaxed);
+}
+
+bool DetectionConsumer::TryNext(DetectionFramePtr& frame) {
+  bool ok = stream_->pImpl_->ring_.TryRead(cursor_, frame);
+  if (ok) {
+    SyncCounters();
+  }
+  return ok;
+}
+
+bool DetectionConsumer::Next(DetectionFramePtr& frame,
+                             std::chrono::milliseconds timeout) {
+  if (TryNext(frame)) {
+    return true;
+  }
+
+  auto& impl = *stream_->pImpl_;
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  std::unique_lock<std::mutex> lock(impl.wait_mutex_);
+  impl.waiters_.fetch_add(1, std::memory_order_seq_cst);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  bool ok = false;
+  while (!(ok = impl.ring_.TryRead(cursor_, frame))) {
+    if (impl.wait_cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+      ok = impl.ring_.TryRead(cursor_, frame);
+      break;
+    }
+  }
+  impl.waiters_.fetch_sub(1, std::memory_order_relaxed);
+  SyncCounters();
+  return ok;
+}
+
+uint64_t DetectionConsumer::Depth() const {
+  uint64_t published = stream_->pImpl_->ring_.Published();
+  uint64_t position = position_.load(std::memory_order_relaxed);
+  uint64_t depth = published > position ? published - position : 0;
+  uint64_t capacity = stream_->pImpl_->ring_.Capacity();
+  return depth > capacity ? capacity : depth;
+}
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,513 @@
+#include "robot/modules/image_preprocess.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define HUMANOID_ROBOT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+// 双线性权重的定点位数：水平、垂直各7位，合计14位
+constexpr int kWeightBits = 7;
+constexpr int kWeightOne = 1 << kWeightBits;
+constexpr int kVerticalShift = 2 * kWeightBits;
+constexpr int kVerticalRound = 1 << (kVerticalShift - 1);
+
+// 灰度系数（BT.601，和为256）
+constexpr int kGrayB = 29;
+constexpr int kGrayG = 150;
+constexpr int kGrayR = 77;
+
+// ---------------------------------------------------------------------------
+// 缩放：垂直方向混合两行水平插值结果
+// ---------------------------------------------------------------------------
+
+void VerticalBlendScalar(const int16_t* row0, const int16_t* row1, int weight,
+                         uint8_t* dst, int begin, int count) {
+  const int w0 = kWeightOne - weight;
+  for (int i = begin; i < count; ++i) {
+    int value = (row0[i] * w0 + row1[i] * weight + kVerticalRound) >> kVerticalShift;
+    dst[i] = static_cast<uint8_t>(value);
+  }
+}
+
+#ifdef HUMANOID_ROBOT_X86_SIMD
+__attribute__((target("ssse3"))) int VerticalBlendSSE(const int16_t* row0,
+                                                      const int16_t* row1,
+                                                      int weight, uint8_t* dst,
+                                                      int count) {
+  const __m128i w = _mm_set1_epi32(static_cast<int>(
+      (static_cast<uint32_t>(weight) << 16) |
+      static_cast<uint16_t>(kWeightOne - weight)));
+  const __m128i round = _mm_set1_epi32(kVerticalRound);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+    __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i + 8));
+    __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+    __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i + 8));
+    __m128i r0 = _mm_srai_epi32(
+        _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a0, b0), w), round),
+        kVerticalShift);
+    __m128i r1 = _mm_srai_epi32(
+        _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a0, b0), w), round),
+        kVerticalShift);
+    __m128i r2 = _mm_srai_epi32(
+        _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(a1, b1), w), round),
+        kVerticalShift);
+    __m128i r3 = _mm_srai_epi32(
+        _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(a1, b1), w), round),
+        kVerticalShift);
+    __m128i packed = _mm_packus_epi16(_mm_packs_epi32(r0, r1),
+                                      _mm_packs_epi32(r2, r3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) int VerticalBlendAVX2(const int16_t* row0,
+                                                      const int16_t* row1,
+                                                      int weight, uint8_t* dst,
+                                                      int count) {
+  const __m256i w = _mm256_set1_epi32(static_cast<int>(
+      (static_cast<uint32_t>(weight) << 16) |
+      static_cast<uint16_t>(kWeightOne - weight)));
+  const __m256i round = _mm256_set1_epi32(kVerticalRound);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + i));
+    __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + i + 16));
+    __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + i));
+    __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + i + 16));
+    __m256i r0 = _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a0, b0), w), round),
+        kVerticalShift);
+    __m256i r1 = _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a0, b0), w), round),
+        kVerticalShift);
+    __m256i r2 = _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpacklo_epi16(a1, b1), w), round),
+        kVerticalShift);
+    __m256i r3 = _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_madd_epi16(_mm256_unpackhi_epi16(a1, b1), w), round),
+        kVerticalShift);
+    // packus 按128位通道交错，需要重排回原始顺序
+    __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(r0, r1),
+                                         _mm256_packs_epi32(r2, r3));
+    packed = _mm256_permute4x64_epi64(packed, 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+  }
+  return i;
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// 颜色转换
+// ---------------------------------------------------------------------------
+
+void SwapRBScalar(const uint8_t* src, uint8_t* dst, int begin, int width) {
+  for (int x = begin; x < width; ++x) {
+    const uint8_t* s = src + x * 3;
+    uint8_t* d = dst + x * 3;
+    uint8_t c0 = s[0];
+    d[1] = s[1];
+    d[0] = s[2];
+    d[2] = c0;
+  }
+}
+
+// swap_rb 为 true 表示输入为 RGB
+void ToGrayScalar(const uint8_t* src, uint8_t* dst, int begin, int width,
+                  bool swap_rb) {
+  const int cb = swap_rb ? kGrayR : kGrayB;
+  const int cr = swap_rb ? kGrayB : kGrayR;
+  for (int x = begin; x < width; ++x) {
+    const uint8_t* s = src + x * 3;
+    dst[x] = static_cast<uint8_t>((s[0] * cb + s[1] * kGrayG + s[2] * cr + 128) >> 8);
+  }
+}
+
+#ifdef HUMANOID_ROBOT_X86_SIMD
+__attribute__((target("ssse3"))) int SwapRBSSSE3(const uint8_t* src,
+                                                 uint8_t* dst, int width) {
+  // 每次处理4个像素(12字节)，读写16字节，最后4字节由下一轮覆盖
+  const __m128i mask =
+      _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+  int x = 0;
+  for (; x + 6 <= width; x += 4) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 3));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 3),
+                     _mm_shuffle_epi8(v, mask));
+  }
+  return x;
+}
+
+// 从48字节交错数据中取出各通道16个字节的 pshufb 掩码，masks[channel][register]
+struct GatherMasks {
+  alignas(16) int8_t masks[3][3][16];
+};
+
+GatherMasks BuildGatherMasks() {
+  GatherMasks result;
+  for (int channel = 0; channel < 3; ++channel) {
+    for (int i = 0; i < 16; ++i) {
+      int pos = i * 3 + channel;
+      for (int reg = 0; reg < 3; ++reg) {
+        int offset = pos - reg * 16;
+        result.masks[channel][reg][i] =
+            offset >= 0 && offset < 16 ? static_cast<int8_t>(offset) : -1;
+      }
+    }
+  }
+  return result;
+}
+
+const GatherMasks& GetGatherMasks() {
+  static const GatherMasks masks = BuildGatherMasks();
+  return masks;
+}
+
+__attribute__((target("ssse3"))) inline __m128i GatherChannel(
+    __m128i a, __m128i b, __m128i c, const __m128i* mask) {
+  return _mm_or_si128(
+      _mm_or_si128(_mm_shuffle_epi8(a, mask[0]), _mm_shuffle_epi8(b, mask[1])),
+      _mm_shuffle_epi8(c, mask[2]));
+}
+
+__attribute__((target("ssse3"))) int ToGraySSSE3(const uint8_t* src,
+                                                 uint8_t* dst, int width,
+                                                 bool swap_rb) {
+  const __m128i cb = _mm_set1_epi16(static_cast<int16_t>(swap_rb ? kGrayR : kGrayB));
+  const __m128i cg = _mm_set1_epi16(static_cast<int16_t>(kGrayG));
+  const __m128i cr = _mm_set1_epi16(static_cast<int16_t>(swap_rb ? kGrayB : kGrayR));
+  const __m128i round = _mm_set1_epi16(128);
+  const __m128i zero = _mm_setzero_si128();
+  const GatherMasks& table = GetGatherMasks();
+  __m128i masks[3][3];
+  for (int channel = 0; channel < 3; ++channel) {
+    for (int reg = 0; reg < 3; ++reg) {
+      masks[channel][reg] = _mm_load_si128(
+          reinterpret_cast<const __m128i*>(table.masks[channel][reg]));
+    }
+  }
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    const uint8_t* s = src + x * 3;
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16));
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32));
+    __m128i c0 = GatherChannel(a, b, c, masks[0]);
+    __m128i c1 = GatherChannel(a, b, c, masks[1]);
+    __m128i c2 = GatherChannel(a, b, c, masks[2]);
+    // 16位无符号累加：最大值 255*256+128 不会溢出
+    __m128i lo = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c0, zero), cb),
+                      _mm_mullo_epi16(_mm_unpacklo_epi8(c1, zero), cg)),
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(c2, zero), cr), round));
+    __m128i hi = _mm_add_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c0, zero), cb),
+                      _mm_mullo_epi16(_mm_unpackhi_epi8(c1, zero), cg)),
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(c2, zero), cr), round));
+    __m128i gray = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), gray);
+  }
+  return x;
+}
+#endif
+
+void ConvertRow(const uint8_t* src, uint8_t* dst, int width, PixelFormat from,
+                PixelFormat to, SimdLevel level) {
+  if (from == to) {
+    std::memcpy(dst, src, static_cast<size_t>(width) * PixelChannels(from));
+    return;
+  }
+  int done = 0;
+  if (to == PixelFormat::kGray8) {
+    bool swap_rb = from == PixelFormat::kRGB8;
+#ifdef HUMANOID_ROBOT_X86_SIMD
+    if (level >= SimdLevel::kSSSE3) {
+      done = ToGraySSSE3(src, dst, width, swap_rb);
+    }
+#endif
+    ToGrayScalar(src, dst, done, width, swap_rb);
+    return;
+  }
+#ifdef HUMANOID_ROBOT_X86_SIMD
+  if (level >= SimdLevel::kSSSE3) {
+    done = SwapRBSSSE3(src, dst, width);
+  }
+#endif
+  SwapRBScalar(src, dst, done, width);
+}
+
+bool ConversionSupported(PixelFormat from, PixelFormat to) {
+  return from == to || from != PixelFormat::kGray8;
+}
+
+Status InvalidArgument(const char* message) {
+  return Status(std::make_error_code(std::errc::invalid_argument), message);
+}
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#ifdef HUMANOID_ROBOT_X86_SIMD
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAVX2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return SimdLevel::kSSSE3;
+  }
+#endif
+  return SimdLevel::kScalar;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::kAVX2:
+      return "avx2";
+    case SimdLevel::kSSSE3:
+      return "ssse3";
+    default:
+      return "scalar";
+  }
+}
+
+AlignedBuffer::~AlignedBuffer() { std::free(data_); }
+
+uint8_t* AlignedBuffer::Reserve(size_t size) {
+  if (size <= capacity_ && data_ != nullptr) {
+    return data_;
+  }
+  std::free(data_);
+  // 额外预留一个对齐块，允许向量化代码越过末尾读写
+  size_t rounded = (size + kAlignment - 1) / kAlignment * kAlignment + kAlignment;
+  data_ = static_cast<uint8_t*>(std::aligned_alloc(kAlignment, rounded));
+  capacity_ = data_ != nullptr ? rounded - kAlignment : 0;
+  return data_;
+}
+
+class ImagePreprocessor::Impl {
+public:
+  explicit Impl(SimdLevel max_level)
+      : level_(std::min(max_level, DetectSimdLevel())) {}
+
+  Status Process(const ImageView& input, const PreprocessOptions& options,
+                 ImageView& output) {
+    if (input.data == nullptr || input.width <= 0 || input.height <= 0) {
+      return InvalidArgument("Empty input image");
+    }
+    if (input.Stride() < input.RowBytes()) {
+      return InvalidArgument("Input stride is smaller than row size");
+    }
+    if (!ConversionSupported(input.format, options.out_format)) {
+      return InvalidArgument("Unsupported colour conversion");
+    }
+
+    ImageRoi roi = options.roi;
+    if (roi.Empty()) {
+      roi = ImageRoi{0, 0, input.width, input.height};
+    }
+    if (roi.x < 0 || roi.y < 0 || roi.x + roi.width > input.width ||
+        roi.y + roi.height > input.height) {
+      return InvalidArgument("ROI is outside the input image");
+    }
+
+    // 裁剪只调整视图，不拷贝
+    const int channels = PixelChannels(input.format);
+    ImageView current = input;
+    current.data = input.data + static_cast<size_t>(roi.y) * input.Stride() +
+                   static_cast<size_t>(roi.x) * channels;
+    current.width = roi.width;
+    current.height = roi.height;
+    current.stride = input.Stride();
+
+    int out_width = options.out_width > 0 ? options.out_width : roi.width;
+    int out_height = options.out_height > 0 ? options.out_height : roi.height;
+    bool resized = false;
+    if (out_width != roi.width || out_height != roi.height) {
+      Resize(current, out_width, out_height);
+      current.data = resize_buffer_.data();
+      current.width = out_width;
+      current.height = out_height;
+      current.stride = current.RowBytes();
+      resized = true;
+    }
+
+    if (resized && current.format == options.out_format) {
+      output = current;
+      return Status();
+    }
+
+    // 颜色转换（或仅拷贝为紧密排列）写入输出缓冲
+    ImageView converted = current;
+    converted.format = options.out_format;
+    converted.stride = converted.RowBytes();
+    uint8_t* dst = output_buffer_.Reserve(converted.ByteSize());
+    if (dst == nullptr) {
+      return Status(std::make_error_code(std::errc::not_enough_memory),
+                    "Failed to allocate output buffer");
+    }
+    for (int y = 0; y < current.height; ++y) {
+      ConvertRow(current.data + static_cast<size_t>(y) * current.Stride(),
+                 dst + static_cast<size_t>(y) * converted.stride, current.width,
+                 current.format, options.out_format, level_);
+    }
+    converted.data = dst;
+    output = converted;
+    return Status();
+  }
+
+  SimdLevel level_;
+
+private:
+  void PreparePlan(const ImageView& src, int dst_width, int dst_height) {
+    const int channels = PixelChannels(src.format);
+    if (plan_src_width_ == src.width && plan_src_height_ == src.height &&
+        plan_dst_width_ == dst_width && plan_dst_height_ == dst_height &&
+        plan_channels_ == channels) {
+      return;
+    }
+    plan_src_width_ = src.width;
+    plan_src_height_ = src.height;
+    plan_dst_width_ = dst_width;
+    plan_dst_height_ = dst_height;
+    plan_channels_ = channels;
+
+    auto build = [](int src_size, int dst_size, std::vector<int>& index0,
+                    std::vector<int>& index1, std::vector<int16_t>& weight) {
+      index0.resize(dst_size);
+      index1.resize(dst_size);
+      weight.resize(dst_size);
+      const double scale = static_cast<double>(src_size) / dst_size;
+      for (int i = 0; i < dst_size; ++i) {
+        double position = (i + 0.5) * scale - 0.5;
+        position = std::max(0.0, std::min(position, static_cast<double>(src_size - 1)));
+        int i0 = static_cast<int>(position);
+        int i1 = std::min(i0 + 1, src_size - 1);
+        int w = static_cast<int>((position - i0) * kWeightOne + 0.5);
+        if (w >= kWeightOne) {
+          i0 = i1;
+          w = 0;
+        }
+        index0[i] = i0;
+        index1[i] = i1;
+        weight[i] = static_cast<int16_t>(w);
+      }
+    };
+    build(src.width, dst_width, x0_, x1_, xw_);
+    build(src.height, dst_height, y0_, y1_, yw_);
+
+    const size_t row_elements = static_cast<size_t>(dst_width) * channels;
+    for (auto& row : rows_) {
+      row.assign(row_elements, 0);
+    }
+  }
+
+  template <int kChannels>
+  void HorizontalRowImpl(const uint8_t* __restrict src,
+                         int16_t* __restrict dst) const {
+    const int* x0 = x0_.data();
+    const int* x1 = x1_.data();
+    const int16_t* xw = xw_.data();
+    for (int x = 0; x < plan_dst_width_; ++x) {
+      const uint8_t* s0 = src + x0[x] * kChannels;
+      const uint8_t* s1 = src + x1[x] * kChannels;
+      const int w1 = xw[x];
+      const int w0 = kWeightOne - w1;
+      int16_t* d = dst + x * kChannels;
+      for (int c = 0; c < kChannels; ++c) {
+        d[c] = static_cast<int16_t>(s0[c] * w0 + s1[c] * w1);
+      }
+    }
+  }
+
+  void HorizontalRow(const uint8_t* src, int16_t* dst) const {
+    if (plan_channels_ == 3) {
+      HorizontalRowImpl<3>(src, dst);
+    } else {
+      HorizontalRowImpl<1>(src, dst);
+    }
+  }
+
+  // 返回源图第 src_row 行的水平插值结果，相邻输出行之间复用
+  const int16_t* HorizontalCached(const ImageView& src, int src_row) {
+    for (int i = 0; i < 2; ++i) {
+      if (row_index_[i] == src_row) {
+        return rows_[i].data();
+      }
+    }
+    int slot = next_slot_;
+    next_slot_ ^= 1;
+    HorizontalRow(src.data + static_cast<size_t>(src_row) * src.Stride(),
+                  rows_[slot].data());
+    row_index_[slot] = src_row;
+    return rows_[slot].data();
+  }
+
+  void Resize(const ImageView& src, int dst_width, int dst_height) {
+    PreparePlan(src, dst_width, dst_height);
+    row_index_[0] = row_index_[1] = -1;
+    next_slot_ = 0;
+
+    const int count = dst_width * plan_channels_;
+    uint8_t* dst = resize_buffer_.Reserve(static_cast<size_t>(count) * dst_height);
+    for (int y = 0; y < dst_height; ++y) {
+      const int16_t* row0 = HorizontalCached(src, y0_[y]);
+      const int16_t* row1 = HorizontalCached(src, y1_[y]);
+      uint8_t* out = dst + static_cast<size_t>(y) * count;
+      int done = 0;
+#ifdef HUMANOID_ROBOT_X86_SIMD
+      if (level_ >= SimdLevel::kAVX2) {
+        done = VerticalBlendAVX2(row0, row1, yw_[y], out, count);
+      } else if (level_ >= SimdLevel::kSSSE3) {
+        done = VerticalBlendSSE(row0, row1, yw_[y], out, count);
+      }
+#endif
+      VerticalBlendScalar(row0, row1, yw_[y], out, done, count);
+    }
+  }
+
+  AlignedBuffer resize_buffer_;
+  AlignedBuffer output_buffer_;
+
+  int plan_src_width_ = 0;
+  int plan_src_height_ = 0;
+  int plan_dst_width_ = 0;
+  int plan_dst_height_ = 0;
+  int plan_channels_ = 0;
+  std::vector<int> x0_, x1_, y0_, y1_;
+  std::vector<int16_t> xw_, yw_;
+  std::vector<int16_t> rows_[2];
+  int row_index_[2] = {-1, -1};
+  int next_slot_ = 0;
+};
+
+ImagePreprocessor::ImagePreprocessor(SimdLevel max_level)
+    : pImpl_(std::make_unique<Impl>(max_level)) {}
+
+ImagePreprocessor::~ImagePreprocessor() = default;
+
+Status ImagePreprocessor::Process(const ImageView& input,
+                                  const PreprocessOptions& options,
+                                  ImageView& output) {
+  return pImpl_->Process(input, options, output);
+}
+
+SimdLevel ImagePreprocessor::simd_level() const { return pImpl_->level_; }
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,522 @@
+#include "robot/modules/mask_util.h"
+
+#include <algorithm>
+
+#include "robot/modules/image_preprocess.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define HUMANOID_ROBOT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+constexpr int kWordBits = 64;
+
+size_t WordsPerRow(int width) {
+  return (static_cast<size_t>(width) + kWordBits - 1) / kWordBits;
+}
+
+// 置位 [x0, x1) 区间
+void SetRange(uint64_t* row, int x0, int x1) {
+  while (x0 < x1) {
+    int word = x0 >> 6;
+    int bit = x0 & 63;
+    int count = std::min(kWordBits - bit, x1 - x0);
+    uint64_t mask = count == kWordBits ? ~0ULL : ((1ULL << count) - 1) << bit;
+    row[word] |= mask;
+    x0 += count;
+  }
+}
+
+// 一个字内所有置位的位下标之和
+inline uint64_t BitIndexSum(uint64_t word) {
+  return static_cast<uint64_t>(__builtin_popcountll(word & 0xAAAAAAAAAAAAAAAAULL)) +
+         (static_cast<uint64_t>(__builtin_popcountll(word & 0xCCCCCCCCCCCCCCCCULL)) << 1) +
+         (static_cast<uint64_t>(__builtin_popcountll(word & 0xF0F0F0F0F0F0F0F0ULL)) << 2) +
+         (static_cast<uint64_t>(__builtin_popcountll(word & 0xFF00FF00FF00FF00ULL)) << 3) +
+         (static_cast<uint64_t>(__builtin_popcountll(word & 0xFFFF0000FFFF0000ULL)) << 4) +
+         (static_cast<uint64_t>(__builtin_popcountll(word & 0xFFFFFFFF00000000ULL)) << 5);
+}
+
+// ---------------------------------------------------------------------------
+// popcount 内核
+// ---------------------------------------------------------------------------
+
+uint64_t PopcountGeneric(const uint64_t* words, size_t count) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    total += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+  }
+  return total;
+}
+
+uint64_t AndPopcountGeneric(const uint64_t* a, const uint64_t* b, size_t count) {
+  uint64_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    total += static_cast<uint64_t>(__builtin_popcountll(a[i] & b[i]));
+  }
+  return total;
+}
+
+#ifdef HUMANOID_ROBOT_X86_SIMD
+__attribute__((target("popcnt"))) uint64_t PopcountHw(const uint64_t* words,
+                                                      size_t count) {
+  // 四路累加以隐藏 popcnt 延迟
+  uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    t0 += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+    t1 += static_cast<uint64_t>(__builtin_popcountll(words[i + 1]));
+    t2 += static_cast<uint64_t>(__builtin_popcountll(words[i + 2]));
+    t3 += static_cast<uint64_t>(__builtin_popcountll(words[i + 3]));
+  }
+  for (; i < count; ++i) {
+    t0 += static_cast<uint64_t>(__builtin_popcountll(words[i]));
+  }
+  return t0 + t1 + t2 + t3;
+}
+
+__attribute__((target("popcnt"))) uint64_t AndPopcountHw(const uint64_t* a,
+                                                         const uint64_t* b,
+                                                         size_t count) {
+  uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    t0 += static_cast<uint64_t>(__builtin_popcountll(a[i] & b[i]));
+    t1 += static_cast<uint64_t>(__builtin_popcountll(a[i + 1] & b[i + 1]));
+    t2 += static_cast<uint64_t>(__builtin_popcountll(a[i + 2] & b[i + 2]));
+    t3 += static_cast<uint64_t>(__builtin_popcountll(a[i + 3] & b[i + 3]));
+  }
+  for (; i < count; ++i) {
+    t0 += static_cast<uint64_t>(__builtin_popcountll(a[i] & b[i]));
+  }
+  return t0 + t1 + t2 + t3;
+}
+
+bool HasHardwarePopcount() {
+  static const bool supported = []() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("popcnt") != 0;
+  }();
+  return supported;
+}
+#endif
+
+uint64_t Popcount(const uint64_t* words, size_t count) {
+#ifdef HUMANOID_ROBOT_X86_SIMD
+  if (HasHardwarePopcount()) {
+    return PopcountHw(words, count);
+  }
+#endif
+  return PopcountGeneric(words, count);
+}
+
+uint64_t AndPopcount(const uint64_t* a, const uint64_t* b, size_t count) {
+#ifdef HUMANOID_ROBOT_X86_SIMD
+  if (HasHardwarePopcount()) {
+    return AndPopcountHw(a, b, count);
+  }
+#endif
+  return AndPopcountGeneric(a, b, count);
+}
+
+// ---------------------------------------------------------------------------
+// 字节掩码打包
+// ---------------------------------------------------------------------------
+
+void PackRowScalar(const uint8_t* src, int begin, int width, uint8_t threshold,
+                   uint64_t* dst) {
+  for (int x = begin; x < width; ++x) {
+    if (src[x] > threshold) {
+      dst[x >> 6] |= 1ULL << (x & 63);
+    }
+  }
+}
+
+#ifdef HUMANOID_ROBOT_X86_SIMD
+__attribute__((target("sse2"))) int PackRowSSE2(const uint8_t* src, int width,
+                                                uint8_t threshold,
+                                                uint64_t* dst) {
+  const __m128i t = _mm_set1_epi8(static_cast<char>(threshold));
+  const __m128i zero = _mm_setzero_si128();
+  int x = 0;
+  for (; x + 64 <= width; x += 64) {
+    uint64_t word = 0;
+    for (int k = 0; k < 4; ++k) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x + k * 16));
+      // 饱和减法后非零即大于阈值
+      __m128i background = _mm_cmpeq_epi8(_mm_subs_epu8(v, t), zero);
+      uint64_t bits = static_cast<uint16_t>(~_mm_movemask_epi8(background));
+      word |= bits << (k * 16);
+    }
+    dst[x >> 6] = word;
+  }
+  return x;
+}
+
+__attribute__((target("avx2"))) int PackRowAVX2(const uint8_t* src, int width,
+                                                uint8_t threshold,
+                                                uint64_t* dst) {
+  const __m256i t = _mm256_set1_epi8(static_cast<char>(threshold));
+  const __m256i zero = _mm256_setzero_si256();
+  int x = 0;
+  for (; x + 64 <= width; x += 64) {
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+    __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x + 32));
+    uint32_t b0 = ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_subs_epu8(v0, t), zero)));
+    uint32_t b1 = ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_subs_epu8(v1, t), zero)));
+    dst[x >> 6] = static_cast<uint64_t>(b0) | (static_cast<uint64_t>(b1) << 32);
+  }
+  return x;
+}
+#endif
+
+// RLE 游程遍历：对每段前景 [start, start + length) 调用 fn
+template <typename Fn>
+void ForEachForeground(const std::vector<uint32_t>& runs, Fn fn) {
+  uint64_t position = 0;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    if (i & 1) {
+      fn(position, static_cast<uint64_t>(runs[i]));
+    }
+    position += runs[i];
+  }
+}
+}  // namespace
+
+// ---------------------------------------------------------------------------
+// BitMask
+// ---------------------------------------------------------------------------
+
+BitMask::BitMask(int width, int height)
+    : width_(std::max(width, 0)),
+      height_(std::max(height, 0)),
+      words_per_row_(WordsPerRow(width_)),
+      words_(words_per_row_ * static_cast<size_t>(height_), 0) {}
+
+BitMask BitMask::FromBytes(const uint8_t* data, int width, int height,
+                           size_t stride, uint8_t threshold) {
+  BitMask mask(width, height);
+  if (data == nullptr || mask.words_.empty()) {
+    return mask;
+  }
+  if (stride == 0) {
+    stride = static_cast<size_t>(width);
+  }
+  static const SimdLevel level = DetectSimdLevel();
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* src = data + static_cast<size_t>(y) * stride;
+    uint64_t* dst = mask.MutableRow(y);
+    int done = 0;
+#ifdef HUMANOID_ROBOT_X86_SIMD
+    if (level >= SimdLevel::kAVX2) {
+      done = PackRowAVX2(src, width, threshold, dst);
+    } else {
+      done = PackRowSSE2(src, width, threshold, dst);
+    }
+#else
+    (void)level;
+#endif
+    PackRowScalar(src, done, width, threshold, dst);
+  }
+  return mask;
+}
+
+BitMask BitMask::FromBytes(const std::string& data, int width, int height,
+                           uint8_t threshold) {
+  if (data.size() < static_cast<size_t>(std::max(width, 0)) * std::max(height, 0)) {
+    return BitMask();
+  }
+  return FromBytes(reinterpret_cast<const uint8_t*>(data.data()), width, height,
+                   0, threshold);
+}
+
+std::vector<uint8_t> BitMask::ToBytes() const {
+  std::vector<uint8_t> bytes(static_cast<size_t>(width_) * height_, 0);
+  for (int y = 0; y < height_; ++y) {
+    const uint64_t* row = Row(y);
+    uint8_t* dst = bytes.data() + static_cast<size_t>(y) * width_;
+    for (size_t w = 0; w < words_per_row_; ++w) {
+      uint64_t word = row[w];
+      while (word != 0) {
+        int bit = __builtin_ctzll(word);
+        dst[w * kWordBits + bit] = 1;
+        word &= word - 1;
+      }
+    }
+  }
+  return bytes;
+}
+
+void BitMask::Set(int x, int y, bool value) {
+  uint64_t& word = MutableRow(y)[x >> 6];
+  uint64_t bit = 1ULL << (x & 63);
+  word = value ? (word | bit) : (word & ~bit);
+}
+
+uint64_t BitMask::Area() const { return Popcount(words_.data(), words_.size()); }
+
+MaskBox BitMask::BoundingBox() const {
+  MaskBox box;
+  box.x_min = width_;
+  box.y_min = height_;
+  for (int y = 0; y < height_; ++y) {
+    const uint64_t* row = Row(y);
+    size_t first = 0;
+    while (first < words_per_row_ && row[first] == 0) {
+      ++first;
+    }
+    if (first == words_per_row_) {
+      continue;
+    }
+    size_t last = words_per_row_ - 1;
+    while (row[last] == 0) {
+      --last;
+    }
+    int x0 = static_cast<int>(first) * kWordBits + __builtin_ctzll(row[first]);
+    int x1 = static_cast<int>(last) * kWordBits + 63 - __builtin_clzll(row[last]);
+    box.x_min = std::min(box.x_min, x0);
+    box.x_max = std::max(box.x_max, x1);
+    if (box.y_min > y) {
+      box.y_min = y;
+    }
+    box.y_max = y;
+  }
+  if (box.y_max < 0) {
+    return MaskBox();
+  }
+  return box;
+}
+
+MaskCentroid BitMask::Centroid() const {
+  uint64_t count = 0;
+  uint64_t sum_x = 0;
+  uint64_t sum_y = 0;
+  for (int y = 0; y < height_; ++y) {
+    const uint64_t* row = Row(y);
+    uint64_t row_count = 0;
+    for (size_t w = 0; w < words_per_row_; ++w) {
+      uint64_t word = row[w];
+      if (word == 0) {
+        continue;
+      }
+      uint64_t n = static_cast<uint64_t>(__builtin_popcountll(word));
+      row_count += n;
+      sum_x += n * w * kWordBits + BitIndexSum(word);
+    }
+    count += row_count;
+    sum_y += row_count * static_cast<uint64_t>(y);
+  }
+  MaskCentroid centroid;
+  if (count > 0) {
+    centroid.x = static_cast<double>(sum_x) / static_cast<double>(count);
+    centroid.y = static_cast<double>(sum_y) / static_cast<double>(count);
+    centroid.valid = true;
+  }
+  return centroid;
+}
+
+uint64_t BitMask::IntersectionArea(const BitMask& a, const BitMask& b) {
+  if (a.width_ != b.width_ || a.height_ != b.height_) {
+    return 0;
+  }
+  return AndPopcount(a.words_.data(), b.words_.data(), a.words_.size());
+}
+
+double BitMask::IoU(const BitMask& a, const BitMask& b) {
+  if (a.width_ != b.width_ || a.height_ != b.height_) {
+    return 0.0;
+  }
+  uint64_t inter = IntersectionArea(a, b);
+  uint64_t uni = a.Area() + b.Area() - inter;
+  return uni == 0 ? 0.0 : static_cast<double>(inter) / static_cast<double>(uni);
+}
+
+// ---------------------------------------------------------------------------
+// RleMask
+// ---------------------------------------------------------------------------
+
+RleMask RleMask::FromBitMask(const BitMask& mask) {
+  RleMask rle;
+  rle.width_ = mask.width();
+  rle.height_ = mask.height();
+
+  bool state = false;  // 当前游程是否为前景
+  uint64_t run = 0;
+  for (int y = 0; y < mask.height(); ++y) {
+    const uint64_t* row = mask.Row(y);
+    int x = 0;
+    while (x < mask.width()) {
+      // 在当前字内寻找下一个与当前状态不同的位（行尾填充位按越界处理）
+      int word_index = x >> 6;
+      uint64_t word = (row[word_index] ^ (state ? ~0ULL : 0ULL)) >> (x & 63);
+      int next = word == 0 ? (word_index + 1) * kWordBits
+                           : x + __builtin_ctzll(word);
+      if (next >= mask.width()) {
+        run += static_cast<uint64_t>(mask.width() - x);
+        break;
+      }
+      run += static_cast<uint64_t>(next - x);
+      x = next;
+      if (word != 0) {
+        rle.runs_.push_back(static_cast<uint32_t>(run));
+        run = 0;
+        state = !state;
+      }
+    }
+  }
+  rle.runs_.push_back(static_cast<uint32_t>(run));
+  return rle;
+}
+
+RleMask RleMask::FromBytes(const uint8_t* data, int width, int height,
+                           size_t stride, uint8_t threshold) {
+  return FromBitMask(BitMask::FromBytes(data, width, height, stride, threshold));
+}
+
+BitMask RleMask::ToBitMask() const {
+  BitMask mask(width_, height_);
+  if (width_ <= 0) {
+    return mask;
+  }
+  const uint64_t width = static_cast<uint64_t>(width_);
+  ForEachForeground(runs_, [&](uint64_t start, uint64_t length) {
+    uint64_t end = start + length;
+    while (start < end) {
+      int y = static_cast<int>(start / width);
+      int x0 = static_cast<int>(start % width);
+      uint64_t row_end = std::min(end, (static_cast<uint64_t>(y) + 1) * width);
+      int x1 = static_cast<int>(row_end - static_cast<uint64_t>(y) * width);
+      SetRange(mask.MutableRow(y), x0, x1);
+      start = row_end;
+    }
+  });
+  return mask;
+}
+
+uint64_t RleMask::Area() const {
+  uint64_t area = 0;
+  for (size_t i = 1; i < runs_.size(); i += 2) {
+    area += runs_[i];
+  }
+  return area;
+}
+
+MaskBox RleMask::BoundingBox() const {
+  MaskBox box;
+  if (width_ <= 0) {
+    return box;
+  }
+  box.x_min = width_;
+  box.y_min = height_;
+  const uint64_t width = static_cast<uint64_t>(width_);
+  ForEachForeground(runs_, [&](uint64_t start, uint64_t length) {
+    if (length == 0) {
+      return;
+    }
+    uint64_t last = start + length - 1;
+    int y0 = static_cast<int>(start / width);
+    int y1 = static_cast<int>(last / width);
+    int x0 = static_cast<int>(start % width);
+    int x1 = static_cast<int>(last % width);
+    if (y0 != y1) {
+      // 跨行游程覆盖首行行尾和末行行首
+      x0 = 0;
+      x1 = width_ - 1;
+    }
+    box.x_min = std::min(box.x_min, x0);
+    box.x_max = std::max(box.x_max, x1);
+    box.y_min = std::min(box.y_min, y0);
+    box.y_max = std::max(box.y_max, y1);
+  });
+  if (box.y_max < 0) {
+    return MaskBox();
+  }
+  return box;
+}
+
+MaskCentroid RleMask::Centroid() const {
+  MaskCentroid centroid;
+  if (width_ <= 0) {
+    return centroid;
+  }
+  const uint64_t width = static_cast<uint64_t>(width_);
+  double sum_x = 0.0;
+  double sum_y = 0.0;
+  uint64_t count = 0;
+  ForEachForeground(runs_, [&](uint64_t start, uint64_t length) {
+    uint64_t end = start + length;
+    while (start < end) {
+      uint64_t y = start / width;
+      uint64_t x0 = start % width;
+      uint64_t row_end = std::min(end, (y + 1) * width);
+      uint64_t n = row_end - start;
+      uint64_t x1 = x0 + n - 1;
+      sum_x += static_cast<double>(x0 + x1) * static_cast<double>(n) / 2.0;
+      sum_y += static_cast<double>(y) * static_cast<double>(n);
+      count += n;
+      start = row_end;
+    }
+  });
+  if (count > 0) {
+    centroid.x = sum_x / static_cast<double>(count);
+    centroid.y = sum_y / static_cast<double>(count);
+    centroid.valid = true;
+  }
+  return centroid;
+}
+
+uint64_t RleMask::IntersectionArea(const RleMask& a, const RleMask& b) {
+  if (a.width_ != b.width_ || a.height_ != b.height_) {
+    return 0;
+  }
+  // 两个游程序列归并，仅在两者同时处于前景时累计
+  size_t ia = 0;
+  size_t ib = 0;
+  uint64_t remain_a = a.runs_.empty() ? 0 : a.runs_[0];
+  uint64_t remain_b = b.runs_.empty() ? 0 : b.runs_[0];
+  uint64_t inter = 0;
+  while (ia < a.runs_.size() && ib < b.runs_.size()) {
+    if (remain_a == 0) {
+      if (++ia < a.runs_.size()) {
+        remain_a = a.runs_[ia];
+      }
+      continue;
+    }
+    if (remain_b == 0) {
+      if (++ib < b.runs_.size()) {
+        remain_b = b.runs_[ib];
+      }
+      continue;
+    }
+    uint64_t step = std::min(remain_a, remain_b);
+    if ((ia & 1) && (ib & 1)) {
+      inter += step;
+    }
+    remain_a -= step;
+    remain_b -= step;
+  }
+  return inter;
+}
+
+double RleMask::IoU(const RleMask& a, const RleMask& b) {
+  if (a.width_ != b.width_ || a.height_ != b.height_) {
+    return 0.0;
+  }
+  uint64_t inter = IntersectionArea(a, b);
+  uint64_t uni = a.Area() + b.Area() - inter;
+  return uni == 0 ? 0.0 : static_cast<double>(inter) / static_cast<double>(uni);
+}
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -1,6 +1,5 @@
 #include "robot/modules/navigation_api.h"
 
-#include <iostream>
 #include <stdexcept>
 #include <string>
 
@@ -11,6 +10,10 @@
 #include "interfaces/interfaces_request_response.pb.h"
 #include "robot/client/interfaces_client.h"
 #include "robot/common/json_convert_util.hpp"
+#include "robot/common/logger.h"
+#include "robot/common/metrics.h"
+#include "robot/modules/compact_codec.h"
+#include "robot/modules/request_envelope.h"
 #include "ros2/action_msgs/GoalStatus.pb.h"
 #include "ros2/geometry_msgs/Pose.pb.h"
 #include "ros2/nav_msgs/Goals.pb.h"
@@ -36,8 +39,6 @@ namespace constants {
 // gRPC请求默认超时时间(ms)
 constexpr int kDefaultGrpcTimeoutMs = 30000;
 // 请求参数key
-constexpr const char* kCommandIdKey = "command_id";
-constexpr const char* kDataKey = "data";
 constexpr const char* kRequestDataKey = "request_data";
 // 错误提示信息
 constexpr const char* kSerializeFailedMsg = "Failed to serialize request_data";
@@ -89,6 +90,13 @@ using GrpcStreamPtr =
     std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>>;
 using GrpcContextPtr = std::unique_ptr<grpc::ClientContext>;
 
+// 指标类型别名
+using RequestTimer = humanoid_robot::konka_sdk::common::RequestTimer;
+using MetricPhase = humanoid_robot::konka_sdk::common::MetricPhase;
+using MetricErrorCategory =
+    humanoid_robot::konka_sdk::common::MetricErrorCategory;
+using humanoid_robot::konka_sdk::common::kMetricMethodSend;
+
 // ===================== 封装公共工具函数 =====================
 /**
  * @brief 检查protobuf序列化状态，失败则打印日志并返回false
@@ -99,82 +107,53 @@ using GrpcContextPtr = std::unique_ptr<grpc::ClientContext>;
 inline bool CheckSerializeStatus(bool serialize_status,
                                  const std::string& error_msg) {
   if (!serialize_status) {
-    std::cerr << error_msg << std::endl;
+    KONKA_LOG_ERROR("navigation") << error_msg;
   }
   return serialize_status;
 }
 
-/**
- * @brief 构建gRPC请求对象（填充command_id和request_data）
- * @param command_id 导航命令ID
- * @param request_data 业务请求数据（protobuf对象）
- * @return 构建好的SendRequest对象
- */
-template <typename RequestType>
-SendRequest BuildSendRequest(NavigationCommandCode command_id,
-                             const RequestType& request_data) {
-  SendRequest send_req;
-  auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-
-  // 设置command_id
-  Variant command_id_var;
-  command_id_var.set_int32value(command_id);
-  input_map->emplace(constants::kCommandIdKey, std::move(command_id_var));
-
-  // 设置request_data
-  Variant request_dict;
-  auto request_dict_map =
-      request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-  Variant request_params;
-
-  std::string serialize_data;
-  if (!CheckSerializeStatus(request_data.SerializeToString(&serialize_data),
-                            constants::kSerializeFailedMsg)) {
-    return send_req;  // 序列化失败，返回空请求
-  }
-
-  request_params.set_bytevalue(serialize_data);
-  request_dict_map->emplace(constants::kRequestDataKey,
-                            std::move(request_params));
-  input_map->emplace(constants::kDataKey, std::move(request_dict));
-
-  return send_req;
-}
-
 /**
  * @brief 发送gRPC请求并获取响应（核心通信逻辑封装）
  * @param client InterfacesClient对象
  * @param send_req 待发送的请求
  * @param send_resp 输出参数，接收响应
+ * @param timer 请求计时器，记录打开流、写出和等待响应的耗时
  * @return 是否成功获取响应
  */
 bool SendGrpcRequest(std::unique_ptr<InterfacesClient>& client,
-                     const SendRequest& send_req, SendResponse& send_resp) {
+                     const SendRequest& send_req, SendResponse& send_resp,
+                     RequestTimer& timer) {
   GrpcStreamPtr stream;
   GrpcContextPtr context;
 
   // 创建gRPC流
   auto send_status =
       client->Send(stream, context, constants::kDefaultGrpcTimeoutMs);
+  timer.Mark(MetricPhase::kStreamOpen);
   if (!send_status) {
-    std::cerr << constants::kCreateStreamFailedMsg << send_status.message()
-              << std::endl;
+    KONKA_LOG_ERROR("navigation") << constants::kCreateStreamFailedMsg
+                                  << send_status.message();
+    timer.Fail(send_status);
     return false;
   }
 
   // 发送请求
-  if (!stream->Write(send_req)) {
-    std::cerr << constants::kSendRequestFailedMsg << std::endl;
+  bool written = stream->Write(send_req);
+  timer.Mark(MetricPhase::kWrite);
+  if (!written) {
+    KONKA_LOG_ERROR("navigation") << constants::kSendRequestFailedMsg;
     stream->WritesDone();
-    stream->Finish();
+    timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
     return false;
   }
 
   // 读取响应
-  if (!stream->Read(&send_resp)) {
-    std::cerr << constants::kNoResponseReceivedMsg << std::endl;
+  bool received = stream->Read(&send_resp);
+  timer.Mark(MetricPhase::kServerWait);
+  if (!received) {
+    KONKA_LOG_ERROR("navigation") << constants::kNoResponseReceivedMsg;
     stream->WritesDone();
-    stream->Finish();
+    timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
     return false;
   }
 
@@ -200,28 +179,50 @@ NavigationResStatus ParseResponse(const SendResponse& send_resp,
 
   // 非成功状态直接返回
   if (res_status != NavigationResStatus::RESPONSE_SUCCESS) {
-    std::cerr << "Request failed: " << response_status.message() << std::endl;
+    KONKA_LOG_ERROR("navigation") << "Request failed: "
+                                  << response_status.message();
     return res_status;
   }
 
-  // 查找并解析data字段
-  auto response_output = send_resp.output();
-  auto data_it = response_output.keyvaluelist().find(constants::kDataKey);
-  if (data_it == response_output.keyvaluelist().end()) {
-    std::cerr << constants::kDataKeyNotFoundMsg << std::endl;
-    return NavigationResStatus::ERROR_DATA_GET_FAILED;
-  }
-
-  // 反序列化数据
-  const Variant& data_var = data_it->second;
-  if (!CheckSerializeStatus(result.ParseFromString(data_var.bytevalue()),
-                            constants::kUnserializeFailedMsg)) {
-    return NavigationResStatus::ERROR_PARSE_FAILED;
+  // 查找并反序列化data字段
+  switch (request_envelope::ParseResponseData(send_resp, &result)) {
+    case request_envelope::ParseResult::kDataNotFound:
+      KONKA_LOG_ERROR("navigation") << constants::kDataKeyNotFoundMsg;
+      return NavigationResStatus::ERROR_DATA_GET_FAILED;
+    case request_envelope::ParseResult::kParseFailed:
+      KONKA_LOG_ERROR("navigation") << constants::kUnserializeFailedMsg;
+      return NavigationResStatus::ERROR_PARSE_FAILED;
+    case request_envelope::ParseResult::kOk:
+      break;
   }
 
   return NavigationResStatus::RESPONSE_SUCCESS;
 }
 
+/**
+ * @brief 导航命令对应的 span 名称
+ */
+const char* SpanNameOf(NavigationCommandCode command_id) {
+  switch (command_id) {
+    case NavigationCommandCode::kGetCurrentPose:
+      return "GetCurrentPose";
+    case NavigationCommandCode::kGetGridMap2D:
+      return "GetGridMap2D";
+    case NavigationCommandCode::kNavigationTo:
+      return "NavigationTo";
+    case NavigationCommandCode::kGetRemainingPathDistance:
+      return "GetRemainingPathDistance";
+    case NavigationCommandCode::kCancelNavigationTask:
+      return "CancelNavigationTask";
+    case NavigationCommandCode::kStartCharging:
+      return "StartChargingTask";
+    case NavigationCommandCode::kStopCharging:
+      return "StopChargingTask";
+    default:
+      return "Navigation";
+  }
+}
+
 /**
  * @brief 通用导航请求模板函数（核心逻辑复用）
  * @param client InterfacesClient对象
@@ -235,26 +236,42 @@ NavigationResStatus NavigationRequestTemplate(
     std::unique_ptr<InterfacesClient>& client, NavigationCommandCode command_id,
     const RequestType& request_data, ResultType& result) {
   NavigationResStatus res_status = NavigationResStatus::ERROR_DATA_GET_FAILED;
+  RequestTimer timer(kMetricMethodSend, command_id, SpanNameOf(command_id),
+                     "navigation");
 
   try {
     // 1. 构建请求
-    SendRequest send_req = BuildSendRequest(command_id, request_data);
+    bool use_compact =
+        client->HasCapability(compact_codec::kCompactCodecCapability);
+    SendRequest send_req;
+    bool built = request_envelope::BuildSendRequest(
+        command_id, constants::kRequestDataKey, request_data, use_compact,
+        &send_req);
+    request_envelope::AcceptCompactResponse<ResultType>(use_compact, &send_req);
+    timer.Mark(MetricPhase::kEnvelopeBuild);
     // 序列化失败时直接返回
-    if (send_req.input().keyvaluelist().empty()) {
+    if (!CheckSerializeStatus(built, constants::kSerializeFailedMsg)) {
+      timer.Fail(MetricErrorCategory::kParse);
       return NavigationResStatus::ERROR_PARSE_FAILED;
     }
 
     // 2. 发送gRPC请求
     SendResponse send_resp;
-    if (!SendGrpcRequest(client, send_req, send_resp)) {
+    if (!SendGrpcRequest(client, send_req, send_resp, timer)) {
       return res_status;
     }
 
     // 3. 解析响应
     res_status = ParseResponse(send_resp, result);
+    timer.Mark(MetricPhase::kParse);
+    if (res_status == NavigationResStatus::ERROR_PARSE_FAILED ||
+        res_status == NavigationResStatus::ERROR_DATA_GET_FAILED) {
+      timer.Fail(MetricErrorCategory::kParse);
+    }
 
   } catch (const std::exception& e) {
-    std::cerr << constants::kExceptionMsg << e.what() << std::endl;
+    KONKA_LOG_ERROR("navigation") << constants::kExceptionMsg << e.what();
+    timer.Fail(MetricErrorCategory::kParse);
   }
 
   return res_status;
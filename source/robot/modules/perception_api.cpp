@@ -1,6 +1,5 @@
-#include "robot/modules/perception/perception_api.h"
+#include "robot/modules/perception_api.h"
 
-#include <iostream>
 #include <string>
 #include <stdexcept>
 
@@ -11,14 +10,21 @@
 #include "sdk_service/common/service.pb.h"
 
 #include "robot/common/json_convert_util.hpp"
+#include "robot/common/logger.h"
+#include "robot/common/metrics.h"
+#include "robot/modules/request_envelope.h"
 
 namespace humanoid_robot {
-namespace clientSDK {
+namespace konka_sdk {
 namespace robot {
 namespace perception_api {
 
 using Variant = humanoid_robot::PB::common::Variant;
 using PerceptionResStatus = humanoid_robot::PB::sdk_service::perception::ResponseStatus;
+using RequestTimer = humanoid_robot::konka_sdk::common::RequestTimer;
+using MetricPhase = humanoid_robot::konka_sdk::common::MetricPhase;
+using MetricErrorCategory = humanoid_robot::konka_sdk::common::MetricErrorCategory;
+using humanoid_robot::konka_sdk::common::kMetricMethodSend;
 
 PerceptionResStatus Detection(std::unique_ptr<InterfacesClient>& client,
                                 const RequestDetection& request_detection,
@@ -26,72 +32,65 @@ PerceptionResStatus Detection(std::unique_ptr<InterfacesClient>& client,
 {
     
     PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, PerceptionCommandCode::kDetection,
+                       "Detection", "perception");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(PerceptionCommandCode::kDetection);
-            input_map->insert(std::make_pair(std::string("command_id"), command_id));
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            
-            auto serialize_status = request_detection.SerializeToString(&serialize_data);
-            
-            if (!serialize_status) {
-                std::cerr << "Failed to serialize request_detection." << std::endl;
-                return PerceptionResStatus::ERROR_PARSE_FAILED;
-            }
-            
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_detection"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            PerceptionCommandCode::kDetection, "request_detection",
+            request_detection, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("perception") << "Failed to serialize request_detection.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return PerceptionResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
-        
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Failed to create gRPC stream: " 
-                      << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("perception") << "Failed to create gRPC stream: "
+                << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Failed to write Detection request" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("perception") << "Failed to write Detection request";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] Detection response received" << std::endl;
-            std::cout << "[✓] Response code: " << send_resp.ret().code() << std::endl;
-            std::cout << "[✓] Response message: " << send_resp.ret().message() << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("perception")
+                .Field("code", send_resp.ret().code())
+                .Field("message", send_resp.ret().message())
+                << "Detection response received";
 
             auto response_status = send_resp.ret();
             try {
                 res_status = static_cast<PerceptionResStatus>(std::stoi(response_status.code()));
             } catch (const std::invalid_argument& e) {
-                std::cerr << "Invalid response code: " << response_status.code() << std::endl;
+                KONKA_LOG_ERROR("perception") << "Invalid response code: "
+                    << response_status.code();
+                timer.Fail(MetricErrorCategory::kParse);
                 return PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
             }
 
             auto response_output = send_resp.output();
             auto data_it = response_output.keyvaluelist().find("data");
             if (data_it == response_output.keyvaluelist().end()) {
-                std::cerr << "'data' field not found in Detection response" << std::endl;
+                KONKA_LOG_ERROR("perception") << "'data' field not found in Detection response";
+                timer.Fail(MetricErrorCategory::kParse);
                 return res_status;
             }
 
@@ -99,22 +98,27 @@ PerceptionResStatus Detection(std::unique_ptr<InterfacesClient>& client,
             auto unserialize_status =
                 response_detection.ParseFromString(data_var.bytevalue());
             if (!unserialize_status) {
-                std::cerr << "Failed to unserialize response_detection" << std::endl;
+                KONKA_LOG_ERROR("perception") << "Failed to unserialize response_detection";
+                timer.Fail(MetricErrorCategory::kParse);
                 return PerceptionResStatus::ERROR_PARSE_FAILED;
             }
             
         } else {
-            std::cerr << "No Detection response received from server" << std::endl;
+            KONKA_LOG_ERROR("perception") << "No Detection response received from server";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         auto finish_status = stream->Finish();
-        std::cout << "[✓] Detection stream finished: " 
-                  << (finish_status.ok() ? "success" : "failed") << std::endl;
+        KONKA_LOG_DEBUG("perception") << "Detection stream finished: "
+            << (finish_status.ok() ? "success" : "failed");
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in Detection: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("perception") << "Exception in Detection: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
         res_status = PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
     }
     return res_status;
@@ -125,52 +129,45 @@ PerceptionResStatus Division(std::unique_ptr<InterfacesClient>& client,
                                 ResponseDivision& response_division)
 {    
     PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, PerceptionCommandCode::kDivision,
+                       "Division", "perception");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(PerceptionCommandCode::kDivision);
-            input_map->insert({"command_id", command_id});
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            auto serialize_status = request_division.SerializeToString(&serialize_data);
-            if (!serialize_status) {
-                std::cerr << "Serialize request_division failed." << std::endl;
-                return PerceptionResStatus::ERROR_PARSE_FAILED;
-            }
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_division"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            PerceptionCommandCode::kDivision, "request_division",
+            request_division, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("perception") << "Serialize request_division failed.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return PerceptionResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Create stream failed: " << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("perception") << "Create stream failed: " << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Write Division request failed" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("perception") << "Write Division request failed";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] Division response received" << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("perception") << "Division response received";
             res_status = static_cast<PerceptionResStatus>(std::stoi(send_resp.ret().code()));
 
             auto data_it = send_resp.output().keyvaluelist().find("data");
@@ -179,20 +176,25 @@ PerceptionResStatus Division(std::unique_ptr<InterfacesClient>& client,
                 auto unserialize_status =
                 response_division.ParseFromString(data_var.bytevalue());
                 if (!unserialize_status) {
-                    std::cerr << "Failed to unserialize response_division" << std::endl;
+                    KONKA_LOG_ERROR("perception") << "Failed to unserialize response_division";
+                    timer.Fail(MetricErrorCategory::kParse);
                     return PerceptionResStatus::ERROR_PARSE_FAILED;
                 }
             }
         } else {
-            std::cerr << "No Division response received" << std::endl;
+            KONKA_LOG_ERROR("perception") << "No Division response received";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         stream->Finish();
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in Division: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("perception") << "Exception in Division: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
     }
 
     return res_status;
@@ -203,52 +205,45 @@ PerceptionResStatus Perception(std::unique_ptr<InterfacesClient>& client,
                                 ResponsePerception& response_perception)
 {    
     PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+    RequestTimer timer(kMetricMethodSend, PerceptionCommandCode::kPerception,
+                       "Perception", "perception");
     SendRequest send_req;
     SendResponse send_resp;
 
     try {
-        auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
-        
-        {
-            Variant command_id;
-            command_id.set_int32value(PerceptionCommandCode::kPerception);
-            input_map->insert({"command_id", command_id});
-        }
-
-        {
-            Variant request_dict;
-            auto request_dict_map =
-                        request_dict.mutable_dictvalue()->mutable_keyvaluelist();
-            Variant request_params;
-            std::string serialize_data;
-            auto serialize_status = request_perception.SerializeToString(&serialize_data);
-            if (!serialize_status) {
-                std::cerr << "Serialize request_perception failed." << std::endl;
-                return PerceptionResStatus::ERROR_PARSE_FAILED;
-            }
-            request_params.set_bytevalue(serialize_data);
-            request_dict_map->insert(
-                std::make_pair(std::string("request_perception"), request_params));
-            input_map->insert(std::make_pair(std::string("data"), request_dict));
+        bool built = request_envelope::BuildSendRequest(
+            PerceptionCommandCode::kPerception, "request_perception",
+            request_perception, false, &send_req);
+        if (!built) {
+            KONKA_LOG_ERROR("perception") << "Serialize request_perception failed.";
+            timer.Fail(MetricErrorCategory::kParse);
+            return PerceptionResStatus::ERROR_PARSE_FAILED;
         }
+        timer.Mark(MetricPhase::kEnvelopeBuild);
 
         std::unique_ptr<grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
         std::unique_ptr<grpc::ClientContext> context;
         auto send_status = client->Send(stream, context, 10000);
+        timer.Mark(MetricPhase::kStreamOpen);
         if (!send_status) {
-            std::cerr << "Create stream failed: " << send_status.message() << std::endl;
+            KONKA_LOG_ERROR("perception") << "Create stream failed: " << send_status.message();
+            timer.Fail(send_status);
             return res_status;
         }
 
-        if (!stream->Write(send_req)) {
-            std::cerr << "Write Perception request failed" << std::endl;
+        bool written = stream->Write(send_req);
+        timer.Mark(MetricPhase::kWrite);
+        if (!written) {
+            KONKA_LOG_ERROR("perception") << "Write Perception request failed";
             stream->WritesDone();
-            stream->Finish();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
-        if (stream->Read(&send_resp)) {
-            std::cout << "[✓] Perception response received" << std::endl;
+        bool received = stream->Read(&send_resp);
+        timer.Mark(MetricPhase::kServerWait);
+        if (received) {
+            KONKA_LOG_DEBUG("perception") << "Perception response received";
             res_status = static_cast<PerceptionResStatus>(std::stoi(send_resp.ret().code()));
 
             auto data_it = send_resp.output().keyvaluelist().find("data");
@@ -257,21 +252,26 @@ PerceptionResStatus Perception(std::unique_ptr<InterfacesClient>& client,
                 auto unserialize_status = 
                 response_perception.ParseFromString(data_var.bytevalue());
                 if (!unserialize_status) {
-                    std::cerr << "Failed to unserialize response_perception" << std::endl;
+                    KONKA_LOG_ERROR("perception") << "Failed to unserialize response_perception";
+                    timer.Fail(MetricErrorCategory::kParse);
                     return PerceptionResStatus::ERROR_PARSE_FAILED;
                 }
                 }
             
         } else {
-            std::cerr << "No Perception response received" << std::endl;
+            KONKA_LOG_ERROR("perception") << "No Perception response received";
+            stream->WritesDone();
+            timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
             return res_status;
         }
 
+        timer.Mark(MetricPhase::kParse);
         stream->WritesDone();
         stream->Finish();
 
     } catch (const std::exception& e) {
-        std::cerr << "Exception in Perception: " << e.what() << std::endl;
+        KONKA_LOG_ERROR("perception") << "Exception in Perception: " << e.what();
+        timer.Fail(MetricErrorCategory::kParse);
     }
 
     return res_status;
@@ -279,5 +279,5 @@ PerceptionResStatus Perception(std::unique_ptr<InterfacesClient>& client,
 
 }  // namespace perception_api
 }  // namespace robot
-}  // namespace clientSDK
+}  // namespace konka_sdk
 }  // namespace humanoid_robot
@@ -0,0 +1,425 @@
+#include "robot/modules/perception_batch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "grpcpp/support/sync_stream.h"
+#include "robot/common/logger.h"
+#include "robot/common/metrics.h"
+#include "robot/modules/request_envelope.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+using request_envelope::kCommandIdKey;
+constexpr const char* kBatchKey = "batch";
+constexpr const char* kCountKey = "count";
+constexpr const char* kFramesKey = "frames";
+constexpr const char* kCameraIdKey = "camera_id";
+constexpr const char* kRequestDetectionKey = "request_detection";
+constexpr const char* kCodeKey = "code";
+
+using Variant = humanoid_robot::PB::common::Variant;
+using Clock = std::chrono::steady_clock;
+using RequestTimer = humanoid_robot::konka_sdk::common::RequestTimer;
+using MetricPhase = humanoid_robot::konka_sdk::common::MetricPhase;
+using MetricErrorCategory = humanoid_robot::konka_sdk::common::MetricErrorCategory;
+using MetricsRegistry = humanoid_robot::konka_sdk::common::MetricsRegistry;
+using humanoid_robot::konka_sdk::common::kMetricMethodSendBatch;
+
+struct PendingFrame {
+  std::string camera_id;
+  std::string payload;
+  BatchResultCallback callback;
+  Clock::time_point enqueue_time;
+};
+
+/**
+ * 将一组已序列化的帧打包为一个请求发送，results 与 frames 顺序一致
+ */
+PerceptionResStatus SendDetectionBatch(std::unique_ptr<InterfacesClient>& client,
+                                       std::vector<PendingFrame>& frames,
+                                       std::vector<BatchFrameResult>& results,
+                                       int64_t timeout_ms) {
+  results.assign(frames.size(), BatchFrameResult());
+  PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  RequestTimer timer(kMetricMethodSendBatch, PerceptionCommandCode::kDetection,
+                     "DetectionBatch", "perception");
+  MetricsRegistry::Instance().RecordBatchSize(
+      {kMetricMethodSendBatch, PerceptionCommandCode::kDetection}, frames.size());
+  try {
+    SendRequest send_req;
+    auto input_map = send_req.mutable_input()->mutable_keyvaluelist();
+    (*input_map)[kCommandIdKey].set_int32value(PerceptionCommandCode::kDetection);
+    auto batch_map =
+        (*input_map)[kBatchKey].mutable_dictvalue()->mutable_keyvaluelist();
+    (*batch_map)[kCountKey].set_int32value(static_cast<int32_t>(frames.size()));
+    auto frames_map =
+        (*batch_map)[kFramesKey].mutable_dictvalue()->mutable_keyvaluelist();
+    for (size_t i = 0; i < frames.size(); ++i) {
+      auto frame_map = (*frames_map)[std::to_string(i)]
+                           .mutable_dictvalue()
+                           ->mutable_keyvaluelist();
+      (*frame_map)[kCameraIdKey].set_stringvalue(frames[i].camera_id);
+      (*frame_map)[kRequestDetectionKey].mutable_bytevalue()->swap(
+          frames[i].payload);
+    }
+    timer.Mark(MetricPhase::kEnvelopeBuild);
+
+    std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
+    std::unique_ptr<grpc::ClientContext> context;
+    auto send_status = client->Send(stream, context, timeout_ms);
+    timer.Mark(MetricPhase::kStreamOpen);
+    if (!send_status) {
+      KONKA_LOG_ERROR("perception") << "Create stream failed: "
+                                    << send_status.message();
+      timer.Fail(send_status);
+      return res_status;
+    }
+
+    bool written = stream->Write(send_req);
+    timer.Mark(MetricPhase::kWrite);
+    if (!written) {
+      KONKA_LOG_ERROR("perception") << "Write Detection batch failed";
+      stream->WritesDone();
+      timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
+      return res_status;
+    }
+
+    SendResponse send_resp;
+    bool received = stream->Read(&send_resp);
+    timer.Mark(MetricPhase::kServerWait);
+    if (!received) {
+      KONKA_LOG_ERROR("perception") << "No Detection batch response received";
+      stream->WritesDone();
+      timer.Fail(InterfacesClient::ConvertGrpcStatus(stream->Finish()));
+      return res_status;
+    }
+    stream->WritesDone();
+    stream->Finish();
+
+    try {
+      res_status =
+          static_cast<PerceptionResStatus>(std::stoi(send_resp.ret().code()));
+    } catch (const std::invalid_argument&) {
+      KONKA_LOG_ERROR("perception") << "Invalid response code: "
+                                    << send_resp.ret().code();
+      timer.Fail(MetricErrorCategory::kParse);
+      return PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+    }
+
+    const auto& output = send_resp.output().keyvaluelist();
+    auto batch_it = output.find(kBatchKey);
+    if (batch_it == output.end()) {
+      KONKA_LOG_ERROR("perception")
+          << "'batch' field not found in Detection batch response";
+      timer.Fail(MetricErrorCategory::kParse);
+      for (auto& result : results) {
+        result.status = res_status;
+      }
+      return res_status;
+    }
+
+    const auto& result_map = batch_it->second.dictvalue().keyvaluelist();
+    bool parse_failed = false;
+    for (size_t i = 0; i < results.size(); ++i) {
+      auto frame_it = result_map.find(std::to_string(i));
+      if (frame_it == result_map.end()) {
+        continue;
+      }
+      const auto& frame_result = frame_it->second.dictvalue().keyvaluelist();
+      auto code_it = frame_result.find(kCodeKey);
+      results[i].status =
+          code_it == frame_result.end()
+              ? res_status
+              : static_cast<PerceptionResStatus>(code_it->second.int32value());
+      if (request_envelope::ParseDictData(frame_result, &results[i].detection) ==
+          request_envelope::ParseResult::kParseFailed) {
+        results[i].status = PerceptionResStatus::ERROR_PARSE_FAILED;
+        parse_failed = true;
+      }
+    }
+    // 一批只记一次失败，避免按帧数放大错误计数
+    if (parse_failed) {
+      timer.Fail(MetricErrorCategory::kParse);
+    }
+    timer.Mark(MetricPhase::kParse);
+  } catch (const std::exception& e) {
+    KONKA_LOG_ERROR("perception") << "Exception in Detection batch: "
+                                  << e.what();
+    res_status = PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+  }
+  return res_status;
+}
+
+/**
+ * 调用单帧回调，异常只记录不外抛，避免终止攒批线程
+ * @return 回调抛出异常时返回false
+ */
+bool InvokeCallback(const BatchResultCallback& callback,
+                    const BatchFrameResult& result) {
+  if (!callback) {
+    return true;
+  }
+  try {
+    callback(result);
+    return true;
+  } catch (const std::exception& e) {
+    KONKA_LOG_ERROR("perception") << "Error in batch result callback: "
+                                  << e.what();
+  } catch (...) {
+    KONKA_LOG_ERROR("perception") << "Unknown error in batch result callback";
+  }
+  return false;
+}
+}  // namespace
+
+PerceptionResStatus DetectionBatch(std::unique_ptr<InterfacesClient>& client,
+                                   const std::vector<BatchFrame>& frames,
+                                   std::vector<BatchFrameResult>& results,
+                                   const BatchOptions& options) {
+  results.clear();
+  results.reserve(frames.size());
+  PerceptionResStatus first_error = PerceptionResStatus::RESPONSE_SUCCESS;
+  size_t max_frames = options.max_batch_frames > 0 ? options.max_batch_frames : 1;
+
+  std::vector<PendingFrame> batch;
+  std::vector<BatchFrameResult> batch_results;
+  size_t batch_bytes = 0;
+  auto send = [&]() {
+    SendDetectionBatch(client, batch, batch_results, options.timeout_ms);
+    for (auto& result : batch_results) {
+      if (result.status != PerceptionResStatus::RESPONSE_SUCCESS &&
+          first_error == PerceptionResStatus::RESPONSE_SUCCESS) {
+        first_error = result.status;
+      }
+      results.push_back(std::move(result));
+    }
+    batch.clear();
+    batch_bytes = 0;
+  };
+
+  for (const auto& frame : frames) {
+    PendingFrame pending;
+    pending.camera_id = frame.camera_id;
+    if (!frame.request.SerializeToString(&pending.payload)) {
+      KONKA_LOG_ERROR("perception") << "Failed to serialize request_detection.";
+      return PerceptionResStatus::ERROR_PARSE_FAILED;
+    }
+    if (!batch.empty() &&
+        batch_bytes + pending.payload.size() > options.max_batch_bytes) {
+      send();
+    }
+    batch_bytes += pending.payload.size();
+    batch.push_back(std::move(pending));
+    if (batch.size() >= max_frames) {
+      send();
+    }
+  }
+  if (!batch.empty()) {
+    send();
+  }
+  return first_error;
+}
+
+class PerceptionBatcher::Impl {
+public:
+  Impl(std::unique_ptr<InterfacesClient>& client, BatchOptions options)
+      : client_(client), options_(options) {
+    if (options_.max_batch_frames == 0) {
+      options_.max_batch_frames = 1;
+    }
+    batch_size_counts_.assign(options_.max_batch_frames + 1, 0);
+    worker_ = std::thread([this]() { FlushLoop(); });
+  }
+
+  ~Impl() { Stop(); }
+
+  Status Submit(const std::string& camera_id,
+                const RequestDetection& request_detection,
+                BatchResultCallback callback) {
+    PendingFrame pending;
+    pending.camera_id = camera_id;
+    pending.callback = std::move(callback);
+    if (!request_detection.SerializeToString(&pending.payload)) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Failed to serialize request_detection");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return Status(std::make_error_code(std::errc::operation_not_permitted),
+                    "PerceptionBatcher is stopped");
+    }
+    pending.enqueue_time = Clock::now();
+    pending_bytes_ += pending.payload.size();
+    pending_.push_back(std::move(pending));
+    // 队列由空变为非空时唤醒攒批线程开始 max_delay_ms 计时
+    if (pending_.size() == 1 || SizeReached()) {
+      cv_.notify_all();
+    }
+    return Status();
+  }
+
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = ++flush_requests_;
+    cv_.notify_all();
+    cv_.wait(lock, [this, target]() { return flushed_ >= target || exited_; });
+  }
+
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+      cv_.notify_all();
+    }
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+  }
+
+  BatchStats GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    BatchStats stats = stats_;
+    stats.batch_size_counts = batch_size_counts_;
+    stats.mean_batch_size =
+        stats.batches == 0
+            ? 0.0
+            : static_cast<double>(stats.frames) / static_cast<double>(stats.batches);
+    return stats;
+  }
+
+private:
+  bool SizeReached() const {
+    return pending_.size() >= options_.max_batch_frames ||
+           pending_bytes_ >= options_.max_batch_bytes;
+  }
+
+  // 从待发队列取出一批（不超过 max_batch_frames），需持有锁
+  std::vector<PendingFrame> TakeBatch() {
+    std::vector<PendingFrame> batch;
+    size_t count = std::min(pending_.size(), options_.max_batch_frames);
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+      if (i > 0 && bytes + pending_[i].payload.size() > options_.max_batch_bytes) {
+        break;
+      }
+      bytes += pending_[i].payload.size();
+      batch.push_back(std::move(pending_[i]));
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + batch.size());
+    pending_bytes_ -= bytes;
+    return batch;
+  }
+
+  void FlushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      bool time_flush = false;
+      if (!stopping_ && flush_requests_ == flushed_ && !SizeReached()) {
+        if (pending_.empty()) {
+          cv_.wait(lock);
+          continue;
+        }
+        auto deadline = pending_.front().enqueue_time + std::chrono::milliseconds(options_.max_delay_ms);
+        if (cv_.wait_until(lock, deadline) != std::cv_status::timeout) {
+          continue;
+        }
+        time_flush = true;
+      }
+
+      if (pending_.empty()) {
+        flushed_ = flush_requests_;
+        cv_.notify_all();
+        if (stopping_) {
+          break;
+        }
+        continue;
+      }
+
+      bool size_flush = !time_flush && SizeReached();
+      uint64_t flush_target = flush_requests_;
+      std::vector<PendingFrame> batch = TakeBatch();
+      lock.unlock();
+
+      std::vector<BatchFrameResult> results;
+      auto batch_status =
+          SendDetectionBatch(client_, batch, results, options_.timeout_ms);
+      uint64_t callback_errors = 0;
+      for (size_t i = 0; i < batch.size(); ++i) {
+        if (!InvokeCallback(batch[i].callback, results[i])) {
+          ++callback_errors;
+        }
+      }
+
+      lock.lock();
+      stats_.callback_errors += callback_errors;
+      ++stats_.batches;
+      stats_.frames += batch.size();
+      if (size_flush) {
+        ++stats_.size_flushes;
+      } else if (time_flush) {
+        ++stats_.time_flushes;
+      }
+      if (batch_status != PerceptionResStatus::RESPONSE_SUCCESS) {
+        ++stats_.failed_batches;
+      }
+      ++batch_size_counts_[batch.size()];
+      if (pending_.empty() && flushed_ < flush_target) {
+        flushed_ = flush_target;
+        cv_.notify_all();
+      }
+    }
+    exited_ = true;
+    cv_.notify_all();
+  }
+
+  std::unique_ptr<InterfacesClient>& client_;
+  BatchOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<PendingFrame> pending_;
+  size_t pending_bytes_ = 0;
+  uint64_t flush_requests_ = 0;
+  uint64_t flushed_ = 0;
+  bool stopping_ = false;
+  bool exited_ = false;
+
+  BatchStats stats_;
+  std::vector<uint64_t> batch_size_counts_;
+  std::thread worker_;
+};
+
+PerceptionBatcher::PerceptionBatcher(std::unique_ptr<InterfacesClient>& client,
+                                     BatchOptions options)
+    : pImpl_(std::make_unique<Impl>(client, options)) {}
+
+PerceptionBatcher::~PerceptionBatcher() = default;
+
+Status PerceptionBatcher::Submit(const std::string& camera_id,
+                                 const RequestDetection& request_detection,
+                                 BatchResultCallback callback) {
+  return pImpl_->Submit(camera_id, request_detection, std::move(callback));
+}
+
+void PerceptionBatcher::Flush() { pImpl_->Flush(); }
+
+void PerceptionBatcher::Stop() { pImpl_->Stop(); }
+
+BatchStats PerceptionBatcher::GetStats() const { return pImpl_->GetStats(); }
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,351 @@
+#include "robot/modules/perception_fanout.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/variant.pb.h"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
+#include "google/protobuf/wire_format_lite.h"
+#include "grpcpp/support/sync_stream.h"
+#include "robot/common/logger.h"
+#include "robot/modules/request_envelope.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+// 常驻扇出线程数：三个分析中调用线程执行一个，其余最多两个并行
+constexpr size_t kFanOutWorkers = 2;
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::internal::WireFormatLite;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * 把 image 作为 image_field 字段追加在已序列化的请求末尾
+ */
+bool AppendImage(const google::protobuf::Message& request,
+                 const std::string& image, const std::string& image_field,
+                 std::string* out) {
+  if (image.empty()) {
+    return true;
+  }
+  const FieldDescriptor* field =
+      request.GetDescriptor()->FindFieldByName(image_field);
+  if (field == nullptr || field->is_repeated() ||
+      field->type() != FieldDescriptor::TYPE_BYTES) {
+    KONKA_LOG_ERROR("perception")
+        << request.GetDescriptor()->full_name() << " has no bytes field '"
+        << image_field << "' for the frame image";
+    return false;
+  }
+  out->reserve(out->size() + image.size() + 16);
+  google::protobuf::io::StringOutputStream raw_output(out);
+  google::protobuf::io::CodedOutputStream coded_output(&raw_output);
+  WireFormatLite::WriteBytes(field->number(), image, &coded_output);
+  coded_output.Trim();
+  return !coded_output.HadError();
+}
+
+/**
+ * 一次扇出调用中交给常驻线程的分析任务
+ *
+ * claimed 保证任务只执行一次：调用线程做完自己的分析后会收回尚未被
+ * 工作线程取走的任务直接执行，线程池繁忙时不会排队等待。
+ */
+struct FanOutJob {
+  std::function<void()> task;
+  std::atomic<bool> claimed{false};
+  std::mutex* mutex = nullptr;
+  std::condition_variable* done_cv = nullptr;
+  size_t* pending = nullptr;
+
+  void TryRun() {
+    if (claimed.exchange(true, std::memory_order_acq_rel)) {
+      return;
+    }
+    task();
+    std::lock_guard<std::mutex> lock(*mutex);
+    if (--*pending == 0) {
+      done_cv->notify_all();
+    }
+  }
+};
+
+/**
+ * 进程内共享的常驻扇出线程，避免每帧创建线程
+ */
+class FanOutWorkers {
+public:
+  static FanOutWorkers& Instance() {
+    // 有意不释放：避免在静态析构阶段 join 仍可能被使用的线程
+    static auto* workers = new FanOutWorkers(kFanOutWorkers);
+    return *workers;
+  }
+
+  void Post(std::shared_ptr<FanOutJob> job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+    cv_.notify_one();
+  }
+
+private:
+  explicit FanOutWorkers(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+      std::thread([this]() { WorkerLoop(); }).detach();
+    }
+  }
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      cv_.wait(lock, [this]() { return !jobs_.empty(); });
+      auto job = std::move(jobs_.front());
+      jobs_.pop_front();
+      lock.unlock();
+      job->TryRun();
+      job.reset();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::shared_ptr<FanOutJob>> jobs_;
+};
+
+template <typename RequestType, typename ResultType>
+PerceptionResStatus RunAnalysis(std::unique_ptr<InterfacesClient>& client,
+                                PerceptionCommandCode command_id,
+                                const char* request_key,
+                                const RequestType& request,
+                                const std::string& image,
+                                const FanOutOptions& options,
+                                ResultType& result) {
+  PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+  try {
+    SendRequest send_req;
+    bool built = request_envelope::BuildSendRequest(command_id, request_key,
+                                                    request, false, &send_req);
+    if (built) {
+      std::string* payload =
+          (*(*send_req.mutable_input()
+                  ->mutable_keyvaluelist())[request_envelope::kDataKey]
+                .mutable_dictvalue()
+                ->mutable_keyvaluelist())[request_key]
+              .mutable_bytevalue();
+      built = AppendImage(request, image, options.image_field, payload);
+    }
+    if (!built) {
+      KONKA_LOG_ERROR("perception") << "Failed to serialize " << request_key;
+      return PerceptionResStatus::ERROR_PARSE_FAILED;
+    }
+
+    std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>> stream;
+    std::unique_ptr<grpc::ClientContext> context;
+    auto send_status = client->Send(stream, context, options.timeout_ms);
+    if (!send_status) {
+      KONKA_LOG_ERROR("perception") << "Create stream failed: "
+                                    << send_status.message();
+      return res_status;
+    }
+
+    if (!stream->Write(send_req)) {
+      KONKA_LOG_ERROR("perception") << "Write " << request_key << " failed";
+      stream->WritesDone();
+      stream->Finish();
+      return res_status;
+    }
+
+    SendResponse send_resp;
+    if (!stream->Read(&send_resp)) {
+      KONKA_LOG_ERROR("perception") << "No response received for "
+                                    << request_key;
+      return res_status;
+    }
+    stream->WritesDone();
+    stream->Finish();
+
+    try {
+      res_status =
+          static_cast<PerceptionResStatus>(std::stoi(send_resp.ret().code()));
+    } catch (const std::invalid_argument&) {
+      KONKA_LOG_ERROR("perception") << "Invalid response code: "
+                                    << send_resp.ret().code();
+      return PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+    }
+
+    if (request_envelope::ParseResponseData(send_resp, &result) ==
+        request_envelope::ParseResult::kParseFailed) {
+      KONKA_LOG_ERROR("perception") << "Failed to unserialize response of "
+                                    << request_key;
+      return PerceptionResStatus::ERROR_PARSE_FAILED;
+    }
+  } catch (const std::exception& e) {
+    KONKA_LOG_ERROR("perception") << "Exception in " << request_key << ": "
+                                  << e.what();
+    res_status = PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+  }
+  return res_status;
+}
+
+/**
+ * 调用用户回调，异常只记录不外抛（工作线程上的异常会终止进程）
+ * @return 回调抛出异常时返回false
+ */
+template <typename ResultType>
+bool InvokeCallback(
+    const std::function<void(PerceptionResStatus, const ResultType&)>& callback,
+    const char* name, PerceptionResStatus status, const ResultType& result) {
+  if (!callback) {
+    return true;
+  }
+  try {
+    callback(status, result);
+    return true;
+  } catch (const std::exception& e) {
+    KONKA_LOG_ERROR("perception") << "Error in " << name
+                                  << " callback: " << e.what();
+  } catch (...) {
+    KONKA_LOG_ERROR("perception") << "Unknown error in " << name
+                                  << " callback";
+  }
+  return false;
+}
+}  // namespace
+
+PerceptionResStatus PerceptionFanOut(std::unique_ptr<InterfacesClient>& client,
+                                     const PerceptionFrameRequests& requests,
+                                     const std::string& image,
+                                     uint32_t analyses,
+                                     PerceptionFanOutResult& result,
+                                     const PerceptionFanOutCallbacks* callbacks,
+                                     const FanOutOptions& options) {
+  result = PerceptionFanOutResult();
+  PerceptionFanOutCallbacks no_callbacks;
+  const PerceptionFanOutCallbacks& on_result =
+      callbacks != nullptr ? *callbacks : no_callbacks;
+  std::mutex result_mutex;
+
+  std::vector<std::function<void()>> tasks;
+  if (analyses & kAnalysisDetection) {
+    tasks.push_back([&]() {
+      int64_t start_us = NowUs();
+      ResponseDetection detection;
+      auto status = RunAnalysis(client, PerceptionCommandCode::kDetection,
+                                "request_detection", requests.detection, image,
+                                options, detection);
+      int64_t elapsed_us = NowUs() - start_us;
+      bool callback_ok = InvokeCallback(on_result.on_detection, "detection",
+                                        status, detection);
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.detection_status = status;
+      result.detection = std::move(detection);
+      result.detection_us = elapsed_us;
+      result.completed |= kAnalysisDetection;
+      result.callback_errors += callback_ok ? 0 : 1;
+    });
+  }
+  if (analyses & kAnalysisDivision) {
+    tasks.push_back([&]() {
+      int64_t start_us = NowUs();
+      ResponseDivision division;
+      auto status = RunAnalysis(client, PerceptionCommandCode::kDivision,
+                                "request_division", requests.division, image,
+                                options, division);
+      int64_t elapsed_us = NowUs() - start_us;
+      bool callback_ok = InvokeCallback(on_result.on_division, "division",
+                                        status, division);
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.division_status = status;
+      result.division = std::move(division);
+      result.division_us = elapsed_us;
+      result.completed |= kAnalysisDivision;
+      result.callback_errors += callback_ok ? 0 : 1;
+    });
+  }
+  if (analyses & kAnalysisPerception) {
+    tasks.push_back([&]() {
+      int64_t start_us = NowUs();
+      ResponsePerception perception;
+      auto status = RunAnalysis(client, PerceptionCommandCode::kPerception,
+                                "request_perception", requests.perception,
+                                image, options, perception);
+      int64_t elapsed_us = NowUs() - start_us;
+      bool callback_ok = InvokeCallback(on_result.on_perception, "perception",
+                                        status, perception);
+      std::lock_guard<std::mutex> lock(result_mutex);
+      result.perception_status = status;
+      result.perception = std::move(perception);
+      result.perception_us = elapsed_us;
+      result.completed |= kAnalysisPerception;
+      result.callback_errors += callback_ok ? 0 : 1;
+    });
+  }
+
+  int64_t start_us = NowUs();
+  if (options.concurrent && tasks.size() > 1) {
+    // 调用线程执行最后一个分析，其余分析交给常驻线程
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_t pending = tasks.size() - 1;
+    std::vector<std::shared_ptr<FanOutJob>> jobs;
+    for (size_t i = 0; i + 1 < tasks.size(); ++i) {
+      auto job = std::make_shared<FanOutJob>();
+      job->task = tasks[i];
+      job->mutex = &done_mutex;
+      job->done_cv = &done_cv;
+      job->pending = &pending;
+      jobs.push_back(job);
+      FanOutWorkers::Instance().Post(std::move(job));
+    }
+    tasks.back()();
+    for (auto& job : jobs) {
+      job->TryRun();
+    }
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [&pending]() { return pending == 0; });
+  } else {
+    for (auto& task : tasks) {
+      task();
+    }
+  }
+  result.wall_us = NowUs() - start_us;
+  result.sequential_us =
+      result.detection_us + result.division_us + result.perception_us;
+
+  if ((result.completed & kAnalysisDetection) &&
+      result.detection_status != PerceptionResStatus::RESPONSE_SUCCESS) {
+    return result.detection_status;
+  }
+  if ((result.completed & kAnalysisDivision) &&
+      result.division_status != PerceptionResStatus::RESPONSE_SUCCESS) {
+    return result.division_status;
+  }
+  if ((result.completed & kAnalysisPerception) &&
+      result.perception_status != PerceptionResStatus::RESPONSE_SUCCESS) {
+    return result.perception_status;
+  }
+  return tasks.empty() ? PerceptionResStatus::ERROR_DATA_GET_FAILED
+                       : PerceptionResStatus::RESPONSE_SUCCESS;
+}
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
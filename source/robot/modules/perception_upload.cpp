@@ -0,0 +1,482 @@
+#include "robot/modules/perception_upload.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "google/protobuf/io/zero_copy_stream.h"
+#include "grpcpp/support/sync_stream.h"
+#include "robot/common/logger.h"
+#include "robot/modules/request_envelope.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace robot {
+namespace perception_api {
+
+namespace {
+using request_envelope::kCommandIdKey;
+using request_envelope::kDataKey;
+constexpr const char* kChunkKey = "chunk";
+constexpr const char* kUploadIdKey = "upload_id";
+constexpr const char* kChunkIndexKey = "chunk_index";
+constexpr const char* kTotalSizeKey = "total_size";
+constexpr const char* kLastKey = "last";
+
+using Variant = humanoid_robot::PB::common::Variant;
+using GrpcStreamPtr =
+    std::unique_ptr<::grpc::ClientReaderWriter<SendRequest, SendResponse>>;
+using GrpcContextPtr = std::unique_ptr<grpc::ClientContext>;
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/**
+ * 分块缓冲管道：固定数量的缓冲在序列化线程与发送线程之间循环使用
+ */
+class ChunkPipe {
+public:
+  struct Chunk {
+    std::string data;
+    bool last = false;
+  };
+
+  ChunkPipe(size_t chunk_size, size_t buffer_count) : chunk_size_(chunk_size) {
+    for (size_t i = 0; i < buffer_count; ++i) {
+      std::string buffer;
+      buffer.reserve(chunk_size);
+      free_.push_back(std::move(buffer));
+    }
+    total_buffers_ = buffer_count;
+  }
+
+  void Reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!ready_.empty()) {
+      free_.push_back(std::move(ready_.front().data));
+      ready_.pop_front();
+    }
+    aborted_ = false;
+    failed_ = false;
+    peak_in_use_ = 0;
+  }
+
+  // 序列化线程：获取空闲缓冲，管道中止时返回false
+  bool Acquire(std::string& buffer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    free_cv_.wait(lock, [this]() { return aborted_ || !free_.empty(); });
+    if (aborted_) {
+      return false;
+    }
+    buffer = std::move(free_.front());
+    free_.pop_front();
+    size_t in_use = total_buffers_ - free_.size();
+    if (in_use > peak_in_use_) {
+      peak_in_use_ = in_use;
+    }
+    return true;
+  }
+
+  void PushReady(std::string&& buffer, bool last) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready_.push_back(Chunk{std::move(buffer), last});
+    ready_cv_.notify_one();
+  }
+
+  void Fail() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    failed_ = true;
+    ready_cv_.notify_one();
+  }
+
+  // 发送线程：获取下一个待发送分块，序列化失败时返回false
+  bool PopReady(Chunk& chunk) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait(lock, [this]() { return failed_ || !ready_.empty(); });
+    if (ready_.empty()) {
+      return false;
+    }
+    chunk = std::move(ready_.front());
+    ready_.pop_front();
+    return true;
+  }
+
+  void Release(std::string&& buffer) {
+    buffer.clear();
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(std::move(buffer));
+    free_cv_.notify_one();
+  }
+
+  void Abort() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    aborted_ = true;
+    free_cv_.notify_all();
+  }
+
+  size_t chunk_size() const { return chunk_size_; }
+
+  uint64_t PeakBufferedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<uint64_t>(peak_in_use_) * chunk_size_;
+  }
+
+private:
+  const size_t chunk_size_;
+  size_t total_buffers_ = 0;
+  mutable std::mutex mutex_;
+  std::condition_variable free_cv_;
+  std::condition_variable ready_cv_;
+  std::deque<std::string> free_;
+  std::deque<Chunk> ready_;
+  bool aborted_ = false;
+  bool failed_ = false;
+  size_t peak_in_use_ = 0;
+};
+
+/**
+ * 将 protobuf 序列化结果直接写入分块缓冲的零拷贝输出流
+ */
+class ChunkOutputStream : public google::protobuf::io::ZeroCopyOutputStream {
+public:
+  explicit ChunkOutputStream(ChunkPipe& pipe) : pipe_(pipe) {}
+
+  // 序列化中途失败时手里的缓冲还没交出，归还给管道，避免缓冲池永久缩小
+  ~ChunkOutputStream() override {
+    if (has_buffer_) {
+      pipe_.Release(std::move(buffer_));
+    }
+  }
+
+  bool Next(void** data, int* size) override {
+    if (has_buffer_ && position_ == pipe_.chunk_size()) {
+      pipe_.PushReady(std::move(buffer_), false);
+      has_buffer_ = false;
+    }
+    if (!has_buffer_) {
+      if (!pipe_.Acquire(buffer_)) {
+        return false;
+      }
+      buffer_.resize(pipe_.chunk_size());
+      position_ = 0;
+      has_buffer_ = true;
+    }
+    *data = &buffer_[position_];
+    *size = static_cast<int>(pipe_.chunk_size() - position_);
+    byte_count_ += *size;
+    position_ = pipe_.chunk_size();
+    return true;
+  }
+
+  void BackUp(int count) override {
+    position_ -= static_cast<size_t>(count);
+    byte_count_ -= count;
+  }
+
+  int64_t ByteCount() const override { return byte_count_; }
+
+  // 提交最后一个分块（可能为空）
+  bool Finish() {
+    if (!has_buffer_ && !pipe_.Acquire(buffer_)) {
+      return false;
+    }
+    buffer_.resize(has_buffer_ ? position_ : 0);
+    has_buffer_ = false;
+    pipe_.PushReady(std::move(buffer_), true);
+    return true;
+  }
+
+private:
+  ChunkPipe& pipe_;
+  std::string buffer_;
+  size_t position_ = 0;
+  bool has_buffer_ = false;
+  int64_t byte_count_ = 0;
+};
+}  // namespace
+
+class ChunkedUploader::Impl {
+public:
+  Impl(std::unique_ptr<InterfacesClient>& client, ChunkedUploadOptions options)
+      : client_(client),
+        options_(options),
+        pipe_(options.chunk_size > 0 ? options.chunk_size : 1,
+              options.max_inflight_chunks > 1 ? options.max_inflight_chunks
+                                              : 2) {
+    worker_ = std::thread([this]() { WorkerLoop(); });
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(job_mutex_);
+      stopping_ = true;
+      job_cv_.notify_all();
+    }
+    pipe_.Abort();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+    Close();
+  }
+
+  void Close() {
+    if (stream_) {
+      stream_->WritesDone();
+      stream_->Finish();
+    }
+    stream_.reset();
+    context_.reset();
+  }
+
+  template <typename RequestType, typename ResultType>
+  using SingleSend = PerceptionResStatus (*)(std::unique_ptr<InterfacesClient>&,
+                                             const RequestType&, ResultType&);
+
+  template <typename RequestType, typename ResultType>
+  PerceptionResStatus Upload(PerceptionCommandCode command_id,
+                             const char* request_key,
+                             const RequestType& request, ResultType& result,
+                             SingleSend<RequestType, ResultType> fallback) {
+    if (!client_->HasCapability(kChunkedUploadCapability)) {
+      // 服务端不支持分块协议，整条请求走普通 Send
+      int64_t start_us = NowUs();
+      PerceptionResStatus status = fallback(client_, request, result);
+      last_stats_ = ChunkedUploadStats();
+      last_stats_.total_bytes = static_cast<uint64_t>(request.ByteSizeLong());
+      last_stats_.upload_us = NowUs() - start_us;
+      return status;
+    }
+
+    PerceptionResStatus res_status = PerceptionResStatus::ERROR_DATA_GET_FAILED;
+    try {
+      if (!EnsureStream()) {
+        return res_status;
+      }
+
+      pipe_.Reset();
+      uint64_t upload_id = ++upload_id_;
+      int64_t total_size = static_cast<int64_t>(request.ByteSizeLong());
+      int64_t start_us = NowUs();
+
+      // 后台线程序列化，调用线程发送
+      SubmitJob([this, &request]() {
+        ChunkOutputStream out(pipe_);
+        if (!request.SerializeToZeroCopyStream(&out) || !out.Finish()) {
+          pipe_.Fail();
+        }
+      });
+
+      SendRequest chunk_req;
+      auto input_map = chunk_req.mutable_input()->mutable_keyvaluelist();
+      (*input_map)[kCommandIdKey].set_int32value(command_id);
+      auto chunk_map =
+          (*input_map)[kChunkKey].mutable_dictvalue()->mutable_keyvaluelist();
+      (*chunk_map)[kUploadIdKey].set_int64value(
+          static_cast<int64_t>(upload_id));
+      (*chunk_map)[kTotalSizeKey].set_int64value(total_size);
+      std::string* chunk_bytes =
+          (*(*input_map)[kDataKey].mutable_dictvalue()->mutable_keyvaluelist())
+              [request_key]
+                  .mutable_bytevalue();
+
+      bool write_ok = true;
+      uint64_t chunk_count = 0;
+      ChunkPipe::Chunk chunk;
+      while (pipe_.PopReady(chunk)) {
+        (*chunk_map)[kChunkIndexKey].set_int64value(
+            static_cast<int64_t>(chunk_count));
+        (*chunk_map)[kLastKey].set_boolvalue(chunk.last);
+        // 交换而非拷贝：分块缓冲临时借给信封，写完后归还
+        chunk_bytes->swap(chunk.data);
+        write_ok = stream_->Write(chunk_req);
+        chunk_bytes->swap(chunk.data);
+        pipe_.Release(std::move(chunk.data));
+        ++chunk_count;
+        if (!write_ok || chunk.last) {
+          break;
+        }
+      }
+      if (!write_ok) {
+        pipe_.Abort();
+      }
+      WaitJob();
+
+      int64_t written_us = NowUs();
+      last_stats_ = ChunkedUploadStats();
+      last_stats_.total_bytes = static_cast<uint64_t>(total_size);
+      last_stats_.chunks = chunk_count;
+      last_stats_.peak_buffered_bytes = pipe_.PeakBufferedBytes();
+      last_stats_.upload_us = written_us - start_us;
+
+      if (!write_ok || !chunk.last) {
+        KONKA_LOG_ERROR("perception")
+            << "Failed to upload perception request chunks";
+        ResetStream();
+        return res_status;
+      }
+
+      SendResponse send_resp;
+      if (!stream_->Read(&send_resp)) {
+        KONKA_LOG_ERROR("perception")
+            << "No perception response received for chunked upload";
+        ResetStream();
+        return res_status;
+      }
+      last_stats_.response_us = NowUs() - written_us;
+
+      res_status = ParseResponse(send_resp, result);
+    } catch (const std::exception& e) {
+      KONKA_LOG_ERROR("perception")
+          << "Exception in chunked perception upload: " << e.what();
+      res_status = PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+    }
+    return res_status;
+  }
+
+  ChunkedUploadStats last_stats_;
+
+private:
+  bool EnsureStream() {
+    if (stream_) {
+      return true;
+    }
+    auto send_status =
+        client_->Send(stream_, context_, options_.stream_timeout_ms);
+    if (!send_status) {
+      KONKA_LOG_ERROR("perception") << "Failed to create upload stream: "
+                                    << send_status.message();
+      stream_.reset();
+      context_.reset();
+      return false;
+    }
+    return true;
+  }
+
+  void ResetStream() {
+    if (context_) {
+      context_->TryCancel();
+    }
+    if (stream_) {
+      stream_->Finish();
+    }
+    stream_.reset();
+    context_.reset();
+  }
+
+  template <typename ResultType>
+  PerceptionResStatus ParseResponse(const SendResponse& send_resp,
+                                    ResultType& result) {
+    PerceptionResStatus res_status;
+    try {
+      res_status =
+          static_cast<PerceptionResStatus>(std::stoi(send_resp.ret().code()));
+    } catch (const std::exception&) {
+      KONKA_LOG_ERROR("perception") << "Invalid response code: "
+                                    << send_resp.ret().code();
+      return PerceptionResStatus::ERROR_UNKNOWN_SERVICE;
+    }
+
+    switch (request_envelope::ParseResponseData(send_resp, &result)) {
+      case request_envelope::ParseResult::kOk:
+      case request_envelope::ParseResult::kDataNotFound:
+        return res_status;
+      case request_envelope::ParseResult::kParseFailed:
+        break;
+    }
+    KONKA_LOG_ERROR("perception")
+        << "Failed to unserialize perception response";
+    return PerceptionResStatus::ERROR_PARSE_FAILED;
+  }
+
+  void SubmitJob(std::function<void()> job) {
+    std::lock_guard<std::mutex> lock(job_mutex_);
+    job_ = std::move(job);
+    job_done_ = false;
+    job_cv_.notify_all();
+  }
+
+  void WaitJob() {
+    std::unique_lock<std::mutex> lock(job_mutex_);
+    job_cv_.wait(lock, [this]() { return job_done_; });
+  }
+
+  void WorkerLoop() {
+    std::unique_lock<std::mutex> lock(job_mutex_);
+    for (;;) {
+      job_cv_.wait(lock, [this]() { return stopping_ || job_; });
+      if (stopping_) {
+        return;
+      }
+      auto job = std::move(job_);
+      job_ = nullptr;
+      lock.unlock();
+      job();
+      lock.lock();
+      job_done_ = true;
+      job_cv_.notify_all();
+    }
+  }
+
+  std::unique_ptr<InterfacesClient>& client_;
+  ChunkedUploadOptions options_;
+  ChunkPipe pipe_;
+  GrpcStreamPtr stream_;
+  GrpcContextPtr context_;
+  uint64_t upload_id_ = 0;
+
+  std::thread worker_;
+  std::mutex job_mutex_;
+  std::condition_variable job_cv_;
+  std::function<void()> job_;
+  bool job_done_ = true;
+  bool stopping_ = false;
+};
+
+ChunkedUploader::ChunkedUploader(std::unique_ptr<InterfacesClient>& client,
+                                 ChunkedUploadOptions options)
+    : pImpl_(std::make_unique<Impl>(client, options)) {}
+
+ChunkedUploader::~ChunkedUploader() = default;
+
+PerceptionResStatus ChunkedUploader::Detection(
+    const RequestDetection& request_detection,
+    ResponseDetection& response_detection) {
+  return pImpl_->Upload(PerceptionCommandCode::kDetection, "request_detection",
+                        request_detection, response_detection,
+                        &perception_api::Detection);
+}
+
+PerceptionResStatus ChunkedUploader::Division(
+    const RequestDivision& request_division,
+    ResponseDivision& response_division) {
+  return pImpl_->Upload(PerceptionCommandCode::kDivision, "request_division",
+                        request_division, response_division,
+                        &perception_api::Division);
+}
+
+PerceptionResStatus ChunkedUploader::Perception(
+    const RequestPerception& request_perception,
+    ResponsePerception& response_perception) {
+  return pImpl_->Upload(PerceptionCommandCode::kPerception,
+                        "request_perception", request_perception,
+                        response_perception, &perception_api::Perception);
+}
+
+void ChunkedUploader::Close() { pImpl_->Close(); }
+
+ChunkedUploadStats ChunkedUploader::GetLastStats() const {
+  return pImpl_->last_stats_;
+}
+
+}  // namespace perception_api
+}  // namespace robot
+}  // namespace konka_sdk
+}  // namespace humanoid_robot
@@ -0,0 +1,711 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * konka_sdk_loadgen - multi-client load generator for the Interfaces-Server
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include "common/variant.pb.h"
+#include "mock_interfaces_server.h"
+#include "robot/client/client_callback_server.h"
+#include "robot/client/interfaces_client.h"
+#include "robot/client/stream_subscription.h"
+#include "robot/client/subscription_manager.h"
+#include "robot/common/latency_histogram.h"
+#include "robot/modules/control_api.h"
+#include "robot/modules/navigation_api.h"
+#include "robot/modules/perception_api.h"
+
+using namespace humanoid_robot::konka_sdk::tools;
+using namespace humanoid_robot::konka_sdk::robot;
+using humanoid_robot::konka_sdk::common::LatencyHistogram;
+using humanoid_robot::PB::common::Variant;
+using humanoid_robot::PB::interfaces::SubscribeRequest;
+using humanoid_robot::PB::interfaces::SubscribeResponse;
+using humanoid_robot::PB::interfaces::UnsubscribeRequest;
+using humanoid_robot::PB::interfaces::UnsubscribeResponse;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/**
+ * 压测配置
+ */
+struct LoadOptions {
+  std::string target;     // 为空时在 127.0.0.1 上启动内置模拟服务端
+  int clients = 50;       // 并发客户端数，每个客户端一个线程和一条连接；
+                          // 为 0 时只测推送
+  double duration_s = 10; // 计入统计的时长
+  double warmup_s = 2;    // 预热时长，期间的请求不计入统计
+  // 各模块的调用权重，模块内的命令均匀选择
+  double navigation_weight = 1;
+  double control_weight = 1;
+  double perception_weight = 1;
+  int subscribers = 0; // 订阅者数，每个订阅 topic
+  std::string topic = "*";
+  bool stream_subscribe = false; // true 用 StreamSubscription，否则用回调服务器
+  bool flow_control = false;     // 回调服务器在确认中返回流控反馈
+  bool json = false;
+};
+
+/**
+ * 压测中的一种调用
+ */
+struct Operation {
+  const char *name;
+  int module; // 0 navigation, 1 control, 2 perception
+  std::function<bool(std::unique_ptr<InterfacesClient> &)> call;
+};
+
+std::vector<Operation> MakeOperations() {
+  namespace nav = navigation_api;
+  namespace ctl = control_api;
+  namespace per = perception_api;
+  return {
+      {"navigation.GetCurrentPose", 0,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         nav::Pose pose;
+         return nav::GetCurrentPose(client, nav::ReqPoseMsg(), pose) ==
+                nav::NavigationResStatus::RESPONSE_SUCCESS;
+       }},
+      {"navigation.GetGridMap2D", 0,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         nav::OccupancyGrid grid;
+         return nav::GetGridMap2D(client, nav::RequestGridMap(), grid) ==
+                nav::NavigationResStatus::RESPONSE_SUCCESS;
+       }},
+      {"navigation.GetRemainingPathDistance", 0,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         nav::ResponseRemainingDistance distance;
+         return nav::GetRemainingPathDistance(
+                    client, nav::RequestRemainingDistance(), distance) ==
+                nav::NavigationResStatus::RESPONSE_SUCCESS;
+       }},
+      {"control.GetJointInfo", 1,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         ctl::ResponseGetJointInfo info;
+         return ctl::GetJointInfo(client, ctl::RequestGetJointInfo(), info) ==
+                ctl::ControlResStatus::RESPONSE_SUCCESS;
+       }},
+      {"control.JointMotion", 1,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         ctl::ResponseJointMotion motion;
+         return ctl::JointMotion(client, ctl::RequestJointMotion(), motion) ==
+                ctl::ControlResStatus::RESPONSE_SUCCESS;
+       }},
+      {"perception.Detection", 2,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         per::ResponseDetection detection;
+         return per::Detection(client, per::RequestDetection(), detection) ==
+                per::PerceptionResStatus::RESPONSE_SUCCESS;
+       }},
+      {"perception.Division", 2,
+       [](std::unique_ptr<InterfacesClient> &client) {
+         per::ResponseDivision division;
+         return per::Division(client, per::RequestDivision(), division) ==
+                per::PerceptionResStatus::RESPONSE_SUCCESS;
+       }},
+  };
+}
+
+/**
+ * 单个客户端线程的统计，结束后合并
+ */
+struct ClientResult {
+  explicit ClientResult(size_t operations)
+      : latency(operations), errors(operations, 0) {}
+
+  std::vector<LatencyHistogram> latency; // 按操作，单位纳秒
+  std::vector<uint64_t> errors;
+};
+
+struct OperationReport {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t errors = 0;
+  double throughput = 0.0;
+  double p50_us = 0.0;
+  double p99_us = 0.0;
+  double p999_us = 0.0;
+  double max_us = 0.0;
+};
+
+OperationReport MakeReport(const std::string &name,
+                           const LatencyHistogram &histogram, uint64_t errors,
+                           double seconds) {
+  OperationReport report;
+  report.name = name;
+  report.count = histogram.Count();
+  report.errors = errors;
+  report.throughput = seconds > 0 ? report.count / seconds : 0.0;
+  report.p50_us = histogram.Percentile(0.50) / 1000.0;
+  report.p99_us = histogram.Percentile(0.99) / 1000.0;
+  report.p999_us = histogram.Percentile(0.999) / 1000.0;
+  report.max_us = histogram.Max() / 1000.0;
+  return report;
+}
+
+void RunClient(std::unique_ptr<InterfacesClient> &client,
+               const std::vector<Operation> &operations,
+               const LoadOptions &options, unsigned seed,
+               Clock::time_point measure_start, Clock::time_point end,
+               ClientResult *result) {
+  std::mt19937 rng(seed);
+  std::discrete_distribution<int> module_dist(
+      {options.navigation_weight, options.control_weight,
+       options.perception_weight});
+  std::vector<std::vector<size_t>> by_module(3);
+  for (size_t i = 0; i < operations.size(); ++i) {
+    by_module[operations[i].module].push_back(i);
+  }
+
+  while (true) {
+    const auto &candidates = by_module[module_dist(rng)];
+    size_t index = candidates[rng() % candidates.size()];
+    auto begin = Clock::now();
+    if (begin >= end) {
+      break;
+    }
+    bool ok = operations[index].call(client);
+    if (begin < measure_start) {
+      continue;
+    }
+    if (!ok) {
+      ++result->errors[index];
+      continue;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       Clock::now() - begin)
+                       .count();
+    result->latency[index].Record(static_cast<uint64_t>(elapsed));
+  }
+}
+
+// =================================================================
+// 订阅推送
+// =================================================================
+
+/**
+ * 一个订阅者：回调服务器或流式订阅，及其在服务端的订阅
+ */
+struct Subscriber {
+  std::unique_ptr<ClientCallbackServer> server;
+  // 流式订阅独占一条连接，避免与请求流量共用
+  std::shared_ptr<InterfacesClient> stream_client;
+  std::unique_ptr<StreamSubscription> stream;
+  std::string subscription_id;
+  std::atomic<uint64_t> received{0};
+
+  NotificationDispatchStats DispatchStats() const {
+    return stream ? stream->GetStats().dispatch : server->GetStats().dispatch;
+  }
+};
+
+void SetString(google::protobuf::Map<std::string, Variant> *map,
+               const std::string &key, const std::string &value) {
+  Variant &variant = (*map)[key];
+  variant.set_type(Variant::KStringValue);
+  variant.set_stringvalue(value);
+}
+
+Status StartStreamSubscriber(const std::string &target,
+                             const std::string &topic, Subscriber *subscriber) {
+  subscriber->stream_client = std::make_shared<InterfacesClient>();
+  Status status = subscriber->stream_client->Connect(target);
+  if (!status) {
+    return status;
+  }
+  status = subscriber->stream_client->NegotiateCapabilities(
+      {kStreamSubscribeCapability});
+  if (!status) {
+    return status;
+  }
+  subscriber->stream =
+      std::make_unique<StreamSubscription>(subscriber->stream_client);
+  subscriber->stream->AddSubscriptionHandler(
+      "", [subscriber](const NotificationPtr &) {
+        subscriber->received.fetch_add(1, std::memory_order_relaxed);
+      });
+
+  SubscribeRequest request;
+  SetString(request.mutable_input()->mutable_keyvaluelist(), "topicId", topic);
+  return subscriber->stream->Start(request);
+}
+
+Status StartSubscriber(std::unique_ptr<InterfacesClient> &client,
+                       const std::string &target, const LoadOptions &options,
+                       Subscriber *subscriber) {
+  if (options.stream_subscribe) {
+    return StartStreamSubscriber(target, options.topic, subscriber);
+  }
+  CallbackServerOptions server_options;
+  server_options.flow_control.enabled = options.flow_control;
+  subscriber->server = std::make_unique<ClientCallbackServer>();
+  subscriber->server->SetServerOptions(server_options);
+  subscriber->server->AddSubscriptionHandler(
+      "", [subscriber](const NotificationPtr &) {
+        subscriber->received.fetch_add(1, std::memory_order_relaxed);
+      });
+  int port = 0;
+  Status status = subscriber->server->StartWithAutoPort("127.0.0.1", port);
+  if (!status) {
+    return status;
+  }
+
+  SubscribeRequest request;
+  auto *input = request.mutable_input()->mutable_keyvaluelist();
+  SetString(input, "topicId", options.topic);
+  SetString(input, "client_endpoint", subscriber->server->GetClientEndpoint());
+  SubscribeResponse response;
+  status = client->Subscribe(request, response, 5000);
+  if (!status) {
+    return status;
+  }
+  const auto &output = response.output().keyvaluelist();
+  auto it = output.find(kSubscriptionIdKey);
+  if (it != output.end()) {
+    subscriber->subscription_id = it->second.stringvalue();
+  }
+  return Status();
+}
+
+void StopSubscriber(std::unique_ptr<InterfacesClient> &client,
+                    Subscriber *subscriber) {
+  if (subscriber->stream) {
+    // 取消订阅流即结束服务端的订阅
+    subscriber->stream->Stop();
+    return;
+  }
+  if (!subscriber->subscription_id.empty()) {
+    UnsubscribeRequest request;
+    SetString(request.mutable_input()->mutable_keyvaluelist(),
+              kSubscriptionIdKey, subscriber->subscription_id);
+    UnsubscribeResponse response;
+    Status status = client->Unsubscribe(request, response, 5000);
+    if (!status) {
+      std::fprintf(stderr, "Unsubscribe %s failed: %s\n",
+                   subscriber->subscription_id.c_str(),
+                   status.message().c_str());
+    }
+  }
+  if (subscriber->server) {
+    subscriber->server->Stop();
+  }
+}
+
+uint64_t TotalReceived(const std::vector<std::unique_ptr<Subscriber>> &subscribers) {
+  uint64_t total = 0;
+  for (const auto &subscriber : subscribers) {
+    total += subscriber->received.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+// 进程累计 CPU 时间（用户态 + 内核态），单位微秒
+int64_t ProcessCpuUs() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+  return (static_cast<int64_t>(usage.ru_utime.tv_sec) +
+          static_cast<int64_t>(usage.ru_stime.tv_sec)) *
+             1000000 +
+         usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/**
+ * 测量期内的推送汇总
+ */
+struct PushReport {
+  const char *mode = "callback";
+  uint64_t messages = 0;
+  double messages_per_s = 0.0;
+  double cpu_us_per_message = 0.0; // 进程 CPU 时间 / 收到的消息数
+};
+
+// =================================================================
+// 命令行与输出
+// =================================================================
+
+void PrintUsage(const char *program) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [options]\n"
+      "  --target HOST:PORT        server to load; empty starts an embedded\n"
+      "                            mock server on 127.0.0.1 (default)\n"
+      "  --clients N               concurrent clients (default 50, 0 for\n"
+      "                            push-only runs)\n"
+      "  --duration-s S            measured duration (default 10)\n"
+      "  --warmup-s S              warm-up before measuring (default 2)\n"
+      "  --mix navigation=W,control=W,perception=W\n"
+      "                            module weights (default 1,1,1)\n"
+      "  --subscribers N           subscribers on --topic\n"
+      "  --topic NAME              topic to subscribe (default *)\n"
+      "  --subscribe-mode MODE     callback (ClientCallbackServer, default)\n"
+      "                            or stream (StreamSubscription)\n"
+      "  --flow-control 0|1        callback servers return flow-control\n"
+      "                            feedback in acks (default 0)\n"
+      "  --json 0|1                print the report as JSON\n"
+      "Embedded mock server options:\n%s",
+      program, kMockServerFlagsHelp);
+}
+
+Status ParseMix(const std::string &text, LoadOptions *options) {
+  std::stringstream items(text);
+  std::string item;
+  while (std::getline(items, item, ',')) {
+    size_t eq = item.find('=');
+    if (eq == std::string::npos) {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Invalid --mix entry: " + item);
+    }
+    std::string module = item.substr(0, eq);
+    double weight = std::atof(item.c_str() + eq + 1);
+    if (module == "navigation") {
+      options->navigation_weight = weight;
+    } else if (module == "control") {
+      options->control_weight = weight;
+    } else if (module == "perception") {
+      options->perception_weight = weight;
+    } else {
+      return Status(std::make_error_code(std::errc::invalid_argument),
+                    "Unknown --mix module: " + module);
+    }
+  }
+  if (options->navigation_weight < 0 || options->control_weight < 0 ||
+      options->perception_weight < 0 ||
+      options->navigation_weight + options->control_weight +
+              options->perception_weight <=
+          0) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "--mix weights must be non-negative and not all zero");
+  }
+  return Status();
+}
+
+void PrintRow(const OperationReport &report) {
+  std::printf("%-38s %10llu %8llu %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+              report.name.c_str(),
+              static_cast<unsigned long long>(report.count),
+              static_cast<unsigned long long>(report.errors),
+              report.throughput, report.p50_us, report.p99_us, report.p999_us,
+              report.max_us);
+}
+
+void PrintText(const std::vector<OperationReport> &reports,
+               const OperationReport &total, int clients) {
+  std::printf("%d clients\n", clients);
+  std::printf("%-38s %10s %8s %10s %10s %10s %10s %10s\n", "operation",
+              "count", "errors", "req/s", "p50(us)", "p99(us)", "p999(us)",
+              "max(us)");
+  for (const auto &report : reports) {
+    PrintRow(report);
+  }
+  PrintRow(total);
+}
+
+void PrintPushText(const std::vector<std::unique_ptr<Subscriber>> &subscribers,
+                   const PushReport &push, const MockServerStats *mock_stats) {
+  if (subscribers.empty()) {
+    return;
+  }
+  std::printf("push (%s): %llu messages, %.1f msgs/s, %.2f cpu_us/msg\n",
+              push.mode, static_cast<unsigned long long>(push.messages),
+              push.messages_per_s, push.cpu_us_per_message);
+  for (size_t i = 0; i < subscribers.size(); ++i) {
+    NotificationDispatchStats dispatch = subscribers[i]->DispatchStats();
+    FlowControlStats flow_control;
+    if (subscribers[i]->server) {
+      flow_control = subscribers[i]->server->GetStats().flow_control;
+    }
+    std::printf("subscriber %zu: received=%llu critical_wait_p99=%lluus "
+                "bulk_shed=%llu slow_down=%llu drop=%llu\n",
+                i,
+                static_cast<unsigned long long>(
+                    subscribers[i]->received.load()),
+                static_cast<unsigned long long>(dispatch.critical_wait_p99_us),
+                static_cast<unsigned long long>(dispatch.bulk_shed),
+                static_cast<unsigned long long>(flow_control.slow_down),
+                static_cast<unsigned long long>(flow_control.drop));
+    for (const auto &topic : dispatch.topics) {
+      std::printf("  %-20s count=%llu push_p50=%lluus push_p99=%lluus\n",
+                  topic.first.c_str(),
+                  static_cast<unsigned long long>(topic.second.count),
+                  static_cast<unsigned long long>(topic.second.push_p50_us),
+                  static_cast<unsigned long long>(topic.second.push_p99_us));
+    }
+  }
+  if (mock_stats == nullptr) {
+    return;
+  }
+  for (const auto &topic : mock_stats->push.topics) {
+    const MockTopicStats &t = topic.second;
+    std::printf("mock push %-20s sent=%llu slow_down=%llu drop=%llu "
+                "suppressed=%llu rate=%.1fHz\n",
+                topic.first.c_str(), static_cast<unsigned long long>(t.sent),
+                static_cast<unsigned long long>(t.slow_down),
+                static_cast<unsigned long long>(t.drop),
+                static_cast<unsigned long long>(t.suppressed),
+                t.current_rate_hz);
+  }
+}
+
+void PrintJsonReport(const OperationReport &report, bool last) {
+  std::printf("    {\"name\": \"%s\", \"count\": %llu, \"errors\": %llu, "
+              "\"throughput\": %.3f, \"p50_us\": %.3f, \"p99_us\": %.3f, "
+              "\"p999_us\": %.3f, \"max_us\": %.3f}%s\n",
+              report.name.c_str(),
+              static_cast<unsigned long long>(report.count),
+              static_cast<unsigned long long>(report.errors),
+              report.throughput, report.p50_us, report.p99_us,
+              report.p999_us, report.max_us, last ? "" : ",");
+}
+
+void PrintJson(const std::vector<OperationReport> &reports,
+               const OperationReport &total, const LoadOptions &options,
+               const std::vector<std::unique_ptr<Subscriber>> &subscribers,
+               const PushReport &push) {
+  std::printf("{\n  \"clients\": %d,\n  \"duration_s\": %.3f,\n",
+              options.clients, options.duration_s);
+  std::printf("  \"total\":\n");
+  PrintJsonReport(total, false);
+  std::printf("  \"operations\": [\n");
+  for (size_t i = 0; i < reports.size(); ++i) {
+    PrintJsonReport(reports[i], i + 1 == reports.size());
+  }
+  std::printf("  ],\n  \"push\": {\"mode\": \"%s\", \"messages\": %llu, "
+              "\"messages_per_s\": %.3f, \"cpu_us_per_message\": %.3f},\n",
+              push.mode, static_cast<unsigned long long>(push.messages),
+              push.messages_per_s, push.cpu_us_per_message);
+  std::printf("  \"subscribers\": [\n");
+  for (size_t i = 0; i < subscribers.size(); ++i) {
+    NotificationDispatchStats dispatch = subscribers[i]->DispatchStats();
+    FlowControlStats flow_control;
+    if (subscribers[i]->server) {
+      flow_control = subscribers[i]->server->GetStats().flow_control;
+    }
+    std::printf("    {\"received\": %llu, \"critical_wait_p99_us\": %llu, "
+                "\"bulk_shed\": %llu, \"slow_down\": %llu, \"drop\": %llu}%s\n",
+                static_cast<unsigned long long>(
+                    subscribers[i]->received.load()),
+                static_cast<unsigned long long>(dispatch.critical_wait_p99_us),
+                static_cast<unsigned long long>(dispatch.bulk_shed),
+                static_cast<unsigned long long>(flow_control.slow_down),
+                static_cast<unsigned long long>(flow_control.drop),
+                i + 1 == subscribers.size() ? "" : ",");
+  }
+  std::printf("  ]\n}\n");
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  LoadOptions options;
+  MockServerOptions mock_options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string name = argv[i];
+    if (name == "-h" || name == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", name.c_str());
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++i];
+    Status status;
+    if (name == "--target") {
+      options.target = value;
+    } else if (name == "--clients") {
+      options.clients = std::max(0, std::atoi(value.c_str()));
+    } else if (name == "--duration-s") {
+      options.duration_s = std::atof(value.c_str());
+    } else if (name == "--warmup-s") {
+      options.warmup_s = std::atof(value.c_str());
+    } else if (name == "--mix") {
+      status = ParseMix(value, &options);
+    } else if (name == "--subscribers") {
+      options.subscribers = std::max(0, std::atoi(value.c_str()));
+    } else if (name == "--topic") {
+      options.topic = value;
+    } else if (name == "--subscribe-mode") {
+      if (value != "callback" && value != "stream") {
+        status = Status(std::make_error_code(std::errc::invalid_argument),
+                        "--subscribe-mode must be callback or stream");
+      }
+      options.stream_subscribe = value == "stream";
+    } else if (name == "--flow-control") {
+      options.flow_control = value != "0";
+    } else if (name == "--json") {
+      options.json = value != "0";
+    } else {
+      status = ApplyMockServerFlag(name, value, &mock_options);
+    }
+    if (!status) {
+      std::fprintf(stderr, "%s\n", status.message().c_str());
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  std::unique_ptr<MockInterfacesServer> mock;
+  std::string target = options.target;
+  if (target.empty()) {
+    if (options.stream_subscribe) {
+      mock_options.capabilities.push_back(kStreamSubscribeCapability);
+    }
+    mock = std::make_unique<MockInterfacesServer>(mock_options);
+    Status status = mock->Start("127.0.0.1", 0);
+    if (!status) {
+      std::fprintf(stderr, "Failed to start mock server: %s\n",
+                   status.message().c_str());
+      return 1;
+    }
+    target = mock->GetTarget();
+  }
+
+  // 订阅管理用的连接
+  auto control = std::make_unique<InterfacesClient>();
+  {
+    Status status = control->Connect(target);
+    if (!status) {
+      std::fprintf(stderr, "Failed to connect to %s: %s\n", target.c_str(),
+                   status.message().c_str());
+      return 1;
+    }
+  }
+
+  // 并行建立连接：Connect 等待通道就绪时按秒轮询
+  std::vector<std::unique_ptr<InterfacesClient>> clients(options.clients);
+  std::vector<Status> connect_status(options.clients);
+  {
+    std::vector<std::thread> connectors;
+    for (int i = 0; i < options.clients; ++i) {
+      connectors.emplace_back([&, i] {
+        clients[i] = std::make_unique<InterfacesClient>();
+        connect_status[i] = clients[i]->Connect(target);
+      });
+    }
+    for (auto &connector : connectors) {
+      connector.join();
+    }
+  }
+  for (int i = 0; i < options.clients; ++i) {
+    if (!connect_status[i]) {
+      std::fprintf(stderr, "Client %d failed to connect to %s: %s\n", i,
+                   target.c_str(), connect_status[i].message().c_str());
+      return 1;
+    }
+  }
+
+  std::vector<std::unique_ptr<Subscriber>> subscribers;
+  for (int i = 0; i < options.subscribers; ++i) {
+    auto subscriber = std::make_unique<Subscriber>();
+    Status status = StartSubscriber(control, target, options, subscriber.get());
+    if (!status) {
+      std::fprintf(stderr, "Subscriber %d failed: %s\n", i,
+                   status.message().c_str());
+      return 1;
+    }
+    subscribers.push_back(std::move(subscriber));
+  }
+
+  const std::vector<Operation> operations = MakeOperations();
+  std::vector<std::unique_ptr<ClientResult>> results;
+  for (int i = 0; i < options.clients; ++i) {
+    results.push_back(std::make_unique<ClientResult>(operations.size()));
+  }
+
+  auto start = Clock::now();
+  auto measure_start =
+      start + std::chrono::duration_cast<Clock::duration>(
+                  std::chrono::duration<double>(options.warmup_s));
+  auto end = measure_start + std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(
+                                     options.duration_s));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < options.clients; ++i) {
+    threads.emplace_back(RunClient, std::ref(clients[i]), std::cref(operations),
+                         std::cref(options), static_cast<unsigned>(i + 1),
+                         measure_start, end, results[i].get());
+  }
+  // 推送按测量期统计：预热结束时和测量结束时各取一次接收数与 CPU 时间
+  std::this_thread::sleep_until(measure_start);
+  uint64_t received_start = TotalReceived(subscribers);
+  int64_t cpu_start_us = ProcessCpuUs();
+  std::this_thread::sleep_until(end);
+  uint64_t received_end = TotalReceived(subscribers);
+  int64_t cpu_end_us = ProcessCpuUs();
+  double push_seconds =
+      std::chrono::duration<double>(Clock::now() - measure_start).count();
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  // 最后一批请求可能在 end 之后才返回，按实际结束时间计算吞吐
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - measure_start).count();
+
+  PushReport push;
+  push.mode = options.stream_subscribe ? "stream" : "callback";
+  push.messages = received_end - received_start;
+  push.messages_per_s = push_seconds > 0 ? push.messages / push_seconds : 0.0;
+  push.cpu_us_per_message =
+      push.messages == 0 ? 0.0
+                         : static_cast<double>(cpu_end_us - cpu_start_us) /
+                               static_cast<double>(push.messages);
+
+  std::vector<OperationReport> reports;
+  LatencyHistogram total_latency;
+  uint64_t total_errors = 0;
+  for (size_t op = 0; op < operations.size(); ++op) {
+    LatencyHistogram latency;
+    uint64_t errors = 0;
+    for (const auto &result : results) {
+      latency.Merge(result->latency[op]);
+      errors += result->errors[op];
+    }
+    total_latency.Merge(latency);
+    total_errors += errors;
+    if (latency.Count() > 0 || errors > 0) {
+      reports.push_back(
+          MakeReport(operations[op].name, latency, errors, seconds));
+    }
+  }
+  OperationReport total =
+      MakeReport("total", total_latency, total_errors, seconds);
+
+  MockServerStats mock_stats;
+  if (mock) {
+    mock_stats = mock->GetStats();
+  }
+  if (options.json) {
+    PrintJson(reports, total, options, subscribers, push);
+  } else {
+    PrintText(reports, total, options.clients);
+    PrintPushText(subscribers, push, mock ? &mock_stats : nullptr);
+  }
+
+  for (auto &subscriber : subscribers) {
+    StopSubscriber(control, subscriber.get());
+  }
+  if (mock) {
+    mock->Stop();
+  }
+  return total_errors == 0 ? 0 : 2;
+}
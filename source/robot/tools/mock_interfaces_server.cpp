@@ -0,0 +1,601 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of MockInterfacesServer
+ */
+
+#include "mock_interfaces_server.h"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "interfaces/interfaces_grpc.grpc.pb.h"
+#include "robot/client/clock_sync.h"
+#include "robot/client/stream_subscription.h"
+#include "robot/client/subscription_manager.h"
+#include "robot/common/logger.h"
+#include <grpcpp/grpcpp.h>
+
+using namespace humanoid_robot::konka_sdk::tools;
+using namespace humanoid_robot::PB::interfaces;
+using humanoid_robot::PB::common::Variant;
+
+namespace {
+// 与 SDK 各模块保持一致的请求字段
+constexpr const char *kCommandIdKey = "command_id";
+constexpr const char *kDataKey = "data";
+constexpr const char *kHeartbeatSeqKey = "heartbeat_seq";
+constexpr const char *kClientSendNsKey = "client_send_ns";
+constexpr const char *kCapabilitiesKey = "capabilities";
+constexpr const char *kTopicIdKey = "topicId";
+constexpr const char *kClientEndpointKey = "client_endpoint";
+constexpr const char *kCallbackUrlKey = "callbackurl";
+// InterfacesClient::SubscribeStream 在 Action 输入中加的标志
+constexpr const char *kSubscribeStreamKey = "subscribe_stream";
+// 流式订阅检查客户端取消的间隔
+constexpr auto kStreamPollInterval = std::chrono::milliseconds(20);
+// ChunkedUploader 的分块信封
+constexpr const char *kChunkKey = "chunk";
+constexpr const char *kLastKey = "last";
+
+// 响应数据使用的未知字段号（length-delimited）
+constexpr uint32_t kFillerFieldNumber = 15999;
+
+int64_t UnixNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void AppendVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+/**
+ * 长度恰为 size 的合法 protobuf 编码：一个 bytes 类型的未知字段
+ */
+std::string MakeFillerPayload(size_t size) {
+  std::string tag;
+  AppendVarint(tag, (static_cast<uint64_t>(kFillerFieldNumber) << 3) | 2);
+  if (size <= tag.size()) {
+    return std::string();
+  }
+  // 长度前缀本身的字节数随内容长度变化，从大到小尝试
+  for (size_t prefix = 5; prefix >= 1; --prefix) {
+    if (size < tag.size() + prefix) {
+      continue;
+    }
+    size_t content = size - tag.size() - prefix;
+    std::string length;
+    AppendVarint(length, content);
+    if (length.size() == prefix) {
+      std::string out = tag + length;
+      out.resize(size, '\x5A');
+      return out;
+    }
+  }
+  return std::string();
+}
+
+/**
+ * 由 data 字典中业务数据的 key 判断所属模块
+ */
+const char *ModuleOf(const std::string &data_key) {
+  static const std::set<std::string> control_keys = {
+      "request_emergency_stop", "request_get_joint_info",
+      "request_joint_motion"};
+  static const std::set<std::string> perception_keys = {
+      "request_detection", "request_division", "request_perception"};
+  if (data_key == "request_data") {
+    return "navigation";
+  }
+  if (control_keys.count(data_key) != 0) {
+    return "control";
+  }
+  if (perception_keys.count(data_key) != 0) {
+    return "perception";
+  }
+  return "other";
+}
+
+template <typename Dictionary>
+const std::string &StringField(const Dictionary &dict, const char *key) {
+  static const std::string empty;
+  auto it = dict.keyvaluelist().find(key);
+  return it == dict.keyvaluelist().end() ? empty : it->second.stringvalue();
+}
+
+template <typename ErrorInfo> void SetOk(ErrorInfo *ret) {
+  ret->set_code("0");
+  ret->set_message("OK");
+}
+} // namespace
+
+// =============================================================================
+// MockInterfacesServer::Impl - 私有实现
+// =============================================================================
+
+class MockInterfacesServer::Impl : public InterfaceService::Service {
+public:
+  explicit Impl(MockServerOptions options)
+      : options_(std::move(options)), push_(options_.push) {
+    accepted_capabilities_.insert(options_.capabilities.begin(),
+                                  options_.capabilities.end());
+  }
+
+  grpc::Status Send(grpc::ServerContext *context,
+                    grpc::ServerReaderWriter<SendResponse, SendRequest> *stream)
+      override {
+    SendRequest request;
+    while (stream->Read(&request)) {
+      SendResponse response;
+      if (!HandleSend(request, &response)) {
+        continue;
+      }
+      if (!stream->Write(response)) {
+        break;
+      }
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status Query(grpc::ServerContext *context, const QueryRequest *request,
+                     QueryResponse *response) override {
+    int64_t t2 = UnixNs();
+    queries_.fetch_add(1, std::memory_order_relaxed);
+    const auto &input = request->input().keyvaluelist();
+    auto *output = response->mutable_output()->mutable_keyvaluelist();
+
+    // 能力握手：返回双方都支持的能力
+    auto capabilities_it = input.find(kCapabilitiesKey);
+    if (capabilities_it != input.end()) {
+      std::stringstream offered(capabilities_it->second.stringvalue());
+      std::string capability;
+      std::string accepted;
+      while (std::getline(offered, capability, ',')) {
+        if (accepted_capabilities_.count(capability) != 0) {
+          accepted += accepted.empty() ? capability : "," + capability;
+        }
+      }
+      Variant &value = (*output)[kCapabilitiesKey];
+      value.set_type(Variant::KStringValue);
+      value.set_stringvalue(accepted);
+    }
+
+    // 对时：t2 收到请求，t3 发出响应
+    if (input.count(robot::kClockSyncKey) != 0) {
+      Variant &t2_value = (*output)[robot::kClockSyncT2Key];
+      t2_value.set_type(Variant::KInt64Value);
+      t2_value.set_int64value(t2);
+      Variant &t3_value = (*output)[robot::kClockSyncT3Key];
+      t3_value.set_type(Variant::KInt64Value);
+      t3_value.set_int64value(UnixNs());
+    }
+
+    SetOk(response->mutable_ret());
+    return grpc::Status::OK;
+  }
+
+  grpc::Status Action(grpc::ServerContext *context,
+                      const ActionRequest *request,
+                      grpc::ServerWriter<ActionResponse> *writer) override {
+    const auto &input = request->input().keyvaluelist();
+    auto stream_it = input.find(kSubscribeStreamKey);
+    if (stream_it != input.end() && stream_it->second.boolvalue()) {
+      return SubscribeStream(context, *request, writer);
+    }
+    ActionResponse response;
+    SetOk(response.mutable_ret());
+    writer->Write(response);
+    return grpc::Status::OK;
+  }
+
+  /**
+   * 流式订阅：先回一条带 subscriptionId 的确认，之后由推送线程沿流写通知，
+   * 直到客户端取消或订阅被 Unsubscribe 移除
+   */
+  grpc::Status SubscribeStream(grpc::ServerContext *context,
+                               const ActionRequest &request,
+                               grpc::ServerWriter<ActionResponse> *writer) {
+    if (accepted_capabilities_.count(robot::kStreamSubscribeCapability) == 0) {
+      return grpc::Status(grpc::StatusCode::UNIMPLEMENTED,
+                          "subscribe.stream.v1 is not enabled");
+    }
+    subscribes_.fetch_add(1, std::memory_order_relaxed);
+    std::string subscription_id =
+        "mock-sub-" + std::to_string(next_subscription_.fetch_add(1) + 1);
+
+    ActionResponse ack;
+    Variant &id =
+        (*ack.mutable_output()->mutable_keyvaluelist())[robot::kSubscriptionIdKey];
+    id.set_type(Variant::KStringValue);
+    id.set_stringvalue(subscription_id);
+    SetOk(ack.mutable_ret());
+    if (!writer->Write(ack)) {
+      return grpc::Status::OK;
+    }
+
+    push_.AddStreamSubscriber(
+        subscription_id, StringField(request.input(), kTopicIdKey),
+        [writer](Notification &notification) {
+          ActionResponse message;
+          message.mutable_output()->Swap(notification.mutable_notifymessage());
+          SetOk(message.mutable_ret());
+          return writer->Write(message);
+        });
+    while (!context->IsCancelled() && push_.HasSubscriber(subscription_id)) {
+      std::this_thread::sleep_for(kStreamPollInterval);
+    }
+    // 返回前停止推送线程，之后 writer 失效
+    push_.RemoveSubscriber(subscription_id);
+    return grpc::Status::OK;
+  }
+
+  grpc::Status Subscribe(grpc::ServerContext *context,
+                         const SubscribeRequest *request,
+                         SubscribeResponse *response) override {
+    subscribes_.fetch_add(1, std::memory_order_relaxed);
+    const auto &input = request->input();
+
+    // 批量续租（SubscriptionManager）：返回已不存在的订阅
+    auto renew_it = input.keyvaluelist().find(robot::kRenewSubscriptionsKey);
+    if (renew_it != input.keyvaluelist().end()) {
+      if (accepted_capabilities_.count(robot::kSubscriptionRenewCapability) ==
+          0) {
+        response->mutable_ret()->set_code("1");
+        response->mutable_ret()->set_message(
+            "subscribe.renew.v1 is not enabled");
+        return grpc::Status::OK;
+      }
+      auto *output = response->mutable_output()->mutable_keyvaluelist();
+      Variant &expired = (*output)[robot::kExpiredSubscriptionsKey];
+      expired.set_type(Variant::KDictValue);
+      auto *expired_map = expired.mutable_dictvalue()->mutable_keyvaluelist();
+      for (const auto &item : renew_it->second.dictvalue().keyvaluelist()) {
+        if (!push_.HasSubscriber(item.first)) {
+          Variant &flag = (*expired_map)[item.first];
+          flag.set_type(Variant::KBoolValue);
+          flag.set_boolvalue(true);
+        }
+      }
+      SetOk(response->mutable_ret());
+      return grpc::Status::OK;
+    }
+
+    std::string endpoint = StringField(input, kClientEndpointKey);
+    if (endpoint.empty()) {
+      endpoint = StringField(input, kCallbackUrlKey);
+    }
+    if (endpoint.empty()) {
+      response->mutable_ret()->set_code("1");
+      response->mutable_ret()->set_message("client_endpoint is required");
+      return grpc::Status::OK;
+    }
+
+    std::string subscription_id =
+        "mock-sub-" + std::to_string(next_subscription_.fetch_add(1) + 1);
+    push_.AddSubscriber(subscription_id, endpoint,
+                        StringField(input, kTopicIdKey));
+
+    Variant &id = (*response->mutable_output()
+                        ->mutable_keyvaluelist())[robot::kSubscriptionIdKey];
+    id.set_type(Variant::KStringValue);
+    id.set_stringvalue(subscription_id);
+    SetOk(response->mutable_ret());
+    return grpc::Status::OK;
+  }
+
+  grpc::Status Unsubscribe(grpc::ServerContext *context,
+                           const UnsubscribeRequest *request,
+                           UnsubscribeResponse *response) override {
+    unsubscribes_.fetch_add(1, std::memory_order_relaxed);
+    push_.RemoveSubscriber(
+        StringField(request->input(), robot::kSubscriptionIdKey));
+    SetOk(response->mutable_ret());
+    return grpc::Status::OK;
+  }
+
+  // 返回 false 表示该请求不需要响应
+  bool HandleSend(const SendRequest &request, SendResponse *response) {
+    const auto &input = request.input().keyvaluelist();
+    auto *output = response->mutable_output()->mutable_keyvaluelist();
+
+    // 控制模块的 deadman 心跳：原样回显
+    auto heartbeat_it = input.find(kHeartbeatSeqKey);
+    if (heartbeat_it != input.end()) {
+      heartbeats_.fetch_add(1, std::memory_order_relaxed);
+      (*output)[kHeartbeatSeqKey] = heartbeat_it->second;
+      auto send_ns_it = input.find(kClientSendNsKey);
+      if (send_ns_it != input.end()) {
+        (*output)[kClientSendNsKey] = send_ns_it->second;
+      }
+      SetOk(response->mutable_ret());
+      return true;
+    }
+
+    // 分块上传：只在 last=true 的分块之后按命令配置响应一次
+    auto chunk_it = input.find(kChunkKey);
+    if (chunk_it != input.end()) {
+      upload_chunks_.fetch_add(1, std::memory_order_relaxed);
+      const auto &chunk = chunk_it->second.dictvalue().keyvaluelist();
+      auto last_it = chunk.find(kLastKey);
+      if (last_it == chunk.end() || !last_it->second.boolvalue()) {
+        return false;
+      }
+    }
+
+    int32_t command_id = 0;
+    auto command_it = input.find(kCommandIdKey);
+    if (command_it != input.end()) {
+      command_id = command_it->second.int32value();
+    }
+    const char *module = "other";
+    auto data_it = input.find(kDataKey);
+    if (data_it != input.end() &&
+        !data_it->second.dictvalue().keyvaluelist().empty()) {
+      module = ModuleOf(data_it->second.dictvalue().keyvaluelist().begin()->first);
+    }
+    std::string key = CommandKey(module, command_id);
+
+    auto profile_it = options_.profiles.find(key);
+    const MockCommandProfile &profile = profile_it != options_.profiles.end()
+                                            ? profile_it->second
+                                            : options_.default_profile;
+    Delay(profile);
+
+    const std::string &payload = FillerPayload(profile.response_bytes);
+    if (profile.ret_code == 0) {
+      SetOk(response->mutable_ret());
+      (*output)[kDataKey].set_bytevalue(payload);
+    } else {
+      response->mutable_ret()->set_code(std::to_string(profile.ret_code));
+      response->mutable_ret()->set_message("mock error");
+    }
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    MockCommandStats &stats = command_stats_[key];
+    stats.requests += 1;
+    stats.response_bytes += profile.ret_code == 0 ? payload.size() : 0;
+    return true;
+  }
+
+  static void Delay(const MockCommandProfile &profile) {
+    int64_t delay_us = profile.latency_us;
+    if (profile.jitter_us > 0) {
+      thread_local std::mt19937_64 engine(std::random_device{}());
+      delay_us += std::uniform_int_distribution<int64_t>(
+          0, profile.jitter_us)(engine);
+    }
+    if (delay_us > 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(delay_us));
+    }
+  }
+
+  const std::string &FillerPayload(size_t size) {
+    std::lock_guard<std::mutex> lock(payload_mutex_);
+    auto it = payloads_.find(size);
+    if (it == payloads_.end()) {
+      it = payloads_.emplace(size, MakeFillerPayload(size)).first;
+    }
+    return it->second;
+  }
+
+  MockServerOptions options_;
+  std::set<std::string> accepted_capabilities_;
+  MockPushGenerator push_;
+
+  std::unique_ptr<grpc::Server> server_;
+  std::string listen_address_;
+  int port_ = 0;
+
+  // 按大小缓存的响应数据，返回后不再修改
+  std::mutex payload_mutex_;
+  std::map<size_t, std::string> payloads_;
+
+  mutable std::mutex stats_mutex_;
+  std::map<std::string, MockCommandStats> command_stats_;
+  std::atomic<uint64_t> queries_{0};
+  std::atomic<uint64_t> subscribes_{0};
+  std::atomic<uint64_t> unsubscribes_{0};
+  std::atomic<uint64_t> heartbeats_{0};
+  std::atomic<uint64_t> upload_chunks_{0};
+  std::atomic<uint64_t> next_subscription_{0};
+};
+
+// =============================================================================
+// MockInterfacesServer 实现
+// =============================================================================
+
+MockInterfacesServer::MockInterfacesServer(MockServerOptions options)
+    : pImpl_(std::make_unique<Impl>(std::move(options))) {}
+
+MockInterfacesServer::~MockInterfacesServer() { Stop(); }
+
+Status MockInterfacesServer::Start(const std::string &listen_address,
+                                   int port) {
+  if (pImpl_->server_) {
+    return Status(std::make_error_code(std::errc::operation_in_progress),
+                  "Mock server is already running");
+  }
+  int max_message_bytes = pImpl_->options_.max_message_mb * 1024 * 1024;
+  grpc::ServerBuilder builder;
+  builder.AddListeningPort(listen_address + ":" + std::to_string(port),
+                           grpc::InsecureServerCredentials(), &pImpl_->port_);
+  builder.SetMaxReceiveMessageSize(max_message_bytes);
+  builder.SetMaxSendMessageSize(max_message_bytes);
+  builder.RegisterService(pImpl_.get());
+  pImpl_->server_ = builder.BuildAndStart();
+  if (!pImpl_->server_ || pImpl_->port_ == 0) {
+    pImpl_->server_.reset();
+    return Status(std::make_error_code(std::errc::address_in_use),
+                  "Failed to start mock server on " + listen_address + ":" +
+                      std::to_string(port));
+  }
+  pImpl_->listen_address_ = listen_address;
+  KONKA_LOG_INFO("mock").Field("target", GetTarget())
+      << "Mock Interfaces-Server started";
+  return Status();
+}
+
+void MockInterfacesServer::Stop() {
+  // 先停推送，避免向已关闭的回调服务反复重试
+  pImpl_->push_.Stop();
+  if (pImpl_->server_) {
+    pImpl_->server_->Shutdown();
+    pImpl_->server_.reset();
+  }
+}
+
+int MockInterfacesServer::GetPort() const { return pImpl_->port_; }
+
+std::string MockInterfacesServer::GetTarget() const {
+  return pImpl_->listen_address_ + ":" + std::to_string(pImpl_->port_);
+}
+
+MockServerStats MockInterfacesServer::GetStats() const {
+  MockServerStats stats;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->stats_mutex_);
+    stats.commands = pImpl_->command_stats_;
+  }
+  stats.queries = pImpl_->queries_.load(std::memory_order_relaxed);
+  stats.subscribes = pImpl_->subscribes_.load(std::memory_order_relaxed);
+  stats.unsubscribes = pImpl_->unsubscribes_.load(std::memory_order_relaxed);
+  stats.heartbeats = pImpl_->heartbeats_.load(std::memory_order_relaxed);
+  stats.upload_chunks = pImpl_->upload_chunks_.load(std::memory_order_relaxed);
+  stats.push = pImpl_->push_.GetStats();
+  return stats;
+}
+
+std::string MockInterfacesServer::CommandKey(const std::string &module,
+                                             int32_t command_id) {
+  return module + "." + std::to_string(command_id);
+}
+
+// =============================================================================
+// 命令行配置解析
+// =============================================================================
+
+namespace {
+std::vector<std::string> SplitFields(const std::string &text) {
+  std::stringstream values(text);
+  std::string field;
+  std::vector<std::string> fields;
+  while (std::getline(values, field, ':')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+// <key>=<latency_us>:<response_bytes>[:<jitter_us>]
+bool ParseCommandProfile(const std::string &text, std::string *key,
+                         MockCommandProfile *profile) {
+  size_t eq = text.find('=');
+  if (eq == std::string::npos || eq == 0) {
+    return false;
+  }
+  std::vector<std::string> fields = SplitFields(text.substr(eq + 1));
+  if (fields.size() < 2 || fields.size() > 3) {
+    return false;
+  }
+  MockCommandProfile parsed;
+  parsed.latency_us = std::stoll(fields[0]);
+  parsed.response_bytes = static_cast<size_t>(std::stoull(fields[1]));
+  if (fields.size() == 3) {
+    parsed.jitter_us = std::stoll(fields[2]);
+  }
+  *key = text.substr(0, eq);
+  *profile = parsed;
+  return true;
+}
+
+// <event_type>=<rate_hz>:<payload_bytes>[:critical]
+bool ParseMockTopic(const std::string &text, MockTopic *topic) {
+  size_t eq = text.find('=');
+  if (eq == std::string::npos || eq == 0) {
+    return false;
+  }
+  std::vector<std::string> fields = SplitFields(text.substr(eq + 1));
+  if (fields.size() < 2 || fields.size() > 3 ||
+      (fields.size() == 3 && fields[2] != "critical")) {
+    return false;
+  }
+  MockTopic parsed;
+  parsed.event_type = text.substr(0, eq);
+  parsed.rate_hz = std::stod(fields[0]);
+  parsed.payload_bytes = static_cast<size_t>(std::stoull(fields[1]));
+  parsed.critical = fields.size() == 3;
+  *topic = parsed;
+  return true;
+}
+} // namespace
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace tools {
+
+const char *const kMockServerFlagsHelp =
+    "  --latency-us N            default Send latency (us)\n"
+    "  --jitter-us N             default extra random latency (us)\n"
+    "  --response-bytes N        default response payload size\n"
+    "  --profile K=LAT:BYTES[:JITTER]\n"
+    "                            per-command override, K like navigation.2\n"
+    "  --push TOPIC=HZ:BYTES[:critical]\n"
+    "                            topic pushed to every subscriber\n"
+    "  --push-flow-control 0|1   honour NotificationAck feedback (default 1)\n"
+    "  --capability NAME         accept NAME in the capability handshake\n";
+
+Status ApplyMockServerFlag(const std::string &name, const std::string &value,
+                           MockServerOptions *options) {
+  try {
+    if (name == "--latency-us") {
+      options->default_profile.latency_us = std::stoll(value);
+    } else if (name == "--jitter-us") {
+      options->default_profile.jitter_us = std::stoll(value);
+    } else if (name == "--response-bytes") {
+      options->default_profile.response_bytes =
+          static_cast<size_t>(std::stoull(value));
+    } else if (name == "--profile") {
+      std::string key;
+      MockCommandProfile profile;
+      if (!ParseCommandProfile(value, &key, &profile)) {
+        return Status(std::make_error_code(std::errc::invalid_argument),
+                      "Invalid --profile: " + value);
+      }
+      options->profiles[key] = profile;
+    } else if (name == "--push") {
+      MockTopic topic;
+      if (!ParseMockTopic(value, &topic)) {
+        return Status(std::make_error_code(std::errc::invalid_argument),
+                      "Invalid --push: " + value);
+      }
+      options->push.topics.push_back(topic);
+    } else if (name == "--push-flow-control") {
+      options->push.honor_flow_control = value != "0";
+    } else if (name == "--capability") {
+      options->capabilities.push_back(value);
+    } else {
+      return Status(std::make_error_code(std::errc::not_supported),
+                    "Unknown flag: " + name);
+    }
+  } catch (const std::exception &) {
+    return Status(std::make_error_code(std::errc::invalid_argument),
+                  "Invalid value for " + name + ": " + value);
+  }
+  return Status();
+}
+
+} // namespace tools
+} // namespace konka_sdk
+} // namespace humanoid_robot
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * In-tree mock of the Interfaces-Server for local load testing
+ */
+
+#ifndef HUMANOID_ROBOT_TOOLS_MOCK_INTERFACES_SERVER_H
+#define HUMANOID_ROBOT_TOOLS_MOCK_INTERFACES_SERVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mock_push_generator.h"
+#include "robot/common/status.h"
+
+namespace humanoid_robot {
+namespace konka_sdk {
+namespace tools {
+
+using Status = humanoid_robot::konka_sdk::common::Status;
+
+/**
+ * 单个命令的模拟行为
+ */
+struct MockCommandProfile {
+  int64_t latency_us = 0;     // 处理时延
+  int64_t jitter_us = 0;      // 在 [0, jitter_us] 内均匀分布的附加时延
+  size_t response_bytes = 64; // 响应 data 字段的字节数
+  int32_t ret_code = 0;       // 响应 ret.code，0 表示成功
+};
+
+/**
+ * 模拟服务端配置
+ */
+struct MockServerOptions {
+  MockCommandProfile default_profile;
+  // 按命令覆盖默认行为，键为 "<模块>.<command_id>"，如 "navigation.2"、
+  // "control.1"、"perception.1"；模块由请求 data 字典中的 key 判断
+  std::map<std::string, MockCommandProfile> profiles;
+  // 能力握手时接受的能力，如 "codec.compact.v1"
+  std::vector<std::string> capabilities;
+  // 订阅后向客户端回调服务推送的主题
+  MockPushOptions push;
+  // gRPC 单条消息上限(MB)
+  int max_message_mb = 128;
+};
+
+/**
+ * 单个命令的服务端统计
+ */
+struct MockCommandStats {
+  uint64_t requests = 0;
+  uint64_t response_bytes = 0;
+};
+
+struct MockServerStats {
+  std::map<std::string, MockCommandStats> commands;
+  uint64_t queries = 0;
+  uint64_t subscribes = 0;
+  uint64_t unsubscribes = 0;
+  uint64_t heartbeats = 0;
+  uint64_t upload_chunks = 0; // 收到的分块上传信封数
+  MockPushStats push;
+};
+
+/**
+ * MockInterfacesServer - 本地模拟的 InterfaceService
+ *
+ * - Send：按命令的配置延时后返回指定大小的响应。响应数据是只含一个未知字段的
+ *   合法 protobuf 编码，任意响应类型都能解析成功；heartbeat_seq 原样回显；
+ *   分块上传只在最后一个分块后响应
+ * - Query：处理能力握手和对时(clock_sync)，其余请求直接返回成功
+ * - Subscribe/Unsubscribe：按 client_endpoint(或 callbackurl) 登记订阅者，
+ *   由 MockPushGenerator 推送 topicId 对应的主题；处理批量续租
+ * - Action：返回一条成功响应；带 subscribe_stream 标志时作为流式订阅
+ *   （需在 capabilities 中接受 subscribe.stream.v1），沿流持续下发通知
+ */
+class MockInterfacesServer {
+public:
+  explicit MockInterfacesServer(MockServerOptions options = MockServerOptions());
+  ~MockInterfacesServer();
+
+  /**
+   * 启动服务
+   * @param listen_address 监听地址
+   * @param port 监听端口，0 表示自动分配
+   */
+  Status Start(const std::string &listen_address, int port);
+
+  void Stop();
+
+  int GetPort() const;
+
+  /**
+   * "address:port"，可直接传给 InterfacesClient::Connect
+   */
+  std::string GetTarget() const;
+
+  MockServerStats GetStats() const;
+
+  /**
+   * 命令的统计键，如 "navigation.2"
+   */
+  static std::string CommandKey(const std::string &module, int32_t command_id);
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  MockInterfacesServer(const MockInterfacesServer &) = delete;
+  MockInterfacesServer &operator=(const MockInterfacesServer &) = delete;
+};
+
+/**
+ * 模拟服务端的命令行参数说明
+ */
+extern const char *const kMockServerFlagsHelp;
+
+/**
+ * 把一个 "--name value" 形式的命令行参数应用到配置
+ * @return name 不是模拟服务端参数时返回 not_supported，取值无效时返回
+ *         invalid_argument
+ */
+Status ApplyMockServerFlag(const std::string &name, const std::string &value,
+                           MockServerOptions *options);
+
+} // namespace tools
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_TOOLS_MOCK_INTERFACES_SERVER_H
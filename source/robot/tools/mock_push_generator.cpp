@@ -0,0 +1,356 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * Implementation of MockPushGenerator
+ */
+
+#include "mock_push_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "common/variant.pb.h"
+#include "interfaces/interfaces_callback.grpc.pb.h"
+#include "robot/client/flow_control.h"
+#include "robot/common/logger.h"
+#include <grpcpp/grpcpp.h>
+
+using namespace humanoid_robot::konka_sdk::tools;
+using humanoid_robot::PB::common::Variant;
+using humanoid_robot::PB::interfaces::ClientCallbackService;
+using humanoid_robot::PB::interfaces::Notification;
+using humanoid_robot::PB::interfaces::NotificationAck;
+using humanoid_robot::konka_sdk::robot::FlowFeedback;
+using humanoid_robot::konka_sdk::robot::FlowSignal;
+using humanoid_robot::konka_sdk::robot::kAckOk;
+using humanoid_robot::konka_sdk::robot::ParseFlowFeedback;
+
+namespace {
+constexpr double kMinRateHz = 1.0;
+// 空闲时检查停止标志的最长间隔
+constexpr auto kMaxIdleWait = std::chrono::milliseconds(50);
+
+using Clock = std::chrono::steady_clock;
+
+int64_t UnixMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string NormalizeEndpoint(const std::string &endpoint) {
+  const std::string any = "0.0.0.0:";
+  if (endpoint.compare(0, any.size(), any) == 0) {
+    return "127.0.0.1:" + endpoint.substr(any.size());
+  }
+  return endpoint;
+}
+
+struct TopicCounters {
+  std::atomic<uint64_t> sent{0};
+  std::atomic<uint64_t> acked{0};
+  std::atomic<uint64_t> slow_down{0};
+  std::atomic<uint64_t> drop{0};
+  std::atomic<uint64_t> failed{0};
+  std::atomic<uint64_t> suppressed{0};
+};
+} // namespace
+
+// =============================================================================
+// MockPushGenerator::Impl - 私有实现
+// =============================================================================
+
+class MockPushGenerator::Impl {
+public:
+  // 订阅者上单个主题的调度状态
+  struct TopicState {
+    size_t index = 0; // options_.topics 中的下标
+    std::atomic<double> rate_hz{0.0};
+    Clock::time_point next;
+    uint64_t seq = 0;
+  };
+
+  struct Subscriber {
+    std::string id;
+    std::unique_ptr<ClientCallbackService::Stub> stub;
+    MockStreamSink sink; // 流式订阅者，设置时不使用 stub
+    std::vector<std::unique_ptr<TopicState>> topics;
+    Clock::time_point paused_until;
+    std::atomic<bool> stop{false};
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+    std::thread thread;
+  };
+
+  explicit Impl(MockPushOptions options)
+      : options_(std::move(options)), counters_(options_.topics.size()) {
+    for (const MockTopic &topic : options_.topics) {
+      payloads_.emplace_back(topic.payload_bytes, '\0');
+      std::string &payload = payloads_.back();
+      for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>(i * 31);
+      }
+    }
+  }
+
+  void Run(Subscriber *subscriber) {
+    while (!subscriber->stop.load(std::memory_order_relaxed)) {
+      auto next_it = std::min_element(
+          subscriber->topics.begin(), subscriber->topics.end(),
+          [](const std::unique_ptr<TopicState> &a,
+             const std::unique_ptr<TopicState> &b) { return a->next < b->next; });
+      if (next_it == subscriber->topics.end()) {
+        return;
+      }
+      TopicState &state = **next_it;
+
+      auto now = Clock::now();
+      if (state.next > now) {
+        std::unique_lock<std::mutex> lock(subscriber->wait_mutex);
+        subscriber->wait_cv.wait_until(
+            lock, std::min(state.next, now + kMaxIdleWait), [subscriber]() {
+              return subscriber->stop.load(std::memory_order_relaxed);
+            });
+        continue;
+      }
+
+      const MockTopic &topic = options_.topics[state.index];
+      TopicCounters &counters = counters_[state.index];
+      if (!topic.critical && now < subscriber->paused_until) {
+        counters.suppressed.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        Push(subscriber, state, topic, counters);
+      }
+
+      // 按当前频率排下一条；落后超过一个周期时不追赶，避免突发
+      auto period = std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(
+              1.0 / state.rate_hz.load(std::memory_order_relaxed)));
+      state.next += period;
+      now = Clock::now();
+      if (state.next + period < now) {
+        state.next = now;
+      }
+    }
+  }
+
+  void Push(Subscriber *subscriber, TopicState &state, const MockTopic &topic,
+            TopicCounters &counters) {
+    Notification notification;
+    auto *fields = notification.mutable_notifymessage()->mutable_keyvaluelist();
+    Variant &event_type = (*fields)["event_type"];
+    event_type.set_type(Variant::KStringValue);
+    event_type.set_stringvalue(topic.event_type);
+    Variant &object_id = (*fields)["object_id"];
+    object_id.set_type(Variant::KStringValue);
+    object_id.set_stringvalue(
+        topic.event_type + "-" +
+        std::to_string(state.seq % static_cast<uint64_t>(
+                                       std::max(1, topic.object_count))));
+    Variant &timestamp = (*fields)["timestamp"];
+    timestamp.set_type(Variant::KInt64Value);
+    timestamp.set_int64value(UnixMs());
+    Variant &subscription_id = (*fields)["subscriptionId"];
+    subscription_id.set_type(Variant::KStringValue);
+    subscription_id.set_stringvalue(subscriber->id);
+    Variant &seq = (*fields)["seq"];
+    seq.set_type(Variant::KInt64Value);
+    seq.set_int64value(static_cast<int64_t>(state.seq++));
+    if (!payloads_[state.index].empty()) {
+      (*fields)["payload"].set_bytevalue(payloads_[state.index]);
+    }
+
+    if (subscriber->sink) {
+      counters.sent.fetch_add(1, std::memory_order_relaxed);
+      if (!subscriber->sink(notification)) {
+        counters.failed.fetch_add(1, std::memory_order_relaxed);
+      }
+      return;
+    }
+
+    grpc::ClientContext context;
+    context.set_deadline(std::chrono::system_clock::now() +
+                         std::chrono::milliseconds(options_.push_timeout_ms));
+    NotificationAck ack;
+    grpc::Status status =
+        subscriber->stub->OnSubscriptionMessage(&context, notification, &ack);
+    counters.sent.fetch_add(1, std::memory_order_relaxed);
+    if (!status.ok() || ack.ret() < 0) {
+      counters.failed.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+
+    const double configured = topic.rate_hz;
+    double rate = state.rate_hz.load(std::memory_order_relaxed);
+    FlowFeedback feedback = ParseFlowFeedback(ack, context);
+    if (feedback.signal == FlowSignal::kSlowDown) {
+      counters.slow_down.fetch_add(1, std::memory_order_relaxed);
+      if (options_.honor_flow_control && !topic.critical) {
+        rate = feedback.suggested_rate_hz > 0.0
+                   ? std::min(rate, feedback.suggested_rate_hz)
+                   : rate * 0.5;
+      }
+    } else if (feedback.signal == FlowSignal::kDrop) {
+      counters.drop.fetch_add(1, std::memory_order_relaxed);
+      if (options_.honor_flow_control) {
+        subscriber->paused_until =
+            Clock::now() + std::chrono::milliseconds(options_.drop_backoff_ms);
+      }
+    } else {
+      if (ack.ret() == kAckOk) {
+        counters.acked.fetch_add(1, std::memory_order_relaxed);
+      }
+      rate = std::min(configured, rate * options_.recovery_factor);
+    }
+    state.rate_hz.store(std::max(std::min(kMinRateHz, configured), rate),
+                        std::memory_order_relaxed);
+  }
+
+  // 按订阅主题建立调度状态，登记后启动推送线程
+  void Start(std::unique_ptr<Subscriber> subscriber, const std::string &topic) {
+    auto start = Clock::now();
+    for (size_t i = 0; i < options_.topics.size(); ++i) {
+      const MockTopic &config = options_.topics[i];
+      if (!topic.empty() && topic != "*" && topic != config.event_type) {
+        continue;
+      }
+      if (config.rate_hz <= 0.0) {
+        continue;
+      }
+      auto state = std::make_unique<TopicState>();
+      state->index = i;
+      state->rate_hz.store(config.rate_hz, std::memory_order_relaxed);
+      state->next = start;
+      subscriber->topics.push_back(std::move(state));
+    }
+    if (subscriber->topics.empty()) {
+      KONKA_LOG_WARN("mock").Field("subscription", subscriber->id)
+          << "No configured topic matches subscription topic " << topic;
+    }
+
+    Subscriber *raw = subscriber.get();
+    std::unique_ptr<Subscriber> replaced;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto &slot = subscribers_[raw->id];
+      replaced = std::move(slot);
+      slot = std::move(subscriber);
+    }
+    if (replaced) {
+      StopSubscriber(*replaced);
+    }
+    raw->thread = std::thread([this, raw]() { Run(raw); });
+  }
+
+  static void StopSubscriber(Subscriber &subscriber) {
+    {
+      std::lock_guard<std::mutex> lock(subscriber.wait_mutex);
+      subscriber.stop.store(true, std::memory_order_relaxed);
+    }
+    subscriber.wait_cv.notify_all();
+    if (subscriber.thread.joinable()) {
+      subscriber.thread.join();
+    }
+  }
+
+  MockPushOptions options_;
+  std::vector<TopicCounters> counters_;
+  std::vector<std::string> payloads_;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<Subscriber>> subscribers_;
+};
+
+// =============================================================================
+// MockPushGenerator 实现
+// =============================================================================
+
+MockPushGenerator::MockPushGenerator(MockPushOptions options)
+    : pImpl_(std::make_unique<Impl>(std::move(options))) {}
+
+MockPushGenerator::~MockPushGenerator() { Stop(); }
+
+void MockPushGenerator::AddSubscriber(const std::string &subscription_id,
+                                      const std::string &endpoint,
+                                      const std::string &topic) {
+  auto subscriber = std::make_unique<Impl::Subscriber>();
+  subscriber->id = subscription_id;
+  subscriber->stub = ClientCallbackService::NewStub(grpc::CreateChannel(
+      NormalizeEndpoint(endpoint), grpc::InsecureChannelCredentials()));
+  pImpl_->Start(std::move(subscriber), topic);
+}
+
+void MockPushGenerator::AddStreamSubscriber(const std::string &subscription_id,
+                                            const std::string &topic,
+                                            MockStreamSink sink) {
+  auto subscriber = std::make_unique<Impl::Subscriber>();
+  subscriber->id = subscription_id;
+  subscriber->sink = std::move(sink);
+  pImpl_->Start(std::move(subscriber), topic);
+}
+
+bool MockPushGenerator::RemoveSubscriber(const std::string &subscription_id) {
+  std::unique_ptr<Impl::Subscriber> removed;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    auto it = pImpl_->subscribers_.find(subscription_id);
+    if (it == pImpl_->subscribers_.end()) {
+      return false;
+    }
+    removed = std::move(it->second);
+    pImpl_->subscribers_.erase(it);
+  }
+  Impl::StopSubscriber(*removed);
+  return true;
+}
+
+bool MockPushGenerator::HasSubscriber(
+    const std::string &subscription_id) const {
+  std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+  return pImpl_->subscribers_.count(subscription_id) != 0;
+}
+
+void MockPushGenerator::Stop() {
+  std::map<std::string, std::unique_ptr<Impl::Subscriber>> subscribers;
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    subscribers.swap(pImpl_->subscribers_);
+  }
+  for (auto &entry : subscribers) {
+    Impl::StopSubscriber(*entry.second);
+  }
+}
+
+MockPushStats MockPushGenerator::GetStats() const {
+  MockPushStats stats;
+  std::vector<double> rate_sum(pImpl_->options_.topics.size(), 0.0);
+  std::vector<size_t> rate_count(pImpl_->options_.topics.size(), 0);
+  {
+    std::lock_guard<std::mutex> lock(pImpl_->mutex_);
+    stats.subscribers = pImpl_->subscribers_.size();
+    for (const auto &entry : pImpl_->subscribers_) {
+      for (const auto &state : entry.second->topics) {
+        rate_sum[state->index] +=
+            state->rate_hz.load(std::memory_order_relaxed);
+        rate_count[state->index] += 1;
+      }
+    }
+  }
+  for (size_t i = 0; i < pImpl_->options_.topics.size(); ++i) {
+    const TopicCounters &counters = pImpl_->counters_[i];
+    MockTopicStats &topic = stats.topics[pImpl_->options_.topics[i].event_type];
+    topic.sent = counters.sent.load(std::memory_order_relaxed);
+    topic.acked = counters.acked.load(std::memory_order_relaxed);
+    topic.slow_down = counters.slow_down.load(std::memory_order_relaxed);
+    topic.drop = counters.drop.load(std::memory_order_relaxed);
+    topic.failed = counters.failed.load(std::memory_order_relaxed);
+    topic.suppressed = counters.suppressed.load(std::memory_order_relaxed);
+    topic.current_rate_hz =
+        rate_count[i] == 0 ? 0.0 : rate_sum[i] / static_cast<double>(rate_count[i]);
+  }
+  return stats;
+}
@@ -0,0 +1,134 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * ClientCallbackService push generator for the mock Interfaces-Server
+ */
+
+#ifndef HUMANOID_ROBOT_TOOLS_MOCK_PUSH_GENERATOR_H
+#define HUMANOID_ROBOT_TOOLS_MOCK_PUSH_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace humanoid_robot {
+namespace PB {
+namespace interfaces {
+class Notification;
+} // namespace interfaces
+} // namespace PB
+
+namespace konka_sdk {
+namespace tools {
+
+/**
+ * 推送主题
+ */
+struct MockTopic {
+  std::string event_type;
+  double rate_hz = 10.0;     // 对每个订阅者的推送频率
+  size_t payload_bytes = 64; // 消息中 payload 字段的字节数
+  int object_count = 1;      // object_id 在 [0, object_count) 中轮换
+  bool critical = false;     // 关键主题不受流控影响
+};
+
+/**
+ * 推送配置
+ */
+struct MockPushOptions {
+  std::vector<MockTopic> topics;
+  // 按 NotificationAck 的流控反馈调整推送
+  bool honor_flow_control = true;
+  // 收到 kAckDrop 后暂停非关键主题的时长(ms)
+  int64_t drop_backoff_ms = 200;
+  // 每次正常确认后频率恢复的倍数（不超过配置频率）
+  double recovery_factor = 1.05;
+  // 单次推送超时(ms)
+  int64_t push_timeout_ms = 1000;
+};
+
+/**
+ * 单个主题的推送统计（所有订阅者合计）
+ */
+struct MockTopicStats {
+  uint64_t sent = 0;       // 发出的消息数
+  uint64_t acked = 0;      // kAckOk 确认数
+  uint64_t slow_down = 0;  // kAckSlowDown 确认数
+  uint64_t drop = 0;       // kAckDrop 确认数
+  uint64_t failed = 0;     // 推送失败（RPC 错误或负的 ret）
+  uint64_t suppressed = 0; // 因 kAckDrop 暂停而未发出的消息数
+  double current_rate_hz = 0.0; // 各订阅者当前频率的平均值
+};
+
+/**
+ * 流式订阅者的写出函数，可取走消息内容；返回 false 表示流已断开
+ */
+using MockStreamSink =
+    std::function<bool(humanoid_robot::PB::interfaces::Notification &)>;
+
+struct MockPushStats {
+  size_t subscribers = 0;
+  std::map<std::string, MockTopicStats> topics;
+};
+
+/**
+ * MockPushGenerator - 按主题配置向订阅者的 ClientCallbackService 推送消息
+ *
+ * 每个订阅者一个推送线程，按各主题的频率调度 OnSubscriptionMessage；
+ * 流式订阅者改为交给 MockStreamSink 写入订阅流（没有确认，不参与流控）。
+ * 消息字段与 SDK 的分发器一致：event_type、object_id、timestamp(Unix 毫秒)、
+ * subscriptionId、seq 和 payload。
+ *
+ * 开启 honor_flow_control 时按确认中的流控反馈调整：kAckSlowDown 把该主题
+ * 降到尾部元数据建议的频率（没有建议时减半），kAckDrop 暂停所有非关键主题
+ * drop_backoff_ms，之后随正常确认逐步恢复到配置频率。
+ */
+class MockPushGenerator {
+public:
+  explicit MockPushGenerator(MockPushOptions options);
+  ~MockPushGenerator();
+
+  /**
+   * 添加订阅者并开始推送
+   * @param subscription_id 订阅ID
+   * @param endpoint 订阅者回调地址，0.0.0.0 会替换为 127.0.0.1
+   * @param topic 订阅的事件类型，为空或 "*" 表示所有配置的主题
+   */
+  void AddSubscriber(const std::string &subscription_id,
+                     const std::string &endpoint, const std::string &topic);
+
+  /**
+   * 添加流式订阅者（subscribe.stream.v1）：消息经 sink 写入订阅流
+   * @param sink 在推送线程中调用，RemoveSubscriber 返回后不再调用
+   */
+  void AddStreamSubscriber(const std::string &subscription_id,
+                           const std::string &topic, MockStreamSink sink);
+
+  bool RemoveSubscriber(const std::string &subscription_id);
+
+  bool HasSubscriber(const std::string &subscription_id) const;
+
+  /**
+   * 停止所有推送线程
+   */
+  void Stop();
+
+  MockPushStats GetStats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+
+  MockPushGenerator(const MockPushGenerator &) = delete;
+  MockPushGenerator &operator=(const MockPushGenerator &) = delete;
+};
+
+} // namespace tools
+} // namespace konka_sdk
+} // namespace humanoid_robot
+
+#endif // HUMANOID_ROBOT_TOOLS_MOCK_PUSH_GENERATOR_H
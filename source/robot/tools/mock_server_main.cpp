@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * konka_sdk_mock_server - standalone mock Interfaces-Server
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "mock_interfaces_server.h"
+
+using namespace humanoid_robot::konka_sdk::tools;
+
+namespace {
+std::atomic<bool> g_running{true};
+
+void HandleSignal(int) { g_running.store(false); }
+
+void PrintUsage(const char *program) {
+  std::fprintf(stderr,
+               "Usage: %s [options]\n"
+               "  --listen ADDR             listen address (default 0.0.0.0)\n"
+               "  --port N                  listen port (default 50051)\n"
+               "  --report-s N              stats interval, 0 disables "
+               "(default 5)\n"
+               "%s",
+               program, kMockServerFlagsHelp);
+}
+
+void PrintStats(const MockServerStats &stats) {
+  std::printf("commands:");
+  for (const auto &command : stats.commands) {
+    std::printf(" %s=%llu", command.first.c_str(),
+                static_cast<unsigned long long>(command.second.requests));
+  }
+  std::printf("  queries=%llu subscribes=%llu heartbeats=%llu\n",
+              static_cast<unsigned long long>(stats.queries),
+              static_cast<unsigned long long>(stats.subscribes),
+              static_cast<unsigned long long>(stats.heartbeats));
+  for (const auto &topic : stats.push.topics) {
+    const MockTopicStats &t = topic.second;
+    std::printf("push %-20s sent=%llu ok=%llu slow_down=%llu drop=%llu "
+                "failed=%llu suppressed=%llu rate=%.1fHz\n",
+                topic.first.c_str(), static_cast<unsigned long long>(t.sent),
+                static_cast<unsigned long long>(t.acked),
+                static_cast<unsigned long long>(t.slow_down),
+                static_cast<unsigned long long>(t.drop),
+                static_cast<unsigned long long>(t.failed),
+                static_cast<unsigned long long>(t.suppressed),
+                t.current_rate_hz);
+  }
+  std::fflush(stdout);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::string listen_address = "0.0.0.0";
+  int port = 50051;
+  int report_s = 5;
+  MockServerOptions options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string name = argv[i];
+    if (name == "-h" || name == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", name.c_str());
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (name == "--listen") {
+      listen_address = value;
+    } else if (name == "--port") {
+      port = std::atoi(value.c_str());
+    } else if (name == "--report-s") {
+      report_s = std::atoi(value.c_str());
+    } else {
+      Status status = ApplyMockServerFlag(name, value, &options);
+      if (!status) {
+        std::fprintf(stderr, "%s\n", status.message().c_str());
+        PrintUsage(argv[0]);
+        return 1;
+      }
+    }
+  }
+
+  MockInterfacesServer server(options);
+  Status status = server.Start(listen_address, port);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start mock server: %s\n",
+                 status.message().c_str());
+    return 1;
+  }
+  std::printf("Mock Interfaces-Server listening on %s\n",
+              server.GetTarget().c_str());
+  std::fflush(stdout);
+
+  std::signal(SIGINT, HandleSignal);
+  std::signal(SIGTERM, HandleSignal);
+
+  auto next_report =
+      std::chrono::steady_clock::now() + std::chrono::seconds(report_s);
+  while (g_running.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (report_s > 0 && std::chrono::steady_clock::now() >= next_report) {
+      next_report += std::chrono::seconds(report_s);
+      PrintStats(server.GetStats());
+    }
+  }
+
+  server.Stop();
+  PrintStats(server.GetStats());
+  return 0;
+}
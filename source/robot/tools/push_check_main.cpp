@@ -0,0 +1,647 @@
+/**
+ * Copyright (c) 2025 Humanoid Robot, Inc. All rights reserved.
+ *
+ * konka_sdk_push_check - end-to-end checks of the subscription push path
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "common/variant.pb.h"
+#include "mock_interfaces_server.h"
+#include "robot/client/client_callback_server.h"
+#include "robot/client/clock_sync.h"
+#include "robot/client/interfaces_client.h"
+#include "robot/client/shm_ring.h"
+#include "robot/client/subscription_manager.h"
+#include "robot/common/latency_histogram.h"
+
+using namespace humanoid_robot::konka_sdk::tools;
+using namespace humanoid_robot::konka_sdk::robot;
+using humanoid_robot::konka_sdk::common::LatencyHistogram;
+using humanoid_robot::PB::common::Variant;
+using humanoid_robot::PB::interfaces::Notification;
+using humanoid_robot::PB::interfaces::SubscribeRequest;
+using humanoid_robot::PB::interfaces::SubscribeResponse;
+
+namespace {
+
+/**
+ * 检查配置
+ */
+struct CheckOptions {
+  std::string scenario = "all";
+  double duration_s = 5;
+  // 关键消息端到端延迟 p99 上限(ms)
+  double critical_p99_ms = 10;
+  // 洪泛主题：大流量 lidar(kBulk) 与慢回调的普通主题(kNormal)
+  double lidar_hz = 2000;
+  size_t lidar_bytes = 65536;
+  int64_t lidar_handler_us = 500;
+  double pose_hz = 2000;
+  int64_t pose_handler_us = 8000;
+  double critical_hz = 20;
+  // 流控：推送频率远高于慢回调的消费速率
+  double flow_hz = 2000;
+  int64_t flow_handler_us = 2000;
+  // 共享内存扇出：推送经 ShmRingWriter 转发给读者
+  double shm_hz = 1000;
+  // 网关切换：SubscriptionManager 管理的订阅数与全部恢复的时限
+  size_t failover_subscriptions = 1000;
+  double failover_timeout_s = 30;
+};
+
+void SetString(google::protobuf::Map<std::string, Variant> *map,
+               const std::string &key, const std::string &value) {
+  Variant &variant = (*map)[key];
+  variant.set_type(Variant::KStringValue);
+  variant.set_stringvalue(value);
+}
+
+// 为每个主题单独订阅：模拟服务端每个订阅一个推送线程，
+// 关键消息不会在推送端排在洪泛消息之后
+Status SubscribeTopic(InterfacesClient &client, const std::string &endpoint,
+                      const std::string &topic) {
+  SubscribeRequest request;
+  auto *input = request.mutable_input()->mutable_keyvaluelist();
+  SetString(input, "topicId", topic);
+  SetString(input, "client_endpoint", endpoint);
+  SubscribeResponse response;
+  return client.Subscribe(request, response, 5000);
+}
+
+double Ms(uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+/**
+ * 洪泛下的关键消息：lidar 大流量和慢回调的 navigation.pose 占满普通队列时，
+ * error.critical 从模拟服务端打时间戳到处理器开始执行的端到端延迟。
+ * 延迟包含推送 RPC、解码、分发队列和线程切换；时间戳为毫秒精度，
+ * 测得值最多偏大 1ms。
+ */
+bool CheckCriticalUnderFlood(const CheckOptions &options) {
+  MockServerOptions mock_options;
+  mock_options.push.topics = {
+      {"sensor.lidar", options.lidar_hz, options.lidar_bytes, 4, false},
+      {"navigation.pose", options.pose_hz, 256, 64, false},
+      {"error.critical", options.critical_hz, 64, 1, true}};
+  // 只看分发路径本身，推送端不按确认降速
+  mock_options.push.honor_flow_control = false;
+  MockInterfacesServer mock(mock_options);
+  Status status = mock.Start("127.0.0.1", 0);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start mock server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  CallbackServerOptions server_options;
+  // 普通队列很小，pose 按对象分散到所有分片，慢回调很快把每个分片占满，
+  // gRPC 线程挡在背压上
+  server_options.dispatch.queue_capacity = 16;
+  server_options.dispatch.order_key = NotificationOrderKey::kEventTypeAndObjectId;
+  server_options.flow_control.enabled = false;
+  ClientCallbackServer server;
+  server.SetServerOptions(server_options);
+
+  LatencyHistogram critical_ns;
+  std::atomic<uint64_t> flood{0};
+  server.AddSubscriptionHandler("error.critical", [&](const NotificationPtr &) {
+    const NotificationTiming &timing = CurrentNotificationTiming();
+    if (timing.server_timestamp_ns > 0) {
+      critical_ns.Record(static_cast<uint64_t>(std::max<int64_t>(
+          0, ClockSync::LocalTimeNs() - timing.server_timestamp_ns)));
+    }
+  });
+  server.AddSubscriptionHandler("sensor.lidar", [&](const NotificationPtr &) {
+    flood.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(options.lidar_handler_us));
+  });
+  server.AddSubscriptionHandler("navigation.pose", [&](const NotificationPtr &) {
+    flood.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(options.pose_handler_us));
+  });
+  int port = 0;
+  status = server.StartWithAutoPort("127.0.0.1", port);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start callback server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  InterfacesClient client;
+  status = client.Connect(mock.GetTarget());
+  for (const char *topic : {"sensor.lidar", "navigation.pose"}) {
+    if (status) {
+      status = SubscribeTopic(client, server.GetClientEndpoint(), topic);
+    }
+  }
+  // 洪泛建立起积压后再开始推送关键消息
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  if (status) {
+    status = SubscribeTopic(client, server.GetClientEndpoint(), "error.critical");
+  }
+  if (!status) {
+    std::fprintf(stderr, "Subscribe failed: %s\n", status.message().c_str());
+    server.Stop();
+    return false;
+  }
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(static_cast<int64_t>(options.duration_s * 1000)));
+
+  MockPushStats push = mock.GetStats().push;
+  mock.Stop();
+  NotificationDispatchStats dispatch = server.GetStats().dispatch;
+  server.Stop();
+
+  const uint64_t sent = push.topics["error.critical"].sent;
+  const uint64_t received = critical_ns.Count();
+  const uint64_t p99_ns = critical_ns.Percentile(0.99);
+  std::printf("[critical] flood_handled=%llu bulk_shed=%llu max_queue_depth=%llu\n"
+              "[critical] sent=%llu received=%llu e2e p50=%.2fms p99=%.2fms "
+              "max=%.2fms (queue wait p99=%.2fms)\n",
+              static_cast<unsigned long long>(flood.load()),
+              static_cast<unsigned long long>(dispatch.bulk_shed),
+              static_cast<unsigned long long>(dispatch.max_queue_depth),
+              static_cast<unsigned long long>(sent),
+              static_cast<unsigned long long>(received),
+              Ms(critical_ns.Percentile(0.5)), Ms(p99_ns),
+              Ms(critical_ns.Max()), Ms(dispatch.critical_wait_p99_us * 1000));
+
+  bool ok = true;
+  if (dispatch.max_queue_depth < server_options.dispatch.queue_capacity) {
+    std::fprintf(stderr, "[critical] FAIL: flood did not fill the normal queue\n");
+    ok = false;
+  }
+  // 测量结束时最多有一条仍在路上
+  if (sent == 0 || received + 1 < sent) {
+    std::fprintf(stderr, "[critical] FAIL: %llu of %llu critical messages "
+                         "handled\n",
+                 static_cast<unsigned long long>(received),
+                 static_cast<unsigned long long>(sent));
+    ok = false;
+  }
+  if (Ms(p99_ns) > options.critical_p99_ms) {
+    std::fprintf(stderr, "[critical] FAIL: e2e p99 %.2fms exceeds %.2fms\n",
+                 Ms(p99_ns), options.critical_p99_ms);
+    ok = false;
+  }
+  return ok;
+}
+
+/**
+ * 模拟服务端按确认中的流控反馈推送：客户端开启流控，单个分片的慢回调
+ * 消费速率约 1e6 / flow_handler_us Hz。检查推送方收到了 kAckSlowDown、
+ * 按 ParseFlowFeedback() 解析出的建议频率降到配置频率的一半以下，
+ * 且收到 kAckDrop 时暂停了该主题。
+ */
+bool CheckFlowControl(const CheckOptions &options) {
+  MockServerOptions mock_options;
+  mock_options.push.topics = {
+      {"navigation.pose", options.flow_hz, 256, 8, false}};
+  mock_options.push.honor_flow_control = true;
+  MockInterfacesServer mock(mock_options);
+  Status status = mock.Start("127.0.0.1", 0);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start mock server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  CallbackServerOptions server_options;
+  server_options.dispatch.queue_capacity = 64;
+  server_options.flow_control.enabled = true;
+  ClientCallbackServer server;
+  server.SetServerOptions(server_options);
+  std::atomic<uint64_t> handled{0};
+  server.AddSubscriptionHandler("navigation.pose", [&](const NotificationPtr &) {
+    handled.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(options.flow_handler_us));
+  });
+  int port = 0;
+  status = server.StartWithAutoPort("127.0.0.1", port);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start callback server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  InterfacesClient client;
+  status = client.Connect(mock.GetTarget());
+  if (status) {
+    status = SubscribeTopic(client, server.GetClientEndpoint(), "navigation.pose");
+  }
+  if (!status) {
+    std::fprintf(stderr, "Subscribe failed: %s\n", status.message().c_str());
+    server.Stop();
+    return false;
+  }
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(static_cast<int64_t>(options.duration_s * 1000)));
+
+  MockTopicStats push = mock.GetStats().push.topics["navigation.pose"];
+  mock.Stop();
+  CallbackServerStats stats = server.GetStats();
+  server.Stop();
+
+  std::printf("[flow] sent=%llu handled=%llu ok=%llu slow_down=%llu drop=%llu "
+              "suppressed=%llu\n"
+              "[flow] configured=%.0fHz current=%.1fHz drain=%.1fHz\n",
+              static_cast<unsigned long long>(push.sent),
+              static_cast<unsigned long long>(handled.load()),
+              static_cast<unsigned long long>(push.acked),
+              static_cast<unsigned long long>(push.slow_down),
+              static_cast<unsigned long long>(push.drop),
+              static_cast<unsigned long long>(push.suppressed), options.flow_hz,
+              push.current_rate_hz, stats.flow_control.drain_rate_hz);
+
+  bool ok = true;
+  if (push.slow_down + push.drop == 0) {
+    std::fprintf(stderr, "[flow] FAIL: pusher received no flow feedback\n");
+    ok = false;
+  }
+  if (push.current_rate_hz > options.flow_hz * 0.5) {
+    std::fprintf(stderr, "[flow] FAIL: push rate %.1fHz was not reduced\n",
+                 push.current_rate_hz);
+    ok = false;
+  }
+  if (push.drop > 0 && push.suppressed == 0) {
+    std::fprintf(stderr, "[flow] FAIL: kAckDrop did not pause the topic\n");
+    ok = false;
+  }
+  if (push.failed > 0) {
+    std::fprintf(stderr, "[flow] FAIL: %llu pushes failed\n",
+                 static_cast<unsigned long long>(push.failed));
+    ok = false;
+  }
+  return ok;
+}
+
+/**
+ * 共享内存扇出：推送的 navigation.pose 经 ShmRingWriter::AsHandler() 写入
+ * 环形缓冲，读者线程通过 ShmRingReader 读取（与其他进程的读法相同）。
+ * 检查每条推送都已发布、读者收到与丢失之和等于发布数，并且写者销毁后
+ * 仍被调用的处理器不会访问已释放的写者，共享内存对象也已删除。
+ */
+bool CheckShmRing(const CheckOptions &options) {
+  MockServerOptions mock_options;
+  mock_options.push.topics = {
+      {"navigation.pose", options.shm_hz, 256, 8, false}};
+  mock_options.push.honor_flow_control = false;
+  MockInterfacesServer mock(mock_options);
+  Status status = mock.Start("127.0.0.1", 0);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start mock server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  const std::string name = "/konka_push_check_" + std::to_string(getpid());
+  std::unique_ptr<ShmRingWriter> writer;
+  std::unique_ptr<ShmRingReader> reader;
+  status = ShmRingWriter::Create(name, ShmRingOptions(), writer);
+  if (status) {
+    status = ShmRingReader::Open(name, reader);
+  }
+  if (!status) {
+    std::fprintf(stderr, "[shm] Failed to set up ring: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  std::atomic<bool> reading{true};
+  std::atomic<uint64_t> received{0};
+  std::thread reader_thread([&]() {
+    Notification message;
+    while (reading.load(std::memory_order_relaxed)) {
+      if (reader->Read(&message, 100)) {
+        received.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  CallbackServerOptions server_options;
+  server_options.flow_control.enabled = false;
+  ClientCallbackServer server;
+  server.SetServerOptions(server_options);
+  NotificationHandler publish = writer->AsHandler();
+  std::atomic<uint64_t> handled{0};
+  server.AddSubscriptionHandler("navigation.pose",
+                                [&](const NotificationPtr &message) {
+                                  handled.fetch_add(1, std::memory_order_relaxed);
+                                  publish(message);
+                                });
+  int port = 0;
+  status = server.StartWithAutoPort("127.0.0.1", port);
+  InterfacesClient client;
+  if (status) {
+    status = client.Connect(mock.GetTarget());
+  }
+  if (status) {
+    status = SubscribeTopic(client, server.GetClientEndpoint(), "navigation.pose");
+  }
+  if (!status) {
+    std::fprintf(stderr, "[shm] Subscribe failed: %s\n",
+                 status.message().c_str());
+    reading = false;
+    reader_thread.join();
+    server.Stop();
+    return false;
+  }
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(static_cast<int64_t>(options.duration_s * 1000)));
+
+  mock.Stop();
+  server.Stop();
+  // 等读者追上最后发布的消息
+  ShmRingStats stats = writer->GetStats();
+  auto drain_deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (received.load() + reader->Lost() < stats.published &&
+         std::chrono::steady_clock::now() < drain_deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  reading = false;
+  reader_thread.join();
+
+  // 写者销毁后处理器仍可能被调用（例如回调服务晚于写者停止）
+  writer.reset();
+  publish(std::make_shared<const Notification>());
+  std::unique_ptr<ShmRingReader> stale;
+  bool unlinked = !ShmRingReader::Open(name, stale);
+
+  std::printf("[shm] handled=%llu published=%llu received=%llu lost=%llu "
+              "oversize=%llu readers=%llu max_lag=%llu\n",
+              static_cast<unsigned long long>(handled.load()),
+              static_cast<unsigned long long>(stats.published),
+              static_cast<unsigned long long>(received.load()),
+              static_cast<unsigned long long>(reader->Lost()),
+              static_cast<unsigned long long>(stats.oversize),
+              static_cast<unsigned long long>(stats.readers),
+              static_cast<unsigned long long>(stats.max_reader_lag));
+
+  bool ok = true;
+  if (stats.published == 0 || stats.published != handled.load()) {
+    std::fprintf(stderr, "[shm] FAIL: %llu of %llu pushes published\n",
+                 static_cast<unsigned long long>(stats.published),
+                 static_cast<unsigned long long>(handled.load()));
+    ok = false;
+  }
+  if (received.load() + reader->Lost() != stats.published) {
+    std::fprintf(stderr, "[shm] FAIL: reader accounted for %llu of %llu "
+                         "messages\n",
+                 static_cast<unsigned long long>(received.load() +
+                                                 reader->Lost()),
+                 static_cast<unsigned long long>(stats.published));
+    ok = false;
+  }
+  if (stats.readers != 1) {
+    std::fprintf(stderr, "[shm] FAIL: %llu readers registered\n",
+                 static_cast<unsigned long long>(stats.readers));
+    ok = false;
+  }
+  if (!unlinked) {
+    std::fprintf(stderr, "[shm] FAIL: %s still exists after the writer "
+                         "closed\n",
+                 name.c_str());
+    ok = false;
+  }
+  return ok;
+}
+
+/**
+ * 网关切换：SubscriptionManager 在协商了 subscribe.renew.v1 的模拟服务端上
+ * 管理 failover_subscriptions 个订阅并批量续租，随后停掉服务端并在同一端口
+ * 启动一个不认识任何旧订阅的新实例。检查所有订阅在时限内恢复、新实例上
+ * 的订阅数恰好等于管理的订阅数（没有遗留或重复的订阅），并给出恢复耗时。
+ */
+bool CheckFailoverRestore(const CheckOptions &options) {
+  MockServerOptions mock_options;
+  mock_options.capabilities.push_back(kSubscriptionRenewCapability);
+  auto mock = std::make_unique<MockInterfacesServer>(mock_options);
+  Status status = mock->Start("127.0.0.1", 0);
+  if (!status) {
+    std::fprintf(stderr, "Failed to start mock server: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+  const int port = mock->GetPort();
+
+  auto client = std::make_shared<InterfacesClient>();
+  status = client->Connect(mock->GetTarget());
+  if (status) {
+    status = client->NegotiateCapabilities({kSubscriptionRenewCapability});
+  }
+  if (!status) {
+    std::fprintf(stderr, "[failover] Connect failed: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  SubscriptionManagerOptions manager_options;
+  manager_options.tick_ms = 50;
+  manager_options.default_heartbeat_s = 1;
+  SubscriptionManager manager(client, manager_options);
+  // 没有配置推送主题，订阅只登记不推送，端点不会被连接
+  for (size_t i = 0; i < options.failover_subscriptions && status; ++i) {
+    SubscribeRequest request;
+    auto *input = request.mutable_input()->mutable_keyvaluelist();
+    SetString(input, "topicId", "navigation.pose." + std::to_string(i));
+    SetString(input, "client_endpoint", "127.0.0.1:1");
+    ManagedSubscriptionId id = 0;
+    status = manager.Add(request, &id);
+  }
+  if (status) {
+    status = manager.Start();
+  }
+  if (!status) {
+    std::fprintf(stderr, "[failover] Subscribe failed: %s\n",
+                 status.message().c_str());
+    return false;
+  }
+
+  // 至少完成一轮续租后再切换
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (manager.GetStats().renewed < options.failover_subscriptions &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  SubscriptionManagerStats before = manager.GetStats();
+
+  auto failover_start = std::chrono::steady_clock::now();
+  mock->Stop();
+  mock = std::make_unique<MockInterfacesServer>(mock_options);
+  status = mock->Start("127.0.0.1", port);
+  if (!status) {
+    std::fprintf(stderr, "[failover] Failed to restart mock server on port "
+                         "%d: %s\n",
+                 port, status.message().c_str());
+    manager.Stop();
+    return false;
+  }
+
+  deadline = failover_start +
+             std::chrono::milliseconds(
+                 static_cast<int64_t>(options.failover_timeout_s * 1000));
+  SubscriptionManagerStats after;
+  size_t subscribers = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    after = manager.GetStats();
+    subscribers = mock->GetStats().push.subscribers;
+    if (after.pending == 0 && after.restored >= options.failover_subscriptions &&
+        subscribers >= options.failover_subscriptions) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  const double recovery_ms =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - failover_start)
+          .count();
+  manager.Stop();
+  after = manager.GetStats();
+  subscribers = mock->GetStats().push.subscribers;
+  mock->Stop();
+
+  std::printf("[failover] subscriptions=%zu renewed_before=%llu "
+              "renew_requests=%llu renew_skipped=%llu\n"
+              "[failover] restored=%llu restore_failures=%llu restores=%llu "
+              "pending=%llu gateway_subscribers=%zu recovery=%.0fms "
+              "last_restore=%lldms\n",
+              options.failover_subscriptions,
+              static_cast<unsigned long long>(before.renewed),
+              static_cast<unsigned long long>(after.renew_requests),
+              static_cast<unsigned long long>(after.renew_skipped),
+              static_cast<unsigned long long>(after.restored),
+              static_cast<unsigned long long>(after.restore_failures),
+              static_cast<unsigned long long>(after.restores),
+              static_cast<unsigned long long>(after.pending), subscribers,
+              recovery_ms, static_cast<long long>(after.last_restore_ms));
+
+  bool ok = true;
+  if (before.renewed < options.failover_subscriptions ||
+      after.renew_skipped != 0) {
+    std::fprintf(stderr, "[failover] FAIL: negotiated lease renewal did not "
+                         "run before the failover\n");
+    ok = false;
+  }
+  if (after.pending != 0 || after.restored < options.failover_subscriptions) {
+    std::fprintf(stderr, "[failover] FAIL: %llu subscriptions still pending "
+                         "after %.0fs\n",
+                 static_cast<unsigned long long>(after.pending),
+                 options.failover_timeout_s);
+    ok = false;
+  }
+  if (subscribers != options.failover_subscriptions) {
+    std::fprintf(stderr, "[failover] FAIL: new gateway holds %zu "
+                         "subscriptions, expected %zu\n",
+                 subscribers, options.failover_subscriptions);
+    ok = false;
+  }
+  return ok;
+}
+
+void PrintUsage(const char *program) {
+  std::fprintf(
+      stderr,
+      "Usage: %s [options]\n"
+      "Runs push-path checks against an embedded mock server; exits non-zero "
+      "on failure.\n"
+      "  --scenario NAME           critical, flow, shm, failover or all "
+      "(default all)\n"
+      "  --duration-s N            measured seconds per scenario (default 5)\n"
+      "  --critical-p99-ms N       critical e2e p99 limit (default 10)\n"
+      "  --lidar-hz N              sensor.lidar flood rate (default 2000)\n"
+      "  --lidar-bytes N           sensor.lidar payload bytes (default 65536)\n"
+      "  --pose-hz N               navigation.pose flood rate (default 2000)\n"
+      "  --pose-handler-us N       navigation.pose handler time (default 8000)\n"
+      "  --flow-hz N               flow scenario push rate (default 2000)\n"
+      "  --flow-handler-us N       flow scenario handler time (default 2000)\n"
+      "  --shm-hz N                shm scenario push rate (default 1000)\n"
+      "  --failover-subs N         failover scenario subscriptions "
+      "(default 1000)\n"
+      "  --failover-timeout-s N    failover restore time limit (default 30)\n",
+      program);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  CheckOptions options;
+  for (int i = 1; i < argc; ++i) {
+    std::string name = argv[i];
+    if (name == "-h" || name == "--help") {
+      PrintUsage(argv[0]);
+      return 0;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", name.c_str());
+      PrintUsage(argv[0]);
+      return 1;
+    }
+    std::string value = argv[++i];
+    if (name == "--scenario") {
+      options.scenario = value;
+    } else if (name == "--duration-s") {
+      options.duration_s = std::atof(value.c_str());
+    } else if (name == "--critical-p99-ms") {
+      options.critical_p99_ms = std::atof(value.c_str());
+    } else if (name == "--lidar-hz") {
+      options.lidar_hz = std::atof(value.c_str());
+    } else if (name == "--lidar-bytes") {
+      options.lidar_bytes = static_cast<size_t>(std::atoll(value.c_str()));
+    } else if (name == "--pose-hz") {
+      options.pose_hz = std::atof(value.c_str());
+    } else if (name == "--pose-handler-us") {
+      options.pose_handler_us = std::atoll(value.c_str());
+    } else if (name == "--flow-hz") {
+      options.flow_hz = std::atof(value.c_str());
+    } else if (name == "--flow-handler-us") {
+      options.flow_handler_us = std::atoll(value.c_str());
+    } else if (name == "--shm-hz") {
+      options.shm_hz = std::atof(value.c_str());
+    } else if (name == "--failover-subs") {
+      options.failover_subscriptions =
+          static_cast<size_t>(std::atoll(value.c_str()));
+    } else if (name == "--failover-timeout-s") {
+      options.failover_timeout_s = std::atof(value.c_str());
+    } else {
+      std::fprintf(stderr, "Unknown option %s\n", name.c_str());
+      PrintUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (options.scenario != "all" && options.scenario != "critical" &&
+      options.scenario != "flow" && options.scenario != "shm" &&
+      options.scenario != "failover") {
+    std::fprintf(stderr, "Unknown scenario %s\n", options.scenario.c_str());
+    PrintUsage(argv[0]);
+    return 1;
+  }
+
+  bool ok = true;
+  if (options.scenario == "all" || options.scenario == "critical") {
+    ok = CheckCriticalUnderFlood(options) && ok;
+  }
+  if (options.scenario == "all" || options.scenario == "flow") {
+    ok = CheckFlowControl(options) && ok;
+  }
+  if (options.scenario == "all" || options.scenario == "shm") {
+    ok = CheckShmRing(options) && ok;
+  }
+  if (options.scenario == "all" || options.scenario == "failover") {
+    ok = CheckFailoverRestore(options) && ok;
+  }
+  std::printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}